@@ -0,0 +1,198 @@
+// ============================================================
+// ARQUIVO: include/anomaly.hpp
+// DESCRIÇÃO: Detecção online de anomalias nas métricas amostradas
+// Detectores de custo O(1) por amostra, sem guardar a série:
+//
+// - EwmaDetector: z-score contra média e variância exponenciais
+//   (picos: CPU disparando, rajada de I/O)
+// - CusumDetector: CUSUM bilateral contra a linha de base do início
+//   (mudança de nível sustentada, pequena demais para o z-score)
+// - LeakDetector: regressão linear do RSS com pesos exponenciais;
+//   inclinação positiva e consistente = vazamento, com projeção do
+//   tempo até o OOM contra o memory.max do cgroup do processo
+//
+// Alertas são gravados como JSON lines (um objeto por linha) em
+// AnomalyEvents; nada é escrito enquanto não há alerta
+// ============================================================
+
+#ifndef ANOMALY_HPP
+#define ANOMALY_HPP
+
+#include <string>       // Para std::string
+#include <fstream>      // Para std::ofstream
+#include <ostream>      // Para std::ostream
+#include <cstdint>      // Para uint64_t
+
+// AnomalyConfig: limiares dos detectores
+struct AnomalyConfig {
+    // EWMA z-score
+    double ewma_alpha = 0.1;            // Peso da amostra nova na média
+    double z_threshold = 4.0;           // |z| que dispara o alerta
+    int warmup = 10;                    // Amostras antes de alertar
+
+    // CUSUM (em desvios padrão da linha de base)
+    double cusum_k = 0.5;               // Folga: mudanças menores que k·σ são ignoradas
+    double cusum_h = 8.0;               // Soma acumulada que dispara o alerta
+
+    // Vazamento de memória (regressão do RSS)
+    double leak_half_life_sec = 300.0;  // Meia-vida dos pesos da regressão
+    double leak_min_slope = 16384.0;    // Crescimento mínimo (B/s) para alertar
+    double leak_min_r2 = 0.8;           // Ajuste mínimo (crescimento consistente)
+    double leak_min_span_sec = 60.0;    // Tempo mínimo observado antes de alertar
+    double leak_repeat_sec = 60.0;      // Intervalo entre alertas repetidos do mesmo vazamento
+};
+
+// AnomalyEvent: um alerta
+struct AnomalyEvent {
+    int pid = 0;
+    std::string detector;               // "ewma_zscore", "cusum" ou "rss_slope"
+    std::string metric;                 // "cpu_percent", "memory_bytes", "io_bytes_per_second"
+    double value = 0.0;                 // Amostra que disparou
+    double baseline = 0.0;              // Média de referência do detector
+    double score = 0.0;                 // z, soma CUSUM (em σ) ou R² da regressão
+    double threshold = 0.0;
+    std::string direction;              // "up" ou "down"
+
+    // Apenas rss_slope
+    double slope = 0.0;                 // B/s
+    long long headroom_bytes = -1;      // Memória restante até o limite (-1 = desconhecida)
+    long long limit_bytes = -1;
+    std::string limit_source;           // "cgroup:<caminho>" ou "meminfo"
+    double time_to_oom_sec = -1.0;      // -1 = sem projeção
+
+    // Preenchidos no replay (vazios = processo vivo, instante atual)
+    std::string comm;
+    double wall_time = -1.0;            // Segundos desde a época Unix
+};
+
+// AnomalyOrigin: amostra reproduzida de uma sessão gravada
+// O processo pode não existir mais: comm e horário vêm da gravação e o
+// limite de memória (tempo até o OOM) não é consultado no sistema atual
+struct AnomalyOrigin {
+    std::string comm;
+    double wall_time = 0.0;             // Segundos desde a época Unix
+};
+
+// EwmaDetector: alerta quando a amostra se afasta |z| >= limiar da média
+// exponencial; rearma quando |z| volta abaixo da metade do limiar
+class EwmaDetector {
+private:
+    double alpha;
+    double threshold;
+    double min_std;                     // Piso do desvio (séries quase constantes)
+    int warmup;
+    uint64_t count;
+    double mean;
+    double variance;
+    bool firing;
+
+public:
+    EwmaDetector(double alpha, double threshold, double min_std, int warmup);
+
+    // Retorno: true ao entrar em anomalia; z recebe o escore da amostra
+    bool update(double value, double& z);
+
+    double baseline() const { return mean; }
+};
+
+// CusumDetector: soma acumulada dos desvios normalizados contra a média
+// das primeiras 'warmup' amostras; ao alertar, a linha de base é
+// refeita no nível novo
+class CusumDetector {
+private:
+    double k;
+    double h;
+    double min_std;
+    int warmup;
+    uint64_t count;
+    double base_mean;
+    double base_m2;
+    double sum_high;
+    double sum_low;
+
+public:
+    CusumDetector(double k, double h, double min_std, int warmup);
+
+    // Retorno: true ao detectar mudança de nível; score = soma (em σ),
+    // up = direção da mudança, reference = linha de base anterior
+    bool update(double value, double& score, bool& up, double& reference);
+};
+
+// LeakDetector: regressão linear ponderada (pesos decaem com a meia-vida)
+// de valor x tempo, atualizada em O(1) por amostra
+class LeakDetector {
+private:
+    double half_life;
+    double min_slope;
+    double min_r2;
+    double min_span;
+    double repeat;
+    bool has_origin;
+    double origin;                      // Instante da primeira amostra
+    double origin_value;                // Valor da primeira amostra
+    double last_t;
+    double last_alert;
+    double w, st, sx, stt, stx, sxx;    // Somas ponderadas
+
+public:
+    explicit LeakDetector(const AnomalyConfig& config);
+
+    // t_sec: instante da amostra (segundos, monotônico)
+    // Retorno: true quando há crescimento consistente (no máximo a cada
+    // leak_repeat_sec); slope em unidades/s e r2 do ajuste
+    bool update(double t_sec, double value, double& slope, double& r2);
+};
+
+// AnomalyEvents: fluxo de eventos em JSON lines
+class AnomalyEvents {
+private:
+    std::ofstream file;
+    std::ostream* out;
+    std::string deferred;       // Arquivo aberto só no primeiro evento (open_on_first_event)
+    uint64_t emitted;
+
+public:
+    AnomalyEvents();
+
+    // Abre o destino em modo append ("-" = stderr, o stdout pode ser o CSV)
+    // Retorno: false se o arquivo não pôde ser aberto
+    bool open(const std::string& target);
+
+    // Como open(), mas o arquivo só é criado quando o primeiro evento
+    // chega: execuções sem alertas não deixam arquivo vazio
+    void open_on_first_event(const std::string& target);
+
+    bool is_open() const { return out != nullptr || !deferred.empty(); }
+
+    // Grava um evento (com timestamp e comm do processo) e faz flush
+    // comm e wall_time do evento, se preenchidos, substituem os atuais
+    void emit(const AnomalyEvent& event);
+
+    uint64_t count() const { return emitted; }
+};
+
+// AnomalyDetector: conjunto de detectores de um alvo (processo)
+class AnomalyDetector {
+private:
+    AnomalyConfig config;
+    EwmaDetector cpu_z, rss_z, io_z;
+    CusumDetector cpu_shift, rss_shift, io_shift;
+    LeakDetector leak;
+
+public:
+    explicit AnomalyDetector(const AnomalyConfig& config = AnomalyConfig());
+
+    // Processa uma amostra já com as taxas calculadas
+    // origin: preenchido no replay (nullptr = processo vivo)
+    // Retorno: número de alertas emitidos em events
+    int update(int pid, double t_sec, double cpu_percent, double rss_bytes, double io_rate,
+               AnomalyEvents& events, const AnomalyOrigin* origin = nullptr);
+};
+
+// Memória restante até o limite mais apertado do processo: memory.max
+// (v2) ou memory.limit_in_bytes (v1) do cgroup e de seus ancestrais;
+// sem limite, MemAvailable de /proc/meminfo
+// Retorno: false se nada pôde ser lido
+bool memory_headroom(int pid, long long& headroom_bytes, long long& limit_bytes, std::string& source);
+
+#endif
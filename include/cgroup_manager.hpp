@@ -30,6 +30,79 @@ struct PressureStats {
     unsigned long long total;
 };
 
+// CGroupStats: snapshot dos contadores nativos de um cgroup
+// Preenchido de uma só vez por read_cgroup_stats(), lendo poucos arquivos
+// do cgroup em vez de somar /proc/[pid]/* de cada processo membro
+struct CGroupStats {
+    // Tempo total de CPU consumido pelo cgroup (cpu.stat usage_usec)
+    unsigned long long cpu_usage_usec;
+    
+    // Parcelas de usuário e sistema (cpu.stat user_usec / system_usec)
+    unsigned long long cpu_user_usec;
+    unsigned long long cpu_system_usec;
+    
+    // Quantas vezes o cgroup foi estrangulado pelo cpu.max
+    // e por quanto tempo ficou parado (throttled_usec)
+    unsigned long long cpu_nr_throttled;
+    unsigned long long cpu_throttled_usec;
+    
+    // Memória atual em bytes (memory.current)
+    unsigned long long memory_current;
+    
+    // I/O acumulado de todos os dispositivos (io.stat)
+    unsigned long long io_rbytes;
+    unsigned long long io_wbytes;
+    unsigned long long io_rios;
+    unsigned long long io_wios;
+    
+    // Tarefas ativas no cgroup (pids.current), -1 se indisponível
+    int pids_current;
+    
+    // Pressure Stall Information (somente v2, zerado caso contrário)
+    PressureStats cpu_pressure;
+    PressureStats memory_pressure;
+    PressureStats io_pressure;
+    
+    // False se nem o contador de CPU pôde ser lido
+    bool valid;
+};
+
+// CGroupDeviceIO: contadores e limites de I/O de um cgroup em um dispositivo
+// (io.stat e io.max no v2; blkio.throttle.* no v1)
+struct CGroupDeviceIO {
+    unsigned int major;
+    unsigned int minor;
+    
+    // Acumulados desde a criação do cgroup
+    unsigned long long rbytes;
+    unsigned long long wbytes;
+    unsigned long long rios;
+    unsigned long long wios;
+    
+    // Limites configurados (-1 = sem limite)
+    long long rbps_max;
+    long long wbps_max;
+    long long riops_max;
+    long long wiops_max;
+};
+
+// CGroupIOSnapshot: I/O por dispositivo e pressão de I/O de um cgroup
+// Preenchido por read_io_snapshot() para correlacionar com /proc/diskstats
+struct CGroupIOSnapshot {
+    std::vector<CGroupDeviceIO> devices;
+    
+    // Linhas "some" (alguma tarefa parada em I/O) e "full" (todas paradas)
+    PressureStats pressure_some;
+    PressureStats pressure_full;
+    
+    // False quando o cgroup não tem io.pressure (cgroup raiz, v1) e a
+    // pressão veio do sistema inteiro (/proc/pressure/io)
+    bool cgroup_pressure;
+    
+    // False se nem os contadores de I/O puderam ser lidos
+    bool valid;
+};
+
 class CGroupManager {
 private:
     // Caminho base dos cgroups no filesystem
@@ -111,6 +184,10 @@ public:
     // Útil para dimensionar limite apropriado
     size_t read_memory_max_usage(const std::string& cgroup_path);
 
+    // Lê o limite de memória em bytes (memory.max no v2, memory.limit_in_bytes no v1)
+    // Retorno: -1 se não há limite ou o arquivo não existe (sem mensagens de erro)
+    long long read_memory_limit(const std::string& cgroup_path);
+
     // Lê o número de falhas de alocação de memória
     // Contador de quantas vezes malloc() falhou
     // Indica se limite foi atingido frequentemente
@@ -177,6 +254,17 @@ public:
     // Lê PIDs de cgroup.procs ou tasks
     std::vector<std::string> list_processes_in_cgroup(const std::string& cgroup_path);
 
+    // Lê todos os contadores nativos do cgroup em uma única passada
+    // (cpu.stat, memory.current, io.stat, pids.current e PSI)
+    // Não imprime erros: arquivos ausentes ficam zerados
+    CGroupStats read_cgroup_stats(const std::string& cgroup_path);
+
+    // Lê o I/O do cgroup separado por dispositivo, os limites de cada um
+    // e a pressão de I/O (io.stat, io.max e io.pressure no v2;
+    // blkio.throttle.* e /proc/pressure/io no v1)
+    // Não imprime erros: arquivos ausentes ficam zerados
+    CGroupIOSnapshot read_io_snapshot(const std::string& cgroup_path);
+
     // Detecta a versão de CGroup no sistema (ESTÁTICO)
     // Verifica existência de /sys/fs/cgroup/cgroup.controllers
     static bool is_cgroup_v2();
@@ -0,0 +1,31 @@
+// ============================================================
+// ARQUIVO: include/cli.hpp
+// DESCRIÇÃO: Linha de comando não interativa do resource-monitor
+// Subcomandos para uso em scripts e systemd, sem depender do menu:
+//
+//   resource-monitor profile --pid 1234,5678 [--cgroup CAMINHO]
+//                    [--interval-ms N] [--duration S] [--output ARQ|-] [--network]
+//                    [--record SESSÃO]
+//   resource-monitor replay SESSÃO [--pid P1,P2] [--output ARQ|-|none] [--events ARQ|-]
+//   resource-monitor query SESSÃO... [--metric M] [--from HORÁRIO] [--to HORÁRIO]
+//                    [--group-by pid|comm|cgroup|ns] [--bucket 1h] [--agg avg,max,p99]
+//   resource-monitor ns scan [--format csv|json] [--output ARQ|-]
+//   resource-monitor cgroup top [--path CAMINHO] [--depth N] [--limit N]
+//                    [--interval-ms N] [--duration S]
+//   resource-monitor top [--sort cpu|rss|io] [--limit N] [--interval-ms N] [--duration S] [--no-io]
+//   resource-monitor threads --pid P [--sort cpu|wait|switches] [--limit N]
+//                    [--interval-ms N] [--duration S]
+//   resource-monitor bench [opções do bench_collectors]
+//   resource-monitor --daemon [--config ARQ] [opções do profile]
+//
+// Opção global: --root DIR lê /proc e /sys de um snapshot capturado
+// ============================================================
+
+#ifndef CLI_HPP
+#define CLI_HPP
+
+// Executa o subcomando indicado em argv
+// Retorno: código de saída (0 sucesso, 1 falha na execução, 2 uso incorreto)
+int run_cli(int argc, char* argv[]);
+
+#endif
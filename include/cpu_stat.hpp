@@ -0,0 +1,115 @@
+// ============================================================
+// ARQUIVO: include/cpu_stat.hpp
+// DESCRIÇÃO: Utilização de CPU do sistema, por núcleo e agregada
+// Visão do host que falta ao CPU% por processo: a cada ciclo lê
+// /proc/stat inteiro (pread em um fd persistente) e, em uma passada,
+// copia as linhas cpuN para um buffer em colunas (um vetor por campo,
+// o mesmo índice = o mesmo núcleo). Os deltas e percentuais são laços
+// simples sobre esses vetores, sem desvios: o compilador os vetoriza e
+// o custo fica linear e pequeno mesmo com centenas de núcleos.
+//
+// Também calcula a capacidade de CPU que um processo realmente tem
+// (cpuset/afinidade e cota cpu.max do cgroup), base alternativa para
+// normalizar o CPU% por processo
+// ============================================================
+
+#ifndef CPU_STAT_HPP
+#define CPU_STAT_HPP
+
+#include <string>       // Para std::string
+#include <vector>       // Para std::vector
+#include <cstddef>      // Para size_t
+
+// CpuUtilization: percentuais de um intervalo (somam 100)
+// user inclui nice; guest e guest_nice já estão contidos em user/nice
+struct CpuUtilization {
+    double user = 0.0;
+    double system = 0.0;
+    double iowait = 0.0;
+    double irq = 0.0;
+    double softirq = 0.0;
+    double steal = 0.0;         // Tempo roubado pelo hipervisor
+    double idle = 0.0;
+
+    // Ocupado = tudo menos idle e iowait
+    double busy() const { return 100.0 - idle - iowait; }
+};
+
+// CpuColumns: resultado de um ciclo, uma linha por núcleo online
+// O mesmo índice em todos os vetores corresponde ao mesmo núcleo
+struct CpuColumns {
+    std::vector<int> cpu;                   // Número do núcleo (N de cpuN)
+    std::vector<double> user;
+    std::vector<double> system;
+    std::vector<double> iowait;
+    std::vector<double> irq;
+    std::vector<double> softirq;
+    std::vector<double> steal;
+    std::vector<double> idle;
+
+    size_t size() const { return cpu.size(); }
+    CpuUtilization at(size_t i) const;
+};
+
+class SystemCpuStat {
+private:
+    // Colunas de /proc/stat usadas, na ordem do arquivo
+    enum Field { USER, NICE, SYSTEM, IDLE, IOWAIT, IRQ, SOFTIRQ, STEAL, FIELDS };
+
+    // Contadores brutos (ticks) por campo, uma posição por linha cpuN.
+    // Em double: exato até 2^53 ticks e o laço de deltas vetoriza com
+    // SSE2 (não há subtração/máximo vetorial de inteiros de 64 bits sem
+    // extensões mais novas)
+    struct Counters {
+        std::vector<double> field[FIELDS];
+        std::vector<int> cpu;               // Número de cada linha
+        double aggregate[FIELDS] = {};      // Linha "cpu" (todos os núcleos)
+        size_t cores = 0;
+    };
+
+    int stat_fd;
+    std::vector<char> buffer;               // Conteúdo de /proc/stat (cresce se preciso)
+    Counters counters[2];                   // Leitura atual e anterior, alternadas
+    int current;
+    bool has_prev;
+    std::vector<double> delta[FIELDS];      // Rascunho dos deltas (mesmo layout)
+    std::vector<double> total;
+    CpuColumns cols;
+    CpuUtilization aggregate;
+
+    void reserve(size_t cores);
+    bool read_file();
+    bool parse(Counters& out);
+
+public:
+    SystemCpuStat();
+    ~SystemCpuStat();
+
+    SystemCpuStat(const SystemCpuStat&) = delete;
+    SystemCpuStat& operator=(const SystemCpuStat&) = delete;
+
+    // Lê /proc/stat e calcula os percentuais desde a leitura anterior
+    // A primeira leitura (e a seguinte a uma mudança dos núcleos online)
+    // só estabelece a linha de base
+    // Retorno: número de núcleos com percentuais, 0 na linha de base, -1 erro
+    int sample();
+
+    // Núcleos do último ciclo
+    const CpuColumns& cores() const { return cols; }
+
+    // Agregado de todos os núcleos (linha "cpu" de /proc/stat)
+    const CpuUtilization& total_utilization() const { return aggregate; }
+};
+
+// Núcleos que o processo realmente pode usar: CPUs da afinidade
+// (Cpus_allowed_list, que já reflete o cpuset do cgroup) limitadas pela
+// cota de CPU (cpu.max no v2, cpu.cfs_quota_us no v1) do cgroup e de
+// seus ancestrais. Fracionário com cota (ex: 1.5 = 150ms a cada 100ms)
+// Retorno: 0 se /proc/[pid]/status é ilegível
+double process_cpu_capacity(int pid);
+
+// Expande uma lista de CPUs no formato "0-3,8,10-11" (cpulist do /sys,
+// Cpus_allowed_list do status) em ordem
+std::vector<int> parse_cpu_list(const std::string& list);
+
+#endif
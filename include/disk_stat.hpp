@@ -0,0 +1,180 @@
+// ============================================================
+// ARQUIVO: include/disk_stat.hpp
+// DESCRIÇÃO: Latência e utilização de dispositivos de bloco (/proc/diskstats)
+// io_read_bytes/io_write_bytes dizem quanto um processo leu ou escreveu,
+// não se o disco está no limite. Aqui cada dispositivo tem, entre dois
+// ciclos (mesmas definições do iostat -x):
+//
+// - IOPS e vazão de leitura/escrita (setores de 512 bytes)
+// - await: tempo médio por requisição concluída (fila + serviço, ms)
+// - Utilização: % do tempo com pelo menos uma requisição em andamento
+//   (io_ticks). Em SSD/NVMe, que atendem várias em paralelo, 100% não
+//   significa saturado: olhar também await e a fila
+// - Fila: requisições em voo no instante da leitura e a média do ciclo
+//   (aqu-sz, tempo ponderado / tempo decorrido)
+//
+// CgroupDiskMonitor cruza esses números com io.stat, io.max e
+// io.pressure de um cgroup para separar estrangulamento (o cgroup está
+// no seu limite de io.max) de saturação (o próprio dispositivo está no
+// limite) e de espera sem causa local (outros cgroups, io.weight)
+// ============================================================
+
+#ifndef DISK_STAT_HPP
+#define DISK_STAT_HPP
+
+#include "cgroup_manager.hpp"
+#include <string>           // Para std::string
+#include <vector>           // Para std::vector
+#include <unordered_map>    // Para std::unordered_map
+#include <chrono>           // Para std::chrono
+#include <cstdint>          // Para uint64_t
+
+// DiskDevice: uma linha de /proc/diskstats
+struct DiskDevice {
+    unsigned int major = 0;
+    unsigned int minor = 0;
+    std::string name;
+    bool whole_disk = false;        // Disco inteiro (/sys/block/<nome>), não partição
+
+    // Contadores acumulados
+    uint64_t reads = 0;             // Leituras concluídas
+    uint64_t read_sectors = 0;
+    uint64_t read_ms = 0;           // Tempo somado das leituras
+    uint64_t writes = 0;
+    uint64_t write_sectors = 0;
+    uint64_t write_ms = 0;
+    uint64_t in_flight = 0;         // Requisições em voo agora (instantâneo)
+    uint64_t io_ms = 0;             // Tempo com alguma requisição em voo (io_ticks)
+    uint64_t weighted_ms = 0;       // Tempo em voo somado por requisição
+
+    // Taxas do último ciclo (0 no primeiro ciclo do dispositivo)
+    double read_iops = 0;
+    double write_iops = 0;
+    double read_bps = 0;            // B/s
+    double write_bps = 0;
+    double read_await = 0;          // ms por leitura concluída
+    double write_await = 0;
+    double utilization = 0;         // % do ciclo
+    double queue_depth = 0;         // Média de requisições em voo (aqu-sz)
+};
+
+class DiskStat {
+private:
+    struct Entry {
+        bool seen = false;          // Presente na última leitura
+        bool has_prev = false;
+        DiskDevice device;
+    };
+
+    int fd;
+    std::vector<char> buffer;       // Conteúdo do diskstats (cresce com o número de dispositivos)
+    std::unordered_map<uint64_t, Entry> entries;   // Chave: major << 32 | minor
+    std::vector<const DiskDevice*> order;
+    bool include_all;
+    unsigned int generation;
+    std::chrono::steady_clock::time_point prev_time;
+    double last_elapsed;
+
+    void update(Entry& entry, const uint64_t* fields, double elapsed);
+
+public:
+    // include_all=true lista partições e dispositivos sem nenhum I/O
+    // (loop, ram, zram ociosos); por padrão só discos inteiros já usados
+    explicit DiskStat(bool include_all = false);
+    ~DiskStat();
+
+    DiskStat(const DiskStat&) = delete;
+    DiskStat& operator=(const DiskStat&) = delete;
+
+    // Relê /proc/diskstats e calcula as taxas. O primeiro ciclo só
+    // estabelece a base
+    // Retorno: false se o arquivo não pôde ser lido
+    bool sample();
+
+    // Dispositivos do último ciclo em ordem decrescente de utilização
+    const std::vector<const DiskDevice*>& devices() const { return order; }
+
+    // Dispositivo pelo número (inclusive os que devices() omite), nullptr se não existe
+    const DiskDevice* find(unsigned int major, unsigned int minor) const;
+
+    // Tempo real entre os dois últimos ciclos (segundos; 0 no primeiro)
+    double elapsed() const { return last_elapsed; }
+};
+
+// Diagnóstico de um cgroup em um dispositivo no último ciclo
+enum class IoVerdict {
+    IDLE,           // Sem I/O do cgroup e sem espera
+    OK,             // I/O sem espera relevante
+    THROTTLED,      // Taxa no limite do io.max: o gargalo é o limite
+    SATURATED,      // Dispositivo no limite (utilização alta)
+    CONTENDED       // Tarefas esperando I/O sem limite nem dispositivo cheio
+};
+
+// Nome curto do diagnóstico (colunas do CLI)
+const char* io_verdict_name(IoVerdict verdict);
+
+// CgroupDiskIO: I/O de um cgroup em um dispositivo no último ciclo
+struct CgroupDiskIO {
+    unsigned int major = 0;
+    unsigned int minor = 0;
+    std::string device;             // Nome em /proc/diskstats ("MAJ:MIN" se ausente)
+
+    double read_bps = 0;
+    double write_bps = 0;
+    double read_iops = 0;
+    double write_iops = 0;
+
+    // Limite mais próximo de ser atingido: nome (rbps, wbps, riops,
+    // wiops; vazio sem limite) e uso no ciclo em %
+    std::string limit_name;
+    long long limit_value = -1;
+    double limit_usage = 0;
+
+    double device_share = 0;        // % dos bytes do dispositivo vindos do cgroup
+    double device_utilization = 0;
+    IoVerdict verdict = IoVerdict::IDLE;
+};
+
+class CgroupDiskMonitor {
+private:
+    // Limiares do diagnóstico (%)
+    static constexpr double LIMIT_THRESHOLD = 90.0;        // Taxa / io.max
+    static constexpr double SATURATION_THRESHOLD = 90.0;   // Utilização do dispositivo
+    static constexpr double STALL_THRESHOLD = 10.0;        // Tempo com tarefas paradas em I/O
+
+    std::string cgroup;
+    CGroupManager manager;
+    CGroupIOSnapshot prev;
+    bool has_prev;
+    std::chrono::steady_clock::time_point prev_time;
+    std::vector<CgroupDiskIO> rows;
+    double some_percent;
+    double full_percent;
+
+public:
+    explicit CgroupDiskMonitor(const std::string& cgroup_path);
+
+    CgroupDiskMonitor(const CgroupDiskMonitor&) = delete;
+    CgroupDiskMonitor& operator=(const CgroupDiskMonitor&) = delete;
+
+    // Relê io.stat/io.max/io.pressure e diagnostica cada dispositivo com
+    // o ciclo de disks (amostrado logo antes). O primeiro ciclo só
+    // estabelece a base
+    // Retorno: false se os contadores de I/O do cgroup não existem
+    bool sample(const DiskStat& disks);
+
+    // Dispositivos em que o cgroup tem contadores, na ordem do io.stat
+    const std::vector<CgroupDiskIO>& devices() const { return rows; }
+
+    // % do último ciclo com alguma / todas as tarefas paradas em I/O
+    // (delta do total do io.pressure, mais preciso que avg10)
+    double stall_some() const { return some_percent; }
+    double stall_full() const { return full_percent; }
+
+    // False se a pressão é do sistema inteiro (cgroup raiz ou v1)
+    bool cgroup_pressure() const { return prev.cgroup_pressure; }
+
+    const std::string& path() const { return cgroup; }
+};
+
+#endif
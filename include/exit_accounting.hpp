@@ -0,0 +1,158 @@
+// ============================================================
+// ARQUIVO: include/exit_accounting.hpp
+// DESCRIÇÃO: Contabilidade de processos encerrados (taskstats)
+// Processos que nascem e terminam entre duas amostras não aparecem em
+// nenhuma leitura do /proc; em runners de CI e cargas de shell eles
+// somam a maior parte da CPU. O kernel entrega o registro final de cada
+// tarefa que termina (CPU, bytes de I/O, faults, atrasos, comm) pela
+// família genetlink TASKSTATS a quem registrar uma máscara de CPUs
+// (CAP_NET_ADMIN, kernel com CONFIG_TASKSTATS):
+//
+// - TaskstatsListener: socket netlink não bloqueante, drenado a cada
+//   ciclo. Só os registros por tarefa (TASKSTATS_TYPE_AGGR_PID) são
+//   usados: o registro por grupo (AGGR_TGID) só traz os atrasos
+// - ExitAccounting: soma os registros por cgroup e por processo pai e
+//   concilia com a amostragem do /proc (ProcessTree) para que a CPU
+//   atribuída (vivos + encerrados) feche com a do host
+//
+// O cgroup de quem já terminou vem do cache de metadados (se o processo
+// foi visto vivo) ou do pai, cujo cgroup o filho herda no fork
+// ============================================================
+
+#ifndef EXIT_ACCOUNTING_HPP
+#define EXIT_ACCOUNTING_HPP
+
+#include <string>           // Para std::string
+#include <vector>           // Para std::vector
+#include <unordered_map>    // Para std::unordered_map
+#include <cstdint>          // Para uint64_t, uint16_t
+
+class ProcessTree;
+
+// ExitRecord: registro final de uma tarefa (thread) que terminou
+struct ExitRecord {
+    int pid = 0;                    // ID da tarefa (TID)
+    int tgid = 0;                   // Processo (igual a pid na thread principal)
+    int ppid = 0;
+    int uid = -1;
+    std::string comm;
+    uint64_t btime = 0;             // Início (segundos desde 1970)
+    uint32_t exit_code = 0;
+
+    uint64_t utime_us = 0;
+    uint64_t stime_us = 0;
+    uint64_t read_bytes = 0;        // I/O de bloco (como /proc/[pid]/io)
+    uint64_t write_bytes = 0;
+    uint64_t minor_faults = 0;
+    uint64_t major_faults = 0;
+
+    // Atrasos (ns); zerados sem delay accounting (sysctl kernel.task_delayacct)
+    uint64_t cpu_delay_ns = 0;      // Esperando CPU na runqueue
+    uint64_t blkio_delay_ns = 0;    // Esperando I/O de bloco
+    uint64_t swapin_delay_ns = 0;   // Esperando swap-in
+
+    uint64_t cpu_us() const { return utime_us + stime_us; }
+};
+
+class TaskstatsListener {
+private:
+    int sock;
+    uint16_t family_id;
+    std::string cpumask;            // Máscara registrada ("0-7")
+    std::vector<char> buffer;
+    unsigned long lost;             // Mensagens perdidas (buffer do socket cheio)
+
+    bool send_command(uint16_t type, uint8_t cmd, uint16_t attr, const void* data, size_t len);
+    bool wait_ack();
+    bool resolve_family();
+
+public:
+    TaskstatsListener();
+    ~TaskstatsListener();
+
+    TaskstatsListener(const TaskstatsListener&) = delete;
+    TaskstatsListener& operator=(const TaskstatsListener&) = delete;
+
+    // Abre o socket, resolve a família e registra todas as CPUs possíveis
+    // Retorno: false (com mensagem em stderr) sem permissão ou sem suporte
+    bool open();
+
+    // Cancela o registro e fecha o socket
+    void close();
+
+    bool is_open() const { return sock >= 0; }
+    int fd() const { return sock; }
+
+    // Lê todos os registros pendentes sem bloquear e os acrescenta a out
+    // Retorno: registros lidos
+    size_t drain(std::vector<ExitRecord>& out);
+
+    // Mensagens perdidas por estouro do buffer (ENOBUFS) desde a abertura
+    unsigned long dropped() const { return lost; }
+};
+
+// ExitGroup: soma dos registros de um cgroup ou de um processo pai
+struct ExitGroup {
+    std::string key;
+    long tasks = 0;                 // Tarefas (threads) encerradas
+    long processes = 0;             // Processos inteiros (thread principal)
+    double cpu_us = 0;              // utime + stime das tarefas
+    double tick_cpu_us = 0;         // Parcela do último ciclo
+    uint64_t read_bytes = 0;
+    uint64_t write_bytes = 0;
+    uint64_t minor_faults = 0;
+    uint64_t major_faults = 0;
+    uint64_t cpu_delay_ns = 0;
+    uint64_t blkio_delay_ns = 0;
+};
+
+enum class ExitGroupBy {
+    CGROUP,
+    PARENT
+};
+
+class ExitAccounting {
+private:
+    // Registros de um processo ainda não conciliados com a árvore
+    struct Pending {
+        double cpu_us = 0;
+        int ticks = 0;              // Ciclos esperando o processo sumir do /proc
+    };
+
+    std::unordered_map<std::string, ExitGroup> by_cgroup;
+    std::unordered_map<int, ExitGroup> by_parent;          // Por PPID
+    std::unordered_map<int, Pending> pending;
+    std::unordered_map<int, unsigned long long> prev_exited;   // PIDs que sumiram no ciclo anterior
+    long tick_tasks;
+    long tick_processes;
+    bool settled;                   // Ciclo fechado: o próximo add/settle zera as parcelas
+    double boot_epoch;              // Boot em segundos desde 1970 (btime de /proc/stat)
+    long ticks_per_sec;
+
+    std::string cgroup_of(const ExitRecord& record) const;
+    void reset_tick();
+
+public:
+    ExitAccounting();
+
+    // Soma o registro nos agregados por cgroup e por pai
+    void add(const ExitRecord& record);
+
+    // Concilia os registros do ciclo com a árvore recém-amostrada e fecha
+    // o ciclo (parcelas do ciclo valem até o próximo add ou settle)
+    // - Processo visto vivo na amostra anterior: só o trecho após a
+    //   última leitura (registros - último utime+stime lido) é novo
+    // - Processo ainda vivo na árvore (threads que terminaram): já está
+    //   no utime+stime do processo; espera um ciclo e é descartado
+    // - Processo nunca visto: todo o tempo é novo
+    // Retorno: CPU (us) dos encerrados que a amostragem do /proc não viu
+    double settle(const ProcessTree& tree);
+
+    // Grupos em ordem decrescente de CPU acumulada
+    std::vector<const ExitGroup*> top(ExitGroupBy by, size_t k) const;
+
+    long last_tasks() const { return tick_tasks; }
+    long last_processes() const { return tick_processes; }
+};
+
+#endif
@@ -0,0 +1,149 @@
+// ============================================================
+// ARQUIVO: include/metrics_server.hpp
+// DESCRIÇÃO: Exposição de métricas no formato Prometheus/OpenMetrics
+// Um servidor HTTP mínimo (epoll, sem dependências externas) serve
+// a última amostra do profiler a partir de um snapshot em memória:
+//
+// - O snapshot é renderizado no máximo uma vez por ciclo de coleta e
+//   publicado em buffer duplo (o buffer anterior é reaproveitado)
+// - Um scrape nunca lê /proc: apenas copia o texto já pronto
+//
+// Endereços aceitos: "127.0.0.1:9464", "[::1]:9464", "unix:/run/ra3.sock"
+// ============================================================
+
+#ifndef METRICS_SERVER_HPP
+#define METRICS_SERVER_HPP
+
+#include <string>       // Para std::string
+#include <vector>       // Para std::vector
+#include <map>          // Para std::map
+#include <memory>       // Para std::shared_ptr
+#include <mutex>        // Para std::mutex
+#include <atomic>       // Para std::atomic
+#include <chrono>       // Para std::chrono
+#include "profiler.hpp"
+#include "cgroup_manager.hpp"
+
+// Tipo de uma família de métricas
+enum class MetricType {
+    GAUGE,      // Valor instantâneo
+    COUNTER     // Acumulado monotônico (nome termina em _total)
+};
+
+// MetricFamily: uma métrica e suas séries (uma por conjunto de labels)
+struct MetricFamily {
+    // Nome da métrica (contadores sem o sufixo _total)
+    std::string name;
+
+    // Texto do # HELP
+    std::string help;
+
+    MetricType type;
+
+    // Séries: labels já formatados (ex: pid="1",comm="init") e valor
+    std::vector<std::pair<std::string, double>> samples;
+
+    MetricFamily(const std::string& metric_name, const std::string& metric_help, MetricType metric_type);
+
+    void add(const std::string& labels, double value);
+};
+
+// Escapa um valor de label (\, " e quebra de linha)
+std::string metrics_escape_label(const std::string& value);
+
+// Corpo já renderizado nos dois formatos de exposição
+struct MetricsBody {
+    std::string text;           // text/plain; version=0.0.4
+    std::string openmetrics;    // application/openmetrics-text; version=1.0.0
+};
+
+// MetricsSnapshot: última exposição publicada, em buffer duplo
+// publish() renderiza no buffer reserva e troca com o atual; leitores
+// mantêm o buffer que estão enviando vivo via shared_ptr
+class MetricsSnapshot {
+private:
+    mutable std::mutex mtx;
+    std::shared_ptr<const MetricsBody> front;
+    std::shared_ptr<MetricsBody> spare;
+
+public:
+    MetricsSnapshot();
+
+    // Renderiza e publica as famílias (chamado pelo coletor, uma vez por ciclo)
+    void publish(const std::vector<MetricFamily>& families);
+
+    // Exposição atual (chamado pelo servidor a cada scrape)
+    std::shared_ptr<const MetricsBody> current() const;
+};
+
+// MetricsExporter: converte as amostras de um ciclo em famílias de métricas
+// Por processo (amostras do profiler), por cgroup (contadores nativos) e por
+// grupo de namespace (varredura de /proc, no máximo a cada ns_refresh)
+class MetricsExporter {
+private:
+    MetricsSnapshot& snapshot;
+    CGroupManager mgr;
+    std::vector<std::string> cgroups;
+
+    // Grupos de namespace da última varredura
+    std::vector<MetricFamily> ns_families;
+    std::chrono::steady_clock::time_point last_ns_scan;
+    std::chrono::seconds ns_refresh;
+    bool ns_scanned;
+
+    void refresh_namespace_groups();
+
+public:
+    MetricsExporter(MetricsSnapshot& snap, const std::vector<std::string>& cgroup_paths,
+                    std::chrono::seconds namespace_refresh = std::chrono::seconds(10));
+
+    // Troca os cgroups exportados (ex: recarga de configuração do daemon)
+    void set_cgroups(const std::vector<std::string>& cgroup_paths);
+
+    // Monta e publica o snapshot do ciclo
+    // host: memória do host lida pelo profiler no mesmo ciclo
+    void publish_tick(const std::vector<ProcessSample>& samples, const HostMemory& host);
+};
+
+// MetricsServer: servidor HTTP/1.1 de uma thread sobre epoll
+// Responde GET /metrics (e /) com o snapshot; conexões keep-alive
+class MetricsServer {
+private:
+    struct Connection {
+        std::string request;                        // Bytes recebidos ainda não processados
+        std::string header;                         // Cabeçalho da resposta em envio
+        std::shared_ptr<const MetricsBody> body;    // Mantém o buffer vivo durante o envio
+        const std::string* payload;                 // Texto do formato escolhido (dentro de body)
+        size_t sent;                                // Bytes já enviados (cabeçalho + corpo)
+        bool close_after;                           // "Connection: close" ou erro
+    };
+
+    MetricsSnapshot& snapshot;
+    int epoll_fd;
+    std::vector<int> listen_fds;
+    std::string unix_path;
+    std::map<int, Connection> connections;
+
+    bool add_listener(int fd);
+    void accept_connections(int listen_fd);
+    void handle_readable(int fd);
+    void handle_writable(int fd);
+    void prepare_response(Connection& conn, const std::string& request_head);
+    void close_connection(int fd);
+
+public:
+    explicit MetricsServer(MetricsSnapshot& snap);
+    ~MetricsServer();
+
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+
+    // Abre o socket de escuta ("host:porta", "[v6]:porta" ou "unix:/caminho")
+    // Retorno: false em erro (mensagem no stderr)
+    bool listen(const std::string& address);
+
+    // Atende requisições até 'active' ficar false (verificado a cada 200ms)
+    void run(const std::atomic<bool>& active);
+};
+
+#endif
@@ -9,6 +9,7 @@
 #define MONITOR_HPP
 
 #include <string>
+#include <functional>
 
 // Processo com PID não existe em /proc
 #define ERR_PROCESS_NOT_FOUND -2
@@ -31,6 +32,12 @@ struct ProcStats {
     // Tempo em modo sistema (ticks do kernel)
     // Incrementa quando processo executa chamadas de sistema (syscalls)
     long stime;
+
+    // Tempo de CPU dos filhos já encerrados e aguardados (ticks, campos
+    // 16 e 17 de /proc/[pid]/stat). Quem cria e espera filhos (make,
+    // shells, masters pré-fork) acumula aqui o trabalho deles
+    long cutime;
+    long cstime;
     
     // Número de threads ativas do processo
     // Conta threads leves (lightweight processes)
@@ -58,6 +65,16 @@ struct ProcStats {
     // Dados que foram movidos do RAM para o disco (SWAP)
     // Indica swapping (desempenho ruim)
     long memory_swap;
+
+    // Proportional Set Size em KB (smaps_rollup): páginas compartilhadas
+    // divididas entre os processos que as mapeiam. Ao contrário do RSS,
+    // somar o PSS de um pool de workers pré-fork não conta duas vezes
+    // -1 se não coletado (ver sample_smaps_adaptive)
+    long memory_pss;
+
+    // Unique Set Size em KB: páginas só deste processo
+    // (Private_Clean + Private_Dirty); -1 se não coletado
+    long memory_uss;
     
     // Page faults menores (sem I/O de disco)
     long minor_faults;
@@ -99,6 +116,10 @@ struct ProcStats {
     // Número de conexões TCP ativas do processo
     // Contabiliza portas abertas
     int tcp_connections;
+
+    // Instante de início (campo 22 de /proc/[pid]/stat, ticks desde o boot)
+    // Junto com o PID identifica o processo: muda se o PID for reutilizado
+    long long start_time;
 };
 
 // NetworkStats: apenas estatísticas de rede de um processo
@@ -107,16 +128,108 @@ struct NetworkStats {
     // Número de conexões TCP ativas do processo
     int tcp_connections;
 };
+
+// SmapsStats: contabilidade detalhada de memória de /proc/[pid]/smaps_rollup
+// Todos os valores em KB
+struct SmapsStats {
+    long rss;               // Igual ao VmRSS (referência)
+    long pss;               // Proportional Set Size
+    long pss_anon;          // Parcela anônima do PSS
+    long pss_file;          // Parcela de arquivos mapeados do PSS
+    long pss_shmem;         // Parcela de memória compartilhada (shmem/tmpfs) do PSS
+    long uss;               // Private_Clean + Private_Dirty
+    long shared_clean;      // Páginas compartilhadas não modificadas
+    long shared_dirty;      // Páginas compartilhadas modificadas
+    long private_clean;     // Páginas privadas não modificadas
+    long private_dirty;     // Páginas privadas modificadas
+    long anonymous;         // Memória anônima (heap, pilhas)
+    long swap;              // Em swap
+    long swap_pss;          // Swap proporcional (compartilhado dividido)
+    long anon_huge;         // Anônima em transparent huge pages
+    long shmem_huge;        // Shmem mapeada em huge pages (PMD)
+    long file_huge;         // Arquivos mapeados em huge pages (PMD)
+};
+
+// ReadSchedule: agenda de uma leitura cara repetida por PID
+// (smaps_rollup, numa_maps). Relida a cada max_interval ciclos, ou antes
+// se o chamador vê uma mudança relevante, e nunca mais rápido do que o
+// custo medido permite
+struct ReadSchedule {
+    // Releitura forçada a cada N ciclos
+    int max_interval;
+
+    // Custo médio aceitável da leitura por ciclo (ms): uma leitura de
+    // 20ms com orçamento de 1ms só se repete após 20 ciclos
+    double cost_budget_ms = 1.0;
+
+    // Estado
+    bool valid = false;             // Houve ao menos uma leitura
+    int error = 0;                  // Erro permanente (ex: sem permissão): não tenta mais
+    int ticks_since_read = 0;
+    double last_cost_ms = 0.0;
+    long reads = 0;                 // Leituras feitas
+    long skipped = 0;               // Ciclos em que a leitura anterior foi mantida
+
+    explicit ReadSchedule(int interval) : max_interval(interval) {}
+};
+
+// Conta um ciclo e chama read() se a agenda indicar, medindo o custo
+// changed: mudança vista pelo chamador que antecipa a releitura
+// read: 0 sucesso, < 0 código de erro. ERR_PROCESS_NOT_FOUND é tentado
+// de novo (processo terminou); os demais param a agenda
+// Retorno: 1 se relido, 0 se a leitura anterior foi mantida, < 0 erro
+int run_read_schedule(ReadSchedule& schedule, bool changed, const std::function<int()>& read);
+
+// SmapsSchedule: agenda adaptativa de leitura do smaps_rollup de um PID
+// smaps_rollup percorre todas as VMAs e tabelas de páginas (milissegundos
+// em processos grandes); o RSS de /proc/[pid]/status é barato. O PSS é
+// relido antes de max_interval quando o RSS muda de forma relevante
+struct SmapsSchedule : ReadSchedule {
+    // Variação do RSS desde a última leitura que antecipa a releitura
+    double rss_change_ratio = 0.05;
+    long rss_change_min_kb = 1024;
+
+    SmapsStats last = {};           // Última leitura
+    long rss_at_read = 0;           // RSS no momento da última leitura
+
+    SmapsSchedule() : ReadSchedule(10) {}
+};
+
 // Coleta dados de CPU do arquivo /proc/[pid]/stat
 int get_cpu_usage(int pid, ProcStats& stats);
 
+// Número de núcleos do sistema usado na normalização de CPU%
+unsigned int get_num_cores();
+
 // Calcula o percentual de CPU entre duas leituras consecutivas
 // Normaliza automaticamente pelo número de núcleos do sistema
 double calculate_cpu_percent(const ProcStats& prev, const ProcStats& curr, double interval);
 
+// Mesmo cálculo com ticks/s e capacidade explícitos: replay de uma sessão
+// gravada em outra máquina, ou normalização pelos núcleos que o processo
+// pode usar (process_cpu_capacity; fracionária com cota de CPU)
+double calculate_cpu_percent(const ProcStats& prev, const ProcStats& curr, double interval,
+                             long ticks_per_sec, double cores);
+
 // Coleta dados de memória do arquivo /proc/[pid]/status
+// Lê MemTotal de /proc/meminfo para o memory_percent
 int get_memory_usage(int pid, ProcStats& stats);
 
+// Mesma coleta com MemTotal já lido (ex: snapshot do host compartilhado
+// por todos os PIDs do ciclo, ver SystemMemoryStat): sem /proc/meminfo
+int get_memory_usage(int pid, ProcStats& stats, long mem_total_kb);
+
+// Coleta PSS/USS e a divisão compartilhada/privada de /proc/[pid]/smaps_rollup
+// (kernel >= 4.14; exige a mesma permissão de ptrace que /proc/[pid]/io)
+// Retorno: ERR_PROCESS_NOT_FOUND só se o processo terminou; thread de
+// kernel ou kernel sem o arquivo dão ERR_UNKNOWN (permanente na agenda)
+int get_smaps_rollup(int pid, SmapsStats& stats);
+
+// Relê smaps_rollup se a agenda indicar e atualiza schedule.last
+// rss_kb: RSS atual (de get_memory_usage)
+// Retorno: 1 se relido, 0 se a leitura anterior foi mantida, < 0 erro
+int sample_smaps_adaptive(int pid, long rss_kb, SmapsSchedule& schedule);
+
 // Coleta dados de I/O do arquivo /proc/[pid]/io
 int get_io_usage(int pid, ProcStats& stats);
 
@@ -134,6 +134,10 @@ std::vector<pid_t> find_processes_in_namespace(NamespaceType ns_type, ino_t ns_i
 // Verifica quais tipos compartilham (inode igual) e quais diferem
 std::optional<NamespaceComparison> compare_namespaces(pid_t pid1, pid_t pid2);
 
+// Agrupa todos os processos do sistema por namespace (tipo + inode)
+// Base do relatório do sistema e das métricas por grupo de namespace
+std::vector<NamespaceGroup> scan_namespace_groups();
+
 // Gera um relatório completo do sistema em CSV ou JSON
 // Scanneia todos os processos em /proc e agrupa por namespace+inode
 // Útil para entender topologia de isolamento do sistema
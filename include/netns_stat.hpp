@@ -0,0 +1,107 @@
+// ============================================================
+// ARQUIVO: include/netns_stat.hpp
+// DESCRIÇÃO: Tráfego de rede por namespace de rede (contêineres)
+// get_network_usage(ProcStats&) soma as interfaces do /proc/net/dev do
+// host: o tráfego de contêineres em outros namespaces de rede não
+// aparece e a quebra por interface se perde. Aqui cada namespace NET
+// distinto (inode, agrupado pelo Namespace Analyzer) tem um
+// /proc/[pid]/net/dev aberto por um processo representante:
+//
+// - O arquivo aberto fica preso ao namespace (não ao processo): segue
+//   válido se o representante terminar, e cada ciclo custa um pread por
+//   namespace, não por processo (200 contêineres = 200 leituras)
+// - Namespaces novos ou sem processos são detectados numa nova
+//   varredura a cada RESCAN_TICKS ciclos (scan_namespace_groups)
+// - Taxas por interface entre dois ciclos (bytes e pacotes/s); erros e
+//   descartes ficam acumulados como no kernel
+// ============================================================
+
+#ifndef NETNS_STAT_HPP
+#define NETNS_STAT_HPP
+
+#include <string>           // Para std::string
+#include <vector>           // Para std::vector
+#include <unordered_map>    // Para std::unordered_map
+#include <chrono>           // Para std::chrono
+#include <cstdint>          // Para uint64_t
+#include <sys/types.h>      // Para pid_t, ino_t
+
+// NetInterfaceStats: uma linha de /proc/net/dev
+struct NetInterfaceStats {
+    std::string name;
+
+    // Contadores acumulados
+    uint64_t rx_bytes = 0;
+    uint64_t rx_packets = 0;
+    uint64_t rx_errors = 0;
+    uint64_t rx_drops = 0;
+    uint64_t tx_bytes = 0;
+    uint64_t tx_packets = 0;
+    uint64_t tx_errors = 0;
+    uint64_t tx_drops = 0;
+
+    // Taxas do último ciclo (0 no primeiro ciclo da interface)
+    double rx_rate = 0;             // B/s
+    double tx_rate = 0;
+    double rx_packet_rate = 0;      // Pacotes/s
+    double tx_packet_rate = 0;
+};
+
+// NetnsTraffic: um namespace de rede e suas interfaces
+struct NetnsTraffic {
+    ino_t inode = 0;
+    pid_t pid = 0;                  // Representante usado na abertura
+    int process_count = 0;          // Processos no namespace (última varredura)
+    bool host = false;              // Namespace do próprio monitor (snapshot: o do PID 1)
+    std::string comm;               // Nome do representante
+    std::string cgroup;             // Cgroup do representante (identifica o contêiner)
+    std::vector<NetInterfaceStats> interfaces;
+
+    // Soma das interfaces exceto lo
+    double rx_rate = 0;
+    double tx_rate = 0;
+};
+
+class NetnsStat {
+private:
+    // Ciclos entre duas varreduras de namespaces
+    static const unsigned int RESCAN_TICKS = 10;
+
+    struct Entry {
+        int fd = -1;
+        bool seen = false;          // Presente na última varredura
+        bool has_prev = false;
+        NetnsTraffic traffic;
+    };
+
+    std::unordered_map<ino_t, Entry> entries;
+    std::vector<const NetnsTraffic*> order;
+    std::vector<char> buffer;       // Conteúdo de um net/dev (cresce com o número de interfaces)
+    ino_t self_inode;
+    unsigned int generation;
+    std::chrono::steady_clock::time_point prev_time;
+    double last_elapsed;
+
+    void rescan();
+    bool read_entry(Entry& entry, double elapsed);
+
+public:
+    NetnsStat();
+    ~NetnsStat();
+
+    NetnsStat(const NetnsStat&) = delete;
+    NetnsStat& operator=(const NetnsStat&) = delete;
+
+    // Relê o net/dev de cada namespace (e varre os namespaces no primeiro
+    // ciclo e a cada RESCAN_TICKS). O primeiro ciclo só estabelece a base
+    // Retorno: número de namespaces lidos
+    size_t sample();
+
+    // Namespaces do último ciclo em ordem decrescente de rx+tx
+    const std::vector<const NetnsTraffic*>& namespaces() const { return order; }
+
+    // Tempo real entre os dois últimos ciclos (segundos; 0 no primeiro)
+    double elapsed() const { return last_elapsed; }
+};
+
+#endif
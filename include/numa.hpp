@@ -0,0 +1,94 @@
+// ============================================================
+// ARQUIVO: include/numa.hpp
+// DESCRIÇÃO: Posicionamento NUMA da memória e das threads
+// get_memory_usage só dá totais; em hosts com mais de um soquete o
+// acesso à memória de outro nó custa caro. Aqui:
+//
+// - Nós do sistema (/sys/devices/system/node/nodeN): CPUs, memória
+//   total/livre e contadores numa_hit/miss/foreign/local/other
+// - Páginas residentes do processo por nó (/proc/[pid]/numa_maps,
+//   campos N<nó>=<páginas> de cada VMA)
+// - Nó em que cada thread rodou por último (campo processor de
+//   /proc/[pid]/task/[tid]/stat, mapeado para o nó da CPU)
+//
+// Um processo é sinalizado quando a maior parte da memória está em um
+// nó diferente daquele em que a maioria das threads roda.
+//
+// numa_maps percorre todas as VMAs e as tabelas de páginas (caro em
+// processos grandes): é lido em fluxo, sem carregar o arquivo, e com a
+// mesma agenda limitada pelo custo medido do smaps_rollup (ReadSchedule)
+// ============================================================
+
+#ifndef NUMA_HPP
+#define NUMA_HPP
+
+#include "monitor.hpp"
+#include <vector>       // Para std::vector
+
+// NumaNode: um nó de memória do sistema
+struct NumaNode {
+    int node = -1;
+    std::vector<int> cpus;                  // CPUs do nó (cpulist)
+    long long mem_total_kb = 0;
+    long long mem_free_kb = 0;
+
+    // numastat: páginas alocadas (cumulativos desde o boot)
+    unsigned long long numa_hit = 0;        // No nó pretendido
+    unsigned long long numa_miss = 0;       // Aqui, pretendidas em outro nó
+    unsigned long long numa_foreign = 0;    // Pretendidas aqui, alocadas em outro nó
+    unsigned long long local_node = 0;      // Para processo rodando neste nó
+    unsigned long long other_node = 0;      // Para processo rodando em outro nó
+};
+
+// ProcessNuma: posicionamento de um processo
+struct ProcessNuma {
+    std::vector<long long> resident_kb;     // Memória residente por nó (índice = nó)
+    std::vector<int> threads;               // Threads por nó da última CPU usada
+    int memory_node = -1;                   // Nó com mais memória (-1 = nenhuma)
+    int thread_node = -1;                   // Nó com mais threads (-1 = nenhuma)
+    double local_ratio = 1.0;               // Fração da memória no nó das threads
+    bool misplaced = false;                 // Memória majoritariamente em outro nó
+
+    long long total_kb() const;
+};
+
+// Lê os nós de /sys/devices/system/node
+// Retorno: nós em ordem crescente; vazio em kernel sem NUMA
+std::vector<NumaNode> read_numa_nodes();
+
+// Mapa CPU -> nó (índice = CPU; -1 para CPUs sem nó)
+std::vector<int> numa_cpu_nodes(const std::vector<NumaNode>& nodes);
+
+// Soma as páginas residentes por nó de /proc/[pid]/numa_maps (em KB,
+// pelo kernelpagesize_kB de cada VMA: páginas enormes contam inteiras)
+// Retorno: 0 sucesso, < 0 código de erro (ERR_*)
+int get_numa_maps(int pid, std::vector<long long>& resident_kb);
+
+// Conta as threads por nó da última CPU em que rodaram
+// Retorno: threads contadas, < 0 código de erro (ERR_*)
+int get_thread_nodes(int pid, const std::vector<int>& cpu_nodes, std::vector<int>& threads);
+
+// Completa memory_node, thread_node, local_ratio e misplaced a partir
+// de resident_kb e threads
+// misplaced_ratio: abaixo desta fração local (com mais de um nó em
+// uso) o processo é sinalizado
+void classify_numa(ProcessNuma& numa, double misplaced_ratio = 0.5);
+
+// Lê numa_maps e as threads e classifica
+// Retorno: 0 sucesso, < 0 código de erro (ERR_*)
+int get_process_numa(int pid, const std::vector<int>& cpu_nodes, ProcessNuma& numa, double misplaced_ratio = 0.5);
+
+// NumaSchedule: agenda de leitura do numa_maps de um PID (ReadSchedule,
+// sem releitura antecipada)
+struct NumaSchedule : ReadSchedule {
+    double misplaced_ratio = 0.5;
+    ProcessNuma last;                       // Última leitura
+
+    NumaSchedule() : ReadSchedule(30) {}
+};
+
+// Relê o posicionamento se a agenda indicar e atualiza schedule.last
+// Retorno: 1 se relido, 0 se a leitura anterior foi mantida, < 0 erro
+int sample_numa_adaptive(int pid, const std::vector<int>& cpu_nodes, NumaSchedule& schedule);
+
+#endif
@@ -0,0 +1,153 @@
+// ============================================================
+// ARQUIVO: include/proc_batch.hpp
+// DESCRIÇÃO: Leitura em lote do /proc com io_uring
+// Mesmo com fds persistentes, amostrar milhares de PIDs custa uma
+// syscall por arquivo (stat, status e io de cada alvo). Aqui as
+// leituras do ciclo inteiro são enfileiradas e enviadas ao kernel em
+// lotes (uma io_uring_enter por lote de até RING_ENTRIES leituras):
+//
+// - BatchReader: lista de leituras (fd, capacidade) sobre uma arena de
+//   buffers registrada no anel (IORING_OP_READ_FIXED). Sem io_uring
+//   (kernel < 5.6, io_uring_disabled, seccomp) usa pread, uma por
+//   leitura, com a mesma interface
+// - ProcBatch: fds de stat/status/io de cada alvo abertos entre ciclos;
+//   um sample() preenche ProcStats como get_cpu_usage +
+//   get_memory_usage + get_io_usage, tratando cada conclusão assim que
+//   ela chega
+//
+// Arquivos do /proc não têm leitura não bloqueante: o kernel executa
+// cada leitura em um worker (io-wq) do processo. O ganho vem das
+// syscalls (uma por lote em vez de uma por arquivo), não de paralelismo
+// ============================================================
+
+#ifndef PROC_BATCH_HPP
+#define PROC_BATCH_HPP
+
+#include "monitor.hpp"
+#include <vector>           // Para std::vector
+#include <unordered_map>    // Para std::unordered_map
+#include <functional>       // Para std::function
+#include <cstddef>          // Para size_t
+#include <sys/types.h>      // Para ssize_t
+
+class BatchReader {
+private:
+    // Leituras em voo por io_uring_enter
+    static const unsigned int RING_ENTRIES = 256;
+
+    struct Request {
+        int fd;
+        size_t offset;          // Início do buffer na arena
+        size_t capacity;
+    };
+
+    std::vector<Request> requests;
+    std::vector<char> arena;
+    size_t arena_used;
+
+    // Anel (-1 = pread)
+    int ring_fd;
+    void* sq_ring;
+    void* cq_ring;
+    void* sqes;
+    size_t sq_ring_size;
+    size_t cq_ring_size;
+    size_t sqes_size;
+    unsigned int sq_entries;
+    unsigned int* sq_head;
+    unsigned int* sq_tail;
+    unsigned int* sq_mask;
+    unsigned int* sq_array;
+    unsigned int* cq_head;
+    unsigned int* cq_tail;
+    unsigned int* cq_mask;
+    void* cqes;
+
+    // Arena registrada (IORING_REGISTER_BUFFERS); nullptr = leituras comuns
+    const char* registered;
+    size_t registered_size;
+    bool register_failed;       // Sem memória travável (RLIMIT_MEMLOCK): não tenta de novo
+    unsigned long enter_calls;
+
+    bool setup_ring();
+    void teardown_ring();
+    void register_arena();
+    void run_uring(const std::function<void(size_t, const char*, ssize_t)>& on_complete);
+    void run_sync(const std::function<void(size_t, const char*, ssize_t)>& on_complete);
+
+public:
+    // use_uring=false força o caminho com pread (comparação, depuração)
+    explicit BatchReader(bool use_uring = true);
+    ~BatchReader();
+
+    BatchReader(const BatchReader&) = delete;
+    BatchReader& operator=(const BatchReader&) = delete;
+
+    // Backend em uso
+    bool uring() const { return ring_fd >= 0; }
+
+    // Enfileira a leitura de até capacity bytes do início do arquivo
+    // Retorno: índice da leitura (passado a on_complete)
+    size_t add(int fd, size_t capacity);
+
+    // Esvazia a fila (a arena é reaproveitada no próximo ciclo)
+    void clear();
+
+    size_t size() const { return requests.size(); }
+
+    // Executa todas as leituras da fila. on_complete(índice, dados, n) é
+    // chamado na ordem em que as leituras terminam; dados termina em '\0'
+    // e n < 0 é -errno
+    void run(const std::function<void(size_t, const char*, ssize_t)>& on_complete);
+
+    // Syscalls de leitura feitas desde a criação (io_uring_enter ou pread)
+    unsigned long syscalls() const { return enter_calls; }
+};
+
+class ProcBatch {
+private:
+    // Capacidade das leituras (status cresce com grupos e listas de CPUs)
+    static const size_t STAT_CAPACITY = 1024;
+    static const size_t STATUS_CAPACITY = 4096;
+    static const size_t IO_CAPACITY = 512;
+
+    struct Files {
+        int stat_fd = -1;
+        int status_fd = -1;
+        int io_fd = -1;
+    };
+
+    std::unordered_map<int, Files> files;
+    BatchReader reader;
+    bool with_io;
+
+    int open_files(int pid, Files& f);
+    void close_files(Files& f);
+
+public:
+    // with_io=false dispensa /proc/[pid]/io
+    explicit ProcBatch(bool use_uring = true, bool with_io = true);
+    ~ProcBatch();
+
+    ProcBatch(const ProcBatch&) = delete;
+    ProcBatch& operator=(const ProcBatch&) = delete;
+
+    bool uring() const { return reader.uring(); }
+
+    // Lê stat, status e io de todos os PIDs em um lote
+    // stats[i] recebe os campos de get_cpu_usage, get_memory_usage (com
+    // mem_total_kb) e get_io_usage; results[i] = 0 ou ERR_* (processo
+    // terminou, sem permissão). Um PID que falha tem os fds fechados: o
+    // próximo sample() reabre (PID reutilizado = outro processo)
+    void sample(const std::vector<int>& pids, long mem_total_kb,
+                std::vector<ProcStats>& stats, std::vector<int>& results);
+
+    // Fecha os fds de um PID que deixou de ser amostrado
+    void forget(int pid);
+
+    size_t tracked() const { return files.size(); }
+
+    unsigned long syscalls() const { return reader.syscalls(); }
+};
+
+#endif
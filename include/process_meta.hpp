@@ -0,0 +1,82 @@
+// ============================================================
+// ARQUIVO: include/process_meta.hpp
+// DESCRIÇÃO: Cache de metadados estáticos de processos
+// comm, cmdline, exe, uid, ppid, cgroup e namespaces mudam raramente
+// durante a vida de um processo, mas eram relidos de /proc a cada
+// relatório, varredura ou amostra. O cache guarda esses metadados por
+// PID junto com o instante de início (campo 22 de /proc/[pid]/stat):
+// PID reutilizado = instante diferente = entrada relida.
+//
+// Consultas sem o instante de início leem só /proc/[pid]/stat (uma
+// leitura, que já traz comm, ppid e o início) e também comparam o comm:
+// um exec troca o nome e invalida a entrada. setns/unshare seguidos de
+// exec são vistos assim; sem exec, os namespaces ficam os da primeira
+// leitura até o processo terminar.
+//
+// Compartilhado (process_meta_cache()) pelo profiler, gravação de
+// sessões, exportador de métricas, alertas e Namespace Analyzer;
+// seguro para uso concorrente
+// ============================================================
+
+#ifndef PROCESS_META_HPP
+#define PROCESS_META_HPP
+
+#include <string>           // Para std::string
+#include <vector>           // Para std::vector
+#include <memory>           // Para std::shared_ptr
+#include <mutex>            // Para std::mutex
+#include <unordered_map>    // Para std::unordered_map
+#include <cstdint>          // Para uint64_t
+
+// Namespaces na ordem de NamespaceType (cgroup, ipc, mnt, net, pid, user, uts)
+static const size_t PROCESS_META_NS_COUNT = 7;
+
+// ProcessMeta: metadados de um processo (imutáveis depois de lidos)
+struct ProcessMeta {
+    int pid = 0;
+    long long start_time = -1;          // Ticks desde o boot (identifica o processo)
+    std::string comm;
+    std::string cmdline;                // Argumentos separados por espaço (vazio em threads do kernel)
+    std::string exe;                    // Destino de /proc/[pid]/exe (vazio sem permissão)
+    int uid = -1;                       // UID real
+    int ppid = -1;
+    std::string cgroup;                 // Caminho do cgroup (como CGroupManager::get_current_cgroup)
+    uint64_t ns_inode[PROCESS_META_NS_COUNT] = {};  // 0 = ilegível
+};
+
+class ProcessMetaCache {
+private:
+    std::unordered_map<int, std::shared_ptr<const ProcessMeta>> entries;
+    mutable std::mutex mutex;
+    unsigned long hit_count = 0;
+    unsigned long load_count = 0;
+
+public:
+    // Metadados do processo, lidos de /proc só na primeira consulta de
+    // cada (PID, instante de início)
+    // start_time >= 0: instante já conhecido pelo chamador (ex:
+    //   ProcStats.start_time); entrada com o mesmo instante volta sem
+    //   nenhuma leitura
+    // start_time < 0: lê /proc/[pid]/stat e revalida pelo início e comm
+    // Retorno: nullptr se o processo não existe
+    std::shared_ptr<const ProcessMeta> get(int pid, long long start_time = -1);
+
+    // Entrada em cache, sem ler /proc nem revalidar (ex: processo que já
+    // terminou; o chamador confere o instante de início)
+    std::shared_ptr<const ProcessMeta> find(int pid) const;
+
+    // Descarta a entrada (ex: processo terminou)
+    void forget(int pid);
+
+    // Mantém só as entradas dos PIDs informados (ex: após listar o /proc)
+    void retain(const std::vector<int>& live_pids);
+
+    size_t size() const;
+    unsigned long hits() const;         // Consultas respondidas pelo cache
+    unsigned long loads() const;        // Leituras completas de /proc
+};
+
+// Cache compartilhado por todos os componentes
+ProcessMetaCache& process_meta_cache();
+
+#endif
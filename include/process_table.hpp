@@ -0,0 +1,133 @@
+// ============================================================
+// ARQUIVO: include/process_table.hpp
+// DESCRIÇÃO: Amostragem em lote de todos os processos do sistema
+// Base do subcomando "top": a cada ciclo atualiza CPU, RSS e I/O de
+// todos os PIDs, guardando os resultados em colunas (um vetor por
+// métrica) para seleção dos top-K sem ordenar tudo.
+//
+// Custo por PID (orçamento: < 1% de um núcleo a 1s com 5k processos):
+// - Os arquivos ficam abertos entre ciclos e são relidos com pread
+//   (1 syscall por arquivo, sem open/close). O fd fica preso ao
+//   processo original: PID reutilizado = leitura falha = reabertura
+// - CPU vem de /proc/[pid]/schedstat (~3x mais barato que stat) em
+//   processos de uma thread; com várias threads o schedstat só cobre
+//   a thread principal, então esses processos leem stat. Na primeira
+//   checagem sem uso após atividade o stat é relido para confirmar que
+//   o processo continua com uma thread
+// - stat (RSS, threads) e io só são relidos se o processo rodou no
+//   ciclo ou na sua vez do rodízio de REFRESH_TICKS ciclos (recuperação
+//   de páginas, swap); a taxa de I/O é a média desde a última leitura
+// - Processos novos: o último PID criado (/proc/loadavg) indica a faixa
+//   de PIDs a sondar; o /proc inteiro só é relistado se a faixa for
+//   grande (ou deu a volta no pid_max) e a cada REFRESH_TICKS ciclos.
+//   Processos que terminam são detectados pela leitura que falha
+// ============================================================
+
+#ifndef PROCESS_TABLE_HPP
+#define PROCESS_TABLE_HPP
+
+#include <string>           // Para std::string
+#include <vector>           // Para std::vector
+#include <unordered_map>    // Para std::unordered_map
+#include <chrono>           // Para std::chrono
+
+// Métrica usada para ordenar o top
+enum class TopMetric {
+    CPU,    // CPU% normalizado pelos núcleos
+    RSS,    // Memória residente
+    IO      // Leitura + escrita em disco (B/s)
+};
+
+// ProcessColumns: resultado de um ciclo, uma linha por processo
+// O mesmo índice em todos os vetores corresponde ao mesmo processo
+struct ProcessColumns {
+    std::vector<int> pid;
+    std::vector<double> cpu_percent;
+    std::vector<long> rss_kb;
+    std::vector<double> io_rate;                // B/s; -1 se /proc/[pid]/io não é legível
+    std::vector<int> threads;
+    std::vector<const std::string*> comm;       // Válido até o próximo sample()
+
+    size_t size() const { return pid.size(); }
+};
+
+class ProcessTable {
+private:
+    // Ciclos entre duas releituras de stat/io de um processo ocioso
+    // (e entre duas listagens completas do /proc)
+    static const unsigned int REFRESH_TICKS = 30;
+
+    // Ciclos ocioso antes de reduzir a frequência de checagem
+    static const unsigned int IDLE_BACKOFF_TICKS = 4;
+
+    // Maior faixa de PIDs novos sondada individualmente
+    static const long MAX_PROBE_RANGE = 256;
+
+    // Estado persistente de um processo entre ciclos
+    struct Tracked {
+        int stat_fd;                        // -1 = reabrir a cada leitura (limite de fds)
+        int sched_fd;                       // -1 = sem schedstat (CPU sai do stat)
+        int io_fd;                          // -1 = sem fd persistente
+        bool io_available;                  // false = io desabilitado ou sem permissão
+        bool cpu_from_stat;                 // Fonte da CPU no ciclo anterior
+        bool has_prev;                      // Primeiro ciclo do processo: taxas zeradas
+        unsigned long long cpu_ns;          // Tempo de CPU acumulado (ns)
+        double cpu_time;                    // Instante da última leitura de CPU (s)
+        unsigned int idle_ticks;            // Checagens seguidas sem uso de CPU
+        bool pinned;                        // Checar no próximo ciclo (linha exibida)
+        unsigned long long io_bytes;        // read_bytes + write_bytes da última leitura
+        double io_time;                     // Instante da última leitura de io (s)
+        long rss_kb;
+        int threads;
+        std::string comm;
+    };
+
+    std::unordered_map<int, Tracked> tracked;
+    ProcessColumns cols;
+    bool with_io;
+    unsigned int generation;
+    double ns_per_tick;
+    long page_kb;
+    unsigned int num_cores;
+    int loadavg_fd;
+    long last_created_pid;
+    std::chrono::steady_clock::time_point start_time;
+    std::chrono::steady_clock::time_point prev_time;
+    double last_elapsed;
+    mutable std::vector<size_t> order;      // Rascunho reutilizado pelo top_k
+
+    bool open_process(int pid, Tracked& t);
+    void close_process(Tracked& t);
+    bool read_stat(int pid, Tracked& t, unsigned long long& cpu_ns);
+    bool sample_process(int pid, Tracked& t, double now_s, double& cpu_pct, double& io_rate);
+    void track_process(int pid);
+    void discover_new_processes();
+    void discover_processes();
+
+public:
+    // with_io=false dispensa /proc/[pid]/io
+    explicit ProcessTable(bool with_io = true);
+    ~ProcessTable();
+
+    ProcessTable(const ProcessTable&) = delete;
+    ProcessTable& operator=(const ProcessTable&) = delete;
+
+    // Executa um ciclo de amostragem sobre todos os PIDs
+    // Retorno: número de processos amostrados
+    size_t sample();
+
+    // Colunas do último ciclo
+    const ProcessColumns& columns() const { return cols; }
+
+    // Tempo real entre os dois últimos ciclos (segundos; 0 no primeiro)
+    double elapsed() const { return last_elapsed; }
+
+    // Garante a checagem no próximo ciclo das linhas indicadas (ex: as exibidas)
+    void pin(const std::vector<size_t>& rows);
+
+    // Índices (em columns()) dos k maiores valores da métrica, em ordem decrescente
+    // nth_element sobre a coluna + ordenação apenas dos k escolhidos
+    std::vector<size_t> top_k(TopMetric metric, size_t k) const;
+};
+
+#endif
@@ -0,0 +1,142 @@
+// ============================================================
+// ARQUIVO: include/process_tree.hpp
+// DESCRIÇÃO: Árvore de processos com CPU, RSS e I/O inclusivos
+// Um driver de build ou um master pré-fork aparece quase sem CPU no top
+// enquanto os filhos fazem o trabalho. Aqui cada processo tem os valores
+// exclusivos (só dele) e inclusivos (ele + toda a subárvore):
+//
+// - A árvore vem do ppid (campo 4 de /proc/[pid]/stat), montada na
+//   mesma passada que lê os contadores. Entre ciclos os nós ficam: só
+//   processos novos, encerrados ou reparentados mudam as ligações
+// - Filhos que terminaram entre dois ciclos (ex: cada compilador de um
+//   make) não são vistos, mas o tempo deles entra no cutime/cstime do
+//   pai quando este faz wait(). A parcela "reaped" de um nó é o
+//   crescimento de cutime+cstime menos o total já contado dos filhos
+//   vistos que sumiram no ciclo (só o trecho final deles, após a última
+//   leitura, fica na parcela)
+// - RSS inclusivo soma o RSS da subárvore (páginas compartilhadas entre
+//   processos contam mais de uma vez); I/O inclusivo soma só os
+//   processos vivos, pois o kernel não acumula o I/O de filhos em /proc
+//
+// Arquivos stat/io ficam abertos entre ciclos (pread, como ProcessTable)
+// ============================================================
+
+#ifndef PROCESS_TREE_HPP
+#define PROCESS_TREE_HPP
+
+#include <string>           // Para std::string
+#include <vector>           // Para std::vector
+#include <unordered_map>    // Para std::unordered_map
+#include <chrono>           // Para std::chrono
+
+// Ordem dos irmãos na listagem
+enum class TreeMetric {
+    CPU,    // CPU% inclusivo
+    RSS,    // RSS inclusivo
+    IO      // I/O inclusivo
+};
+
+// TreeRow: um processo na listagem da árvore (pré-ordem)
+struct TreeRow {
+    int pid;
+    int ppid;
+    int depth;                      // 0 = raiz da listagem
+    const std::string* comm;        // Válido até o próximo sample()
+
+    // CPU% normalizado pelos núcleos (como o top)
+    double cpu_self;                // Só o processo
+    double cpu_reaped;              // Filhos que terminaram e foram aguardados no ciclo
+    double cpu_total;               // self + reaped + subárvore viva
+
+    long rss_self_kb;
+    long rss_total_kb;
+
+    double io_self;                 // B/s; -1 se /proc/[pid]/io não é legível
+    double io_total;                // B/s dos processos legíveis da subárvore
+
+    int descendants;                // Processos vivos abaixo deste
+};
+
+class ProcessTree {
+private:
+    struct Node {
+        int stat_fd = -1;                   // -1 = reabrir a cada leitura (limite de fds)
+        int io_fd = -1;
+        bool io_available = false;
+        bool has_prev = false;              // Primeiro ciclo do nó: taxas zeradas
+        bool linked = false;                // Na lista children do pai (false = raiz)
+        unsigned int generation = 0;        // Último ciclo em que foi lido
+        long long start_time = -1;
+        int ppid = 0;
+        std::string comm;
+        std::vector<int> children;
+
+        // Contadores acumulados (última leitura)
+        unsigned long long cpu_ticks = 0;   // utime + stime
+        unsigned long long child_ticks = 0; // cutime + cstime
+        unsigned long long io_bytes = 0;    // read_bytes + write_bytes
+        long rss_kb = 0;
+
+        // Ciclo atual
+        double self_ticks = 0;              // Δ(utime + stime)
+        double reaped_ticks = 0;            // Δ(cutime + cstime) - filhos já contados
+        double gone_ticks = 0;              // Totais dos filhos que sumiram no ciclo
+        double io_rate = -1;
+
+        // Agregados da subárvore
+        double total_ticks = 0;
+        long rss_total_kb = 0;
+        double io_total = 0;
+        int descendants = 0;
+    };
+
+    std::unordered_map<int, Node> nodes;
+    std::unordered_map<int, unsigned long long> gone;   // Sumiram no último ciclo: último utime+stime
+    bool with_io;
+    unsigned int generation;
+    long ticks_per_sec;
+    long page_kb;
+    unsigned int num_cores;
+    std::chrono::steady_clock::time_point prev_time;
+    double last_elapsed;
+
+    bool read_node(int pid, Node& node, bool fresh);
+    void unlink(int pid, int ppid);
+    void aggregate();
+    double to_percent(double ticks) const;
+
+public:
+    // with_io=false dispensa /proc/[pid]/io
+    explicit ProcessTree(bool with_io = true);
+    ~ProcessTree();
+
+    ProcessTree(const ProcessTree&) = delete;
+    ProcessTree& operator=(const ProcessTree&) = delete;
+
+    // Lista o /proc uma vez, atualiza contadores e ligações e recalcula
+    // os agregados. O primeiro ciclo só estabelece a linha de base
+    // Retorno: número de processos na árvore
+    size_t sample();
+
+    // Tempo real entre os dois últimos ciclos (segundos; 0 no primeiro)
+    double elapsed() const { return last_elapsed; }
+
+    // Processo presente na última amostra
+    bool alive(int pid) const { return nodes.count(pid) > 0; }
+
+    // Processos que sumiram na última amostra e o último utime+stime
+    // lido de cada um (ticks)
+    const std::unordered_map<int, unsigned long long>& exited() const { return gone; }
+
+    // CPU% (normalizado pelos núcleos) dos processos vivos no ciclo: soma
+    // dos deltas próprios, sem a parcela de filhos aguardados
+    double cpu_live() const;
+
+    // Processos em pré-ordem a partir de root (-1 = todas as raízes),
+    // irmãos em ordem decrescente da métrica inclusiva
+    // max_depth: níveis abaixo da raiz (-1 = todos)
+    // Retorno: vazio se root não existe
+    std::vector<TreeRow> rows(int root = -1, int max_depth = -1, TreeMetric order = TreeMetric::CPU) const;
+};
+
+#endif
@@ -0,0 +1,75 @@
+// ============================================================
+// ARQUIVO: include/process_watch.hpp
+// DESCRIÇÃO: Ciclo de vida dos processos monitorados via pidfd
+// Cada alvo é mantido como um pidfd (pidfd_open, Linux >= 5.3)
+// registrado em um epoll: o término chega como evento durante a espera
+// entre amostras, sem stat() em /proc/[pid] a cada ciclo.
+//
+// O pidfd aponta para o processo, não para o número: se o PID for
+// reutilizado, o evento de saída continua sendo do processo original.
+// As leituras de /proc/[pid] são conferidas pelo instante de início
+// (campo 22 de /proc/[pid]/stat, já lido em get_cpu_usage): valor
+// diferente do registrado = outro processo com o mesmo PID.
+//
+// Sem pidfd (kernel antigo ou --root apontando para um snapshot), a
+// espera dorme e confere o instante de início de cada alvo ao acordar
+// ============================================================
+
+#ifndef PROCESS_WATCH_HPP
+#define PROCESS_WATCH_HPP
+
+#include <map>          // Para std::map
+#include <vector>       // Para std::vector
+#include <chrono>       // Para std::chrono
+
+// Instante de início do processo (campo 22 de /proc/[pid]/stat, em ticks
+// desde o boot); identifica o processo junto com o PID
+// Retorno: -1 se o processo não existe ou o arquivo é ilegível
+long long read_process_start_time(int pid);
+
+// ProcessWatcher: conjunto de processos vigiados
+class ProcessWatcher {
+private:
+    struct Target {
+        int fd;                         // pidfd (-1 no modo sem pidfd)
+        long long start_time;
+    };
+
+    int epoll_fd;
+    bool pidfd_supported;
+    std::map<int, Target> targets;
+
+public:
+    ProcessWatcher();
+    ~ProcessWatcher();
+
+    ProcessWatcher(const ProcessWatcher&) = delete;
+    ProcessWatcher& operator=(const ProcessWatcher&) = delete;
+
+    // Passa a vigiar o PID (nada a fazer se já vigiado)
+    // Retorno: false se o processo não existe mais
+    bool watch(int pid);
+
+    // Deixa de vigiar (fecha o pidfd)
+    void unwatch(int pid);
+
+    bool watching(int pid) const { return targets.count(pid) > 0; }
+
+    // Instante de início registrado em watch() (-1 se não vigiado)
+    long long start_time(int pid) const;
+
+    // Confere se uma leitura de /proc/[pid] é do processo vigiado
+    bool same_process(int pid, long long read_start_time) const {
+        return read_start_time >= 0 && read_start_time == start_time(pid);
+    }
+
+    // Espera até 'timeout' por términos; retorna assim que algum alvo
+    // termina (ou um sinal interrompe a espera)
+    // Retorno: PIDs que terminaram (continuam vigiados até unwatch)
+    std::vector<int> wait(std::chrono::milliseconds timeout);
+
+    bool uses_pidfd() const { return pidfd_supported; }
+    size_t size() const { return targets.size(); }
+};
+
+#endif
@@ -0,0 +1,70 @@
+// ============================================================
+// ARQUIVO: include/procfs.hpp
+// DESCRIÇÃO: Raiz configurável de /proc e /sys
+// Todos os coletores, o Namespace Analyzer e o CGroupManager montam
+// seus caminhos por aqui, permitindo ler de um snapshot capturado
+// (scripts/capture_procfs.py) em vez do sistema vivo.
+//
+// Padrões: /proc e /sys, ou as variáveis de ambiente
+// RA3_PROC_ROOT e RA3_SYS_ROOT, se definidas
+// ============================================================
+
+#ifndef PROCFS_HPP
+#define PROCFS_HPP
+
+#include <string>       // Para std::string
+#include <cstddef>      // Para size_t
+#include <sys/types.h>  // Para ssize_t
+
+// Raiz atual do /proc (sem barra final)
+const std::string& proc_root();
+
+// Raiz atual do /sys (sem barra final)
+const std::string& sys_root();
+
+// Redefinem as raízes (chamar antes de iniciar threads de coleta)
+void set_proc_root(const std::string& root);
+void set_sys_root(const std::string& root);
+
+// Aponta /proc e /sys para dentro de um snapshot (<dir>/proc e <dir>/sys)
+void set_fs_root(const std::string& snapshot_dir);
+
+// Caminho dentro do /proc
+// Exemplo: proc_path("net/tcp") -> "/proc/net/tcp"
+std::string proc_path(const std::string& relative);
+
+// Caminho dentro de /proc/[pid]
+// Exemplo: proc_pid_path(1234, "stat") -> "/proc/1234/stat"
+std::string proc_pid_path(int pid, const std::string& relative);
+
+// Caminho dentro do /sys
+std::string sys_path(const std::string& relative);
+
+// Ponto de montagem do cgroupfs (/sys/fs/cgroup)
+std::string cgroup_root();
+
+// Último PID (ou TID) criado no sistema: 5º campo de /proc/loadavg
+// Se não mudou entre dois ciclos, nenhum processo ou thread nasceu
+// loadavg_fd: descritor persistente, aberto na primeira chamada (-1 antes)
+// Retorno: -1 se ilegível
+long read_last_created_pid(int& loadavg_fd);
+
+// Inode de um namespace a partir do link /proc/[pid]/ns/<tipo>
+// Lê o alvo do link ("pid:[4026531836]"), que também existe nos snapshots
+// (links pendurados); stat() só se o alvo não tiver esse formato
+// Retorno: 0 se ilegível
+unsigned long read_ns_inode(const std::string& ns_path);
+
+// Lê um arquivo de /proc/[pid] pelo fd persistente (pread do início),
+// ou abrindo <name> na hora se fd < 0. O conteúdo termina em '\0'
+// Retorno: bytes lidos, ou -1 se o processo terminou
+ssize_t read_proc_file(int fd, int pid, const char* name, char* buf, size_t size);
+
+// read_bytes + write_bytes do conteúdo de /proc/[pid]/io
+unsigned long long parse_io_bytes(const char* buf);
+
+// Eleva o limite flexível de fds (RLIMIT_NOFILE) até o rígido, para os
+// coletores que mantêm arquivos do /proc abertos entre ciclos
+void raise_nofile_limit();
+
+#endif
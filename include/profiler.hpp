@@ -0,0 +1,220 @@
+// ============================================================
+// ARQUIVO: include/profiler.hpp
+// DESCRIÇÃO: Resource Profiler (Componente 1) - laço de monitoramento
+// Monitora processos (por PID ou membros de um cgroup) e cgroups
+// inteiros, gravando CSV. Usado pelo menu interativo, pelos
+// subcomandos da linha de comando e pelo modo daemon
+// ============================================================
+
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include <string>       // Para std::string
+#include <vector>       // Para std::vector
+#include <map>          // Para std::map
+#include <atomic>       // Para std::atomic
+#include <fstream>      // Para std::ofstream
+#include <ostream>      // Para std::ostream
+#include <functional>   // Para std::function
+#include <chrono>       // Para std::chrono
+#include <memory>       // Para std::unique_ptr
+#include "monitor.hpp"
+#include "stream_stats.hpp"
+#include "anomaly.hpp"
+#include "session.hpp"
+#include "cgroup_manager.hpp"
+#include "system_memory.hpp"
+#include "numa.hpp"
+
+class ProcBatch;
+
+// Controle global do monitoramento (permite parada graciosa)
+// SIGINT/SIGTERM colocam em false; todos os laços de coleta verificam
+extern std::atomic<bool> monitoring_active;
+
+// ProcessSample: uma amostra de processo com as taxas já calculadas
+struct ProcessSample {
+    int pid;
+    double cpu_percent;
+    ProcStats stats;
+    double elapsed_sec;     // Tempo real desde a amostra anterior do PID (resolução)
+    bool fresh;             // false = repetida: o PID não estava na vez neste ciclo
+    const TargetStats* summary;     // Agregados do PID (nullptr na baseline); válido durante on_tick
+    const ProcessNuma* numa = nullptr;  // Posicionamento NUMA (numa_interval); válido durante on_tick
+};
+
+// ProfileOptions: parâmetros do monitoramento não interativo
+// (subcomando "profile" e modo --daemon)
+struct ProfileOptions {
+    // PIDs monitorados
+    std::vector<int> pids;
+
+    // Se definido, os membros deste cgroup também são monitorados
+    // (relistados a cada ciclo, acompanhando processos que entram e saem)
+    std::string cgroup;
+
+    // Intervalo entre amostras em milissegundos (inicial, no modo adaptativo)
+    int interval_ms = 1000;
+
+    // Intervalo adaptativo por PID: volta a min_interval_ms quando CPU%,
+    // RSS ou taxa de I/O mudam além dos limiares entre duas amostras e
+    // dobra a cada amostra estável até max_interval_ms
+    bool adaptive = false;
+    int min_interval_ms = 100;
+    int max_interval_ms = 5000;
+    double adapt_cpu = 5.0;         // Variação de CPU% (pontos percentuais)
+    double adapt_rss = 2.0;         // Variação do RSS (% do valor anterior)
+    double adapt_io = 1024.0;       // Variação da taxa de I/O (KB/s)
+
+    // Duração total em segundos (0 = até SIGINT/SIGTERM)
+    int duration_sec = 0;
+
+    // Destino do CSV ("-" = stdout); arquivos são abertos em modo append
+    std::string output = "-";
+
+    // Coleta conexões TCP por processo (custo O(sockets x fds) por PID)
+    bool include_network = false;
+
+    // Suprime o resumo por amostra no console
+    bool quiet = false;
+
+    // Alertas de anomalia em JSON lines ("" = desligado, "-" = stderr)
+    std::string events;
+    AnomalyConfig anomaly;
+
+    // PSS/USS (smaps_rollup): releitura forçada a cada N ciclos; entre elas,
+    // só quando o RSS muda (ver SmapsSchedule). 0 = não coleta
+    int pss_interval = 10;
+
+    // Gravação da sessão (contadores brutos) para replay ("" = desligada)
+    std::string record;
+
+    // CPU% normalizado pelos núcleos que cada processo pode usar (cpuset e
+    // cota de CPU do cgroup, ver process_cpu_capacity) em vez dos do host:
+    // 100% = o processo esgotou o que lhe foi permitido
+    bool cpu_allowed = false;
+
+    // Posicionamento NUMA por PID (numa_maps + CPU de cada thread):
+    // releitura a cada N ciclos, limitada pelo custo medido. Processos com
+    // a memória majoritariamente fora do nó das threads geram um aviso.
+    // 0 = não coleta
+    int numa_interval = 0;
+
+    // Memória do host por ciclo em CSV ("" = desligado): disponível, page
+    // cache, slab e taxas de reclaim/refault/swap, na mesma linha do tempo
+    // do CSV por processo
+    std::string host_output;
+
+    // stat, status e io de todos os PIDs do ciclo lidos em um lote
+    // (io_uring, ou pread com fds persistentes sem io_uring) em vez de
+    // get_cpu_usage/get_memory_usage/get_io_usage por PID. Para milhares
+    // de alvos (ver ProcBatch)
+    bool batch_reads = false;
+
+    // Chamado uma vez por ciclo com a amostra mais recente de cada PID
+    // (ex: exportador de métricas); fresh indica as lidas neste ciclo.
+    // host: memória do host lida no ciclo
+    std::function<void(const std::vector<ProcessSample>&, const HostMemory& host)> on_tick;
+};
+
+// ReplayOptions: parâmetros do replay de uma sessão gravada
+struct ReplayOptions {
+    // Sessão gravada (profile --record ou monitorProcess)
+    std::string input;
+
+    // PIDs reproduzidos (vazio = todos)
+    std::vector<int> pids;
+
+    // Destino do CSV recalculado ("-" = stdout, "" = sem CSV)
+    std::string output = "-";
+
+    // Alertas de anomalia recalculados ("" = desligado, "-" = stderr)
+    std::string events;
+    AnomalyConfig anomaly;
+
+    // Suprime o relatório de agregados por PID
+    bool quiet = false;
+};
+
+// PidSchedule: estado de um PID entre amostras em profileProcesses
+struct PidSchedule {
+    ProcessSample last = {};                            // Última amostra (baseline das taxas)
+    bool has_rates = false;                             // last já tem taxas (não é só baseline)
+    std::chrono::steady_clock::time_point time;         // Instante da última leitura
+    std::chrono::steady_clock::time_point due;          // Prazo da próxima leitura
+    std::chrono::milliseconds interval{1000};           // Intervalo atual do PID
+    SmapsSchedule smaps;                                // Agenda do PSS/USS
+    std::unique_ptr<TargetStats> summary = std::make_unique<TargetStats>();  // Endereço estável entre ciclos
+    std::unique_ptr<AnomalyDetector> detector;          // Criado só com alertas habilitados
+    double cpu_capacity = 0.0;                          // Núcleos permitidos (cpu_allowed; 0 = do host)
+    int capacity_age = 0;                               // Amostras desde a última leitura da capacidade
+    std::unique_ptr<NumaSchedule> numa;                 // Criado só com numa_interval; endereço estável
+};
+
+class ResourceProfiler {
+private:
+    ProcStats prev_stats;  // Estatísticas da iteração anterior para cálculo de taxas
+
+    // Verifica se um processo com o PID especificado existe no sistema
+    bool pidExists(int pid);
+
+    // Verifica se temos permissão para acessar as informações do processo
+    bool canAccessProcess(int pid);
+
+    // Timestamp atual formatado para CSV e console
+    std::string currentTimestamp();
+
+    // Cabeçalho do CSV por processo (compartilhado por monitorProcess e monitorCgroup)
+    void writeProcessCsvHeader(std::ostream& csv);
+
+    // CSV de memória do host (profileProcesses com host_output)
+    void writeHostCsvHeader(std::ostream& csv);
+    void writeHostCsvRow(std::ostream& csv, const std::string& timestamp, const HostMemory& host);
+
+    // Grava uma linha de métricas de processo no CSV
+    // interval_ms: tempo real coberto pelas taxas da linha (resolução)
+    void writeProcessCsvRow(std::ostream& csv, const std::string& timestamp, int pid,
+                            double cpu_pct, const ProcStats& stats, double interval_ms);
+
+    // Converte códigos de erro semânticos em mensagens descritivas
+    std::string getErrorDescription(int error_code);
+
+    // Relatório final dos agregados de um alvo (execução e janelas 1m/5m/15m)
+    // now: fim das janelas (no replay, o instante da última amostra gravada)
+    void printStatsReport(std::ostream& out, const std::string& target, const TargetStats& summary,
+                          std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now());
+
+    // Coleta métricas de cada PID membro do cgroup e grava no CSV de quebra
+    // reader: leitura em lote, sem mensagens de erro por membro
+    void sampleCgroupMembers(CGroupManager& mgr, ProcBatch& reader, const std::string& cgroup_path,
+                             const std::string& timestamp, double elapsed,
+                             std::map<int, ProcStats>& prev_members, std::ofstream& pids_csv);
+
+public:
+    // Valida completamente o acesso a um processo antes de iniciar monitoramento
+    // Lança invalid_argument/runtime_error com a causa
+    bool validateProcessAccess(int pid);
+
+    // Monitora um processo, exibindo resumo no console e gravando CSV
+    // record_session=true também grava <csv>_session.ra3 para replay
+    bool monitorProcess(int pid, int duration_sec, int interval_sec, const std::string& csv_file,
+                        bool record_session = false);
+
+    // Monitora um cgroup inteiro como uma unidade (contadores nativos do cgroup)
+    bool monitorCgroup(const std::string& cgroup_path, int duration_sec, int interval_sec,
+                       const std::string& csv_file, bool per_pid_breakdown);
+
+    // Monitora um conjunto de PIDs sem interação (subcomando profile e daemon)
+    // Retorna quando a duração expira, monitoring_active cai ou
+    // *stop_request é sinalizado (ex: SIGHUP pedindo recarga)
+    // Retorno: false se a saída não pôde ser aberta ou não há o que monitorar
+    bool profileProcesses(const ProfileOptions& opts, const std::atomic<bool>* stop_request = nullptr);
+
+    // Reproduz uma sessão gravada sem esperar o tempo real: refaz CPU%,
+    // taxas, agregados e detecção de anomalias a partir dos contadores
+    // brutos e grava o CSV com o layout de profileProcesses
+    // Retorno: false se a sessão não pôde ser lida ou a saída aberta
+    bool replaySession(const ReplayOptions& opts);
+};
+
+#endif
@@ -0,0 +1,120 @@
+// ============================================================
+// ARQUIVO: include/query.hpp
+// DESCRIÇÃO: Consultas de séries temporais sobre sessões gravadas
+// Responde perguntas como "p99 de CPU do PID X entre 02:00 e 03:00" ou
+// "RSS máximo por cgroup por hora" direto dos arquivos de sessão
+// (include/session.hpp), sem exportar para CSV:
+//
+// - filtro por intervalo de horário e por PID
+// - agrupamento por PID, comm, cgroup ou namespaces
+// - buckets de tempo (downsampling) com avg/min/max/sum/last/count e
+//   quantis (DDSketch, mesclável, erro relativo de 1%)
+//
+// A varredura decodifica os registros do mmap em blocos de colunas
+// (instante, grupo, valor) e agrega cada bloco com laços simples sobre
+// os vetores; os grupos são codificados como inteiros (dicionário), então
+// o laço quente não compara strings nem consulta mapas
+// ============================================================
+
+#ifndef QUERY_HPP
+#define QUERY_HPP
+
+#include <string>       // Para std::string
+#include <vector>       // Para std::vector
+#include <cstdint>      // Para int64_t
+#include <climits>      // Para LLONG_MIN/LLONG_MAX
+
+// Métricas consultáveis (derivadas dos contadores brutos como no replay)
+enum class QueryMetric {
+    CPU_PERCENT,        // CPU% normalizado pelos núcleos da gravação
+    MEMORY_RSS,         // Bytes
+    MEMORY_VSZ,
+    MEMORY_SWAP,
+    MEMORY_PSS,         // Amostras sem PSS/USS coletado são ignoradas
+    MEMORY_USS,
+    IO_RATE,            // Leitura + escrita (B/s)
+    IO_READ_RATE,
+    IO_WRITE_RATE,
+    FAULT_RATE,         // Page faults (minor + major) por segundo
+    CTXT_RATE,          // Trocas de contexto (voluntárias + involuntárias) por segundo
+    THREADS
+};
+
+// Agrupamento das amostras
+enum class QueryGroup {
+    NONE,               // Um único grupo ("*")
+    PID,
+    COMM,
+    CGROUP,
+    NAMESPACES          // Conjunto de namespaces (ou um tipo só, ver ns_index)
+};
+
+// Funções de agregação por bucket e grupo
+enum class QueryAggregate {
+    COUNT,
+    AVG,
+    MIN,
+    MAX,
+    SUM,
+    LAST,               // Amostra mais recente do bucket
+    QUANTILE            // pNN (quantile em [0, 1])
+};
+
+struct QueryAggSpec {
+    QueryAggregate type = QueryAggregate::AVG;
+    double quantile = 0.0;
+};
+
+// QueryOptions: uma consulta
+struct QueryOptions {
+    std::vector<std::string> inputs;    // Sessões (ordem qualquer)
+    QueryMetric metric = QueryMetric::CPU_PERCENT;
+
+    // Intervalo de horário [from, to) em ns desde a época Unix
+    long long from_ns = LLONG_MIN;
+    long long to_ns = LLONG_MAX;
+
+    std::vector<int> pids;              // Vazio = todos
+
+    QueryGroup group = QueryGroup::NONE;
+    int ns_index = -1;                  // NAMESPACES: índice em SESSION_NS_NAMES (-1 = conjunto inteiro)
+
+    // Largura do bucket em ns, alinhado à época Unix (0 = intervalo inteiro)
+    long long bucket_ns = 0;
+
+    std::vector<QueryAggSpec> aggregates = {QueryAggSpec()};
+};
+
+// QueryRow: resultado de um (bucket, grupo)
+struct QueryRow {
+    long long bucket_ns;                // Início do bucket (ns desde a época; primeira amostra se sem bucket)
+    std::string group;
+    uint64_t count;
+    std::vector<double> values;         // Um por agregação, na ordem de QueryOptions::aggregates
+};
+
+// QueryResult: linhas ordenadas por bucket e grupo, mais o custo da varredura
+struct QueryResult {
+    std::vector<QueryRow> rows;
+    uint64_t records = 0;               // Registros lidos
+    uint64_t matched = 0;               // Amostras que entraram na agregação
+    uint64_t bytes = 0;                 // Bytes varridos
+    double elapsed_sec = 0.0;
+    bool truncated = false;             // Alguma sessão terminava com registro incompleto
+};
+
+// Executa a consulta sobre todas as sessões de opts.inputs
+// Retorno: false (mensagem em stderr) se alguma sessão não pôde ser lida
+bool run_query(const QueryOptions& opts, QueryResult& result);
+
+// Nomes aceitos na linha de comando
+// Retorno: false se o nome não é conhecido
+bool query_metric_from_name(const std::string& name, QueryMetric& metric);
+bool query_group_from_name(const std::string& name, QueryGroup& group, int& ns_index);
+bool query_aggregates_from_list(const std::string& list, std::vector<QueryAggSpec>& aggregates);
+
+// Nomes das colunas de saída
+const char* query_metric_name(QueryMetric metric);
+std::string query_aggregate_name(const QueryAggSpec& spec);
+
+#endif
@@ -0,0 +1,212 @@
+// ============================================================
+// ARQUIVO: include/session.hpp
+// DESCRIÇÃO: Gravação e leitura de sessões de monitoramento
+// A sessão guarda os contadores brutos (cumulativos) de cada amostra,
+// com o instante monotônico exato da leitura, em vez das taxas já
+// derivadas: o replay refaz CPU%, taxas de I/O, percentis e detectores
+// com qualquer configuração, mais rápido que o tempo real.
+//
+// Formato (little-endian, alinhado em 8 bytes):
+//   SessionFileHeader                 uma vez, no início do arquivo
+//   { SessionFrame, payload }...      registros só acrescentados ao final
+//
+// Cada registro carrega o tamanho e um checksum (FNV-1a em palavras) do payload:
+// um registro cortado por queda do processo ou da máquina é detectado
+// na leitura (que para no último registro íntegro) e descartado quando
+// o gravador reabre o arquivo. O leitor usa mmap, sem cópia.
+// ============================================================
+
+#ifndef SESSION_HPP
+#define SESSION_HPP
+
+#include <string>       // Para std::string
+#include <vector>       // Para std::vector
+#include <map>          // Para std::map
+#include <chrono>       // Para std::chrono
+#include <cstdint>      // Para uint32_t, int64_t
+#include <cstddef>      // Para size_t
+#include "monitor.hpp"
+
+// Assinatura e versão do formato
+static const char SESSION_MAGIC[8] = {'R', 'A', '3', 'S', 'E', 'S', 'S', '\0'};
+static const uint32_t SESSION_VERSION = 2;     // 2: checksum em palavras de 64 bits
+
+// Tipos de registro
+enum SessionRecordType : uint32_t {
+    SESSION_ANCHOR = 1,     // Âncora de relógio: início de um trecho gravado
+    SESSION_PROCESS = 2,    // Metadados de um processo (comm, cgroup, namespaces)
+    SESSION_SAMPLE = 3      // Contadores brutos de uma amostra
+};
+
+// Cabeçalho do arquivo (16 bytes)
+struct SessionFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+};
+
+// Moldura de cada registro (16 bytes); o payload segue, completado com
+// zeros até múltiplo de 8
+struct SessionFrame {
+    uint32_t type;
+    uint32_t length;        // Bytes do payload (sem o preenchimento)
+    uint32_t checksum;      // FNV-1a (64 bits, 4 faixas) de type, length e payload
+    uint32_t reserved;
+};
+
+// SESSION_ANCHOR: gravado a cada abertura do gravador. Relaciona o
+// relógio monotônico (que recomeça a cada boot) ao horário de parede e
+// guarda os parâmetros da máquina usados nas taxas
+struct SessionAnchor {
+    int64_t mono_ns;        // steady_clock no instante da âncora
+    int64_t wall_ns;        // system_clock no mesmo instante (ns desde a época Unix)
+    int64_t ticks_per_sec;  // sysconf(_SC_CLK_TCK)
+    int64_t page_size;
+    uint32_t num_cores;
+    uint32_t reserved;
+    char boot_id[40];       // /proc/sys/kernel/random/boot_id (relógios de boots diferentes não se comparam)
+};
+
+// Tipos de namespace guardados em SessionProcess (ordem de /proc/[pid]/ns)
+static const size_t SESSION_NS_COUNT = 7;
+static const char* const SESSION_NS_NAMES[SESSION_NS_COUNT] = {
+    "cgroup", "ipc", "mnt", "net", "pid", "user", "uts"
+};
+
+// SESSION_PROCESS: parte fixa; seguem comm_length bytes do comm e
+// cgroup_length bytes do caminho do cgroup
+struct SessionProcess {
+    int32_t pid;
+    uint16_t comm_length;
+    uint16_t cgroup_length;
+    int64_t start_time;                     // Campo 22 de /proc/[pid]/stat (ticks desde o boot)
+    uint64_t ns_inode[SESSION_NS_COUNT];    // 0 = ilegível
+};
+
+// SESSION_SAMPLE: contadores como lidos de /proc (128 bytes)
+struct SessionSample {
+    int64_t mono_ns;                // Instante monotônico da leitura
+    int32_t pid;
+    int32_t threads;
+    int64_t utime;                  // Ticks
+    int64_t stime;
+    int64_t memory_rss;             // KB
+    int64_t memory_vsz;
+    int64_t memory_swap;
+    int64_t memory_pss;             // -1 = não coletado
+    int64_t memory_uss;
+    int64_t io_read_bytes;
+    int64_t io_write_bytes;
+    int64_t minor_faults;
+    int64_t major_faults;
+    int64_t voluntary_ctxt;
+    int64_t nonvoluntary_ctxt;
+    int32_t tcp_connections;
+    int32_t reserved;
+};
+
+static_assert(sizeof(SessionFileHeader) == 16, "layout do cabeçalho da sessão");
+static_assert(sizeof(SessionFrame) == 16, "layout da moldura de registro");
+static_assert(sizeof(SessionSample) == 128, "layout da amostra gravada");
+
+// Conversões entre a amostra gravada e ProcStats
+SessionSample session_sample_from_stats(int pid, const ProcStats& stats, int64_t mono_ns);
+ProcStats session_sample_to_stats(const SessionSample& sample);
+
+// Instante monotônico em ns (mesma origem que steady_clock)
+int64_t session_mono_ns(std::chrono::steady_clock::time_point time);
+
+// SessionRecorder: grava uma sessão em modo append
+// Os registros de um ciclo são acumulados e escritos com um único
+// write() em flush(); fdatasync a cada sync_interval_sec
+class SessionRecorder {
+private:
+    int fd;
+    std::string path;
+    std::vector<unsigned char> buffer;      // Registros ainda não escritos
+    std::map<int, long long> known;         // PID -> instante de início dos metadados já gravados
+    std::chrono::steady_clock::time_point last_sync;
+    uint64_t samples;
+    bool failed;
+
+    void append(uint32_t type, const void* payload, size_t length, const void* extra = nullptr,
+                size_t extra_length = 0);
+    void record_process(int pid, long long start_time);
+
+public:
+    int sync_interval_sec = 5;
+
+    SessionRecorder();
+    ~SessionRecorder();
+
+    SessionRecorder(const SessionRecorder&) = delete;
+    SessionRecorder& operator=(const SessionRecorder&) = delete;
+
+    // Abre (ou cria) o arquivo; se já existe, valida o cabeçalho e corta
+    // um registro incompleto no final. Grava a âncora de relógio
+    // Retorno: false se o arquivo não pôde ser aberto ou não é uma sessão
+    bool open(const std::string& file);
+
+    bool is_open() const { return fd >= 0; }
+
+    // Acrescenta uma amostra lida em 'time' (metadados do processo na
+    // primeira amostra do PID)
+    void record(int pid, const ProcStats& stats, std::chrono::steady_clock::time_point time);
+
+    // Escreve os registros acumulados (uma vez por ciclo de coleta)
+    // Retorno: false em erro de escrita (a gravação é desligada)
+    bool flush();
+
+    // flush + fdatasync + fecha
+    void close();
+
+    uint64_t count() const { return samples; }
+};
+
+// SessionRecord: registro íntegro visto pelo leitor (aponta para o mmap)
+struct SessionRecord {
+    uint32_t type;
+    const unsigned char* data;
+    uint32_t length;
+};
+
+// SessionReader: leitura sequencial de uma sessão mapeada em memória
+class SessionReader {
+private:
+    int fd;
+    const unsigned char* base;
+    size_t size;
+    size_t pos;
+    bool torn;
+
+public:
+    SessionReader();
+    ~SessionReader();
+
+    SessionReader(const SessionReader&) = delete;
+    SessionReader& operator=(const SessionReader&) = delete;
+
+    // Mapeia o arquivo e valida o cabeçalho
+    // Retorno: false (com mensagem em stderr) se não é uma sessão válida
+    bool open(const std::string& file);
+
+    // Próximo registro íntegro; false no fim ou no primeiro registro
+    // cortado ou corrompido (truncated() indica o segundo caso)
+    bool next(SessionRecord& record);
+
+    // Volta ao primeiro registro
+    void rewind();
+
+    // Deslocamento logo após o último registro íntegro lido
+    size_t offset() const { return pos; }
+    size_t file_size() const { return size; }
+    bool truncated() const { return torn; }
+};
+
+// Leitura tipada dos payloads (false se o tamanho não confere)
+bool session_read_anchor(const SessionRecord& record, SessionAnchor& anchor);
+bool session_read_sample(const SessionRecord& record, SessionSample& sample);
+bool session_read_process(const SessionRecord& record, SessionProcess& process, std::string& comm,
+                          std::string& cgroup);
+
+#endif
@@ -0,0 +1,159 @@
+// ============================================================
+// ARQUIVO: include/stream_stats.hpp
+// DESCRIÇÃO: Estatísticas em fluxo com memória constante
+// Agregados por alvo monitorado sem guardar a série bruta:
+//
+// - RunningStats: mínimo, máximo, média e variância (Welford)
+// - QuantileSketch: DDSketch, quantis com erro relativo garantido
+//   (1% por padrão) e mesclável: mesclar dois sketches equivale a
+//   inserir a união das amostras
+// - WindowedSummary: janela deslizante como anel de sub-janelas; a
+//   consulta mescla as sub-janelas ainda dentro da janela
+// - TargetStats: CPU%, memória, taxa de I/O e page faults de um alvo
+//   (processo ou cgroup) na execução inteira e em janelas de 1m/5m/15m
+// ============================================================
+
+#ifndef STREAM_STATS_HPP
+#define STREAM_STATS_HPP
+
+#include <vector>       // Para std::vector
+#include <array>        // Para std::array
+#include <chrono>       // Para std::chrono
+#include <cstdint>      // Para uint64_t
+
+// RunningStats: momentos de uma série em O(1) por amostra
+struct RunningStats {
+    uint64_t count = 0;
+    double mean = 0.0;
+    double m2 = 0.0;        // Soma dos quadrados dos desvios (Welford)
+    double min = 0.0;
+    double max = 0.0;
+
+    void add(double value);
+
+    // Combina duas séries (Chan et al.): equivale a inserir as amostras de other
+    void merge(const RunningStats& other);
+
+    // Variância amostral (0 com menos de 2 amostras)
+    double variance() const;
+    double stddev() const;
+};
+
+// QuantileSketch: DDSketch com buckets logarítmicos densos
+// O bucket i cobre (gamma^(i-1), gamma^i], gamma = (1+a)/(1-a): qualquer
+// quantil é devolvido com erro relativo <= a. Valores <= 0 vão para um
+// bucket de zero. Acima de max_bins buckets, os mais baixos são
+// colapsados (a precisão dos quantis altos, os de SLO, é preservada)
+class QuantileSketch {
+private:
+    double relative_accuracy;
+    double gamma;
+    double log_gamma;
+    size_t max_bins;
+    std::vector<uint64_t> bins;     // bins[k] = contagem do índice offset + k
+    int offset;
+    uint64_t zero_count;
+    uint64_t total;
+
+    int index_of(double value) const;
+    void add_count(int index, uint64_t n);
+
+public:
+    explicit QuantileSketch(double relative_accuracy = 0.01, size_t max_bins = 2048);
+
+    void add(double value);
+
+    // Mescla outro sketch com a mesma precisão
+    void merge(const QuantileSketch& other);
+
+    // Quantil q em [0, 1] (0 se vazio)
+    double quantile(double q) const;
+
+    uint64_t count() const { return total; }
+    void clear();
+};
+
+// MetricSummary: momentos + quantis de uma série
+struct MetricSummary {
+    RunningStats stats;
+    QuantileSketch sketch;
+
+    void add(double value);
+    void merge(const MetricSummary& other);
+    void clear();
+};
+
+// WindowedSummary: resumo dos últimos 'window' segundos
+// A janela é dividida em slot_count sub-janelas; cada amostra entra na
+// sub-janela do seu instante e a consulta mescla as que não expiraram
+// (a janela efetiva oscila entre window - window/slot_count e window)
+class WindowedSummary {
+private:
+    std::chrono::steady_clock::duration slot_length;
+    std::vector<MetricSummary> slots;
+    std::vector<long long> slot_epoch;  // Número da sub-janela guardada em cada posição
+
+    long long epoch_of(std::chrono::steady_clock::time_point now) const;
+
+public:
+    WindowedSummary(std::chrono::seconds window, size_t slot_count);
+
+    void add(double value, std::chrono::steady_clock::time_point now);
+
+    // Mescla das sub-janelas vivas em 'now'
+    MetricSummary summary(std::chrono::steady_clock::time_point now) const;
+};
+
+// Métricas agregadas por alvo
+enum class StatMetric {
+    CPU_PERCENT,    // CPU% normalizado
+    MEMORY_BYTES,   // RSS (processo) ou memory.current (cgroup)
+    IO_RATE,        // Leitura + escrita (B/s)
+    FAULT_RATE      // Page faults (minor + major) por segundo
+};
+
+// Janelas disponíveis
+enum class StatWindow {
+    RUN,            // Execução inteira
+    MIN_1,
+    MIN_5,
+    MIN_15
+};
+
+static const size_t STAT_METRIC_COUNT = 4;
+static const size_t STAT_WINDOW_COUNT = 4;
+
+// Nomes usados no relatório e nos labels de métricas
+const char* stat_metric_name(StatMetric metric);
+const char* stat_window_name(StatWindow window);
+
+// TargetStats: agregados de um alvo monitorado
+// Memória constante por alvo: não cresce com a duração da coleta
+class TargetStats {
+private:
+    struct Series {
+        MetricSummary run;
+        WindowedSummary last_1m;
+        WindowedSummary last_5m;
+        WindowedSummary last_15m;
+
+        Series();
+        void add(double value, std::chrono::steady_clock::time_point now);
+    };
+
+    std::array<Series, STAT_METRIC_COUNT> series;
+
+public:
+    // Uma amostra do alvo; fault_rate < 0 = indisponível (ex: cgroup)
+    void add(double cpu_percent, double memory_bytes, double io_rate, double fault_rate,
+             std::chrono::steady_clock::time_point now);
+
+    // Resumo de uma métrica em uma janela
+    MetricSummary summary(StatMetric metric, StatWindow window,
+                          std::chrono::steady_clock::time_point now) const;
+
+    // Amostras recebidas na execução
+    uint64_t count() const { return series[0].run.stats.count; }
+};
+
+#endif
@@ -0,0 +1,92 @@
+// ============================================================
+// ARQUIVO: include/system_memory.hpp
+// DESCRIÇÃO: Memória do host (/proc/meminfo e /proc/vmstat)
+// Uma leitura por ciclo, compartilhada por todos os alvos: o MemTotal
+// usado no memory_percent de cada PID sai deste snapshot, em vez de um
+// parse de /proc/meminfo por PID. Além do tamanho da memória disponível,
+// do page cache e do slab, traz as taxas de reclaim (scan, steal,
+// direct reclaim), refault e swap do intervalo, para correlacionar a
+// pressão de memória do host com o crescimento do RSS de cada processo
+// ============================================================
+
+#ifndef SYSTEM_MEMORY_HPP
+#define SYSTEM_MEMORY_HPP
+
+#include <vector>       // Para std::vector
+#include <chrono>       // Para std::chrono
+
+// HostMemory: snapshot de um ciclo
+struct HostMemory {
+    // /proc/meminfo (KB)
+    long long total_kb = 0;
+    long long free_kb = 0;
+    long long available_kb = 0;         // Estimativa do kernel (inclui cache recuperável)
+    long long buffers_kb = 0;
+    long long cached_kb = 0;
+    long long slab_kb = 0;
+    long long slab_reclaimable_kb = 0;
+    long long slab_unreclaimable_kb = 0;
+    long long dirty_kb = 0;
+    long long swap_total_kb = 0;
+    long long swap_free_kb = 0;
+
+    // /proc/vmstat (páginas, cumulativos desde o boot)
+    // Somas de kswapd + direct (+ khugepaged); refaults de anon + file
+    unsigned long long pgscan = 0;          // Páginas examinadas pelo reclaim
+    unsigned long long pgsteal = 0;         // Páginas efetivamente recuperadas
+    unsigned long long allocstall = 0;      // Entradas em direct reclaim
+    unsigned long long refaults = 0;        // Páginas despejadas e lidas de volta
+    unsigned long long pswpin = 0;
+    unsigned long long pswpout = 0;
+    unsigned long long pgmajfault = 0;
+
+    // Taxas por segundo desde o ciclo anterior (0 na linha de base)
+    double scan_rate = 0.0;
+    double steal_rate = 0.0;
+    double direct_reclaim_rate = 0.0;
+    double refault_rate = 0.0;
+    double swapin_rate = 0.0;
+    double swapout_rate = 0.0;
+    double major_fault_rate = 0.0;
+    bool has_rates = false;
+
+    long long page_cache_kb() const { return cached_kb + buffers_kb; }
+    long long swap_used_kb() const { return swap_total_kb - swap_free_kb; }
+
+    // Eficiência do reclaim no intervalo: páginas recuperadas por página
+    // examinada (%); baixa = o kernel varre muito para liberar pouco
+    // Retorno: -1 sem varredura no intervalo
+    double reclaim_efficiency() const { return scan_rate > 0 ? steal_rate * 100.0 / scan_rate : -1.0; }
+};
+
+class SystemMemoryStat {
+private:
+    int meminfo_fd;
+    int vmstat_fd;
+    std::vector<char> buffer;                   // Conteúdo do arquivo lido (cresce se preciso)
+    HostMemory snapshot;
+    std::chrono::steady_clock::time_point time; // Instante da leitura anterior do vmstat
+    bool has_prev;
+
+    bool read_file(int& fd, const char* name);
+    bool parse_meminfo(HostMemory& out);
+    bool parse_vmstat(HostMemory& out);
+
+public:
+    SystemMemoryStat();
+    ~SystemMemoryStat();
+
+    SystemMemoryStat(const SystemMemoryStat&) = delete;
+    SystemMemoryStat& operator=(const SystemMemoryStat&) = delete;
+
+    // Relê /proc/meminfo e /proc/vmstat (pread em fds persistentes) e
+    // calcula as taxas desde a leitura anterior
+    // Sem /proc/vmstat legível, as taxas ficam em zero
+    // Retorno: false se /proc/meminfo é ilegível
+    bool sample();
+
+    // Snapshot do último sample() com sucesso
+    const HostMemory& current() const { return snapshot; }
+};
+
+#endif
@@ -0,0 +1,107 @@
+// ============================================================
+// ARQUIVO: include/thread_table.hpp
+// DESCRIÇÃO: Amostragem por thread (TID) de um processo
+// get_cpu_usage soma a CPU de todas as threads do TGID; aqui cada
+// thread de /proc/[pid]/task/[tid] é medida separadamente:
+//
+// - CPU% (de um núcleo: uma thread só ocupa um núcleo por vez)
+// - Espera na runqueue (schedstat): % do tempo pronta sem CPU e
+//   latência média por fatia de execução
+// - Fatias de execução/s e trocas de contexto voluntárias (bloqueio)
+//   e involuntárias (preempção) por segundo
+//
+// Escala para milhares de threads: stat e schedstat ficam abertos
+// entre ciclos (pread); status (trocas de contexto) só é relido para
+// threads que rodaram; o diretório task só é relistado quando o
+// último TID criado no sistema muda
+// ============================================================
+
+#ifndef THREAD_TABLE_HPP
+#define THREAD_TABLE_HPP
+
+#include <string>           // Para std::string
+#include <vector>           // Para std::vector
+#include <unordered_map>    // Para std::unordered_map
+#include <chrono>           // Para std::chrono
+
+// Métrica usada para ordenar as threads
+enum class ThreadMetric {
+    CPU,        // CPU% da thread
+    WAIT,       // % do tempo esperando na runqueue
+    SWITCHES    // Trocas de contexto por segundo
+};
+
+// ThreadColumns: resultado de um ciclo, uma linha por thread
+struct ThreadColumns {
+    std::vector<int> tid;
+    std::vector<char> state;                    // R, S, D, ...
+    std::vector<double> cpu_percent;            // % de um núcleo
+    std::vector<double> wait_percent;           // % do intervalo pronta na runqueue
+    std::vector<double> avg_wait_us;            // Espera média por fatia (µs)
+    std::vector<double> slices_rate;            // Fatias de execução por segundo
+    std::vector<double> voluntary_rate;         // Trocas voluntárias por segundo
+    std::vector<double> nonvoluntary_rate;      // Trocas involuntárias por segundo
+    std::vector<const std::string*> name;       // Válido até o próximo sample()
+
+    size_t size() const { return tid.size(); }
+};
+
+class ThreadTable {
+private:
+    // Estado persistente de uma thread entre ciclos
+    struct Tracked {
+        int stat_fd;
+        int sched_fd;                       // -1 = sem schedstat (CPU pelo stat, sem espera)
+        int status_fd;
+        bool has_prev;
+        unsigned long long run_ns;          // Tempo em CPU acumulado
+        unsigned long long wait_ns;         // Tempo na runqueue acumulado
+        unsigned long long slices;          // Fatias de execução acumuladas
+        long voluntary;                     // voluntary_ctxt_switches
+        long nonvoluntary;                  // nonvoluntary_ctxt_switches
+        char state;
+        std::string name;
+    };
+
+    int pid;
+    std::unordered_map<int, Tracked> tracked;
+    ThreadColumns cols;
+    unsigned int generation;
+    double ns_per_tick;
+    int loadavg_fd;
+    long last_created_tid;
+    bool alive;
+    std::chrono::steady_clock::time_point prev_time;
+    double last_elapsed;
+    mutable std::vector<size_t> order;
+    std::vector<char> status_buffer;        // status cresce com as máscaras de CPUs e nós
+
+    bool open_thread(int tid, Tracked& t);
+    bool read_status(int fd);
+    void close_thread(Tracked& t);
+    void discover_threads();
+
+public:
+    explicit ThreadTable(int pid);
+    ~ThreadTable();
+
+    ThreadTable(const ThreadTable&) = delete;
+    ThreadTable& operator=(const ThreadTable&) = delete;
+
+    // Executa um ciclo sobre todas as threads do processo
+    // Retorno: número de threads amostradas (0 se o processo terminou)
+    size_t sample();
+
+    const ThreadColumns& columns() const { return cols; }
+
+    // Tempo real entre os dois últimos ciclos (segundos; 0 no primeiro)
+    double elapsed() const { return last_elapsed; }
+
+    // False depois que o processo termina
+    bool process_alive() const { return alive; }
+
+    // Índices (em columns()) das k threads com maior valor, em ordem decrescente
+    std::vector<size_t> top_k(ThreadMetric metric, size_t k) const;
+};
+
+#endif
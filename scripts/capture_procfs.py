@@ -0,0 +1,224 @@
+#!/usr/bin/env python3
+# ============================================================
+# ARQUIVO: scripts/capture_procfs.py
+# DESCRIÇÃO: Captura um snapshot de /proc e do cgroupfs
+# Copia os arquivos lidos pelos coletores (Componentes 1, 2 e 3) para
+# um diretório, preservando a estrutura, para que os benchmarks rodem
+# contra a escala de um host de produção em qualquer máquina:
+#
+#   <destino>/proc/[pid]/{stat,status,io,...}
+#   <destino>/proc/[pid]/exe    -> link simbólico para o executável
+#   <destino>/proc/[pid]/ns/*   -> links simbólicos "tipo:[inode]"
+#   <destino>/proc/[pid]/fd/*   -> links simbólicos "socket:[inode]", ...
+#   <destino>/proc/net/*, meminfo, stat, vmstat, diskstats, ...
+#   <destino>/sys/fs/cgroup/... -> arquivos de interface do cgroupfs
+#   <destino>/sys/devices/system/node/node*/{cpulist,meminfo,numastat,distance}
+#
+# USO:
+#   sudo python3 scripts/capture_procfs.py /tmp/snap [--no-tasks] [--no-cgroup]
+#   ./bin/bench_collectors --root /tmp/snap --pid 1234
+#   RA3_PROC_ROOT=/tmp/snap/proc RA3_SYS_ROOT=/tmp/snap/sys ./bin/resource-monitor
+#
+# Links simbólicos (exe, ns/ e fd/) são recriados com o mesmo alvo, mesmo
+# que "pendurados" (ex: "pid:[4026531836]", que não existe), exatamente
+# como readlink() os vê no /proc
+# ============================================================
+
+import os
+import sys
+import argparse
+
+# Arquivos globais do /proc
+PROC_GLOBAL_FILES = [
+    "meminfo", "stat", "vmstat", "diskstats", "loadavg", "uptime", "cpuinfo",
+    "pressure/cpu", "pressure/memory", "pressure/io",
+    "net/dev", "net/tcp", "net/tcp6", "net/udp", "net/udp6", "net/unix",
+    "net/snmp", "net/netstat",
+    "sys/kernel/pid_max",
+]
+
+# Arquivos por processo (/proc/[pid]/...)
+PROC_PID_FILES = [
+    "stat", "statm", "status", "io", "comm", "cmdline", "cgroup",
+    "schedstat", "smaps_rollup", "net/dev", "numa_maps",
+]
+
+# Links simbólicos por processo (/proc/[pid]/...) lidos com readlink
+PROC_PID_LINKS = ["exe"]
+
+# Arquivos por thread (/proc/[pid]/task/[tid]/...)
+PROC_TASK_FILES = ["stat", "status", "schedstat", "comm"]
+
+# Arquivos do /sys fora do cgroupfs
+SYS_GLOBAL_FILES = [
+    "devices/system/cpu/online",
+    "devices/system/cpu/possible",
+    "devices/system/node/online",
+]
+
+# Arquivos de cada nó NUMA (/sys/devices/system/node/node[N]/...)
+SYS_NODE_FILES = ["cpulist", "meminfo", "numastat", "distance"]
+
+
+def copy_file(src, dst):
+    # Copia o conteúdo de um pseudo-arquivo; retorna False se ilegível
+    # (processo terminou, sem permissão, arquivo somente escrita)
+    try:
+        with open(src, "rb") as f:
+            data = f.read()
+    except OSError:
+        return False
+    os.makedirs(os.path.dirname(dst), exist_ok=True)
+    with open(dst, "wb") as f:
+        f.write(data)
+    return True
+
+
+def copy_link(src, dst):
+    # Recria um link simbólico com o mesmo alvo; retorna False se ilegível
+    # (processo terminou, exe de thread de kernel, sem permissão)
+    try:
+        target = os.readlink(src)
+    except OSError:
+        return False
+    if os.path.lexists(dst):
+        return False
+    os.makedirs(os.path.dirname(dst), exist_ok=True)
+    os.symlink(target, dst)
+    return True
+
+
+def copy_links(src_dir, dst_dir):
+    # Recria os links simbólicos de um diretório (ns/ ou fd/)
+    try:
+        names = os.listdir(src_dir)
+    except OSError:
+        return 0
+    os.makedirs(dst_dir, exist_ok=True)
+    count = 0
+    for name in names:
+        if copy_link(os.path.join(src_dir, name), os.path.join(dst_dir, name)):
+            count += 1
+    return count
+
+
+def capture_proc(proc, dest, with_tasks):
+    pids = 0
+    tasks = 0
+    fds = 0
+
+    for rel in PROC_GLOBAL_FILES:
+        copy_file(os.path.join(proc, rel), os.path.join(dest, rel))
+
+    for entry in os.listdir(proc):
+        if not entry.isdigit():
+            continue
+        src_pid = os.path.join(proc, entry)
+        dst_pid = os.path.join(dest, entry)
+
+        # stat é obrigatório: sem ele o processo já terminou
+        if not copy_file(os.path.join(src_pid, "stat"), os.path.join(dst_pid, "stat")):
+            continue
+        pids += 1
+
+        for rel in PROC_PID_FILES:
+            if rel == "stat":
+                continue
+            copy_file(os.path.join(src_pid, rel), os.path.join(dst_pid, rel))
+
+        for rel in PROC_PID_LINKS:
+            copy_link(os.path.join(src_pid, rel), os.path.join(dst_pid, rel))
+        copy_links(os.path.join(src_pid, "ns"), os.path.join(dst_pid, "ns"))
+        fds += copy_links(os.path.join(src_pid, "fd"), os.path.join(dst_pid, "fd"))
+
+        if with_tasks:
+            try:
+                tids = os.listdir(os.path.join(src_pid, "task"))
+            except OSError:
+                tids = []
+            for tid in tids:
+                src_task = os.path.join(src_pid, "task", tid)
+                dst_task = os.path.join(dst_pid, "task", tid)
+                for rel in PROC_TASK_FILES:
+                    copy_file(os.path.join(src_task, rel), os.path.join(dst_task, rel))
+                tasks += 1
+
+    return pids, tasks, fds
+
+
+def capture_numa_nodes(node_dir, dest):
+    # Copia os arquivos de cada nó NUMA (visão numa e profile --numa-interval)
+    try:
+        entries = os.listdir(node_dir)
+    except OSError:
+        return 0
+    nodes = 0
+    for entry in entries:
+        if not (entry.startswith("node") and entry[4:].isdigit()):
+            continue
+        for rel in SYS_NODE_FILES:
+            copy_file(os.path.join(node_dir, entry, rel), os.path.join(dest, entry, rel))
+        nodes += 1
+    return nodes
+
+
+def capture_cgroupfs(cgroup, dest):
+    # Copia todos os arquivos legíveis da hierarquia (v1 ou v2)
+    files = 0
+    for root, dirs, names in os.walk(cgroup, followlinks=False):
+        rel_root = os.path.relpath(root, cgroup)
+        for name in names:
+            src = os.path.join(root, name)
+            if copy_file(src, os.path.join(dest, rel_root, name)):
+                files += 1
+        # Hierarquias v1 montadas em diretórios separados (cpu, memory, ...)
+        for d in dirs:
+            link = os.path.join(root, d)
+            if os.path.islink(link):
+                os.makedirs(os.path.join(dest, rel_root), exist_ok=True)
+                dst_link = os.path.join(dest, rel_root, d)
+                if not os.path.lexists(dst_link):
+                    os.symlink(os.readlink(link), dst_link)
+    return files
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Captura snapshot de /proc e do cgroupfs")
+    parser.add_argument("destino", help="diretório do snapshot (criado se não existir)")
+    parser.add_argument("--proc", default="/proc", help="raiz do /proc a capturar")
+    parser.add_argument("--sys", default="/sys", help="raiz do /sys a capturar")
+    parser.add_argument("--no-tasks", action="store_true", help="não captura /proc/[pid]/task")
+    parser.add_argument("--no-cgroup", action="store_true", help="não captura /sys/fs/cgroup")
+    args = parser.parse_args()
+
+    dest_proc = os.path.join(args.destino, "proc")
+    dest_sys = os.path.join(args.destino, "sys")
+    os.makedirs(dest_proc, exist_ok=True)
+    os.makedirs(dest_sys, exist_ok=True)
+
+    if os.geteuid() != 0:
+        print("AVISO: sem root, fd/ e io de processos de outros usuários não serão capturados")
+
+    print(f"Capturando {args.proc} ...")
+    pids, tasks, fds = capture_proc(args.proc, dest_proc, not args.no_tasks)
+    print(f"  {pids} processos, {tasks} threads, {fds} descritores")
+
+    for rel in SYS_GLOBAL_FILES:
+        copy_file(os.path.join(args.sys, rel), os.path.join(dest_sys, rel))
+
+    node_rel = os.path.join("devices", "system", "node")
+    nodes = capture_numa_nodes(os.path.join(args.sys, node_rel), os.path.join(dest_sys, node_rel))
+    print(f"  {nodes} nós NUMA")
+
+    if not args.no_cgroup:
+        cgroup = os.path.join(args.sys, "fs", "cgroup")
+        print(f"Capturando {cgroup} ...")
+        files = capture_cgroupfs(cgroup, os.path.join(dest_sys, "fs", "cgroup"))
+        print(f"  {files} arquivos")
+
+    print(f"Snapshot salvo em: {args.destino}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,430 @@
+// ============================================================
+// ARQUIVO: src/anomaly.cpp
+// DESCRIÇÃO: Implementação dos detectores de anomalia (EWMA z-score,
+// CUSUM e regressão do RSS) e do fluxo de eventos JSON lines
+// ============================================================
+
+#include "../include/anomaly.hpp"
+#include "../include/cgroup_manager.hpp"
+#include "../include/procfs.hpp"
+#include "../include/process_meta.hpp"
+#include <iostream>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <chrono>
+#include <limits>
+#include <algorithm>
+
+// Pisos do desvio padrão por métrica: abaixo disso a variação é ruído
+// (processo ocioso tem desvio ~0 e qualquer tick viraria um z enorme)
+static const double MIN_STD_CPU = 2.0;                  // Pontos percentuais
+static const double MIN_STD_RSS = 1024.0 * 1024.0;      // 1 MB
+static const double MIN_STD_IO = 64.0 * 1024.0;         // 64 KB/s
+
+// ================================
+// EWMA Z-SCORE
+// ================================
+
+EwmaDetector::EwmaDetector(double ewma_alpha, double z_threshold, double std_floor, int warmup_samples)
+    : alpha(ewma_alpha), threshold(z_threshold), min_std(std_floor), warmup(warmup_samples),
+      count(0), mean(0.0), variance(0.0), firing(false) {}
+
+bool EwmaDetector::update(double value, double& z) {
+    z = 0.0;
+    if (count == 0) {
+        mean = value;
+        count = 1;
+        return false;
+    }
+
+    // Escore contra o estado anterior; depois a amostra entra na média
+    double diff = value - mean;
+    z = diff / std::max(std::sqrt(variance), min_std);
+    double increment = alpha * diff;
+    mean += increment;
+    variance = (1.0 - alpha) * (variance + diff * increment);
+    count++;
+
+    if (count <= static_cast<uint64_t>(warmup)) {
+        return false;
+    }
+    if (!firing && std::fabs(z) >= threshold) {
+        firing = true;
+        return true;
+    }
+    if (firing && std::fabs(z) < threshold / 2.0) {
+        firing = false;
+    }
+    return false;
+}
+
+// ================================
+// CUSUM
+// ================================
+
+CusumDetector::CusumDetector(double slack, double limit, double std_floor, int warmup_samples)
+    : k(slack), h(limit), min_std(std_floor), warmup(std::max(warmup_samples, 2)),
+      count(0), base_mean(0.0), base_m2(0.0), sum_high(0.0), sum_low(0.0) {}
+
+bool CusumDetector::update(double value, double& score, bool& up, double& reference) {
+    score = 0.0;
+    up = false;
+    reference = base_mean;
+
+    // Linha de base: Welford sobre as primeiras amostras
+    if (count < static_cast<uint64_t>(warmup)) {
+        count++;
+        double delta = value - base_mean;
+        base_mean += delta / count;
+        base_m2 += delta * (value - base_mean);
+        return false;
+    }
+    count++;
+
+    double sigma = std::max(std::sqrt(base_m2 / (warmup - 1)), min_std);
+    double deviation = (value - base_mean) / sigma;
+    sum_high = std::max(0.0, sum_high + deviation - k);
+    sum_low = std::max(0.0, sum_low - deviation - k);
+    score = std::max(sum_high, sum_low);
+    if (score < h) {
+        return false;
+    }
+
+    up = sum_high >= sum_low;
+    reference = base_mean;
+
+    // Nível novo vira a referência
+    count = 0;
+    base_mean = 0.0;
+    base_m2 = 0.0;
+    sum_high = 0.0;
+    sum_low = 0.0;
+    return true;
+}
+
+// ================================
+// REGRESSÃO DO RSS (VAZAMENTO)
+// ================================
+
+LeakDetector::LeakDetector(const AnomalyConfig& config)
+    : half_life(config.leak_half_life_sec), min_slope(config.leak_min_slope), min_r2(config.leak_min_r2),
+      min_span(config.leak_min_span_sec), repeat(config.leak_repeat_sec),
+      has_origin(false), origin(0.0), origin_value(0.0), last_t(0.0),
+      last_alert(-std::numeric_limits<double>::infinity()),
+      w(0.0), st(0.0), sx(0.0), stt(0.0), stx(0.0), sxx(0.0) {}
+
+bool LeakDetector::update(double t_sec, double value, double& slope, double& r2) {
+    slope = 0.0;
+    r2 = 0.0;
+    if (!has_origin) {
+        has_origin = true;
+        origin = t_sec;
+        origin_value = value;
+        last_t = t_sec;
+    }
+
+    // Tempo e valor relativos à primeira amostra (evita cancelamento
+    // numérico com RSS na casa dos GB)
+    double t = t_sec - origin;
+    double x = value - origin_value;
+
+    // Decaimento dos pesos pelo tempo desde a amostra anterior
+    double decay = std::exp(-M_LN2 * (t_sec - last_t) / half_life);
+    w *= decay;
+    st *= decay;
+    sx *= decay;
+    stt *= decay;
+    stx *= decay;
+    sxx *= decay;
+    w += 1.0;
+    st += t;
+    sx += x;
+    stt += t * t;
+    stx += t * x;
+    sxx += x * x;
+    last_t = t_sec;
+
+    double var_t = w * stt - st * st;
+    double var_x = w * sxx - sx * sx;
+    if (var_t <= 0.0) {
+        return false;
+    }
+    double cov = w * stx - st * sx;
+    slope = cov / var_t;
+    r2 = var_x > 0.0 ? (cov * cov) / (var_t * var_x) : 0.0;
+
+    if (t < min_span || slope < min_slope || r2 < min_r2) {
+        return false;
+    }
+    if (t_sec - last_alert < repeat) {
+        return false;
+    }
+    last_alert = t_sec;
+    return true;
+}
+
+// ================================
+// CONJUNTO POR PROCESSO
+// ================================
+
+AnomalyDetector::AnomalyDetector(const AnomalyConfig& cfg)
+    : config(cfg),
+      cpu_z(cfg.ewma_alpha, cfg.z_threshold, MIN_STD_CPU, cfg.warmup),
+      rss_z(cfg.ewma_alpha, cfg.z_threshold, MIN_STD_RSS, cfg.warmup),
+      io_z(cfg.ewma_alpha, cfg.z_threshold, MIN_STD_IO, cfg.warmup),
+      cpu_shift(cfg.cusum_k, cfg.cusum_h, MIN_STD_CPU, cfg.warmup),
+      rss_shift(cfg.cusum_k, cfg.cusum_h, MIN_STD_RSS, cfg.warmup),
+      io_shift(cfg.cusum_k, cfg.cusum_h, MIN_STD_IO, cfg.warmup),
+      leak(cfg) {}
+
+int AnomalyDetector::update(int pid, double t_sec, double cpu_percent, double rss_bytes, double io_rate,
+                            AnomalyEvents& events, const AnomalyOrigin* origin) {
+    struct Series {
+        const char* metric;
+        double value;
+        EwmaDetector& spike;
+        CusumDetector& shift;
+    } series[] = {
+        {"cpu_percent", cpu_percent, cpu_z, cpu_shift},
+        {"memory_bytes", rss_bytes, rss_z, rss_shift},
+        {"io_bytes_per_second", io_rate, io_z, io_shift},
+    };
+
+    int alerts = 0;
+    for (auto& s : series) {
+        double baseline = s.spike.baseline();
+        double z;
+        if (s.spike.update(s.value, z)) {
+            AnomalyEvent event;
+            event.pid = pid;
+            event.detector = "ewma_zscore";
+            event.metric = s.metric;
+            event.value = s.value;
+            event.baseline = baseline;
+            event.score = z;
+            event.threshold = config.z_threshold;
+            event.direction = z > 0 ? "up" : "down";
+            if (origin) {
+                event.comm = origin->comm;
+                event.wall_time = origin->wall_time;
+            }
+            events.emit(event);
+            alerts++;
+        }
+
+        double score, reference;
+        bool up;
+        if (s.shift.update(s.value, score, up, reference)) {
+            AnomalyEvent event;
+            event.pid = pid;
+            event.detector = "cusum";
+            event.metric = s.metric;
+            event.value = s.value;
+            event.baseline = reference;
+            event.score = score;
+            event.threshold = config.cusum_h;
+            event.direction = up ? "up" : "down";
+            if (origin) {
+                event.comm = origin->comm;
+                event.wall_time = origin->wall_time;
+            }
+            events.emit(event);
+            alerts++;
+        }
+    }
+
+    double slope, r2;
+    if (leak.update(t_sec, rss_bytes, slope, r2)) {
+        AnomalyEvent event;
+        event.pid = pid;
+        event.detector = "rss_slope";
+        event.metric = "memory_bytes";
+        event.value = rss_bytes;
+        event.score = r2;
+        event.threshold = config.leak_min_r2;
+        event.direction = "up";
+        event.slope = slope;
+        // Limite só é consultado quando há alerta (raro), e nunca no replay
+        if (origin) {
+            event.comm = origin->comm;
+            event.wall_time = origin->wall_time;
+        } else if (memory_headroom(pid, event.headroom_bytes, event.limit_bytes, event.limit_source) &&
+                   event.headroom_bytes >= 0) {
+            event.time_to_oom_sec = event.headroom_bytes / slope;
+        }
+        events.emit(event);
+        alerts++;
+    }
+    return alerts;
+}
+
+// ================================
+// LIMITE DE MEMÓRIA
+// ================================
+
+bool memory_headroom(int pid, long long& headroom_bytes, long long& limit_bytes, std::string& source) {
+    headroom_bytes = -1;
+    limit_bytes = -1;
+    source.clear();
+
+    // Limite efetivo: o de menor folga entre o cgroup e seus ancestrais
+    CGroupManager mgr;
+    std::string path = CGroupManager::get_current_cgroup(pid);
+    while (!path.empty() && path[0] == '/') {
+        long long limit = mgr.read_memory_limit(path);
+        if (limit >= 0) {
+            CGroupStats stats = mgr.read_cgroup_stats(path);
+            long long headroom = std::max(0LL, limit - static_cast<long long>(stats.memory_current));
+            if (headroom_bytes < 0 || headroom < headroom_bytes) {
+                headroom_bytes = headroom;
+                limit_bytes = limit;
+                source = "cgroup:" + path;
+            }
+        }
+        if (path == "/") break;
+        size_t slash = path.rfind('/');
+        path = (slash == 0) ? "/" : path.substr(0, slash);
+    }
+    if (headroom_bytes >= 0) {
+        return true;
+    }
+
+    // Sem limite de cgroup: memória disponível do sistema
+    FILE* meminfo = fopen(proc_path("meminfo").c_str(), "r");
+    if (!meminfo) {
+        return false;
+    }
+    char line[256];
+    long long total_kb = -1, available_kb = -1;
+    while (fgets(line, sizeof(line), meminfo)) {
+        sscanf(line, "MemTotal: %lld kB", &total_kb);
+        sscanf(line, "MemAvailable: %lld kB", &available_kb);
+    }
+    fclose(meminfo);
+    if (available_kb < 0) {
+        return false;
+    }
+    headroom_bytes = available_kb * 1024;
+    limit_bytes = total_kb >= 0 ? total_kb * 1024 : -1;
+    source = "meminfo";
+    return true;
+}
+
+// ================================
+// FLUXO DE EVENTOS
+// ================================
+
+AnomalyEvents::AnomalyEvents() : out(nullptr), emitted(0) {}
+
+bool AnomalyEvents::open(const std::string& target) {
+    if (target == "-") {
+        out = &std::cerr;
+        return true;
+    }
+    file.open(target, std::ios::app);
+    if (!file.is_open()) {
+        out = nullptr;
+        return false;
+    }
+    out = &file;
+    return true;
+}
+
+void AnomalyEvents::open_on_first_event(const std::string& target) {
+    out = nullptr;
+    deferred = target;
+}
+
+// Escapa uma string para JSON (aspas, barra invertida e controles)
+static void append_json_string(std::string& line, const std::string& value) {
+    line += '"';
+    for (unsigned char c : value) {
+        if (c == '"' || c == '\\') {
+            line += '\\';
+            line += static_cast<char>(c);
+        } else if (c < 0x20) {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            line += escaped;
+        } else {
+            line += static_cast<char>(c);
+        }
+    }
+    line += '"';
+}
+
+static void append_json_number(std::string& line, const char* key, double value) {
+    char number[64];
+    snprintf(number, sizeof(number), ",\"%s\":%.15g", key, value);
+    line += number;
+}
+
+void AnomalyEvents::emit(const AnomalyEvent& event) {
+    if (!out && !deferred.empty()) {
+        std::string target;
+        target.swap(deferred);
+        if (!open(target)) {
+            std::cerr << "Aviso: não foi possível criar " << target << "; detecção de anomalias desligada" << std::endl;
+        }
+    }
+    if (!out) return;
+
+    // Timestamp UTC com milissegundos (ISO 8601)
+    double wall = event.wall_time;
+    if (wall < 0) {
+        wall = std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+    std::time_t seconds = static_cast<std::time_t>(wall);
+    long millis = static_cast<long>((wall - static_cast<double>(seconds)) * 1000.0);
+    std::tm tm_buf;
+    gmtime_r(&seconds, &tm_buf);
+    char timestamp[40];
+    size_t len = strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%S", &tm_buf);
+    snprintf(timestamp + len, sizeof(timestamp) - len, ".%03ldZ", millis);
+
+    std::string comm = event.comm;
+    if (comm.empty()) {
+        auto meta = process_meta_cache().get(event.pid);
+        if (meta) comm = meta->comm;
+    }
+
+    std::string line = "{\"ts\":\"";
+    line += timestamp;
+    line += "\",\"pid\":" + std::to_string(event.pid) + ",\"comm\":";
+    append_json_string(line, comm);
+    line += ",\"detector\":";
+    append_json_string(line, event.detector);
+    line += ",\"metric\":";
+    append_json_string(line, event.metric);
+    line += ",\"direction\":";
+    append_json_string(line, event.direction);
+    append_json_number(line, "value", event.value);
+    if (event.detector == "rss_slope") {
+        append_json_number(line, "slope_bytes_per_sec", event.slope);
+        append_json_number(line, "r2", event.score);
+        if (event.headroom_bytes >= 0) {
+            append_json_number(line, "headroom_bytes", static_cast<double>(event.headroom_bytes));
+        }
+        if (event.limit_bytes >= 0) {
+            append_json_number(line, "limit_bytes", static_cast<double>(event.limit_bytes));
+        }
+        if (!event.limit_source.empty()) {
+            line += ",\"limit_source\":";
+            append_json_string(line, event.limit_source);
+        }
+        if (event.time_to_oom_sec >= 0) {
+            append_json_number(line, "time_to_oom_sec", event.time_to_oom_sec);
+        }
+    } else {
+        append_json_number(line, "baseline", event.baseline);
+        append_json_number(line, "score", event.score);
+        append_json_number(line, "threshold", event.threshold);
+    }
+    line += "}\n";
+
+    out->write(line.data(), static_cast<std::streamsize>(line.size()));
+    out->flush();
+    emitted++;
+}
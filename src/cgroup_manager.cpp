@@ -1,4 +1,5 @@
 #include "cgroup_manager.hpp"
+#include "procfs.hpp"
 #include <fstream>
 #include <sstream>
 #include <iostream>
@@ -10,13 +11,14 @@
 #include <fcntl.h>
 #include <vector>
 #include <algorithm>
+#include <cstdlib>
 
 // Construtor: inicializa o caminho base do cgroup detectando automaticamente a versão
+// No v2 a hierarquia unificada fica montada diretamente em /sys/fs/cgroup
+// (é lá que is_cgroup_v2() encontra cgroup.controllers); cgroup_root()
+// respeita a raiz do /sys configurada (snapshot capturado)
 CGroupManager::CGroupManager() {
-    base_path = "/sys/fs/cgroup";
-    if (is_cgroup_v2()) {
-        base_path += "/unified";
-    }
+    base_path = cgroup_root();
 }
 
 // Destrutor
@@ -424,14 +426,14 @@ void CGroupManager::print_pressure(const PressureStats& p, const std::string& ty
 // Detecta se o sistema está usando CGroup v2
 bool CGroupManager::is_cgroup_v2() {
     struct stat st;
-    return stat("/sys/fs/cgroup/cgroup.controllers", &st) == 0;
+    return stat((cgroup_root() + "/cgroup.controllers").c_str(), &st) == 0;
 }
 
 // Obtém o cgroup atual de um processo específico
 std::string CGroupManager::get_current_cgroup(int pid) {
     if (pid == 0) pid = getpid();
     
-    std::string cgroup_file = "/proc/" + std::to_string(pid) + "/cgroup";
+    std::string cgroup_file = proc_pid_path(pid, "cgroup");
     std::ifstream file(cgroup_file);
     
     if (!file.is_open()) {
@@ -590,6 +592,23 @@ bool CGroupManager::set_memory_swap_limit(const std::string& cgroup_path, size_t
     return true;
 }
 
+// Lê o limite de memória de um cgroup em bytes
+long long CGroupManager::read_memory_limit(const std::string& cgroup_path) {
+    std::string limit_file = base_path + cgroup_path +
+        (is_cgroup_v2() ? "/memory.max" : "/memory.limit_in_bytes");
+    std::ifstream file(limit_file);
+    std::string value;
+    if (!file.is_open() || !(file >> value) || value == "max") {
+        return -1;
+    }
+    long long limit = atoll(value.c_str());
+    // O v1 representa "sem limite" como um valor perto de LLONG_MAX (arredondado à página)
+    if (limit <= 0 || limit >= (1LL << 60)) {
+        return -1;
+    }
+    return limit;
+}
+
 size_t CGroupManager::read_memory_max_usage(const std::string& cgroup_path) {
     (void)cgroup_path;
     return 0;
@@ -615,7 +634,252 @@ bool CGroupManager::set_io_weight(const std::string& cgroup_path, int weight) {
     return true;
 }
 
+// Lista os PIDs membros de um cgroup (cgroup.procs no v2, tasks no v1)
 std::vector<std::string> CGroupManager::list_processes_in_cgroup(const std::string& cgroup_path) {
-    (void)cgroup_path;
-    return std::vector<std::string>();
-}
\ No newline at end of file
+    std::vector<std::string> pids;
+    std::string full_path = base_path + cgroup_path;
+    std::string procs_file = full_path + (is_cgroup_v2() ? "/cgroup.procs" : "/tasks");
+    
+    std::ifstream file(procs_file);
+    if (!file.is_open()) {
+        std::cerr << " Erro: não foi possível abrir " << procs_file << std::endl;
+        return pids;
+    }
+    
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty()) {
+            pids.push_back(line);
+        }
+    }
+    
+    file.close();
+    return pids;
+}
+
+// Lê a linha "some" (ou "full") de um arquivo PSI sem reportar erro (arquivo opcional)
+static PressureStats read_pressure_quiet(const std::string& pressure_file, const std::string& kind = "some") {
+    PressureStats stats = {0, 0, 0, 0};
+    std::ifstream file(pressure_file);
+    if (!file.is_open()) {
+        return stats;
+    }
+    
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.compare(0, kind.size() + 1, kind + " ") == 0) {
+            sscanf(line.c_str() + kind.size(), " avg10=%lf avg60=%lf avg300=%lf total=%llu",
+                   &stats.avg10, &stats.avg60, &stats.avg300, &stats.total);
+            break;
+        }
+    }
+    return stats;
+}
+
+// Lê um único valor numérico de um arquivo do cgroup (0 se ausente)
+static unsigned long long read_value_quiet(const std::string& value_file) {
+    std::ifstream file(value_file);
+    unsigned long long value = 0;
+    if (file.is_open()) {
+        file >> value;
+    }
+    return value;
+}
+
+// Lê todos os contadores nativos de um cgroup de uma só vez
+CGroupStats CGroupManager::read_cgroup_stats(const std::string& cgroup_path) {
+    CGroupStats stats = {};
+    stats.pids_current = -1;
+    std::string full_path = base_path + cgroup_path;
+    
+    if (!is_cgroup_v2()) {
+        // CGroup v1: apenas os contadores equivalentes disponíveis sem controller
+        std::ifstream usage(full_path + "/cpuacct.usage");
+        if (usage.is_open()) {
+            unsigned long long usage_nsec = 0;
+            usage >> usage_nsec;
+            stats.cpu_usage_usec = usage_nsec / 1000;
+            stats.valid = true;
+        }
+        stats.memory_current = read_value_quiet(full_path + "/memory.usage_in_bytes");
+        std::ifstream pids(full_path + "/pids.current");
+        if (pids.is_open()) {
+            pids >> stats.pids_current;
+        }
+        return stats;
+    }
+    
+    // cpu.stat: pares "chave valor", um por linha
+    std::ifstream cpu_stat(full_path + "/cpu.stat");
+    if (cpu_stat.is_open()) {
+        std::string key;
+        unsigned long long value;
+        while (cpu_stat >> key >> value) {
+            if (key == "usage_usec") stats.cpu_usage_usec = value;
+            else if (key == "user_usec") stats.cpu_user_usec = value;
+            else if (key == "system_usec") stats.cpu_system_usec = value;
+            else if (key == "nr_throttled") stats.cpu_nr_throttled = value;
+            else if (key == "throttled_usec") stats.cpu_throttled_usec = value;
+        }
+        stats.valid = true;
+    }
+    
+    stats.memory_current = read_value_quiet(full_path + "/memory.current");
+    
+    // io.stat: "MAJ:MIN rbytes=N wbytes=N rios=N wios=N dbytes=N dios=N" por dispositivo
+    std::ifstream io_stat(full_path + "/io.stat");
+    if (io_stat.is_open()) {
+        std::string line;
+        while (std::getline(io_stat, line)) {
+            std::istringstream iss(line);
+            std::string field;
+            iss >> field;  // Pula "MAJ:MIN"
+            while (iss >> field) {
+                size_t eq = field.find('=');
+                if (eq == std::string::npos) continue;
+                std::string key = field.substr(0, eq);
+                unsigned long long value = std::strtoull(field.c_str() + eq + 1, nullptr, 10);
+                if (key == "rbytes") stats.io_rbytes += value;
+                else if (key == "wbytes") stats.io_wbytes += value;
+                else if (key == "rios") stats.io_rios += value;
+                else if (key == "wios") stats.io_wios += value;
+            }
+        }
+    }
+    
+    std::ifstream pids(full_path + "/pids.current");
+    if (pids.is_open()) {
+        pids >> stats.pids_current;
+    }
+    
+    stats.cpu_pressure = read_pressure_quiet(full_path + "/cpu.pressure");
+    stats.memory_pressure = read_pressure_quiet(full_path + "/memory.pressure");
+    stats.io_pressure = read_pressure_quiet(full_path + "/io.pressure");
+    
+    return stats;
+}
+
+// Entrada de um dispositivo no snapshot (criada sem limites na primeira vez)
+static CGroupDeviceIO& device_io_entry(std::vector<CGroupDeviceIO>& devices, unsigned int major, unsigned int minor) {
+    for (CGroupDeviceIO& dev : devices) {
+        if (dev.major == major && dev.minor == minor) return dev;
+    }
+    CGroupDeviceIO dev = {};
+    dev.major = major;
+    dev.minor = minor;
+    dev.rbps_max = dev.wbps_max = dev.riops_max = dev.wiops_max = -1;
+    devices.push_back(dev);
+    return devices.back();
+}
+
+// Lê um arquivo blkio.throttle.*_device do v1: "MAJ:MIN valor" por linha
+static void read_blkio_limits(const std::string& limit_file, std::vector<CGroupDeviceIO>& devices,
+                              long long CGroupDeviceIO::*limit) {
+    std::ifstream file(limit_file);
+    std::string line;
+    while (std::getline(file, line)) {
+        unsigned int major, minor;
+        long long value;
+        if (sscanf(line.c_str(), "%u:%u %lld", &major, &minor, &value) == 3) {
+            device_io_entry(devices, major, minor).*limit = value;
+        }
+    }
+}
+
+// Lê I/O por dispositivo, limites e pressão de I/O de um cgroup
+CGroupIOSnapshot CGroupManager::read_io_snapshot(const std::string& cgroup_path) {
+    CGroupIOSnapshot snapshot = {};
+    
+    if (!is_cgroup_v2()) {
+        // CGroup v1: contadores do controller blkio (camada de throttling)
+        // Formato: "MAJ:MIN Read N", "MAJ:MIN Write N", ... e "Total N"
+        std::string blkio_path = base_path + "/blkio" + cgroup_path;
+        const char* counter_files[] = {"/blkio.throttle.io_service_bytes", "/blkio.throttle.io_serviced"};
+        for (int i = 0; i < 2; i++) {
+            std::ifstream file(blkio_path + counter_files[i]);
+            if (!file.is_open()) continue;
+            snapshot.valid = true;
+            std::string line;
+            while (std::getline(file, line)) {
+                unsigned int major, minor;
+                char op[16];
+                unsigned long long value;
+                if (sscanf(line.c_str(), "%u:%u %15s %llu", &major, &minor, op, &value) != 4) continue;
+                CGroupDeviceIO& dev = device_io_entry(snapshot.devices, major, minor);
+                if (strcmp(op, "Read") == 0) (i == 0 ? dev.rbytes : dev.rios) = value;
+                else if (strcmp(op, "Write") == 0) (i == 0 ? dev.wbytes : dev.wios) = value;
+            }
+        }
+        read_blkio_limits(blkio_path + "/blkio.throttle.read_bps_device", snapshot.devices, &CGroupDeviceIO::rbps_max);
+        read_blkio_limits(blkio_path + "/blkio.throttle.write_bps_device", snapshot.devices, &CGroupDeviceIO::wbps_max);
+        read_blkio_limits(blkio_path + "/blkio.throttle.read_iops_device", snapshot.devices, &CGroupDeviceIO::riops_max);
+        read_blkio_limits(blkio_path + "/blkio.throttle.write_iops_device", snapshot.devices, &CGroupDeviceIO::wiops_max);
+        
+        // v1 não tem PSI por cgroup
+        snapshot.pressure_some = read_pressure_quiet(proc_path("pressure/io"), "some");
+        snapshot.pressure_full = read_pressure_quiet(proc_path("pressure/io"), "full");
+        return snapshot;
+    }
+    
+    std::string full_path = base_path + cgroup_path;
+    
+    // io.stat: "MAJ:MIN rbytes=N wbytes=N rios=N wios=N dbytes=N dios=N"
+    std::ifstream io_stat(full_path + "/io.stat");
+    if (io_stat.is_open()) {
+        snapshot.valid = true;
+        std::string line;
+        while (std::getline(io_stat, line)) {
+            std::istringstream iss(line);
+            std::string field;
+            unsigned int major, minor;
+            if (!(iss >> field) || sscanf(field.c_str(), "%u:%u", &major, &minor) != 2) continue;
+            CGroupDeviceIO& dev = device_io_entry(snapshot.devices, major, minor);
+            while (iss >> field) {
+                size_t eq = field.find('=');
+                if (eq == std::string::npos) continue;
+                std::string key = field.substr(0, eq);
+                unsigned long long value = std::strtoull(field.c_str() + eq + 1, nullptr, 10);
+                if (key == "rbytes") dev.rbytes = value;
+                else if (key == "wbytes") dev.wbytes = value;
+                else if (key == "rios") dev.rios = value;
+                else if (key == "wios") dev.wios = value;
+            }
+        }
+    }
+    
+    // io.max: "MAJ:MIN rbps=N wbps=max riops=max wiops=max" (só dispositivos com limite)
+    std::ifstream io_max(full_path + "/io.max");
+    if (io_max.is_open()) {
+        std::string line;
+        while (std::getline(io_max, line)) {
+            std::istringstream iss(line);
+            std::string field;
+            unsigned int major, minor;
+            if (!(iss >> field) || sscanf(field.c_str(), "%u:%u", &major, &minor) != 2) continue;
+            CGroupDeviceIO& dev = device_io_entry(snapshot.devices, major, minor);
+            while (iss >> field) {
+                size_t eq = field.find('=');
+                if (eq == std::string::npos) continue;
+                std::string key = field.substr(0, eq);
+                std::string value = field.substr(eq + 1);
+                long long limit = value == "max" ? -1 : std::strtoll(value.c_str(), nullptr, 10);
+                if (key == "rbps") dev.rbps_max = limit;
+                else if (key == "wbps") dev.wbps_max = limit;
+                else if (key == "riops") dev.riops_max = limit;
+                else if (key == "wiops") dev.wiops_max = limit;
+            }
+        }
+    }
+    
+    // O cgroup raiz não tem io.pressure: usa o PSI do sistema
+    struct stat st;
+    std::string pressure_file = full_path + "/io.pressure";
+    snapshot.cgroup_pressure = stat(pressure_file.c_str(), &st) == 0;
+    if (!snapshot.cgroup_pressure) {
+        pressure_file = proc_path("pressure/io");
+    }
+    snapshot.pressure_some = read_pressure_quiet(pressure_file, "some");
+    snapshot.pressure_full = read_pressure_quiet(pressure_file, "full");
+    
+    return snapshot;
+}
@@ -0,0 +1,1819 @@
+// ============================================================
+// ARQUIVO: src/cli.cpp
+// DESCRIÇÃO: Implementação da linha de comando e do modo daemon
+// O daemon roda o profiler continuamente; SIGHUP relê o arquivo de
+// configuração e reabre a saída (compatível com logrotate), e
+// SIGINT/SIGTERM encerram pelo monitoring_active compartilhado
+// ============================================================
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <thread>
+#include <chrono>
+#include <ctime>
+#include <cstdlib>
+#include <cstring>
+#include <csignal>
+#include <climits>
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <unistd.h>
+#include <sys/resource.h>
+#include "cli.hpp"
+#include "profiler.hpp"
+#include "namespace.hpp"
+#include "cgroup_manager.hpp"
+#include "procfs.hpp"
+#include "metrics_server.hpp"
+#include "process_table.hpp"
+#include "thread_table.hpp"
+#include "query.hpp"
+#include "cpu_stat.hpp"
+#include "system_memory.hpp"
+#include "numa.hpp"
+#include "process_meta.hpp"
+#include "process_tree.hpp"
+#include "exit_accounting.hpp"
+#include "netns_stat.hpp"
+#include "disk_stat.hpp"
+
+using namespace std;
+
+namespace fs = std::filesystem;
+
+// Pedido de recarga da configuração (SIGHUP)
+static atomic<bool> reload_requested{false};
+
+// ================================
+// PARSING DE ARGUMENTOS
+// ================================
+
+// Opções que recebem valor (--opcao VALOR)
+static const set<string> value_options = {
+    "root", "pid", "cgroup", "interval-ms", "duration", "output",
+    "config", "format", "path", "limit", "depth", "metrics", "sort",
+    "pss-interval", "events", "min-interval-ms", "max-interval-ms", "adapt-cpu", "adapt-rss", "adapt-io",
+    "record", "host-output", "numa-interval", "metric", "from", "to", "group-by", "bucket", "agg"
+};
+
+struct CliArgs {
+    vector<string> positional;        // Subcomando e argumentos soltos
+    map<string, string> options;      // --opcao VALOR
+    set<string> flags;                // --flag
+};
+
+// Separa argumentos posicionais, opções com valor e flags
+// Retorno: false se uma opção com valor veio sem o valor
+static bool parse_args(int argc, char* argv[], CliArgs& args) {
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg.rfind("--", 0) != 0) {
+            args.positional.push_back(arg);
+            continue;
+        }
+        string name = arg.substr(2);
+        size_t eq = name.find('=');
+        if (eq != string::npos) {
+            args.options[name.substr(0, eq)] = name.substr(eq + 1);
+        } else if (value_options.count(name)) {
+            if (i + 1 >= argc) {
+                cerr << "Erro: opção --" << name << " requer um valor" << endl;
+                return false;
+            }
+            args.options[name] = argv[++i];
+        } else {
+            args.flags.insert(name);
+        }
+    }
+    return true;
+}
+
+// Converte "1234,5678" em lista de PIDs
+// Retorno: false se algum elemento não é um PID válido
+static bool parse_pid_list(const string& text, vector<int>& pids) {
+    stringstream ss(text);
+    string item;
+    while (getline(ss, item, ',')) {
+        if (item.empty()) continue;
+        char* end = nullptr;
+        long pid = strtol(item.c_str(), &end, 10);
+        if (*end != '\0' || pid <= 0 || pid > INT_MAX) {
+            cerr << "Erro: PID inválido: " << item << endl;
+            return false;
+        }
+        pids.push_back(static_cast<int>(pid));
+    }
+    return true;
+}
+
+// Lê inteiro positivo de uma opção, com valor padrão
+static bool option_int(const CliArgs& args, const string& name, int& value) {
+    auto it = args.options.find(name);
+    if (it == args.options.end()) {
+        return true;
+    }
+    char* end = nullptr;
+    long parsed = strtol(it->second.c_str(), &end, 10);
+    if (*end != '\0' || parsed < 0 || parsed > INT_MAX) {
+        cerr << "Erro: valor inválido para --" << name << ": " << it->second << endl;
+        return false;
+    }
+    value = static_cast<int>(parsed);
+    return true;
+}
+
+// Lê número real não negativo de uma opção, com valor padrão
+static bool option_double(const CliArgs& args, const string& name, double& value) {
+    auto it = args.options.find(name);
+    if (it == args.options.end()) {
+        return true;
+    }
+    char* end = nullptr;
+    double parsed = strtod(it->second.c_str(), &end);
+    if (*end != '\0' || !(parsed >= 0)) {
+        cerr << "Erro: valor inválido para --" << name << ": " << it->second << endl;
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+// Normaliza caminho de cgroup para começar com '/'
+static string normalize_cgroup(const string& path) {
+    if (path.empty() || path[0] == '/') return path;
+    return "/" + path;
+}
+
+// Preenche ProfileOptions a partir das opções da linha de comando
+static bool profile_options_from_args(const CliArgs& args, ProfileOptions& opts) {
+    auto it = args.options.find("pid");
+    if (it != args.options.end() && !parse_pid_list(it->second, opts.pids)) {
+        return false;
+    }
+    it = args.options.find("cgroup");
+    if (it != args.options.end()) {
+        opts.cgroup = normalize_cgroup(it->second);
+    }
+    it = args.options.find("output");
+    if (it != args.options.end()) {
+        opts.output = it->second;
+    }
+    it = args.options.find("events");
+    if (it != args.options.end()) {
+        opts.events = it->second;
+    }
+    it = args.options.find("record");
+    if (it != args.options.end()) {
+        opts.record = it->second;
+    }
+    it = args.options.find("host-output");
+    if (it != args.options.end()) {
+        opts.host_output = it->second;
+    }
+    if (!option_int(args, "interval-ms", opts.interval_ms) ||
+        !option_int(args, "duration", opts.duration_sec) ||
+        !option_int(args, "pss-interval", opts.pss_interval) ||
+        !option_int(args, "numa-interval", opts.numa_interval) ||
+        !option_int(args, "min-interval-ms", opts.min_interval_ms) ||
+        !option_int(args, "max-interval-ms", opts.max_interval_ms) ||
+        !option_double(args, "adapt-cpu", opts.adapt_cpu) ||
+        !option_double(args, "adapt-rss", opts.adapt_rss) ||
+        !option_double(args, "adapt-io", opts.adapt_io)) {
+        return false;
+    }
+    if (opts.interval_ms <= 0) {
+        cerr << "Erro: --interval-ms deve ser positivo" << endl;
+        return false;
+    }
+    if (args.flags.count("network")) opts.include_network = true;
+    if (args.flags.count("quiet")) opts.quiet = true;
+    if (args.flags.count("adaptive")) opts.adaptive = true;
+    if (args.flags.count("cpu-allowed")) opts.cpu_allowed = true;
+    if (args.flags.count("batch-reads")) opts.batch_reads = true;
+    return true;
+}
+
+// ================================
+// SINAIS
+// ================================
+
+// Handlers só alteram flags atômicas (seguros em contexto de sinal)
+static void cli_stop_handler(int) {
+    monitoring_active = false;
+}
+
+static void cli_reload_handler(int) {
+    reload_requested = true;
+}
+
+// Sem SA_RESTART: leituras bloqueadas retornam e os laços verificam as flags
+static void install_signal_handlers(bool handle_reload) {
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sigemptyset(&sa.sa_mask);
+    sa.sa_handler = cli_stop_handler;
+    sigaction(SIGINT, &sa, nullptr);
+    sigaction(SIGTERM, &sa, nullptr);
+
+    if (handle_reload) {
+        sa.sa_handler = cli_reload_handler;
+        sigaction(SIGHUP, &sa, nullptr);
+    }
+
+    // Saída redirecionada para pipe fechado não deve matar o processo
+    signal(SIGPIPE, SIG_IGN);
+}
+
+// Avança next um intervalo e dorme até ele em fatias de 100ms, para que
+// Ctrl+C não espere o intervalo inteiro. Somar ao instante anterior (e
+// não a "agora") evita que o tempo de coleta atrase os quadros seguintes
+// Retorno: false se o monitoramento foi interrompido
+static bool wait_next_frame(chrono::steady_clock::time_point& next, int interval_ms) {
+    next += chrono::milliseconds(interval_ms);
+    while (monitoring_active && chrono::steady_clock::now() < next) {
+        this_thread::sleep_for(min<chrono::steady_clock::duration>(
+            next - chrono::steady_clock::now(), chrono::milliseconds(100)));
+    }
+    return monitoring_active;
+}
+
+// Horário local "HH:MM:SS" do cabeçalho das visões
+static string clock_text() {
+    time_t t = time(nullptr);
+    struct tm tm_buf;
+    localtime_r(&t, &tm_buf);
+    char text[16];
+    strftime(text, sizeof(text), "%H:%M:%S", &tm_buf);
+    return text;
+}
+
+// ================================
+// ENDPOINT DE MÉTRICAS (--metrics)
+// ================================
+
+// Servidor de métricas em thread própria; o exportador roda na thread de
+// coleta (on_tick), então um scrape só copia o snapshot já renderizado
+class MetricsEndpoint {
+private:
+    MetricsSnapshot snapshot;
+    MetricsServer server;
+    MetricsExporter exporter;
+    atomic<bool> active{true};
+    thread worker;
+
+public:
+    MetricsEndpoint() : server(snapshot), exporter(snapshot, {}) {}
+
+    ~MetricsEndpoint() {
+        active = false;
+        if (worker.joinable()) worker.join();
+    }
+
+    // Abre o endereço e inicia a thread do servidor
+    bool start(const string& address) {
+        if (!server.listen(address)) {
+            return false;
+        }
+        worker = thread([this] { server.run(active); });
+        cerr << "Métricas expostas em " << address << " (GET /metrics)" << endl;
+        return true;
+    }
+
+    // Liga o exportador ao profiler; sem --cgroup exporta o cgroup raiz
+    void attach(ProfileOptions& opts) {
+        exporter.set_cgroups({opts.cgroup.empty() ? string("/") : opts.cgroup});
+        opts.on_tick = [this](const vector<ProcessSample>& samples, const HostMemory& host) {
+            exporter.publish_tick(samples, host);
+        };
+    }
+};
+
+// ================================
+// USO
+// ================================
+
+static void print_usage(const char* prog) {
+    cout << "Uso: " << prog << " [--root DIR] <subcomando> [opções]\n"
+         << "     " << prog << "                       (sem argumentos: menu interativo)\n\n"
+         << "Subcomandos:\n"
+         << "  profile     --pid P1,P2,... [--cgroup CAMINHO] [--interval-ms N]\n"
+         << "              [--duration S] [--output ARQ|-] [--network] [--quiet]\n"
+         << "              [--metrics ENDEREÇO] [--pss-interval N] [--events ARQ|-]\n"
+         << "              [--adaptive [--min-interval-ms N] [--max-interval-ms N]\n"
+         << "               [--adapt-cpu PP] [--adapt-rss PCT] [--adapt-io KBPS]]\n"
+         << "              [--record SESSÃO] [--cpu-allowed] [--host-output ARQ] [--numa-interval N]\n"
+         << "              [--batch-reads]\n"
+         << "              Monitora processos e grava CSV (padrão: stdout)\n"
+         << "  replay      SESSÃO [--pid P1,P2,...] [--output ARQ|-|none] [--events ARQ|-] [--quiet]\n"
+         << "              Refaz CPU%, taxas, estatísticas e anomalias de uma sessão gravada\n"
+         << "  query       SESSÃO... [--metric cpu|rss|vsz|swap|pss|uss|io|io-read|io-write|faults|ctxt|threads]\n"
+         << "              [--from HORÁRIO] [--to HORÁRIO] [--pid P1,P2,...]\n"
+         << "              [--group-by none|pid|comm|cgroup|ns|netns|pidns|...] [--bucket 1h|5m|30s]\n"
+         << "              [--agg avg,min,max,sum,last,count,p50,p99,...] [--format table|csv] [--output ARQ|-]\n"
+         << "              Consulta sessões gravadas (HORÁRIO: \"AAAA-MM-DD HH:MM[:SS]\" local ou @epoch)\n"
+         << "  ns scan     [--format csv|json] [--output ARQ|-]\n"
+         << "              Relatório de namespaces de todos os processos\n"
+         << "  cgroup top  [--path CAMINHO] [--depth N] [--limit N] [--interval-ms N] [--duration S]\n"
+         << "              Cgroups ordenados por uso de CPU\n"
+         << "  top         [--sort cpu|rss|io] [--limit N] [--interval-ms N] [--duration S] [--no-io]\n"
+         << "              Processos que mais usam CPU, memória ou I/O (todos os PIDs)\n"
+         << "  threads     --pid P [--sort cpu|wait|switches] [--limit N] [--interval-ms N] [--duration S]\n"
+         << "              CPU, espera na runqueue e trocas de contexto por thread\n"
+         << "  tree        [--pid RAIZ] [--depth N] [--sort cpu|rss|io] [--limit N] [--interval-ms N]\n"
+         << "              [--duration S] [--no-io]\n"
+         << "              Árvore de processos com CPU, RSS e I/O exclusivos e da subárvore\n"
+         << "  net         [--limit N] [--interval-ms N] [--duration S] [--lo]\n"
+         << "              Tráfego por namespace de rede (contêineres) e por interface\n"
+         << "  disk        [--cgroup CAMINHO] [--interval-ms N] [--duration S] [--all]\n"
+         << "              IOPS, vazão, await, utilização e fila por dispositivo; com --cgroup,\n"
+         << "              separa limite do io.max, disco saturado e espera (io.stat/io.pressure)\n"
+         << "  exits       [--group-by cgroup|parent] [--limit N] [--interval-ms N] [--duration S]\n"
+         << "              Processos encerrados entre amostras (taskstats; requer CAP_NET_ADMIN)\n"
+         << "  cpu         [--per-core] [--limit N] [--interval-ms N] [--duration S]\n"
+         << "              Utilização do sistema (user/system/iowait/irq/softirq/steal/idle)\n"
+         << "  numa        [--pid P1,P2,...]\n"
+         << "              Nós NUMA e, por processo, memória por nó e nó das threads\n"
+         << "  bench       [opções do bench_collectors]\n"
+         << "              Microbenchmarks dos coletores\n\n"
+         << "Daemon:\n"
+         << "  --daemon    [--config ARQ] [opções do profile]\n"
+         << "              Coleta contínua; SIGHUP recarrega a configuração e reabre a saída,\n"
+         << "              SIGINT/SIGTERM encerram\n\n"
+         << "Métricas (profile e --daemon):\n"
+         << "  --metrics ENDEREÇO  Expõe GET /metrics (Prometheus/OpenMetrics) em\n"
+         << "              127.0.0.1:PORTA, [::1]:PORTA ou unix:/caminho\n\n"
+         << "Opção global:\n"
+         << "  --root DIR  Lê DIR/proc e DIR/sys (snapshot de scripts/capture_procfs.py)\n";
+}
+
+// ================================
+// SUBCOMANDO: profile
+// ================================
+
+static int cmd_profile(const CliArgs& args) {
+    ProfileOptions opts;
+    if (!profile_options_from_args(args, opts)) {
+        return 2;
+    }
+    if (opts.pids.empty() && opts.cgroup.empty()) {
+        cerr << "Erro: informe --pid e/ou --cgroup" << endl;
+        return 2;
+    }
+
+    install_signal_handlers(false);
+    MetricsEndpoint metrics;
+    if (args.options.count("metrics")) {
+        if (!metrics.start(args.options.at("metrics"))) return 1;
+        metrics.attach(opts);
+    }
+
+    ResourceProfiler profiler;
+    return profiler.profileProcesses(opts) ? 0 : 1;
+}
+
+// ================================
+// SUBCOMANDO: replay
+// ================================
+
+static int cmd_replay(const CliArgs& args) {
+    ReplayOptions opts;
+    if (args.positional.size() < 2) {
+        cerr << "Erro: informe o arquivo da sessão (replay SESSÃO)" << endl;
+        return 2;
+    }
+    opts.input = args.positional[1];
+    if (args.options.count("pid") && !parse_pid_list(args.options.at("pid"), opts.pids)) {
+        return 2;
+    }
+    if (args.options.count("output")) {
+        opts.output = args.options.at("output");
+        if (opts.output == "none") opts.output.clear();
+    }
+    if (args.options.count("events")) {
+        opts.events = args.options.at("events");
+    }
+    opts.quiet = args.flags.count("quiet") > 0;
+
+    ResourceProfiler profiler;
+    return profiler.replaySession(opts) ? 0 : 1;
+}
+
+// ================================
+// SUBCOMANDO: query
+// ================================
+
+// Horário local "AAAA-MM-DD HH:MM[:SS]" (ou com 'T') ou "@segundos" desde a época
+// Retorno: false se o texto não está em nenhum dos formatos
+static bool parse_time(const string& text, long long& ns) {
+    if (!text.empty() && text[0] == '@') {
+        char* end = nullptr;
+        double seconds = strtod(text.c_str() + 1, &end);
+        if (*end != '\0' || text.size() < 2) return false;
+        ns = static_cast<long long>(seconds * 1e9);
+        return true;
+    }
+    string normalized = text;
+    replace(normalized.begin(), normalized.end(), 'T', ' ');
+    for (const char* format : {"%Y-%m-%d %H:%M:%S", "%Y-%m-%d %H:%M", "%Y-%m-%d"}) {
+        struct tm tm_buf;
+        memset(&tm_buf, 0, sizeof(tm_buf));
+        const char* end = strptime(normalized.c_str(), format, &tm_buf);
+        if (end && *end == '\0') {
+            tm_buf.tm_isdst = -1;
+            time_t t = mktime(&tm_buf);
+            if (t == static_cast<time_t>(-1)) return false;
+            ns = static_cast<long long>(t) * 1000000000LL;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Duração "30s", "5m", "1h", "1d" (sem sufixo: segundos)
+static bool parse_duration(const string& text, long long& ns) {
+    char* end = nullptr;
+    double value = strtod(text.c_str(), &end);
+    if (end == text.c_str() || !(value > 0)) return false;
+    string unit = end;
+    double scale;
+    if (unit.empty() || unit == "s") scale = 1.0;
+    else if (unit == "ms") scale = 1e-3;
+    else if (unit == "m") scale = 60.0;
+    else if (unit == "h") scale = 3600.0;
+    else if (unit == "d") scale = 86400.0;
+    else return false;
+    ns = static_cast<long long>(value * scale * 1e9);
+    return ns > 0;
+}
+
+static int cmd_query(const CliArgs& args) {
+    QueryOptions opts;
+    opts.inputs.assign(args.positional.begin() + 1, args.positional.end());
+    if (opts.inputs.empty()) {
+        cerr << "Erro: informe ao menos uma sessão (query SESSÃO...)" << endl;
+        return 2;
+    }
+    if (args.options.count("metric") && !query_metric_from_name(args.options.at("metric"), opts.metric)) {
+        cerr << "Erro: métrica desconhecida: " << args.options.at("metric") << endl;
+        return 2;
+    }
+    if (args.options.count("from") && !parse_time(args.options.at("from"), opts.from_ns)) {
+        cerr << "Erro: horário inválido para --from: " << args.options.at("from") << endl;
+        return 2;
+    }
+    if (args.options.count("to") && !parse_time(args.options.at("to"), opts.to_ns)) {
+        cerr << "Erro: horário inválido para --to: " << args.options.at("to") << endl;
+        return 2;
+    }
+    if (args.options.count("pid") && !parse_pid_list(args.options.at("pid"), opts.pids)) {
+        return 2;
+    }
+    if (args.options.count("group-by") &&
+        !query_group_from_name(args.options.at("group-by"), opts.group, opts.ns_index)) {
+        cerr << "Erro: agrupamento desconhecido: " << args.options.at("group-by") << endl;
+        return 2;
+    }
+    if (args.options.count("bucket") && !parse_duration(args.options.at("bucket"), opts.bucket_ns)) {
+        cerr << "Erro: duração inválida para --bucket: " << args.options.at("bucket") << endl;
+        return 2;
+    }
+    if (args.options.count("agg") && !query_aggregates_from_list(args.options.at("agg"), opts.aggregates)) {
+        cerr << "Erro: agregação inválida em --agg: " << args.options.at("agg") << endl;
+        return 2;
+    }
+    string format = args.options.count("format") ? args.options.at("format") : "table";
+    if (format != "table" && format != "csv") {
+        cerr << "Erro: formato deve ser table ou csv" << endl;
+        return 2;
+    }
+
+    QueryResult result;
+    if (!run_query(opts, result)) {
+        return 1;
+    }
+
+    ofstream file;
+    string output = args.options.count("output") ? args.options.at("output") : "-";
+    if (output != "-") {
+        file.open(output);
+        if (!file.is_open()) {
+            cerr << "Erro: Não foi possível criar arquivo: " << output << endl;
+            return 1;
+        }
+    }
+    ostream& out = output == "-" ? cout : file;
+
+    auto format_time = [](long long ns) {
+        time_t t = static_cast<time_t>(ns / 1000000000LL);
+        struct tm tm_buf;
+        localtime_r(&t, &tm_buf);
+        char text[32];
+        strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", &tm_buf);
+        return string(text);
+    };
+    bool grouped = opts.group != QueryGroup::NONE;
+    string metric = query_metric_name(opts.metric);
+    vector<string> columns;
+    for (const auto& spec : opts.aggregates) {
+        columns.push_back(query_aggregate_name(spec));
+    }
+
+    if (format == "csv") {
+        out << (opts.bucket_ns > 0 ? "bucket_start" : "first_sample") << (grouped ? ",group" : "") << ",samples";
+        for (const string& column : columns) out << "," << metric << "_" << column;
+        out << "\n";
+        for (const QueryRow& row : result.rows) {
+            out << format_time(row.bucket_ns);
+            if (grouped) {
+                string group = row.group;
+                if (group.find_first_of(",\"") != string::npos) {
+                    string quoted = "\"";
+                    for (char c : group) quoted += (c == '"') ? string("\"\"") : string(1, c);
+                    group = quoted + "\"";
+                }
+                out << "," << group;
+            }
+            out << "," << row.count;
+            for (double v : row.values) out << "," << fixed << setprecision(2) << v;
+            out << "\n";
+        }
+    } else {
+        size_t group_width = 5;
+        for (const QueryRow& row : result.rows) group_width = max(group_width, row.group.size());
+        group_width = min<size_t>(group_width, 60);
+        // setw conta bytes: "início" tem um caractere de 2 bytes
+        out << left << setw(opts.bucket_ns > 0 ? 22 : 21) << (opts.bucket_ns > 0 ? "início" : "primeira amostra");
+        if (grouped) out << setw(static_cast<int>(group_width) + 2) << "grupo";
+        out << right << setw(10) << "amostras";
+        for (const string& column : columns) out << setw(16) << column;
+        out << "   (" << metric << ")\n";
+        for (const QueryRow& row : result.rows) {
+            out << left << setw(21) << format_time(row.bucket_ns);
+            if (grouped) out << setw(static_cast<int>(group_width) + 2) << row.group.substr(0, group_width);
+            out << right << setw(10) << row.count;
+            for (double v : row.values) out << setw(16) << fixed << setprecision(2) << v;
+            out << "\n";
+        }
+    }
+    out.flush();
+
+    cerr << result.rows.size() << " linha(s); " << result.records << " registros ("
+         << fixed << setprecision(1) << result.bytes / (1024.0 * 1024.0) << " MB) varridos em "
+         << setprecision(1) << result.elapsed_sec * 1000.0 << "ms";
+    if (result.elapsed_sec > 0) {
+        cerr << " (" << setprecision(0) << result.bytes / (1024.0 * 1024.0) / result.elapsed_sec << " MB/s)";
+    }
+    cerr << ", " << result.matched << " amostras agregadas" << endl;
+    return 0;
+}
+
+// ================================
+// SUBCOMANDO: ns scan
+// ================================
+
+static int cmd_ns_scan(const CliArgs& args) {
+    string format = args.options.count("format") ? args.options.at("format") : "csv";
+    if (format != "csv" && format != "json") {
+        cerr << "Erro: formato deve ser csv ou json" << endl;
+        return 2;
+    }
+    string output = args.options.count("output") ? args.options.at("output") : "-";
+    string filename = (output == "-") ? "/dev/stdout" : output;
+
+    if (!generate_namespace_report(filename, format)) {
+        cerr << "Erro ao gerar relatório de namespaces em " << output << endl;
+        return 1;
+    }
+    if (output != "-") {
+        cerr << "Relatório " << format << " gerado: " << output << endl;
+    }
+    return 0;
+}
+
+// ================================
+// SUBCOMANDO: cgroup top
+// ================================
+
+struct CgroupTopRow {
+    string path;
+    double cpu_pct;
+    unsigned long long memory;
+    double io_read_rate;
+    double io_write_rate;
+    int pids;
+};
+
+// Lista o cgroup raiz informado e seus descendentes até max_depth níveis
+static vector<string> list_cgroups(const string& base_path, const string& root, int max_depth) {
+    vector<string> cgroups = {root.empty() ? "/" : root};
+    error_code ec;
+    fs::recursive_directory_iterator it(base_path + root, fs::directory_options::skip_permission_denied, ec);
+    for (; !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+        if (it.depth() >= max_depth) {
+            it.disable_recursion_pending();
+        }
+        if (!it->is_directory(ec) || it->is_symlink(ec)) {
+            continue;
+        }
+        string rel = it->path().string().substr(base_path.size());
+        cgroups.push_back(rel);
+    }
+    return cgroups;
+}
+
+static int cmd_cgroup_top(const CliArgs& args) {
+    CGroupManager mgr;
+    int interval_ms = 1000, duration_sec = 0, limit = 20, depth = 2;
+    if (!option_int(args, "interval-ms", interval_ms) || !option_int(args, "duration", duration_sec) ||
+        !option_int(args, "limit", limit) || !option_int(args, "depth", depth)) {
+        return 2;
+    }
+    if (interval_ms <= 0) interval_ms = 1000;
+
+    // v1: os contadores ficam na hierarquia do cpuacct
+    string root = args.options.count("path") ? normalize_cgroup(args.options.at("path"))
+                                             : (CGroupManager::is_cgroup_v2() ? "" : "/cpuacct");
+    if (!mgr.exists_cgroup(root.empty() ? "/" : root)) {
+        cerr << "Erro: CGroup " << mgr.get_base_path() << root << " não existe" << endl;
+        return 1;
+    }
+
+    install_signal_handlers(false);
+    bool tty = isatty(STDOUT_FILENO);
+    unsigned int num_cores = get_num_cores();
+    map<string, CGroupStats> prev;
+    auto start = chrono::steady_clock::now();
+    auto next = start;
+    auto prev_time = start;
+    bool first = true;
+
+    while (monitoring_active) {
+        auto now = chrono::steady_clock::now();
+        double elapsed = chrono::duration<double>(now - prev_time).count();
+
+        map<string, CGroupStats> curr;
+        vector<CgroupTopRow> rows;
+        for (const string& path : list_cgroups(mgr.get_base_path(), root, depth)) {
+            CGroupStats stats = mgr.read_cgroup_stats(path);
+            if (!stats.valid) continue;
+            auto p = prev.find(path);
+            if (p != prev.end() && elapsed > 0) {
+                const CGroupStats& old = p->second;
+                CgroupTopRow row;
+                row.path = path;
+                row.cpu_pct = stats.cpu_usage_usec >= old.cpu_usage_usec
+                    ? (stats.cpu_usage_usec - old.cpu_usage_usec) / 1e6 / elapsed * 100.0 / num_cores : 0.0;
+                row.memory = stats.memory_current;
+                row.io_read_rate = stats.io_rbytes >= old.io_rbytes ? (stats.io_rbytes - old.io_rbytes) / elapsed : 0.0;
+                row.io_write_rate = stats.io_wbytes >= old.io_wbytes ? (stats.io_wbytes - old.io_wbytes) / elapsed : 0.0;
+                row.pids = stats.pids_current;
+                rows.push_back(row);
+            }
+            curr[path] = stats;
+        }
+        prev.swap(curr);
+        prev_time = now;
+
+        if (!first) {
+            sort(rows.begin(), rows.end(), [](const CgroupTopRow& a, const CgroupTopRow& b) {
+                return a.cpu_pct > b.cpu_pct;
+            });
+            if (tty) {
+                cout << "\033[H\033[2J";  // Limpa a tela no terminal
+            }
+            time_t t = time(nullptr);
+            struct tm tm_buf;
+            localtime_r(&t, &tm_buf);
+            cout << "cgroup top - " << put_time(&tm_buf, "%Y-%m-%d %H:%M:%S")
+                 << " - " << rows.size() << " cgroups" << "\n";
+            cout << left << setw(50) << "CGROUP" << right
+                 << setw(9) << "CPU%" << setw(12) << "MEM(MB)"
+                 << setw(12) << "IO_R(KB/s)" << setw(12) << "IO_W(KB/s)" << setw(7) << "PIDS" << "\n";
+            int shown = 0;
+            for (const auto& row : rows) {
+                if (limit > 0 && shown++ >= limit) break;
+                cout << left << setw(50) << row.path.substr(0, 49) << right
+                     << setw(9) << fixed << setprecision(2) << row.cpu_pct
+                     << setw(12) << setprecision(1) << row.memory / (1024.0 * 1024.0)
+                     << setw(12) << row.io_read_rate / 1024.0
+                     << setw(12) << row.io_write_rate / 1024.0
+                     << setw(7) << row.pids << "\n";
+            }
+            cout << endl;
+        }
+        first = false;
+
+        if (duration_sec > 0 && chrono::steady_clock::now() - start >= chrono::seconds(duration_sec)) {
+            break;
+        }
+        if (!wait_next_frame(next, interval_ms)) break;
+    }
+    return 0;
+}
+
+// ================================
+// SUBCOMANDO: top
+// ================================
+
+// Quadro de terminal com redesenho mínimo: só as linhas que mudaram
+// desde o quadro anterior são reescritas, e o quadro inteiro sai em
+// um único write()
+class TerminalFrame {
+private:
+    vector<string> previous;
+    string out;
+    bool first = true;
+
+public:
+    ~TerminalFrame() {
+        if (!first) {
+            const char* restore = "\033[?25h\n";  // Cursor visível de novo
+            if (write(STDOUT_FILENO, restore, strlen(restore)) < 0) {}
+        }
+    }
+
+    void present(const vector<string>& lines) {
+        out.clear();
+        if (first) {
+            out += "\033[?25l\033[H\033[2J";  // Esconde o cursor e limpa a tela
+        }
+        char move[24];
+        for (size_t i = 0; i < lines.size(); i++) {
+            if (!first && i < previous.size() && previous[i] == lines[i]) continue;
+            int len = snprintf(move, sizeof(move), "\033[%zu;1H", i + 1);
+            out.append(move, len);
+            out += lines[i];
+            out += "\033[K";
+        }
+        if (lines.size() < previous.size()) {
+            int len = snprintf(move, sizeof(move), "\033[%zu;1H", lines.size() + 1);
+            out.append(move, len);
+            out += "\033[J";  // Apaga as linhas que sobraram do quadro anterior
+        }
+        previous = lines;
+        first = false;
+
+        size_t written = 0;
+        while (written < out.size()) {
+            ssize_t n = write(STDOUT_FILENO, out.data() + written, out.size() - written);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                return;
+            }
+            written += n;
+        }
+    }
+};
+
+// Tempo de CPU (usuário + sistema) consumido por este processo, em segundos
+static double self_cpu_seconds() {
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_utime.tv_sec + ru.ru_utime.tv_usec / 1e6 + ru.ru_stime.tv_sec + ru.ru_stime.tv_usec / 1e6;
+}
+
+static int cmd_top(const CliArgs& args) {
+    int interval_ms = 1000, duration_sec = 0, limit = 20;
+    if (!option_int(args, "interval-ms", interval_ms) || !option_int(args, "duration", duration_sec) ||
+        !option_int(args, "limit", limit)) {
+        return 2;
+    }
+    if (interval_ms <= 0) interval_ms = 1000;
+    if (limit <= 0) limit = 20;
+
+    string sort_name = args.options.count("sort") ? args.options.at("sort") : "cpu";
+    TopMetric metric;
+    if (sort_name == "cpu") metric = TopMetric::CPU;
+    else if (sort_name == "rss") metric = TopMetric::RSS;
+    else if (sort_name == "io") metric = TopMetric::IO;
+    else {
+        cerr << "Erro: --sort deve ser cpu, rss ou io" << endl;
+        return 2;
+    }
+    bool with_io = !args.flags.count("no-io");
+    if (metric == TopMetric::IO && !with_io) {
+        cerr << "Erro: --sort io requer a coleta de I/O (remova --no-io)" << endl;
+        return 2;
+    }
+
+    install_signal_handlers(false);
+    bool tty = isatty(STDOUT_FILENO);
+    ProcessTable table(with_io);
+    SystemCpuStat host_cpu;
+    SystemMemoryStat host_mem;
+    TerminalFrame frame;
+    vector<string> lines;
+    char line[256];
+
+    auto start = chrono::steady_clock::now();
+    auto next = start;
+    double prev_cpu = self_cpu_seconds();
+    auto prev_wall = start;
+    double overhead_pct = 0.0;
+
+    // Primeiro ciclo só estabelece a linha de base das taxas
+    table.sample();
+    host_cpu.sample();
+    host_mem.sample();
+
+    while (monitoring_active) {
+        if (!wait_next_frame(next, interval_ms)) break;
+
+        auto t0 = chrono::steady_clock::now();
+        size_t count = table.sample();
+        host_cpu.sample();
+        host_mem.sample();
+        double sample_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+        const ProcessColumns& cols = table.columns();
+
+        // Top-K da métrica escolhida e o líder das demais
+        vector<size_t> top = table.top_k(metric, limit);
+        vector<size_t> top_cpu = table.top_k(TopMetric::CPU, 1);
+        vector<size_t> top_rss = table.top_k(TopMetric::RSS, 1);
+        vector<size_t> top_io = with_io ? table.top_k(TopMetric::IO, 1) : vector<size_t>();
+        table.pin(top);
+
+        string clock = clock_text();
+
+        lines.clear();
+        snprintf(line, sizeof(line), "top - %s - %zu processos - ordenado por %s - coleta %.1f ms - overhead %.2f%% CPU",
+                 clock.c_str(), count, sort_name.c_str(), sample_ms, overhead_pct);
+        lines.push_back(line);
+
+        string leaders = "maior CPU: ";
+        auto describe = [&](const vector<size_t>& idx, const char* fmt, double value) {
+            if (idx.empty()) return string("-");
+            snprintf(line, sizeof(line), fmt, cols.comm[idx[0]]->c_str(), cols.pid[idx[0]], value);
+            return string(line);
+        };
+        leaders += describe(top_cpu, "%s(%d) %.1f%%", top_cpu.empty() ? 0 : cols.cpu_percent[top_cpu[0]]);
+        leaders += " | maior RSS: " + describe(top_rss, "%s(%d) %.0f MB",
+                                               top_rss.empty() ? 0 : cols.rss_kb[top_rss[0]] / 1024.0);
+        if (with_io) {
+            leaders += " | maior I/O: " + describe(top_io, "%s(%d) %.1f KB/s",
+                                                   top_io.empty() ? 0 : max(0.0, cols.io_rate[top_io[0]]) / 1024.0);
+        }
+        lines.push_back(leaders);
+        const CpuUtilization& host = host_cpu.total_utilization();
+        snprintf(line, sizeof(line), "CPU: %5.1f us %5.1f sy %5.1f wa %5.1f hi %5.1f si %5.1f st %5.1f id",
+                 host.user, host.system, host.iowait, host.irq, host.softirq, host.steal, host.idle);
+        lines.push_back(line);
+        const HostMemory& mem = host_mem.current();
+        snprintf(line, sizeof(line), "Mem: %.0f MB total, %.0f disp, %.0f cache, %.0f slab, %.0f swap | "
+                 "pág/s: scan %.0f steal %.0f refault %.0f swapin %.0f",
+                 mem.total_kb / 1024.0, mem.available_kb / 1024.0, mem.page_cache_kb() / 1024.0,
+                 mem.slab_kb / 1024.0, mem.swap_used_kb() / 1024.0,
+                 mem.scan_rate, mem.steal_rate, mem.refault_rate, mem.swapin_rate);
+        lines.push_back(line);
+        lines.push_back("");
+
+        snprintf(line, sizeof(line), "%7s  %-16s %8s %10s %11s %5s", "PID", "COMM", "CPU%", "RSS(MB)", "IO(KB/s)", "THR");
+        lines.push_back(line);
+        for (size_t i : top) {
+            char io_text[16];
+            if (cols.io_rate[i] < 0) snprintf(io_text, sizeof(io_text), "-");
+            else snprintf(io_text, sizeof(io_text), "%.1f", cols.io_rate[i] / 1024.0);
+            snprintf(line, sizeof(line), "%7d  %-16.16s %8.2f %10.1f %11s %5d",
+                     cols.pid[i], cols.comm[i]->c_str(), cols.cpu_percent[i],
+                     cols.rss_kb[i] / 1024.0, io_text, cols.threads[i]);
+            lines.push_back(line);
+        }
+
+        if (tty) {
+            frame.present(lines);
+        } else {
+            for (const string& l : lines) cout << l << "\n";
+            cout << endl;
+        }
+
+        // Overhead próprio (coleta + renderização) desde o quadro anterior
+        auto now = chrono::steady_clock::now();
+        double cpu = self_cpu_seconds();
+        double wall = chrono::duration<double>(now - prev_wall).count();
+        overhead_pct = wall > 0 ? (cpu - prev_cpu) / wall * 100.0 : 0.0;
+        prev_cpu = cpu;
+        prev_wall = now;
+
+        if (duration_sec > 0 && now - start >= chrono::seconds(duration_sec)) {
+            break;
+        }
+    }
+    return 0;
+}
+
+// ================================
+// SUBCOMANDO: threads
+// ================================
+
+static int cmd_threads(const CliArgs& args) {
+    int interval_ms = 1000, duration_sec = 0, limit = 30;
+    if (!option_int(args, "interval-ms", interval_ms) || !option_int(args, "duration", duration_sec) ||
+        !option_int(args, "limit", limit)) {
+        return 2;
+    }
+    if (interval_ms <= 0) interval_ms = 1000;
+    if (limit <= 0) limit = 30;
+
+    vector<int> pids;
+    if (!args.options.count("pid") || !parse_pid_list(args.options.at("pid"), pids) || pids.size() != 1) {
+        cerr << "Erro: informe um único processo com --pid" << endl;
+        return 2;
+    }
+    int pid = pids[0];
+
+    string sort_name = args.options.count("sort") ? args.options.at("sort") : "cpu";
+    ThreadMetric metric;
+    if (sort_name == "cpu") metric = ThreadMetric::CPU;
+    else if (sort_name == "wait") metric = ThreadMetric::WAIT;
+    else if (sort_name == "switches") metric = ThreadMetric::SWITCHES;
+    else {
+        cerr << "Erro: --sort deve ser cpu, wait ou switches" << endl;
+        return 2;
+    }
+
+    install_signal_handlers(false);
+    ThreadTable table(pid);
+    if (table.sample() == 0) {
+        cerr << "Erro: Processo com PID " << pid << " não existe ou não é acessível" << endl;
+        return 1;
+    }
+
+    auto meta = process_meta_cache().get(pid);
+    string comm = meta ? meta->comm : "";
+
+    bool tty = isatty(STDOUT_FILENO);
+    TerminalFrame frame;
+    vector<string> lines;
+    char line[256];
+    auto start = chrono::steady_clock::now();
+    auto next = start;
+
+    while (monitoring_active) {
+        if (!wait_next_frame(next, interval_ms)) break;
+
+        auto t0 = chrono::steady_clock::now();
+        size_t count = table.sample();
+        double sample_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+        if (!table.process_alive()) {
+            cerr << "Processo " << pid << " terminou" << endl;
+            break;
+        }
+        const ThreadColumns& cols = table.columns();
+
+        // Totais do processo: quanto da CPU e da espera cada thread explica
+        double total_cpu = 0, total_wait = 0;
+        for (size_t i = 0; i < count; i++) {
+            total_cpu += cols.cpu_percent[i];
+            if (cols.wait_percent[i] > 0) total_wait += cols.wait_percent[i];
+        }
+
+        string clock = clock_text();
+
+        lines.clear();
+        snprintf(line, sizeof(line), "threads - %s - PID %d (%s) - %zu threads - ordenado por %s - coleta %.1f ms",
+                 clock.c_str(), pid, comm.c_str(), count, sort_name.c_str(), sample_ms);
+        lines.push_back(line);
+        snprintf(line, sizeof(line), "total: CPU %.1f%% de um núcleo | espera na runqueue %.1f%%", total_cpu, total_wait);
+        lines.push_back(line);
+        lines.push_back("");
+        snprintf(line, sizeof(line), "%7s  %-16s %1s %7s %7s %9s %9s %9s %9s",
+                 "TID", "NOME", "S", "CPU%", "WAIT%", "LAT(us)", "FATIAS/s", "VCSW/s", "NVCSW/s");
+        lines.push_back(line);
+        for (size_t i : table.top_k(metric, limit)) {
+            char wait_text[16], lat_text[16];
+            if (cols.wait_percent[i] < 0) {
+                snprintf(wait_text, sizeof(wait_text), "-");
+                snprintf(lat_text, sizeof(lat_text), "-");
+            } else {
+                snprintf(wait_text, sizeof(wait_text), "%.2f", cols.wait_percent[i]);
+                snprintf(lat_text, sizeof(lat_text), "%.1f", cols.avg_wait_us[i]);
+            }
+            snprintf(line, sizeof(line), "%7d  %-16.16s %c %7.2f %7s %9s %9.1f %9.1f %9.1f",
+                     cols.tid[i], cols.name[i]->c_str(), cols.state[i], cols.cpu_percent[i],
+                     wait_text, lat_text, cols.slices_rate[i], cols.voluntary_rate[i], cols.nonvoluntary_rate[i]);
+            lines.push_back(line);
+        }
+
+        if (tty) {
+            frame.present(lines);
+        } else {
+            for (const string& l : lines) cout << l << "\n";
+            cout << endl;
+        }
+
+        if (duration_sec > 0 && chrono::steady_clock::now() - start >= chrono::seconds(duration_sec)) {
+            break;
+        }
+    }
+    return 0;
+}
+
+// ================================
+// SUBCOMANDO: tree
+// ================================
+
+static int cmd_tree(const CliArgs& args) {
+    int interval_ms = 1000, duration_sec = 0, limit = 40, depth = -1, root = -1;
+    if (!option_int(args, "interval-ms", interval_ms) || !option_int(args, "duration", duration_sec) ||
+        !option_int(args, "limit", limit) || !option_int(args, "depth", depth) || !option_int(args, "pid", root)) {
+        return 2;
+    }
+    if (interval_ms <= 0) interval_ms = 1000;
+    if (limit <= 0) limit = 40;
+
+    string sort_name = args.options.count("sort") ? args.options.at("sort") : "cpu";
+    TreeMetric metric;
+    if (sort_name == "cpu") metric = TreeMetric::CPU;
+    else if (sort_name == "rss") metric = TreeMetric::RSS;
+    else if (sort_name == "io") metric = TreeMetric::IO;
+    else {
+        cerr << "Erro: --sort deve ser cpu, rss ou io" << endl;
+        return 2;
+    }
+    bool with_io = !args.flags.count("no-io");
+    if (metric == TreeMetric::IO && !with_io) {
+        cerr << "Erro: --sort io requer a coleta de I/O (remova --no-io)" << endl;
+        return 2;
+    }
+
+    install_signal_handlers(false);
+    ProcessTree tree(with_io);
+    // Primeiro ciclo só estabelece a linha de base das taxas
+    tree.sample();
+    if (root >= 0 && tree.rows(root, 0).empty()) {
+        cerr << "Erro: Processo com PID " << root << " não existe ou não é acessível" << endl;
+        return 1;
+    }
+
+    bool tty = isatty(STDOUT_FILENO);
+    TerminalFrame frame;
+    vector<string> lines;
+    char line[256];
+    auto start = chrono::steady_clock::now();
+    auto next = start;
+
+    while (monitoring_active) {
+        if (!wait_next_frame(next, interval_ms)) break;
+
+        auto t0 = chrono::steady_clock::now();
+        size_t count = tree.sample();
+        vector<TreeRow> rows = tree.rows(root, depth, metric);
+        double sample_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+        if (root >= 0 && rows.empty()) {
+            cerr << "Processo " << root << " terminou" << endl;
+            break;
+        }
+
+        string clock = clock_text();
+
+        lines.clear();
+        snprintf(line, sizeof(line), "tree - %s - %zu processos - ordenado por %s (subárvore) - coleta %.1f ms",
+                 clock.c_str(), count, sort_name.c_str(), sample_ms);
+        lines.push_back(line);
+        lines.push_back("CPU% próprio | FILHOS: filhos encerrados e aguardados no ciclo (cutime/cstime) | "
+                        "TOTAL: processo + subárvore");
+        lines.push_back("");
+        snprintf(line, sizeof(line), "%7s %7s %7s %7s %9s %9s %10s %5s  %s",
+                 "PID", "CPU%", "FILHOS%", "TOTAL%", "RSS(MB)", "RSS.T(MB)", "IO.T(KB/s)", "DESC", "COMM");
+        lines.push_back(line);
+        for (size_t i = 0; i < rows.size() && i < static_cast<size_t>(limit); i++) {
+            const TreeRow& row = rows[i];
+            // Recuo de 2 espaços por nível (limitado para não empurrar o nome)
+            string indent(static_cast<size_t>(min(row.depth, 12)) * 2, ' ');
+            char io_text[16];
+            if (!with_io) snprintf(io_text, sizeof(io_text), "-");
+            else snprintf(io_text, sizeof(io_text), "%.1f", row.io_total / 1024.0);
+            snprintf(line, sizeof(line), "%7d %7.2f %7.2f %7.2f %9.1f %9.1f %10s %5d  %s%s",
+                     row.pid, row.cpu_self, row.cpu_reaped, row.cpu_total,
+                     row.rss_self_kb / 1024.0, row.rss_total_kb / 1024.0, io_text, row.descendants,
+                     indent.c_str(), row.comm->c_str());
+            lines.push_back(line);
+        }
+        if (rows.size() > static_cast<size_t>(limit)) {
+            snprintf(line, sizeof(line), "... %zu processos omitidos (--limit)", rows.size() - limit);
+            lines.push_back(line);
+        }
+
+        if (tty) {
+            frame.present(lines);
+        } else {
+            for (const string& l : lines) cout << l << "\n";
+            cout << endl;
+        }
+
+        if (duration_sec > 0 && chrono::steady_clock::now() - start >= chrono::seconds(duration_sec)) {
+            break;
+        }
+    }
+    return 0;
+}
+
+// ================================
+// SUBCOMANDO: net
+// ================================
+
+static int cmd_net(const CliArgs& args) {
+    int interval_ms = 1000, duration_sec = 0, limit = 20;
+    if (!option_int(args, "interval-ms", interval_ms) || !option_int(args, "duration", duration_sec) ||
+        !option_int(args, "limit", limit)) {
+        return 2;
+    }
+    if (interval_ms <= 0) interval_ms = 1000;
+    if (limit <= 0) limit = 20;
+    bool show_lo = args.flags.count("lo") > 0;
+
+    install_signal_handlers(false);
+    NetnsStat netns;
+    netns.sample();  // Linha de base
+
+    bool tty = isatty(STDOUT_FILENO);
+    TerminalFrame frame;
+    vector<string> lines;
+    char line[320];
+    auto start = chrono::steady_clock::now();
+    auto next = start;
+
+    while (monitoring_active) {
+        if (!wait_next_frame(next, interval_ms)) break;
+        netns.sample();
+
+        string clock = clock_text();
+
+        const auto& namespaces = netns.namespaces();
+        lines.clear();
+        snprintf(line, sizeof(line), "net - %s - %zu namespaces de rede", clock.c_str(), namespaces.size());
+        lines.push_back(line);
+        lines.push_back("");
+        snprintf(line, sizeof(line), "%-12s %6s %7s %-16s %11s %11s %9s %9s %7s %7s  %s",
+                 "NETNS", "PROCS", "PID", "COMANDO", "RX(KB/s)", "TX(KB/s)", "RX(pk/s)", "TX(pk/s)",
+                 "ERROS", "DESC", "CGROUP");
+        lines.push_back(line);
+
+        int shown = 0;
+        for (const NetnsTraffic* ns : namespaces) {
+            if (shown++ >= limit) break;
+            snprintf(line, sizeof(line), "%-12lu %6d %7d %-16.16s %11.1f %11.1f %9s %9s %7s %7s  %s%s",
+                     static_cast<unsigned long>(ns->inode), ns->process_count, ns->pid, ns->comm.c_str(),
+                     ns->rx_rate / 1024.0, ns->tx_rate / 1024.0, "", "", "", "",
+                     ns->cgroup.c_str(), ns->host ? " (host)" : "");
+            lines.push_back(line);
+            for (const NetInterfaceStats& iface : ns->interfaces) {
+                if (iface.name == "lo" && !show_lo) continue;
+                string name = "  " + iface.name;
+                snprintf(line, sizeof(line), "%-12.12s %6s %7s %-16s %11.1f %11.1f %9.0f %9.0f %7llu %7llu",
+                         name.c_str(), "", "", "", iface.rx_rate / 1024.0, iface.tx_rate / 1024.0,
+                         iface.rx_packet_rate, iface.tx_packet_rate,
+                         static_cast<unsigned long long>(iface.rx_errors + iface.tx_errors),
+                         static_cast<unsigned long long>(iface.rx_drops + iface.tx_drops));
+                lines.push_back(line);
+            }
+        }
+
+        if (tty) {
+            frame.present(lines);
+        } else {
+            for (const string& l : lines) cout << l << "\n";
+            cout << endl;
+        }
+
+        if (duration_sec > 0 && chrono::steady_clock::now() - start >= chrono::seconds(duration_sec)) {
+            break;
+        }
+    }
+    return 0;
+}
+
+// ================================
+// SUBCOMANDO: disk
+// ================================
+
+// Valor de um limite do io.max para exibição ("wbps 1024K", "riops 500")
+static string format_io_limit(const CgroupDiskIO& io) {
+    if (io.limit_name.empty()) return "-";
+    char text[48];
+    if (io.limit_name.find("bps") != string::npos) {
+        snprintf(text, sizeof(text), "%s %lldK", io.limit_name.c_str(), io.limit_value / 1024);
+    } else {
+        snprintf(text, sizeof(text), "%s %lld", io.limit_name.c_str(), io.limit_value);
+    }
+    return text;
+}
+
+static int cmd_disk(const CliArgs& args) {
+    int interval_ms = 1000, duration_sec = 0;
+    if (!option_int(args, "interval-ms", interval_ms) || !option_int(args, "duration", duration_sec)) {
+        return 2;
+    }
+    if (interval_ms <= 0) interval_ms = 1000;
+    string cgroup_path = args.options.count("cgroup") ? normalize_cgroup(args.options.at("cgroup")) : "";
+
+    DiskStat disks(args.flags.count("all") > 0);
+    if (!disks.sample()) {
+        cerr << "Erro: não foi possível ler " << proc_path("diskstats") << endl;
+        return 1;
+    }
+    unique_ptr<CgroupDiskMonitor> cgroup_io;
+    if (!cgroup_path.empty()) {
+        cgroup_io = make_unique<CgroupDiskMonitor>(cgroup_path);
+        if (!cgroup_io->sample(disks)) {
+            cerr << "Erro: contadores de I/O indisponíveis para o cgroup " << cgroup_path
+                 << " (io.stat ou blkio.throttle.*)" << endl;
+            return 1;
+        }
+    }
+    install_signal_handlers(false);
+
+    bool tty = isatty(STDOUT_FILENO);
+    TerminalFrame frame;
+    vector<string> lines;
+    char line[320];
+    auto start = chrono::steady_clock::now();
+    auto next = start;
+
+    while (monitoring_active) {
+        if (!wait_next_frame(next, interval_ms)) break;
+        disks.sample();
+        if (cgroup_io) cgroup_io->sample(disks);
+
+        string clock = clock_text();
+
+        lines.clear();
+        snprintf(line, sizeof(line), "disk - %s - %zu dispositivos", clock.c_str(), disks.devices().size());
+        lines.push_back(line);
+        lines.push_back("");
+        snprintf(line, sizeof(line), "%-12s %8s %8s %10s %10s %8s %8s %7s %6s %5s",
+                 "DISPOSITIVO", "r/s", "w/s", "rKB/s", "wKB/s", "r_await", "w_await", "aqu-sz", "util%", "VOO");
+        lines.push_back(line);
+        for (const DiskDevice* dev : disks.devices()) {
+            snprintf(line, sizeof(line), "%-12.12s %8.1f %8.1f %10.1f %10.1f %8.2f %8.2f %7.2f %6.1f %5llu",
+                     dev->name.c_str(), dev->read_iops, dev->write_iops, dev->read_bps / 1024.0,
+                     dev->write_bps / 1024.0, dev->read_await, dev->write_await, dev->queue_depth,
+                     dev->utilization, static_cast<unsigned long long>(dev->in_flight));
+            lines.push_back(line);
+        }
+
+        if (cgroup_io) {
+            lines.push_back("");
+            snprintf(line, sizeof(line), "cgroup %s - espera por I/O: some %.1f%% full %.1f%%%s",
+                     cgroup_io->path().c_str(), cgroup_io->stall_some(), cgroup_io->stall_full(),
+                     cgroup_io->cgroup_pressure() ? "" : " (PSI do sistema)");
+            lines.push_back(line);
+            snprintf(line, sizeof(line), "%-12s %10s %10s %8s %8s %-14s %6s %7s %6s  %s",
+                     "DISPOSITIVO", "rKB/s", "wKB/s", "r/s", "w/s", "LIMITE", "USO%", "PARTE%", "util%",
+                     "DIAGNÓSTICO");
+            lines.push_back(line);
+            for (const CgroupDiskIO& io : cgroup_io->devices()) {
+                snprintf(line, sizeof(line), "%-12.12s %10.1f %10.1f %8.1f %8.1f %-14.14s %6.1f %7.1f %6.1f  %s",
+                         io.device.c_str(), io.read_bps / 1024.0, io.write_bps / 1024.0, io.read_iops,
+                         io.write_iops, format_io_limit(io).c_str(), io.limit_usage, io.device_share,
+                         io.device_utilization, io_verdict_name(io.verdict));
+                lines.push_back(line);
+            }
+        }
+
+        if (tty) {
+            frame.present(lines);
+        } else {
+            for (const string& l : lines) cout << l << "\n";
+            cout << endl;
+        }
+
+        if (duration_sec > 0 && chrono::steady_clock::now() - start >= chrono::seconds(duration_sec)) {
+            break;
+        }
+    }
+    return 0;
+}
+
+// ================================
+// SUBCOMANDO: exits
+// ================================
+
+static int cmd_exits(const CliArgs& args) {
+    int interval_ms = 1000, duration_sec = 0, limit = 15;
+    if (!option_int(args, "interval-ms", interval_ms) || !option_int(args, "duration", duration_sec) ||
+        !option_int(args, "limit", limit)) {
+        return 2;
+    }
+    if (interval_ms <= 0) interval_ms = 1000;
+    if (limit <= 0) limit = 15;
+
+    string group_name = args.options.count("group-by") ? args.options.at("group-by") : "cgroup";
+    ExitGroupBy group_by;
+    if (group_name == "cgroup") group_by = ExitGroupBy::CGROUP;
+    else if (group_name == "parent") group_by = ExitGroupBy::PARENT;
+    else {
+        cerr << "Erro: --group-by deve ser cgroup ou parent" << endl;
+        return 2;
+    }
+
+    TaskstatsListener listener;
+    if (!listener.open()) {
+        return 1;
+    }
+    install_signal_handlers(false);
+
+    // Conciliação: vivos pela árvore do /proc, encerrados pelo taskstats,
+    // total pelo /proc/stat
+    ProcessTree tree(false);
+    SystemCpuStat host_cpu;
+    ExitAccounting accounting;
+    vector<ExitRecord> records;
+    tree.sample();
+    host_cpu.sample();
+    listener.drain(records);
+    records.clear();
+
+    bool tty = isatty(STDOUT_FILENO);
+    TerminalFrame frame;
+    vector<string> lines;
+    char line[320];
+    unsigned int cores = get_num_cores();
+    auto start = chrono::steady_clock::now();
+    auto next = start;
+
+    while (monitoring_active) {
+        if (!wait_next_frame(next, interval_ms)) break;
+
+        tree.sample();
+        host_cpu.sample();
+        records.clear();
+        listener.drain(records);
+        for (const ExitRecord& record : records) {
+            accounting.add(record);
+        }
+        double unseen_us = accounting.settle(tree);
+        double elapsed = tree.elapsed();
+        double exited_pct = elapsed > 0 ? unseen_us / 1e6 / elapsed * 100.0 / cores : 0.0;
+        double live_pct = tree.cpu_live();
+        const CpuUtilization& host = host_cpu.total_utilization();
+        double host_pct = host.user + host.system;
+
+        string clock = clock_text();
+
+        lines.clear();
+        snprintf(line, sizeof(line), "exits - %s - %ld tarefas encerradas no ciclo (%ld processos) - perdidas %lu",
+                 clock.c_str(), accounting.last_tasks(), accounting.last_processes(), listener.dropped());
+        lines.push_back(line);
+        snprintf(line, sizeof(line), "CPU do host (us+sy) %.1f%% | atribuída: vivos %.1f%% + encerrados %.1f%% = %.1f%%",
+                 host_pct, live_pct, exited_pct, live_pct + exited_pct);
+        lines.push_back(line);
+        lines.push_back("");
+        snprintf(line, sizeof(line), "%-40s %7s %6s %9s %7s %9s %9s %9s %9s %10s",
+                 group_by == ExitGroupBy::CGROUP ? "CGROUP" : "PAI", "TAREFAS", "PROC", "CPU(s)", "CPU%",
+                 "LEIT(MB)", "ESCR(MB)", "MAJFLT", "ATR.CPU", "ATR.IO(ms)");
+        lines.push_back(line);
+        for (const ExitGroup* group : accounting.top(group_by, limit)) {
+            // Caminhos longos: mantém o final (a parte que distingue)
+            string key = group->key.size() > 40 ? "..." + group->key.substr(group->key.size() - 37) : group->key;
+            snprintf(line, sizeof(line), "%-40s %7ld %6ld %9.2f %7.2f %9.1f %9.1f %9llu %9.1f %10.1f",
+                     key.c_str(), group->tasks, group->processes, group->cpu_us / 1e6,
+                     elapsed > 0 ? group->tick_cpu_us / 1e6 / elapsed * 100.0 / cores : 0.0,
+                     group->read_bytes / 1048576.0, group->write_bytes / 1048576.0,
+                     static_cast<unsigned long long>(group->major_faults),
+                     group->cpu_delay_ns / 1e6, group->blkio_delay_ns / 1e6);
+            lines.push_back(line);
+        }
+
+        if (tty) {
+            frame.present(lines);
+        } else {
+            for (const string& l : lines) cout << l << "\n";
+            cout << endl;
+        }
+
+        if (duration_sec > 0 && chrono::steady_clock::now() - start >= chrono::seconds(duration_sec)) {
+            break;
+        }
+    }
+    return 0;
+}
+
+// ================================
+// SUBCOMANDO: cpu
+// ================================
+
+static int cmd_cpu(const CliArgs& args) {
+    int interval_ms = 1000, duration_sec = 0, limit = 0;
+    if (!option_int(args, "interval-ms", interval_ms) || !option_int(args, "duration", duration_sec) ||
+        !option_int(args, "limit", limit)) {
+        return 2;
+    }
+    if (interval_ms <= 0) interval_ms = 1000;
+    bool per_core = args.flags.count("per-core") > 0;
+
+    install_signal_handlers(false);
+    bool tty = isatty(STDOUT_FILENO);
+    SystemCpuStat stat;
+    TerminalFrame frame;
+    vector<string> lines;
+    vector<size_t> order;
+    char line[160];
+
+    if (stat.sample() < 0) {
+        cerr << "Erro: Não foi possível ler " << proc_path("stat") << endl;
+        return 1;
+    }
+    auto start = chrono::steady_clock::now();
+    auto next = start;
+    auto format_row = [&](const char* name, const CpuUtilization& u) {
+        snprintf(line, sizeof(line), "%-8s %7.1f %7.1f %7.1f %7.1f %7.1f %7.1f %7.1f %7.1f",
+                 name, u.busy(), u.user, u.system, u.iowait, u.irq, u.softirq, u.steal, u.idle);
+        lines.push_back(line);
+    };
+
+    while (monitoring_active) {
+        if (!wait_next_frame(next, interval_ms)) break;
+
+        int cores = stat.sample();
+        if (cores < 0) {
+            cerr << "Erro: Não foi possível ler " << proc_path("stat") << endl;
+            return 1;
+        }
+        const CpuColumns& cols = stat.cores();
+
+        string clock = clock_text();
+
+        lines.clear();
+        snprintf(line, sizeof(line), "cpu - %s - %d núcleos online", clock.c_str(), cores);
+        lines.push_back(line);
+        snprintf(line, sizeof(line), "%-8s %7s %7s %7s %7s %7s %7s %7s %7s",
+                 "CPU", "BUSY%", "USER%", "SYS%", "IOWAIT%", "IRQ%", "SIRQ%", "STEAL%", "IDLE%");
+        lines.push_back(line);
+        format_row("total", stat.total_utilization());
+
+        // Núcleos mais ocupados primeiro (desequilíbrio entre núcleos)
+        if (per_core && cols.size() > 0) {
+            order.resize(cols.size());
+            for (size_t i = 0; i < order.size(); i++) order[i] = i;
+            sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+                return cols.idle[a] + cols.iowait[a] < cols.idle[b] + cols.iowait[b];
+            });
+            size_t shown = limit > 0 ? min(order.size(), static_cast<size_t>(limit)) : order.size();
+            for (size_t k = 0; k < shown; k++) {
+                char name[16];
+                snprintf(name, sizeof(name), "cpu%d", cols.cpu[order[k]]);
+                format_row(name, cols.at(order[k]));
+            }
+        }
+
+        if (tty) {
+            frame.present(lines);
+        } else {
+            for (const string& l : lines) cout << l << "\n";
+            cout << endl;
+        }
+
+        if (duration_sec > 0 && chrono::steady_clock::now() - start >= chrono::seconds(duration_sec)) {
+            break;
+        }
+    }
+    return 0;
+}
+
+// ================================
+// SUBCOMANDO: numa
+// ================================
+
+// Relatório instantâneo: nós do sistema e, para cada PID informado,
+// memória residente por nó e nó em que as threads rodaram por último
+static int cmd_numa(const CliArgs& args) {
+    vector<int> pids;
+    if (args.options.count("pid") && !parse_pid_list(args.options.at("pid"), pids)) {
+        return 2;
+    }
+    vector<NumaNode> nodes = read_numa_nodes();
+    if (nodes.empty()) {
+        cerr << "Erro: " << sys_path("devices/system/node") << " sem nós NUMA (kernel sem CONFIG_NUMA?)" << endl;
+        return 1;
+    }
+    char line[256];
+
+    snprintf(line, sizeof(line), "%-5s %5s %10s %10s %12s %10s %12s %8s",
+             "NÓ", "CPUS", "TOTAL(MB)", "LIVRE(MB)", "NUMA_HIT", "NUMA_MISS", "OTHER_NODE", "LOCAL%");
+    cout << line << "\n";
+    for (const NumaNode& node : nodes) {
+        // LOCAL%: alocações feitas para processos rodando no próprio nó
+        unsigned long long allocations = node.local_node + node.other_node;
+        snprintf(line, sizeof(line), "%-4d %5zu %10.0f %10.0f %12llu %10llu %12llu %8.1f",
+                 node.node, node.cpus.size(), node.mem_total_kb / 1024.0, node.mem_free_kb / 1024.0,
+                 node.numa_hit, node.numa_miss, node.other_node,
+                 allocations > 0 ? node.local_node * 100.0 / allocations : 100.0);
+        cout << line << "\n";
+    }
+
+    if (pids.empty()) {
+        cout << flush;
+        return 0;
+    }
+    vector<int> cpu_nodes = numa_cpu_nodes(nodes);
+    cout << "\n";
+    snprintf(line, sizeof(line), "%7s  %-16s %10s  %-28s %-16s %7s", "PID", "COMM", "RSS(MB)", "MEMÓRIA POR NÓ (MB)",
+             "THREADS POR NÓ", "LOCAL%");
+    cout << line << "\n";
+    int status = 0;
+    for (int pid : pids) {
+        ProcessNuma numa;
+        if (get_process_numa(pid, cpu_nodes, numa) < 0) {
+            status = 1;
+            continue;
+        }
+        auto meta = process_meta_cache().get(pid);
+        string comm = meta ? meta->comm : "";
+
+        string memory, threads;
+        for (size_t n = 0; n < numa.resident_kb.size(); n++) {
+            if (numa.resident_kb[n] == 0) continue;
+            char part[32];
+            snprintf(part, sizeof(part), "%sN%zu=%.1f", memory.empty() ? "" : " ", n, numa.resident_kb[n] / 1024.0);
+            memory += part;
+        }
+        for (size_t n = 0; n < numa.threads.size(); n++) {
+            if (numa.threads[n] == 0) continue;
+            threads += (threads.empty() ? "N" : " N") + to_string(n) + "=" + to_string(numa.threads[n]);
+        }
+        snprintf(line, sizeof(line), "%7d  %-16.16s %10.1f  %-28s %-16s %7.1f%s", pid, comm.c_str(),
+                 numa.total_kb() / 1024.0, memory.empty() ? "-" : memory.c_str(), threads.empty() ? "-" : threads.c_str(),
+                 numa.local_ratio * 100.0, numa.misplaced ? "  REMOTA" : "");
+        cout << line << "\n";
+    }
+    cout << flush;
+    return status;
+}
+
+// ================================
+// SUBCOMANDO: bench
+// ================================
+
+// Executa bin/bench_collectors (mesmo diretório deste executável) com os argumentos restantes
+static int cmd_bench(int argc, char* argv[], int first_arg) {
+    char exe[PATH_MAX];
+    ssize_t len = readlink("/proc/self/exe", exe, sizeof(exe) - 1);
+    if (len <= 0) {
+        cerr << "Erro: não foi possível localizar o executável atual" << endl;
+        return 1;
+    }
+    exe[len] = '\0';
+    string bench_path = fs::path(exe).parent_path() / "bench_collectors";
+
+    vector<char*> bench_argv;
+    bench_argv.push_back(const_cast<char*>(bench_path.c_str()));
+    for (int i = first_arg; i < argc; i++) {
+        bench_argv.push_back(argv[i]);
+    }
+    bench_argv.push_back(nullptr);
+
+    execv(bench_path.c_str(), bench_argv.data());
+    cerr << "Erro: não foi possível executar " << bench_path << " - " << strerror(errno)
+         << " (compile com 'make experiments')" << endl;
+    return 1;
+}
+
+// ================================
+// MODO DAEMON
+// ================================
+
+// Lê arquivo de configuração "chave=valor" (linhas com # são comentários)
+//   pids=1234,5678          (substitui os --pid; sem a chave eles são mantidos)
+//   cgroup=/system.slice/nginx.service
+//   interval_ms=1000
+//   output=/var/log/ra3/monitor.csv
+//   network=0
+//   events=/var/log/ra3/anomalies.jsonl
+//   record=/var/log/ra3/session.ra3
+//   host_output=/var/log/ra3/host.csv  (memória do host, como --host-output)
+//   numa_interval=30        (posicionamento NUMA a cada N ciclos, como --numa-interval)
+//   cpu_allowed=1           (CPU% pelos núcleos permitidos, como --cpu-allowed)
+//   batch_reads=1           (leitura em lote via io_uring, como --batch-reads)
+//   adaptive=1              (min_interval_ms, max_interval_ms, adapt_cpu,
+//                            adapt_rss e adapt_io como as opções --adapt-*)
+// Retorno: false se o arquivo não pôde ser lido ou tem valores inválidos
+static bool load_daemon_config(const string& config_file, ProfileOptions& opts) {
+    ifstream file(config_file);
+    if (!file.is_open()) {
+        cerr << "Erro: Não foi possível abrir configuração " << config_file << " - " << strerror(errno) << endl;
+        return false;
+    }
+
+    ProfileOptions loaded = opts;
+    bool has_pids = false;  // Sem "pids=" mantém os PIDs atuais (linha de comando)
+    string line;
+    int line_no = 0;
+    while (getline(file, line)) {
+        line_no++;
+        size_t hash = line.find('#');
+        if (hash != string::npos) line.erase(hash);
+        line.erase(0, line.find_first_not_of(" \t"));
+        line.erase(line.find_last_not_of(" \t\r") + 1);
+        if (line.empty()) continue;
+
+        size_t eq = line.find('=');
+        if (eq == string::npos) {
+            cerr << config_file << ":" << line_no << ": linha inválida: " << line << endl;
+            return false;
+        }
+        string key = line.substr(0, eq);
+        string value = line.substr(eq + 1);
+
+        if (key == "pids") {
+            if (!has_pids) loaded.pids.clear();
+            has_pids = true;
+            if (!parse_pid_list(value, loaded.pids)) return false;
+        } else if (key == "cgroup") {
+            loaded.cgroup = normalize_cgroup(value);
+        } else if (key == "interval_ms") {
+            loaded.interval_ms = atoi(value.c_str());
+            if (loaded.interval_ms <= 0) {
+                cerr << config_file << ":" << line_no << ": interval_ms inválido" << endl;
+                return false;
+            }
+        } else if (key == "output") {
+            loaded.output = value;
+        } else if (key == "events") {
+            loaded.events = value;
+        } else if (key == "record") {
+            loaded.record = value;
+        } else if (key == "host_output") {
+            loaded.host_output = value;
+        } else if (key == "network") {
+            loaded.include_network = (value == "1" || value == "true");
+        } else if (key == "adaptive") {
+            loaded.adaptive = (value == "1" || value == "true");
+        } else if (key == "cpu_allowed") {
+            loaded.cpu_allowed = (value == "1" || value == "true");
+        } else if (key == "batch_reads") {
+            loaded.batch_reads = (value == "1" || value == "true");
+        } else if (key == "min_interval_ms" || key == "max_interval_ms") {
+            int parsed = atoi(value.c_str());
+            if (parsed <= 0) {
+                cerr << config_file << ":" << line_no << ": " << key << " inválido" << endl;
+                return false;
+            }
+            (key == "min_interval_ms" ? loaded.min_interval_ms : loaded.max_interval_ms) = parsed;
+        } else if (key == "adapt_cpu" || key == "adapt_rss" || key == "adapt_io") {
+            char* end = nullptr;
+            double parsed = strtod(value.c_str(), &end);
+            if (*end != '\0' || !(parsed >= 0)) {
+                cerr << config_file << ":" << line_no << ": " << key << " inválido" << endl;
+                return false;
+            }
+            if (key == "adapt_cpu") loaded.adapt_cpu = parsed;
+            else if (key == "adapt_rss") loaded.adapt_rss = parsed;
+            else loaded.adapt_io = parsed;
+        } else if (key == "pss_interval" || key == "numa_interval") {
+            int parsed = atoi(value.c_str());
+            if (parsed < 0) {
+                cerr << config_file << ":" << line_no << ": " << key << " inválido" << endl;
+                return false;
+            }
+            (key == "pss_interval" ? loaded.pss_interval : loaded.numa_interval) = parsed;
+        } else {
+            cerr << config_file << ":" << line_no << ": chave desconhecida ignorada: " << key << endl;
+        }
+    }
+
+    opts = loaded;
+    return true;
+}
+
+static int run_daemon(const CliArgs& args) {
+    ProfileOptions opts;
+    opts.quiet = true;
+    if (!profile_options_from_args(args, opts)) {
+        return 2;
+    }
+
+    string config_file = args.options.count("config") ? args.options.at("config") : "";
+    if (!config_file.empty() && !load_daemon_config(config_file, opts)) {
+        return 1;
+    }
+    opts.duration_sec = 0;  // Daemon roda até SIGINT/SIGTERM
+
+    install_signal_handlers(true);
+    MetricsEndpoint metrics;
+    bool metrics_enabled = args.options.count("metrics") > 0;
+    if (metrics_enabled) {
+        if (!metrics.start(args.options.at("metrics"))) return 1;
+        metrics.attach(opts);
+    }
+
+    cerr << "resource-monitor daemon iniciado (PID " << getpid() << ", intervalo "
+         << opts.interval_ms << "ms, saída " << opts.output << ")" << endl;
+
+    ResourceProfiler profiler;
+    int status = 0;
+    while (monitoring_active) {
+        if (!profiler.profileProcesses(opts, &reload_requested)) {
+            status = 1;
+            break;
+        }
+        if (!reload_requested) {
+            break;  // Parada por sinal ou todos os processos terminaram
+        }
+
+        // SIGHUP: relê configuração (mantém a anterior se inválida) e reabre a saída
+        reload_requested = false;
+        if (!config_file.empty()) {
+            if (load_daemon_config(config_file, opts)) {
+                cerr << "SIGHUP: configuração recarregada de " << config_file << endl;
+            } else {
+                cerr << "SIGHUP: configuração inválida, mantendo a anterior" << endl;
+            }
+        } else {
+            cerr << "SIGHUP: reabrindo saída " << opts.output << endl;
+        }
+        if (metrics_enabled) {
+            metrics.attach(opts);  // O cgroup pode ter mudado na recarga
+        }
+    }
+
+    cerr << "resource-monitor daemon encerrado" << endl;
+    return status;
+}
+
+// ================================
+// DESPACHO
+// ================================
+
+int run_cli(int argc, char* argv[]) {
+    // bench repassa todos os argumentos seguintes sem interpretá-los
+    for (int i = 1; i < argc; i++) {
+        if (string(argv[i]) == "bench") {
+            return cmd_bench(argc, argv, i + 1);
+        }
+        if (string(argv[i]).rfind("--", 0) != 0) break;
+        if (string(argv[i]) == "--root") i++;
+    }
+
+    CliArgs args;
+    if (!parse_args(argc, argv, args)) {
+        return 2;
+    }
+    if (args.flags.count("help") || (args.positional.empty() && !args.flags.count("daemon"))) {
+        print_usage(argv[0]);
+        return args.flags.count("help") ? 0 : 2;
+    }
+
+    auto root = args.options.find("root");
+    if (root != args.options.end()) {
+        set_fs_root(root->second);
+    }
+
+    if (args.flags.count("daemon")) {
+        return run_daemon(args);
+    }
+
+    const string& cmd = args.positional[0];
+    string sub = args.positional.size() > 1 ? args.positional[1] : "";
+
+    if (cmd == "profile") {
+        return cmd_profile(args);
+    }
+    if (cmd == "replay") {
+        return cmd_replay(args);
+    }
+    if (cmd == "query") {
+        return cmd_query(args);
+    }
+    if (cmd == "ns" && sub == "scan") {
+        return cmd_ns_scan(args);
+    }
+    if (cmd == "cgroup" && sub == "top") {
+        return cmd_cgroup_top(args);
+    }
+    if (cmd == "top") {
+        return cmd_top(args);
+    }
+    if (cmd == "threads") {
+        return cmd_threads(args);
+    }
+    if (cmd == "tree") {
+        return cmd_tree(args);
+    }
+    if (cmd == "exits") {
+        return cmd_exits(args);
+    }
+    if (cmd == "net") {
+        return cmd_net(args);
+    }
+    if (cmd == "disk") {
+        return cmd_disk(args);
+    }
+    if (cmd == "cpu") {
+        return cmd_cpu(args);
+    }
+    if (cmd == "numa") {
+        return cmd_numa(args);
+    }
+
+    cerr << "Erro: subcomando desconhecido: " << cmd << (sub.empty() ? "" : " " + sub) << endl;
+    print_usage(argv[0]);
+    return 2;
+}
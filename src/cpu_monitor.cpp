@@ -7,6 +7,7 @@
 #include <cstring>
 #include <thread>
 #include "../include/monitor.hpp"
+#include "../include/procfs.hpp"
 
 // Códigos de erro semânticos
 #define ERR_PROCESS_NOT_FOUND -2
@@ -15,7 +16,7 @@
 
 // Lê dados de CPU de um PID específico
 int get_cpu_usage(int pid, ProcStats& stats) {
-    std::string path = "/proc/" + std::to_string(pid) + "/stat";
+    std::string path = proc_pid_path(pid, "stat");
     std::ifstream file(path);
     if (!file.is_open()) {
         if (errno == ENOENT) {
@@ -32,16 +33,30 @@ int get_cpu_usage(int pid, ProcStats& stats) {
 
     std::string token;
     long utime = 0, stime = 0, cutime = 0, cstime = 0;
+    long long start_time = -1;
 
-    // Pula até o campo 14
-    for (int i = 0; i < 13; ++i)
-        file >> token;
-
-    file >> utime >> stime >> cutime >> cstime;
+    // O comm (campo 2) pode conter espaços: os campos são contados a
+    // partir do último ')'
+    std::string stat_line;
+    std::getline(file, stat_line);
     file.close();
+    size_t comm_end = stat_line.rfind(')');
+    if (comm_end != std::string::npos) {
+        std::istringstream fields(stat_line.substr(comm_end + 1));
+
+        // Pula os campos 3 a 13
+        for (int i = 0; i < 11; ++i)
+            fields >> token;
+        fields >> utime >> stime >> cutime >> cstime;
+
+        // Pula priority, nice, num_threads e itrealvalue até o campo 22
+        for (int i = 0; i < 4; ++i)
+            fields >> token;
+        fields >> start_time;
+    }
 
     // Lê contexto e threads
-    path = "/proc/" + std::to_string(pid) + "/status";
+    path = proc_pid_path(pid, "status");
     std::ifstream status_file(path);
     if (!status_file.is_open()) {
         if (errno == ENOENT) {
@@ -73,9 +88,12 @@ int get_cpu_usage(int pid, ProcStats& stats) {
 
     stats.utime = utime;
     stats.stime = stime;
+    stats.cutime = cutime;
+    stats.cstime = cstime;
     stats.threads = threads;
     stats.voluntary_ctxt = voluntary_ctxt;
     stats.nonvoluntary_ctxt = nonvoluntary_ctxt;
+    stats.start_time = start_time;
 
     return 0;
 }
@@ -88,13 +106,16 @@ unsigned int get_num_cores() {
 
 // Calcula o percentual de uso da CPU entre duas leituras (normalizado por núcleos)
 double calculate_cpu_percent(const ProcStats& prev, const ProcStats& curr, double interval) {
-    const long ticks_per_sec = sysconf(_SC_CLK_TCK);
+    return calculate_cpu_percent(prev, curr, interval, sysconf(_SC_CLK_TCK), get_num_cores());
+}
+
+double calculate_cpu_percent(const ProcStats& prev, const ProcStats& curr, double interval,
+                             long ticks_per_sec, double cores) {
     double delta_time = ((curr.utime + curr.stime) - (prev.utime + prev.stime)) / static_cast<double>(ticks_per_sec);
     double percent = (delta_time / interval) * 100.0;
     
     // Normalização por número de núcleos
-    unsigned int num_cores = get_num_cores();
-    double normalized_percent = percent / num_cores;
+    double normalized_percent = percent / (cores > 0 ? cores : 1);
     
     return normalized_percent < 0 ? 0 : normalized_percent;
-}
\ No newline at end of file
+}
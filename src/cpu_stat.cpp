@@ -0,0 +1,301 @@
+// ============================================================
+// ARQUIVO: src/cpu_stat.cpp
+// DESCRIÇÃO: Implementação da utilização de CPU do sistema
+// ============================================================
+
+#include "../include/cpu_stat.hpp"
+#include "../include/monitor.hpp"
+#include "../include/procfs.hpp"
+#include <algorithm>
+#include <fstream>
+#include <cstring>
+#include <cstdlib>
+#include <unistd.h>
+#include <fcntl.h>
+
+CpuUtilization CpuColumns::at(size_t i) const {
+    CpuUtilization u;
+    u.user = user[i];
+    u.system = system[i];
+    u.iowait = iowait[i];
+    u.irq = irq[i];
+    u.softirq = softirq[i];
+    u.steal = steal[i];
+    u.idle = idle[i];
+    return u;
+}
+
+SystemCpuStat::SystemCpuStat() : stat_fd(-1), current(0), has_prev(false) {
+    // Capacidade inicial: núcleos configurados; cresce se aparecerem mais
+    // linhas (hotplug)
+    long configured = sysconf(_SC_NPROCESSORS_CONF);
+    reserve(static_cast<size_t>(std::max(configured, 1L)));
+    // ~100 bytes por linha cpuN, mais as linhas finais (intr pode ser longa)
+    buffer.resize(16384 + 128 * counters[0].cpu.size());
+}
+
+SystemCpuStat::~SystemCpuStat() {
+    if (stat_fd >= 0) {
+        close(stat_fd);
+    }
+}
+
+void SystemCpuStat::reserve(size_t cores) {
+    if (cores <= counters[0].cpu.size()) {
+        return;
+    }
+    cores = std::max(cores, counters[0].cpu.size() * 2);
+    for (Counters& c : counters) {
+        for (auto& column : c.field) column.resize(cores, 0.0);
+        c.cpu.resize(cores, -1);
+    }
+    for (auto& column : delta) column.resize(cores, 0.0);
+    total.resize(cores, 0.0);
+}
+
+// Lê /proc/stat inteiro para 'buffer' (terminado em '\0')
+bool SystemCpuStat::read_file() {
+    if (stat_fd < 0) {
+        stat_fd = open(proc_path("stat").c_str(), O_RDONLY | O_CLOEXEC);
+        if (stat_fd < 0) {
+            return false;
+        }
+    }
+    while (true) {
+        ssize_t n = pread(stat_fd, buffer.data(), buffer.size() - 1, 0);
+        if (n < 0) {
+            return false;
+        }
+        if (static_cast<size_t>(n) < buffer.size() - 1) {
+            buffer[n] = '\0';
+            return true;
+        }
+        buffer.resize(buffer.size() * 2);   // Não coube: relê com o dobro
+    }
+}
+
+// Lê os campos de tempo de uma linha "cpu" a partir de p
+// Campos ausentes (kernels antigos sem steal) ficam em zero
+template <typename Store>
+static const char* parse_times(const char* p, Store store) {
+    for (int f = 0; f < 8; f++) {
+        while (*p == ' ') p++;
+        unsigned long long value = 0;
+        while (*p >= '0' && *p <= '9') value = value * 10 + (*p++ - '0');
+        store(f, static_cast<double>(value));
+    }
+    return p;
+}
+
+// Uma passada pelas linhas "cpu" (as primeiras do arquivo) para as colunas
+bool SystemCpuStat::parse(Counters& out) {
+    const char* p = buffer.data();
+    if (strncmp(p, "cpu ", 4) != 0) {
+        return false;
+    }
+    p = parse_times(p + 4, [&](int f, double value) { out.aggregate[f] = value; });
+
+    size_t core = 0;
+    while ((p = strchr(p, '\n')) && p[1] == 'c' && p[2] == 'p' && p[3] == 'u') {
+        p += 4;
+        int cpu = 0;
+        while (*p >= '0' && *p <= '9') cpu = cpu * 10 + (*p++ - '0');
+        reserve(core + 1);
+        out.cpu[core] = cpu;
+        p = parse_times(p, [&](int f, double value) { out.field[f][core] = value; });
+        core++;
+    }
+    out.cores = core;
+    return true;
+}
+
+int SystemCpuStat::sample() {
+    if (!read_file()) {
+        return -1;
+    }
+    Counters& curr = counters[current];
+    Counters& prev = counters[current ^ 1];
+    if (!parse(curr)) {
+        return -1;
+    }
+    current ^= 1;
+
+    // Núcleos online mudaram (hotplug): os índices não correspondem mais
+    size_t cores = curr.cores;
+    bool comparable = has_prev && prev.cores == cores &&
+                      std::equal(curr.cpu.begin(), curr.cpu.begin() + cores, prev.cpu.begin());
+    has_prev = true;
+    cols.cpu.assign(curr.cpu.begin(), curr.cpu.begin() + (comparable ? cores : 0));
+    if (!comparable) {
+        aggregate = CpuUtilization();
+        return 0;
+    }
+
+    for (auto* column : {&cols.user, &cols.system, &cols.iowait, &cols.irq, &cols.softirq, &cols.steal, &cols.idle}) {
+        column->resize(cores);
+    }
+
+    // Deltas por campo (iowait pode recuar entre leituras: limita em zero)
+    for (int f = 0; f < FIELDS; f++) {
+        const double* __restrict c = curr.field[f].data();
+        const double* __restrict o = prev.field[f].data();
+        double* __restrict d = delta[f].data();
+        for (size_t i = 0; i < cores; i++) {
+            double diff = c[i] - o[i];
+            d[i] = diff > 0.0 ? diff : 0.0;
+        }
+    }
+
+    // Escala para percentual: 100 / ticks totais do núcleo no intervalo.
+    // Os ticks são inteiros: somar um valor ínfimo evita a divisão por zero
+    // sem desvio no laço (intervalo sem ticks: deltas e percentuais zero)
+    double* __restrict scale = total.data();
+    for (size_t i = 0; i < cores; i++) {
+        scale[i] = delta[USER][i];
+    }
+    for (int f = NICE; f < FIELDS; f++) {
+        const double* __restrict d = delta[f].data();
+        for (size_t i = 0; i < cores; i++) {
+            scale[i] += d[i];
+        }
+    }
+    for (size_t i = 0; i < cores; i++) {
+        scale[i] = 100.0 / (scale[i] + 1e-9);
+    }
+
+    auto percent = [&](std::vector<double>& out, Field a, Field b) {
+        const double* __restrict da = delta[a].data();
+        const double* __restrict db = delta[b].data();
+        double* __restrict o = out.data();
+        if (a == b) {
+            for (size_t i = 0; i < cores; i++) o[i] = da[i] * scale[i];
+        } else {
+            for (size_t i = 0; i < cores; i++) o[i] = (da[i] + db[i]) * scale[i];
+        }
+    };
+    percent(cols.user, USER, NICE);
+    percent(cols.system, SYSTEM, SYSTEM);
+    percent(cols.iowait, IOWAIT, IOWAIT);
+    percent(cols.irq, IRQ, IRQ);
+    percent(cols.softirq, SOFTIRQ, SOFTIRQ);
+    percent(cols.steal, STEAL, STEAL);
+    percent(cols.idle, IDLE, IDLE);
+
+    // Agregado: mesma conta sobre a linha "cpu"
+    double d[FIELDS];
+    double sum = 0.0;
+    for (int f = 0; f < FIELDS; f++) {
+        d[f] = std::max(curr.aggregate[f] - prev.aggregate[f], 0.0);
+        sum += d[f];
+    }
+    double s = 100.0 / std::max(sum, 1.0);
+    aggregate.user = (d[USER] + d[NICE]) * s;
+    aggregate.system = d[SYSTEM] * s;
+    aggregate.iowait = d[IOWAIT] * s;
+    aggregate.irq = d[IRQ] * s;
+    aggregate.softirq = d[SOFTIRQ] * s;
+    aggregate.steal = d[STEAL] * s;
+    aggregate.idle = d[IDLE] * s;
+    return static_cast<int>(cores);
+}
+
+std::vector<int> parse_cpu_list(const std::string& list) {
+    std::vector<int> cpus;
+    const char* p = list.c_str();
+    while (*p) {
+        char* end;
+        long first = strtol(p, &end, 10);
+        if (end == p) break;
+        long last = first;
+        p = end;
+        if (*p == '-') {
+            last = strtol(p + 1, &end, 10);
+            p = end;
+        }
+        for (long cpu = first; cpu <= last; cpu++) cpus.push_back(static_cast<int>(cpu));
+        if (*p == ',') p++;
+        else break;
+    }
+    return cpus;
+}
+
+// Primeira linha de um arquivo de controle do cgroup
+static bool read_cgroup_line(const std::string& path, std::string& line) {
+    std::ifstream file(path);
+    return file.is_open() && std::getline(file, line);
+}
+
+// Menor cota (em núcleos) entre o cgroup e seus ancestrais; 0 = sem cota
+// v1: a hierarquia do controlador cpu fica em <cgroupfs>/cpu
+static double cgroup_cpu_quota(const std::string& path, bool v1) {
+    std::string dir = path;
+    double quota = 0.0;
+    while (true) {
+        std::string base = cgroup_root() + (v1 ? "/cpu" : "") + (dir == "/" ? "" : dir);
+        std::string line;
+        double cores = 0.0;
+        if (v1) {
+            std::string period_line;
+            if (read_cgroup_line(base + "/cpu.cfs_quota_us", line) &&
+                read_cgroup_line(base + "/cpu.cfs_period_us", period_line)) {
+                long q = atol(line.c_str());
+                long period = atol(period_line.c_str());
+                if (q > 0 && period > 0) cores = static_cast<double>(q) / period;
+            }
+        } else if (read_cgroup_line(base + "/cpu.max", line)) {
+            // "max 100000" (sem cota) ou "50000 100000"
+            if (line.compare(0, 3, "max") != 0) {
+                long q = atol(line.c_str());
+                size_t space = line.find(' ');
+                long period = space != std::string::npos ? atol(line.c_str() + space + 1) : 100000;
+                if (q > 0 && period > 0) cores = static_cast<double>(q) / period;
+            }
+        }
+        if (cores > 0.0 && (quota == 0.0 || cores < quota)) {
+            quota = cores;
+        }
+        if (dir.empty() || dir == "/") break;
+        size_t slash = dir.rfind('/');
+        dir = slash == 0 || slash == std::string::npos ? "/" : dir.substr(0, slash);
+    }
+    return quota;
+}
+
+double process_cpu_capacity(int pid) {
+    std::ifstream status(proc_pid_path(pid, "status"));
+    if (!status.is_open()) {
+        return 0.0;
+    }
+    std::string line;
+    double capacity = get_num_cores();
+    while (std::getline(status, line)) {
+        if (line.rfind("Cpus_allowed_list:", 0) == 0) {
+            size_t start = line.find_first_not_of(" \t", 18);
+            int allowed = start != std::string::npos ? static_cast<int>(parse_cpu_list(line.substr(start)).size()) : 0;
+            if (allowed > 0) capacity = allowed;
+            break;
+        }
+    }
+
+    // Cgroup do controlador cpu: linha "N:cpu,cpuacct:/caminho" no v1
+    // (tem precedência em hierarquias híbridas) ou "0::/caminho" no v2
+    std::ifstream cgroup(proc_pid_path(pid, "cgroup"));
+    std::string v1_path, v2_path;
+    while (std::getline(cgroup, line)) {
+        size_t first = line.find(':');
+        size_t second = first != std::string::npos ? line.find(':', first + 1) : std::string::npos;
+        if (second == std::string::npos) continue;
+        std::string controllers = "," + line.substr(first + 1, second - first - 1) + ",";
+        if (controllers == ",,") {
+            v2_path = line.substr(second + 1);
+        } else if (controllers.find(",cpu,") != std::string::npos) {
+            v1_path = line.substr(second + 1);
+        }
+    }
+    double quota = !v1_path.empty() ? cgroup_cpu_quota(v1_path, true)
+                 : !v2_path.empty() ? cgroup_cpu_quota(v2_path, false) : 0.0;
+    if (quota > 0.0 && quota < capacity) {
+        capacity = quota;
+    }
+    return capacity;
+}
@@ -0,0 +1,257 @@
+// ============================================================
+// ARQUIVO: src/disk_stat.cpp
+// DESCRIÇÃO: Implementação do coletor de /proc/diskstats e do
+// diagnóstico de I/O por cgroup
+// ============================================================
+
+#include "../include/disk_stat.hpp"
+#include "../include/procfs.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <unistd.h>
+#include <fcntl.h>
+
+// Campos após o nome (kernel 5.5+: 17; kernels antigos: 11, 14 ou 15)
+static const int DISKSTATS_FIELDS = 11;
+
+static uint64_t device_key(unsigned int major, unsigned int minor) {
+    return (static_cast<uint64_t>(major) << 32) | minor;
+}
+
+DiskStat::DiskStat(bool include_all)
+    : buffer(8192), include_all(include_all), generation(0), last_elapsed(0.0) {
+    fd = open(proc_path("diskstats").c_str(), O_RDONLY | O_CLOEXEC);
+}
+
+DiskStat::~DiskStat() {
+    if (fd >= 0) close(fd);
+}
+
+// Atualiza os contadores de um dispositivo e deriva as taxas do ciclo
+// Campos: 0 leituras, 2 setores lidos, 3 ms lendo, 4 escritas,
+// 6 setores escritos, 7 ms escrevendo, 8 em voo, 9 io_ticks, 10 ponderado
+void DiskStat::update(Entry& entry, const uint64_t* fields, double elapsed) {
+    DiskDevice& dev = entry.device;
+    DiskDevice prev = dev;
+
+    dev.reads = fields[0];
+    dev.read_sectors = fields[2];
+    dev.read_ms = fields[3];
+    dev.writes = fields[4];
+    dev.write_sectors = fields[6];
+    dev.write_ms = fields[7];
+    dev.in_flight = fields[8];
+    dev.io_ms = fields[9];
+    dev.weighted_ms = fields[10];
+
+    dev.read_iops = dev.write_iops = dev.read_bps = dev.write_bps = 0;
+    dev.read_await = dev.write_await = dev.utilization = dev.queue_depth = 0;
+
+    // Contador menor que o anterior = dispositivo recriado (mesmo número)
+    bool rates = entry.has_prev && elapsed > 0 &&
+                 dev.reads >= prev.reads && dev.writes >= prev.writes &&
+                 dev.read_sectors >= prev.read_sectors && dev.write_sectors >= prev.write_sectors &&
+                 dev.read_ms >= prev.read_ms && dev.write_ms >= prev.write_ms &&
+                 dev.io_ms >= prev.io_ms && dev.weighted_ms >= prev.weighted_ms;
+    entry.has_prev = true;
+    if (!rates) return;
+
+    uint64_t reads = dev.reads - prev.reads;
+    uint64_t writes = dev.writes - prev.writes;
+    double elapsed_ms = elapsed * 1000.0;
+
+    dev.read_iops = reads / elapsed;
+    dev.write_iops = writes / elapsed;
+    dev.read_bps = (dev.read_sectors - prev.read_sectors) * 512.0 / elapsed;
+    dev.write_bps = (dev.write_sectors - prev.write_sectors) * 512.0 / elapsed;
+    dev.read_await = reads > 0 ? static_cast<double>(dev.read_ms - prev.read_ms) / reads : 0.0;
+    dev.write_await = writes > 0 ? static_cast<double>(dev.write_ms - prev.write_ms) / writes : 0.0;
+    dev.utilization = std::min(100.0, (dev.io_ms - prev.io_ms) / elapsed_ms * 100.0);
+    dev.queue_depth = (dev.weighted_ms - prev.weighted_ms) / elapsed_ms;
+}
+
+bool DiskStat::sample() {
+    if (fd < 0) {
+        return false;
+    }
+    ssize_t n;
+    while ((n = pread(fd, buffer.data(), buffer.size() - 1, 0)) == static_cast<ssize_t>(buffer.size() - 1)) {
+        buffer.resize(buffer.size() * 2);  // Muitos dispositivos: lê de novo com buffer maior
+    }
+    if (n <= 0) {
+        return false;
+    }
+    buffer[n] = '\0';
+
+    auto now = std::chrono::steady_clock::now();
+    last_elapsed = generation > 0 ? std::chrono::duration<double>(now - prev_time).count() : 0.0;
+    prev_time = now;
+    generation++;
+
+    for (auto& entry : entries) {
+        entry.second.seen = false;
+    }
+
+    // Formato: "MAJ MIN nome campo1 ... campoN", uma linha por dispositivo
+    char* p = buffer.data();
+    while (*p) {
+        char* end = p;
+        unsigned long major = strtoul(p, &end, 10);
+        unsigned long minor = strtoul(end, &end, 10);
+        while (*end == ' ') end++;
+        char* name = end;
+        while (*end && *end != ' ' && *end != '\n') end++;
+        std::string dev_name(name, end);
+
+        uint64_t fields[DISKSTATS_FIELDS] = {};
+        int count = 0;
+        while (*end && *end != '\n' && count < DISKSTATS_FIELDS) {
+            char* next;
+            fields[count] = strtoull(end, &next, 10);
+            if (next == end) break;
+            end = next;
+            count++;
+        }
+        while (*end && *end != '\n') end++;
+        p = *end ? end + 1 : end;
+        if (count < DISKSTATS_FIELDS || dev_name.empty()) continue;
+
+        Entry& entry = entries[device_key(major, minor)];
+        if (!entry.seen && entry.device.name != dev_name) {
+            // Dispositivo novo: disco inteiro tem /sys/block/<nome> ("/" vira "!")
+            entry = Entry();
+            entry.device.major = major;
+            entry.device.minor = minor;
+            entry.device.name = dev_name;
+            std::string sys_name = dev_name;
+            std::replace(sys_name.begin(), sys_name.end(), '/', '!');
+            entry.device.whole_disk = access(sys_path("block/" + sys_name).c_str(), F_OK) == 0;
+        }
+        entry.seen = true;
+        update(entry, fields, last_elapsed);
+    }
+
+    order.clear();
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (!it->second.seen) {
+            it = entries.erase(it);
+            continue;
+        }
+        const DiskDevice& dev = it->second.device;
+        if (include_all || (dev.whole_disk && dev.reads + dev.writes > 0)) {
+            order.push_back(&dev);
+        }
+        ++it;
+    }
+    std::sort(order.begin(), order.end(), [](const DiskDevice* a, const DiskDevice* b) {
+        if (a->utilization != b->utilization) return a->utilization > b->utilization;
+        return a->name < b->name;
+    });
+    return true;
+}
+
+const DiskDevice* DiskStat::find(unsigned int major, unsigned int minor) const {
+    auto it = entries.find(device_key(major, minor));
+    return it != entries.end() ? &it->second.device : nullptr;
+}
+
+const char* io_verdict_name(IoVerdict verdict) {
+    switch (verdict) {
+        case IoVerdict::IDLE: return "ocioso";
+        case IoVerdict::OK: return "ok";
+        case IoVerdict::THROTTLED: return "LIMITADO";
+        case IoVerdict::SATURATED: return "SATURADO";
+        case IoVerdict::CONTENDED: return "ESPERA";
+    }
+    return "?";
+}
+
+CgroupDiskMonitor::CgroupDiskMonitor(const std::string& cgroup_path)
+    : cgroup(cgroup_path), prev(), has_prev(false), some_percent(0.0), full_percent(0.0) {}
+
+// % do intervalo em que a linha PSI acumulou espera (total em µs)
+static double stall_percent(const PressureStats& now, const PressureStats& before, double elapsed) {
+    if (elapsed <= 0 || now.total < before.total) return 0.0;
+    return std::min(100.0, (now.total - before.total) / (elapsed * 1e6) * 100.0);
+}
+
+bool CgroupDiskMonitor::sample(const DiskStat& disks) {
+    CGroupIOSnapshot snapshot = manager.read_io_snapshot(cgroup);
+    auto now = std::chrono::steady_clock::now();
+    rows.clear();
+    some_percent = full_percent = 0.0;
+    if (!snapshot.valid) {
+        has_prev = false;
+        return false;
+    }
+
+    double elapsed = has_prev ? std::chrono::duration<double>(now - prev_time).count() : 0.0;
+    // Troca de origem (io.pressure do cgroup <-> sistema) invalida o delta
+    if (has_prev && snapshot.cgroup_pressure == prev.cgroup_pressure) {
+        some_percent = stall_percent(snapshot.pressure_some, prev.pressure_some, elapsed);
+        full_percent = stall_percent(snapshot.pressure_full, prev.pressure_full, elapsed);
+    }
+
+    for (const CGroupDeviceIO& io : snapshot.devices) {
+        CgroupDiskIO row;
+        row.major = io.major;
+        row.minor = io.minor;
+        const DiskDevice* disk = disks.find(io.major, io.minor);
+        row.device = disk ? disk->name : std::to_string(io.major) + ":" + std::to_string(io.minor);
+
+        if (elapsed > 0) {
+            for (const CGroupDeviceIO& before : prev.devices) {
+                if (before.major != io.major || before.minor != io.minor) continue;
+                if (io.rbytes >= before.rbytes && io.wbytes >= before.wbytes &&
+                    io.rios >= before.rios && io.wios >= before.wios) {
+                    row.read_bps = (io.rbytes - before.rbytes) / elapsed;
+                    row.write_bps = (io.wbytes - before.wbytes) / elapsed;
+                    row.read_iops = (io.rios - before.rios) / elapsed;
+                    row.write_iops = (io.wios - before.wios) / elapsed;
+                }
+                break;
+            }
+        }
+
+        // Limite com maior uso no ciclo (o primeiro configurado se nenhum foi usado)
+        struct Limit { const char* name; long long value; double rate; };
+        const Limit limits[] = {
+            {"rbps", io.rbps_max, row.read_bps}, {"wbps", io.wbps_max, row.write_bps},
+            {"riops", io.riops_max, row.read_iops}, {"wiops", io.wiops_max, row.write_iops},
+        };
+        row.limit_usage = -1.0;
+        for (const Limit& limit : limits) {
+            if (limit.value <= 0) continue;
+            double usage = limit.rate / limit.value * 100.0;
+            if (usage > row.limit_usage) {
+                row.limit_name = limit.name;
+                row.limit_value = limit.value;
+                row.limit_usage = usage;
+            }
+        }
+        if (row.limit_usage < 0) row.limit_usage = 0.0;
+
+        double cgroup_bps = row.read_bps + row.write_bps;
+        if (disk) {
+            row.device_utilization = disk->utilization;
+            double device_bps = disk->read_bps + disk->write_bps;
+            if (device_bps > 0) row.device_share = std::min(100.0, cgroup_bps / device_bps * 100.0);
+        }
+
+        // Limite primeiro: um cgroup no seu io.max espera pelo limite mesmo
+        // que o dispositivo esteja cheio por causa de outros
+        bool active = cgroup_bps > 0 || row.read_iops + row.write_iops > 0;
+        bool stalled = some_percent >= STALL_THRESHOLD;
+        if (!has_prev) row.verdict = IoVerdict::IDLE;
+        else if (row.limit_usage >= LIMIT_THRESHOLD) row.verdict = IoVerdict::THROTTLED;
+        else if ((active || stalled) && row.device_utilization >= SATURATION_THRESHOLD) row.verdict = IoVerdict::SATURATED;
+        else if (active && stalled) row.verdict = IoVerdict::CONTENDED;
+        else row.verdict = active ? IoVerdict::OK : IoVerdict::IDLE;
+        rows.push_back(std::move(row));
+    }
+
+    prev = std::move(snapshot);
+    prev_time = now;
+    has_prev = true;
+    return true;
+}
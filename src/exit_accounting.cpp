@@ -0,0 +1,367 @@
+// ============================================================
+// ARQUIVO: src/exit_accounting.cpp
+// DESCRIÇÃO: Implementação da contabilidade de processos encerrados
+// ============================================================
+
+#include "../include/exit_accounting.hpp"
+#include "../include/process_tree.hpp"
+#include "../include/process_meta.hpp"
+#include "../include/procfs.hpp"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/genetlink.h>
+#include <linux/taskstats.h>
+
+// Cabeçalhos de uma mensagem genetlink + atributos
+struct GenlRequest {
+    nlmsghdr header;
+    genlmsghdr genl;
+    char attrs[256];
+};
+
+// Percorre os atributos netlink de [data, data + len)
+template <typename Visit>
+static void for_each_attr(const char* data, size_t len, Visit visit) {
+    while (len >= NLA_HDRLEN) {
+        const nlattr* attr = reinterpret_cast<const nlattr*>(data);
+        if (attr->nla_len < NLA_HDRLEN || attr->nla_len > len) break;
+        visit(attr->nla_type & NLA_TYPE_MASK, data + NLA_HDRLEN, attr->nla_len - NLA_HDRLEN);
+        size_t step = NLA_ALIGN(attr->nla_len);
+        if (step >= len) break;
+        data += step;
+        len -= step;
+    }
+}
+
+// Converte a struct taskstats (de qualquer versão: campos que o kernel
+// não envia ficam zerados)
+static ExitRecord to_record(const char* data, size_t len) {
+    taskstats stats;
+    memset(&stats, 0, sizeof(stats));
+    memcpy(&stats, data, std::min(len, sizeof(stats)));
+
+    ExitRecord record;
+    record.pid = static_cast<int>(stats.ac_pid);
+    record.tgid = stats.ac_tgid != 0 ? static_cast<int>(stats.ac_tgid) : record.pid;    // Versão < 10
+    record.ppid = static_cast<int>(stats.ac_ppid);
+    record.uid = static_cast<int>(stats.ac_uid);
+    record.comm.assign(stats.ac_comm, strnlen(stats.ac_comm, sizeof(stats.ac_comm)));
+    record.btime = stats.ac_btime;
+    record.exit_code = stats.ac_exitcode;
+    record.utime_us = stats.ac_utime;
+    record.stime_us = stats.ac_stime;
+    record.read_bytes = stats.read_bytes;
+    record.write_bytes = stats.write_bytes;
+    record.minor_faults = stats.ac_minflt;
+    record.major_faults = stats.ac_majflt;
+    record.cpu_delay_ns = stats.cpu_delay_total;
+    record.blkio_delay_ns = stats.blkio_delay_total;
+    record.swapin_delay_ns = stats.swapin_delay_total;
+    return record;
+}
+
+// ================================
+// LISTENER
+// ================================
+
+TaskstatsListener::TaskstatsListener() : sock(-1), family_id(0), lost(0) {
+    // Uma saída gera ~400 bytes; rajadas de milhares cabem sem realocar
+    buffer.resize(65536);
+}
+
+TaskstatsListener::~TaskstatsListener() {
+    close();
+}
+
+bool TaskstatsListener::send_command(uint16_t type, uint8_t cmd, uint16_t attr, const void* data, size_t len) {
+    GenlRequest req;
+    memset(&req, 0, sizeof(req));
+    if (NLA_HDRLEN + len > sizeof(req.attrs)) {
+        return false;
+    }
+    req.header.nlmsg_type = type;
+    req.header.nlmsg_flags = NLM_F_REQUEST | NLM_F_ACK;
+    req.genl.cmd = cmd;
+    req.genl.version = type == GENL_ID_CTRL ? 1 : TASKSTATS_GENL_VERSION;
+
+    nlattr* nla = reinterpret_cast<nlattr*>(req.attrs);
+    nla->nla_type = attr;
+    nla->nla_len = static_cast<uint16_t>(NLA_HDRLEN + len);
+    memcpy(req.attrs + NLA_HDRLEN, data, len);
+    req.header.nlmsg_len = NLMSG_LENGTH(GENL_HDRLEN) + NLA_ALIGN(nla->nla_len);
+
+    sockaddr_nl kernel = {};
+    kernel.nl_family = AF_NETLINK;
+    ssize_t n = sendto(sock, &req, req.header.nlmsg_len, 0, reinterpret_cast<sockaddr*>(&kernel), sizeof(kernel));
+    return n == static_cast<ssize_t>(req.header.nlmsg_len);
+}
+
+// Espera a confirmação (NLMSG_ERROR) do último comando; a resposta de
+// CTRL_CMD_GETFAMILY chega antes e é tratada aqui também
+bool TaskstatsListener::wait_ack() {
+    for (int attempt = 0; attempt < 50; attempt++) {
+        ssize_t n = recv(sock, buffer.data(), buffer.size(), 0);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                usleep(2000);
+                continue;
+            }
+            return false;
+        }
+        size_t len = static_cast<size_t>(n);
+        for (const nlmsghdr* h = reinterpret_cast<const nlmsghdr*>(buffer.data()); NLMSG_OK(h, len);
+             h = NLMSG_NEXT(h, len)) {
+            if (h->nlmsg_type == NLMSG_ERROR) {
+                const nlmsgerr* err = static_cast<const nlmsgerr*>(NLMSG_DATA(h));
+                errno = -err->error;
+                return err->error == 0;
+            }
+            if (h->nlmsg_type == GENL_ID_CTRL) {
+                const char* attrs = static_cast<const char*>(NLMSG_DATA(h)) + GENL_HDRLEN;
+                for_each_attr(attrs, h->nlmsg_len - NLMSG_LENGTH(GENL_HDRLEN),
+                              [&](int type, const char* data, size_t size) {
+                    if (type == CTRL_ATTR_FAMILY_ID && size >= sizeof(uint16_t)) {
+                        memcpy(&family_id, data, sizeof(uint16_t));
+                    }
+                });
+            }
+        }
+    }
+    errno = ETIMEDOUT;
+    return false;
+}
+
+bool TaskstatsListener::resolve_family() {
+    return send_command(GENL_ID_CTRL, CTRL_CMD_GETFAMILY, CTRL_ATTR_FAMILY_NAME,
+                        TASKSTATS_GENL_NAME, sizeof(TASKSTATS_GENL_NAME)) &&
+           wait_ack() && family_id != 0;
+}
+
+bool TaskstatsListener::open() {
+    close();
+    sock = socket(AF_NETLINK, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_GENERIC);
+    if (sock < 0) {
+        std::cerr << "ERRO: Não foi possível abrir socket netlink - " << strerror(errno) << std::endl;
+        return false;
+    }
+    sockaddr_nl local = {};
+    local.nl_family = AF_NETLINK;
+    if (bind(sock, reinterpret_cast<sockaddr*>(&local), sizeof(local)) != 0) {
+        std::cerr << "ERRO: bind netlink - " << strerror(errno) << std::endl;
+        close();
+        return false;
+    }
+
+    // Rajadas de saídas (ex: make -j) estouram o buffer padrão; como root,
+    // SO_RCVBUFFORCE passa do limite net.core.rmem_max
+    int size = 8 * 1024 * 1024;
+    if (setsockopt(sock, SOL_SOCKET, SO_RCVBUFFORCE, &size, sizeof(size)) != 0) {
+        setsockopt(sock, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+    }
+
+    if (!resolve_family()) {
+        std::cerr << "ERRO: Família genetlink TASKSTATS indisponível (kernel sem CONFIG_TASKSTATS?)" << std::endl;
+        close();
+        return false;
+    }
+
+    // Todas as CPUs possíveis: saídas são entregues pela CPU em que ocorrem
+    std::ifstream possible(sys_path("devices/system/cpu/possible"));
+    if (!std::getline(possible, cpumask) || cpumask.empty()) {
+        long cpus = sysconf(_SC_NPROCESSORS_CONF);
+        cpumask = "0-" + std::to_string(cpus > 0 ? cpus - 1 : 0);
+    }
+    if (!send_command(family_id, TASKSTATS_CMD_GET, TASKSTATS_CMD_ATTR_REGISTER_CPUMASK,
+                      cpumask.c_str(), cpumask.size() + 1) || !wait_ack()) {
+        if (errno == EPERM || errno == EACCES) {
+            std::cerr << "ERRO: Permissão negada para registrar no taskstats (requer CAP_NET_ADMIN)" << std::endl;
+        } else {
+            std::cerr << "ERRO: Falha ao registrar CPUs " << cpumask << " no taskstats - " << strerror(errno) << std::endl;
+        }
+        cpumask.clear();
+        close();
+        return false;
+    }
+    return true;
+}
+
+void TaskstatsListener::close() {
+    if (sock < 0) {
+        return;
+    }
+    if (!cpumask.empty()) {
+        // O kernel também descarta o registro ao fechar, mas só no próximo envio
+        send_command(family_id, TASKSTATS_CMD_GET, TASKSTATS_CMD_ATTR_DEREGISTER_CPUMASK,
+                     cpumask.c_str(), cpumask.size() + 1);
+        cpumask.clear();
+    }
+    ::close(sock);
+    sock = -1;
+}
+
+size_t TaskstatsListener::drain(std::vector<ExitRecord>& out) {
+    size_t count = 0;
+    while (sock >= 0) {
+        ssize_t n = recv(sock, buffer.data(), buffer.size(), 0);
+        if (n < 0) {
+            if (errno == ENOBUFS) {
+                lost++;         // Registros descartados pelo kernel; o socket continua
+                continue;
+            }
+            if (errno == EINTR) continue;
+            break;              // EAGAIN: nada pendente
+        }
+        size_t len = static_cast<size_t>(n);
+        for (const nlmsghdr* h = reinterpret_cast<const nlmsghdr*>(buffer.data()); NLMSG_OK(h, len);
+             h = NLMSG_NEXT(h, len)) {
+            if (h->nlmsg_type != family_id || h->nlmsg_len < NLMSG_LENGTH(GENL_HDRLEN)) continue;
+            const genlmsghdr* genl = static_cast<const genlmsghdr*>(NLMSG_DATA(h));
+            if (genl->cmd != TASKSTATS_CMD_NEW) continue;
+
+            // AGGR_PID { PID, STATS } por tarefa; AGGR_TGID só traz atrasos
+            const char* attrs = reinterpret_cast<const char*>(genl) + GENL_HDRLEN;
+            for_each_attr(attrs, h->nlmsg_len - NLMSG_LENGTH(GENL_HDRLEN), [&](int type, const char* data, size_t size) {
+                if (type != TASKSTATS_TYPE_AGGR_PID) return;
+                for_each_attr(data, size, [&](int inner, const char* payload, size_t payload_size) {
+                    if (inner == TASKSTATS_TYPE_STATS) {
+                        out.push_back(to_record(payload, payload_size));
+                        count++;
+                    }
+                });
+            });
+        }
+    }
+    return count;
+}
+
+// ================================
+// AGREGAÇÃO E CONCILIAÇÃO
+// ================================
+
+ExitAccounting::ExitAccounting() : tick_tasks(0), tick_processes(0), settled(false), boot_epoch(0) {
+    ticks_per_sec = sysconf(_SC_CLK_TCK);
+    std::ifstream stat(proc_path("stat"));
+    std::string line;
+    while (std::getline(stat, line)) {
+        if (line.rfind("btime ", 0) == 0) {
+            boot_epoch = strtod(line.c_str() + 6, nullptr);
+            break;
+        }
+    }
+}
+
+// Cgroup do processo que terminou: a entrada do cache se for o mesmo
+// processo (início confere com o btime do registro), senão o do pai
+std::string ExitAccounting::cgroup_of(const ExitRecord& record) const {
+    auto meta = process_meta_cache().find(record.tgid);
+    if (meta && boot_epoch > 0 &&
+        std::fabs(boot_epoch + static_cast<double>(meta->start_time) / ticks_per_sec - record.btime) <= 1.0) {
+        return meta->cgroup;
+    }
+    auto parent = process_meta_cache().get(record.ppid);
+    return parent ? parent->cgroup : "?";
+}
+
+void ExitAccounting::reset_tick() {
+    for (auto& entry : by_cgroup) entry.second.tick_cpu_us = 0;
+    for (auto& entry : by_parent) entry.second.tick_cpu_us = 0;
+    tick_tasks = 0;
+    tick_processes = 0;
+}
+
+void ExitAccounting::add(const ExitRecord& record) {
+    if (settled) {
+        reset_tick();
+        settled = false;
+    }
+    bool leader = record.pid == record.tgid;
+    tick_tasks++;
+    if (leader) tick_processes++;
+
+    std::string cgroup = cgroup_of(record);
+    ExitGroup& by_cg = by_cgroup[cgroup];
+    by_cg.key = cgroup;
+
+    // Nome do pai lido uma vez: continua valendo depois que ele termina
+    ExitGroup& by_pp = by_parent[record.ppid];
+    if (by_pp.key.empty()) {
+        auto parent = process_meta_cache().get(record.ppid);
+        by_pp.key = std::to_string(record.ppid) + " (" + (parent ? parent->comm : "?") + ")";
+    }
+    for (ExitGroup* group : {&by_cg, &by_pp}) {
+        group->tasks++;
+        if (leader) group->processes++;
+        group->cpu_us += record.cpu_us();
+        group->tick_cpu_us += record.cpu_us();
+        group->read_bytes += record.read_bytes;
+        group->write_bytes += record.write_bytes;
+        group->minor_faults += record.minor_faults;
+        group->major_faults += record.major_faults;
+        group->cpu_delay_ns += record.cpu_delay_ns;
+        group->blkio_delay_ns += record.blkio_delay_ns;
+    }
+    pending[record.tgid].cpu_us += record.cpu_us();
+}
+
+double ExitAccounting::settle(const ProcessTree& tree) {
+    if (settled) {
+        reset_tick();
+    }
+    settled = true;
+
+    double us_per_tick = 1e6 / ticks_per_sec;
+    double unseen_us = 0;
+    for (auto it = pending.begin(); it != pending.end();) {
+        int tgid = it->first;
+        Pending& p = it->second;
+        // Último utime+stime lido se a árvore viu o processo sumir (neste
+        // ciclo, ou no anterior se o registro chegou depois)
+        const unsigned long long* last_ticks = nullptr;
+        auto gone = tree.exited().find(tgid);
+        if (gone != tree.exited().end()) {
+            last_ticks = &gone->second;
+        } else if (auto prev = prev_exited.find(tgid); prev != prev_exited.end()) {
+            last_ticks = &prev->second;
+        }
+
+        if (last_ticks) {
+            // Visto vivo: só o trecho após a última leitura
+            unseen_us += std::max(0.0, p.cpu_us - *last_ticks * us_per_tick);
+        } else if (tree.alive(tgid)) {
+            // Threads de processo vivo (ou processo que termina agora e a
+            // árvore só notará no próximo ciclo): espera um ciclo
+            if (p.ticks++ == 0) {
+                ++it;
+                continue;
+            }
+        } else {
+            unseen_us += p.cpu_us;              // Nasceu e morreu entre as amostras
+        }
+        it = pending.erase(it);
+    }
+    prev_exited = tree.exited();
+    return unseen_us;
+}
+
+std::vector<const ExitGroup*> ExitAccounting::top(ExitGroupBy by, size_t k) const {
+    std::vector<const ExitGroup*> out;
+    if (by == ExitGroupBy::CGROUP) {
+        for (const auto& entry : by_cgroup) out.push_back(&entry.second);
+    } else {
+        for (const auto& entry : by_parent) out.push_back(&entry.second);
+    }
+    size_t n = std::min(k, out.size());
+    std::partial_sort(out.begin(), out.begin() + n, out.end(), [](const ExitGroup* a, const ExitGroup* b) {
+        return a->cpu_us > b->cpu_us;
+    });
+    out.resize(n);
+    return out;
+}
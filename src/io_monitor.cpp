@@ -14,6 +14,7 @@
 #include <errno.h>
 #include <cstring>
 #include "../include/monitor.hpp"
+#include "../include/procfs.hpp"
 
 // INCLUDES ADICIONADOS PELA TAREFA 2
 #include <dirent.h>
@@ -27,7 +28,7 @@
 
 // Obtém estatísticas de I/O de um processo específico
 int get_io_usage(int pid, ProcStats& stats) {
-    std::string path = "/proc/" + std::to_string(pid) + "/io";
+    std::string path = proc_pid_path(pid, "io");
     std::ifstream file(path);
     if (!file.is_open()) {
         // Tratamento específico de erros com códigos semânticos
@@ -74,7 +75,7 @@ void calculate_io_rate(const ProcStats& prev, ProcStats& curr, double interval)
 
 // Obtém estatísticas de rede do sistema inteiro
 int get_network_usage(ProcStats& stats) {
-    std::ifstream file("/proc/net/dev");
+    std::ifstream file(proc_path("net/dev"));
     if (!file.is_open()) {
         std::cerr << "ERRO: Não foi possível abrir /proc/net/dev - " << strerror(errno) << std::endl;
         return ERR_UNKNOWN;
@@ -123,7 +124,7 @@ void calculate_network_rate(const ProcStats& prev, ProcStats& curr, double inter
 int get_network_usage(int pid, ProcStats& stats) {
     stats.tcp_connections = 0;
     
-    std::ifstream tcp("/proc/net/tcp");
+    std::ifstream tcp(proc_path("net/tcp"));
     if (!tcp.is_open()) {
         std::cerr << "ERRO: Não foi possível abrir /proc/net/tcp - " << strerror(errno) << std::endl;
         return ERR_UNKNOWN;
@@ -140,7 +141,7 @@ int get_network_usage(int pid, ProcStats& stats) {
         if (sscanf(line.c_str(), "%*d: %*s %*s %*s %*s %*s %*s %*s %*s %lu", &inode) == 1) {
             
             // Verifica se processo tem file descriptor apontando para este socket
-            std::string fd_path = "/proc/" + std::to_string(pid) + "/fd";
+            std::string fd_path = proc_pid_path(pid, "fd");
             DIR* dir = opendir(fd_path.c_str());
             if (!dir) {
                 if (errno == ENOENT) {
@@ -178,7 +179,7 @@ int get_network_usage(int pid, ProcStats& stats) {
 
 // Sobrecarga da função para estrutura NetworkStats específica
 int get_network_usage(int pid, NetworkStats& stats) {
-    std::ifstream tcp("/proc/net/tcp");
+    std::ifstream tcp(proc_path("net/tcp"));
     if (!tcp.is_open()) {
         std::cerr << "ERRO: Não foi possível abrir /proc/net/tcp - " << strerror(errno) << std::endl;
         return ERR_UNKNOWN;
@@ -191,7 +192,7 @@ int get_network_usage(int pid, NetworkStats& stats) {
         
         if (sscanf(line.c_str(), "%*d: %*s %*s %*s %*s %*s %*s %*s %*s %lu", &inode) == 1) {
             
-            std::string fd_path = "/proc/" + std::to_string(pid) + "/fd";
+            std::string fd_path = proc_pid_path(pid, "fd");
             DIR* dir = opendir(fd_path.c_str());
             if (!dir) {
                 if (errno == ENOENT) {
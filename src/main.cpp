@@ -19,247 +19,15 @@
 #include <fcntl.h>
 #include <errno.h>
 #include <cstring>
+#include <algorithm>
 #include "monitor.hpp"
 #include "cgroup_manager.hpp"
 #include "namespace.hpp"
+#include "profiler.hpp"
+#include "cli.hpp"
 
 using namespace std;
 
-// Variável atômica para controle global do monitoramento (permite parada graciosa)
-atomic<bool> monitoring_active{true};
-
-// Classe principal para perfilagem de recursos de processos
-class ResourceProfiler {
-private:
-    ProcStats prev_stats;  // Estatísticas da iteração anterior para cálculo de taxas
-    
-    // Verifica se um processo com o PID especificado existe no sistema
-    bool pidExists(int pid) {
-        string proc_path = "/proc/" + to_string(pid);
-        struct stat info;
-        return (stat(proc_path.c_str(), &info) == 0);
-    }
-    
-    // Verifica se temos permissão para acessar as informações do processo
-    bool canAccessProcess(int pid) {
-        string stat_path = "/proc/" + to_string(pid) + "/stat";
-        ifstream file(stat_path);
-        if (!file.is_open()) {
-            return false;
-        }
-        file.close();
-        return true;
-    }
-
-    // Converte códigos de erro semânticos em mensagens descritivas
-    string getErrorDescription(int error_code) {
-        switch (error_code) {
-            case ERR_PROCESS_NOT_FOUND:
-                return "Processo não encontrado";
-            case ERR_PERMISSION_DENIED:
-                return "Permissão negada";
-            case ERR_UNKNOWN:
-                return "Erro desconhecido";
-            default:
-                return "Erro código: " + to_string(error_code);
-        }
-    }
-
-public:
-    // Valida completamente o acesso a um processo antes de iniciar monitoramento
-    bool validateProcessAccess(int pid) {
-        if (pid <= 0) {
-            throw invalid_argument("PID inválido: " + to_string(pid));
-        }
-        
-        if (!pidExists(pid)) {
-            throw runtime_error("Processo com PID " + to_string(pid) + " não existe");
-        }
-        
-        if (!canAccessProcess(pid)) {
-            throw runtime_error("Sem permissão para acessar o processo " + to_string(pid) + 
-                              " (execute como root ou com permissões adequadas)");
-        }
-        
-        return true;
-    }
-    
-    // Função principal de monitoramento de processo
-    bool monitorProcess(int pid, int duration_sec, int interval_sec, const string& csv_file) {
-        try {
-            cout << "\nValidando acesso ao processo " << pid << "..." << endl;
-            validateProcessAccess(pid);
-            cout << "Acesso validado com sucesso\n" << endl;
-            
-            // Abre arquivo CSV para gravação dos dados
-            ofstream csv(csv_file);
-            if (!csv.is_open()) {
-                throw runtime_error("Não foi possível criar arquivo: " + csv_file);
-            }
-            
-            // Escreve cabeçalho do CSV com todas as métricas
-            csv << "timestamp,pid,cpu_percent,memory_rss_bytes,memory_vsz_bytes,"
-                << "memory_swap_bytes,io_read_bytes,io_write_bytes,io_read_rate_bps,"
-                << "io_write_rate_bps,threads,minor_faults,major_faults,tcp_connections\n";
-            csv.flush();
-            
-            // Coleta estatísticas iniciais para baseline
-            ProcStats initial_stats;
-            int cpu_result = get_cpu_usage(pid, initial_stats);
-            if (cpu_result < 0) {
-                throw runtime_error("Falha ao coletar CPU: " + getErrorDescription(cpu_result));
-            }
-            
-            int memory_result = get_memory_usage(pid, initial_stats);
-            if (memory_result < 0) {
-                throw runtime_error("Falha ao coletar memória: " + getErrorDescription(memory_result));
-            }
-            
-            int io_result = get_io_usage(pid, initial_stats);
-            if (io_result < 0) {
-                throw runtime_error("Falha ao coletar I/O: " + getErrorDescription(io_result));
-            }
-            
-            prev_stats = initial_stats;
-            
-            // Informações iniciais para o usuário
-            cout << "Monitorando processo PID: " << pid << endl;
-            cout << "Duração: " << duration_sec << " segundos" << endl;
-            cout << "Intervalo: " << interval_sec << " segundos" << endl;
-            cout << "Arquivo: " << csv_file << endl;
-            cout << "Pressione Ctrl+C para parar..." << endl;
-            cout << "----------------------------------------" << endl;
-            
-            auto start = chrono::steady_clock::now();
-            int iteration = 0;
-            int error_count = 0;
-            const int MAX_ERRORS = 3;  // Máximo de erros consecutivos antes de parar
-            
-            // Loop principal de monitoramento
-            while (monitoring_active && error_count < MAX_ERRORS) {
-                auto now = chrono::steady_clock::now();
-                auto elapsed = chrono::duration_cast<chrono::seconds>(now - start).count();
-                
-                // Verifica se atingiu o tempo máximo de monitoramento
-                if (elapsed >= duration_sec) {
-                    break;
-                }
-                
-                try {
-                    // Verifica se processo ainda existe
-                    if (!pidExists(pid)) {
-                        throw runtime_error("Processo " + to_string(pid) + " não existe mais");
-                    }
-                    
-                    ProcStats curr_stats;
-                    
-                    // Coleta todas as métricas do processo
-                    cpu_result = get_cpu_usage(pid, curr_stats);
-                    if (cpu_result < 0) {
-                        throw runtime_error("Erro CPU: " + getErrorDescription(cpu_result));
-                    }
-                    
-                    memory_result = get_memory_usage(pid, curr_stats);
-                    if (memory_result < 0) {
-                        throw runtime_error("Erro memória: " + getErrorDescription(memory_result));
-                    }
-                    
-                    io_result = get_io_usage(pid, curr_stats);
-                    if (io_result < 0) {
-                        throw runtime_error("Erro I/O: " + getErrorDescription(io_result));
-                    }
-                    
-                    // Rede é opcional (pode falhar sem parar monitoramento)
-                    int network_result = get_network_usage(pid, curr_stats);
-                    if (network_result < 0) {
-                        curr_stats.tcp_connections = 0;
-                    }
-                    
-                    // Calcula métricas derivadas (taxas)
-                    double cpu_pct = calculate_cpu_percent(prev_stats, curr_stats, interval_sec);
-                    calculate_io_rate(prev_stats, curr_stats, interval_sec);
-                    
-                    // Obtém timestamp atual formatado
-                    auto time_now = chrono::system_clock::now();
-                    time_t t = chrono::system_clock::to_time_t(time_now);
-                    struct tm tm_buf;
-                    localtime_r(&t, &tm_buf);  // Thread-safe
-                    stringstream timestamp;
-                    timestamp << put_time(&tm_buf, "%Y-%m-%d %H:%M:%S");
-                    
-                    // Grava linha completa no CSV
-                    csv << timestamp.str() << ","
-                        << pid << ","
-                        << fixed << setprecision(2) << cpu_pct << ","
-                        << curr_stats.memory_rss << ","
-                        << curr_stats.memory_vsz << ","
-                        << curr_stats.memory_swap << ","
-                        << curr_stats.io_read_bytes << ","
-                        << curr_stats.io_write_bytes << ","
-                        << fixed << setprecision(0) << curr_stats.io_read_rate << ","
-                        << fixed << setprecision(0) << curr_stats.io_write_rate << ","
-                        << curr_stats.threads << ","
-                        << curr_stats.minor_faults << ","
-                        << curr_stats.major_faults << ","
-                        << curr_stats.tcp_connections << "\n";
-                    csv.flush();
-                    
-                    // Exibe resumo no console
-                    cout << "[" << timestamp.str() << "] "
-                         << "CPU: " << setw(6) << fixed << setprecision(2) << cpu_pct << "% | "
-                         << "RSS: " << setw(6) << (curr_stats.memory_rss / 1024) << "MB | "
-                         << "IO_R: " << setw(7) << fixed << setprecision(1) << (curr_stats.io_read_rate / (1024.0*1024.0)) << "MB/s | "
-                         << "TCP: " << setw(2) << curr_stats.tcp_connections
-                         << endl;
-                    
-                    prev_stats = curr_stats;
-                    iteration++;
-                    error_count = 0;  // Reset contador de erros em caso de sucesso
-                    
-                } catch (const exception& e) {
-                    error_count++;
-                    cerr << "Erro iteração " << iteration + 1 << " (" << error_count << "/" << MAX_ERRORS << "): " << e.what() << endl;
-                    
-                    // Para imediatamente se processo não existir mais
-                    if (string(e.what()).find("não existe") != string::npos) {
-                        break;
-                    }
-                    
-                    // Para após muitos erros consecutivos
-                    if (error_count >= MAX_ERRORS) {
-                        cerr << "Muitos erros consecutivos. Parando monitoramento." << endl;
-                        break;
-                    }
-                    
-                    // Pequena pausa antes de tentar novamente
-                    this_thread::sleep_for(chrono::seconds(2));
-                }
-                
-                // Aguarda intervalo configurado
-                this_thread::sleep_for(chrono::seconds(interval_sec));
-            }
-            
-            csv.close();
-            
-            // Relatório final
-            cout << "----------------------------------------" << endl;
-            if (error_count >= MAX_ERRORS) {
-                cout << "Monitoramento interrompido devido a múltiplos erros" << endl;
-            } else {
-                cout << "Monitoramento concluído" << endl;
-            }
-            cout << "Iterações: " << iteration << endl;
-            cout << "Arquivo: " << csv_file << endl;
-            
-            return (error_count < MAX_ERRORS);
-            
-        } catch (const exception& e) {
-            cerr << "\nErro: " << e.what() << endl;
-            return false;
-        }
-    }
-};
-
 // Wrapper para o Control Group Manager com funcionalidades específicas dos experimentos
 class ControlGroupManagerWrapper {
 private:
@@ -400,13 +168,67 @@ public:
     }
 };
 
+// Menu interativo para monitorar um cgroup inteiro (Componente 1 + 3)
+void cgroupProfilerMenu() {
+    ResourceProfiler profiler;
+    string cgroup_path, breakdown;
+    int duration, interval;
+    
+    cout << "Digite o caminho do cgroup (ex: /system.slice/ssh.service): ";
+    getline(cin, cgroup_path);
+    if (cgroup_path.empty()) {
+        cout << "Erro: caminho do cgroup não pode ser vazio!" << endl;
+        return;
+    }
+    if (cgroup_path[0] != '/') {
+        cgroup_path = "/" + cgroup_path;
+    }
+    
+    cout << "Digite a duração em segundos (padrão 30): ";
+    if (!(cin >> duration) || duration <= 0) {
+        duration = 30;
+    }
+    
+    cout << "Digite o intervalo em segundos (padrão 2): ";
+    if (!(cin >> interval) || interval <= 0) {
+        interval = 2;
+    }
+    
+    cin.clear();
+    cin.ignore(10000, '\n');
+    
+    cout << "Incluir quebra por PID membro? (s/N): ";
+    getline(cin, breakdown);
+    bool per_pid = !breakdown.empty() && (breakdown[0] == 's' || breakdown[0] == 'S');
+    
+    // Nome de arquivo derivado do caminho ("/a/b" -> "monitoring_cgroup_a_b.csv")
+    string name = cgroup_path.substr(1);
+    replace(name.begin(), name.end(), '/', '_');
+    string filename = "monitoring_cgroup_" + (name.empty() ? string("root") : name) + ".csv";
+    profiler.monitorCgroup(cgroup_path, duration, interval, filename, per_pid);
+}
+
 // Menu interativo para o Resource Profiler (Componente 1)
 void resourceProfilerMenu() {
     ResourceProfiler profiler;
-    int pid, duration, interval;
+    int mode, pid, duration, interval;
     
     cout << "\nRESOURCE PROFILER" << endl;
     cout << "-----------------" << endl;
+    cout << "1. Monitorar processo (PID)" << endl;
+    cout << "2. Monitorar cgroup inteiro" << endl;
+    cout << "Escolha: ";
+    if (!(cin >> mode)) {
+        mode = 1;
+    }
+    cin.clear();
+    cin.ignore(10000, '\n');
+    
+    if (mode == 2) {
+        cgroupProfilerMenu();
+        return;
+    }
+    
     cout << "Digite o PID para monitorar: ";
     
     if (!(cin >> pid)) {
@@ -430,7 +252,13 @@ void resourceProfilerMenu() {
     cin.ignore(10000, '\n');
     
     string filename = "monitoring_pid_" + to_string(pid) + ".csv";
-    profiler.monitorProcess(pid, duration, interval, filename);
+    
+    cout << "Gravar sessão para replay em monitoring_pid_" << pid << "_session.ra3? (s/N): ";
+    string answer;
+    getline(cin, answer);
+    bool record_session = !answer.empty() && (answer[0] == 's' || answer[0] == 'S');
+    
+    profiler.monitorProcess(pid, duration, interval, filename, record_session);
 }
 
 // Menu interativo para o Namespace Analyzer (Componente 2)
@@ -636,7 +464,13 @@ void signal_handler(int sig) {
 }
 
 // Função principal - ponto de entrada do programa
-int main() {
+// Sem argumentos abre o menu interativo; com argumentos executa um
+// subcomando não interativo (profile, ns scan, cgroup top, bench, --daemon)
+int main(int argc, char* argv[]) {
+    if (argc > 1) {
+        return run_cli(argc, argv);
+    }
+    
     // Configura handlers para sinais de interrupção e término
     signal(SIGINT, signal_handler);
     signal(SIGTERM, signal_handler);
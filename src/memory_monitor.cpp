@@ -5,7 +5,13 @@
 #include <cstdio>
 #include <errno.h>
 #include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <chrono>
+#include <algorithm>
+#include <unistd.h>
 #include "../include/monitor.hpp"
+#include "../include/procfs.hpp"
 
 // Códigos de erro semânticos para tratamento consistente
 #define ERR_PROCESS_NOT_FOUND -2
@@ -14,7 +20,28 @@
 
 // Obtém estatísticas completas de memória de um processo
 int get_memory_usage(int pid, ProcStats& stats) {
-    std::string path = "/proc/" + std::to_string(pid) + "/status";
+    // Lê memória total do sistema para cálculo de percentual
+    std::ifstream meminfo(proc_path("meminfo"));
+    if (!meminfo.is_open()) {
+        std::cerr << "ERRO: Não foi possível abrir /proc/meminfo - " << strerror(errno) << std::endl;
+        return ERR_UNKNOWN;
+    }
+
+    std::string line;
+    long mem_total_kb = 0;
+    while (std::getline(meminfo, line)) {
+        if (line.rfind("MemTotal:", 0) == 0) {
+            std::sscanf(line.c_str(), "MemTotal: %ld", &mem_total_kb);
+            break;
+        }
+    }
+    meminfo.close();
+
+    return get_memory_usage(pid, stats, mem_total_kb);
+}
+
+int get_memory_usage(int pid, ProcStats& stats, long mem_total_kb) {
+    std::string path = proc_pid_path(pid, "status");
     std::ifstream file(path);
     if (!file.is_open()) {
         // Tratamento específico de erros com códigos semânticos
@@ -44,22 +71,8 @@ int get_memory_usage(int pid, ProcStats& stats) {
     }
     file.close();
 
-    // Lê memória total do sistema para cálculo de percentual
-    std::ifstream meminfo("/proc/meminfo");
-    if (!meminfo.is_open()) {
-        std::cerr << "ERRO: Não foi possível abrir /proc/meminfo - " << strerror(errno) << std::endl;
-        return ERR_UNKNOWN;
-    }
-
-    long mem_total_kb = 0;
-    while (std::getline(meminfo, line)) {
-        if (line.rfind("MemTotal:", 0) == 0)
-            std::sscanf(line.c_str(), "MemTotal: %ld", &mem_total_kb);
-    }
-    meminfo.close();
-
     // Lê estatísticas de page faults do arquivo /proc/[pid]/stat
-    path = "/proc/" + std::to_string(pid) + "/stat";
+    path = proc_pid_path(pid, "stat");
     std::ifstream stat_file(path);
     if (!stat_file.is_open()) {
         if (errno == ENOENT) {
@@ -88,9 +101,134 @@ int get_memory_usage(int pid, ProcStats& stats) {
     stats.memory_rss = rss_kb;
     stats.memory_vsz = vsz_kb;
     stats.memory_swap = swap_kb;
+    stats.memory_pss = -1;  // Preenchidos por sample_smaps_adaptive
+    stats.memory_uss = -1;
     stats.minor_faults = minor_faults;
     stats.major_faults = major_faults;
     stats.memory_percent = mem_percent;
 
     return 0;
-}
\ No newline at end of file
+}
+
+// /proc/[pid] ainda existe (distingue processo encerrado de arquivo ausente)
+static bool process_alive(int pid) {
+    return access(proc_pid_path(pid, "stat").c_str(), F_OK) == 0;
+}
+
+// Lê /proc/[pid]/smaps_rollup: uma linha "Campo:   valor kB" por métrica,
+// já somada sobre todas as VMAs pelo kernel
+int get_smaps_rollup(int pid, SmapsStats& stats) {
+    std::string path = proc_pid_path(pid, "smaps_rollup");
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        int err = errno;
+        if (err == ENOENT || err == ESRCH) {
+            // Processo vivo: thread de kernel, sem memória de usuário (ESRCH),
+            // ou kernel sem smaps_rollup (ENOENT, < 4.14). Nunca vai funcionar
+            if (process_alive(pid)) {
+                if (err == ENOENT) {
+                    std::cerr << "ERRO: Kernel sem " << path << " (requer 4.14+)" << std::endl;
+                }
+                return ERR_UNKNOWN;
+            }
+            std::cerr << "ERRO: Processo com PID " << pid << " não existe" << std::endl;
+            return ERR_PROCESS_NOT_FOUND;
+        } else if (err == EACCES) {
+            std::cerr << "ERRO: Permissão negada para acessar processo " << pid << std::endl;
+            return ERR_PERMISSION_DENIED;
+        } else {
+            std::cerr << "ERRO: Não foi possível abrir " << path << " - " << strerror(err) << std::endl;
+            return ERR_UNKNOWN;
+        }
+    }
+
+    static const struct {
+        const char* key;
+        long SmapsStats::*field;
+    } fields[] = {
+        {"Rss:", &SmapsStats::rss},
+        {"Pss:", &SmapsStats::pss},
+        {"Pss_Anon:", &SmapsStats::pss_anon},
+        {"Pss_File:", &SmapsStats::pss_file},
+        {"Pss_Shmem:", &SmapsStats::pss_shmem},
+        {"Shared_Clean:", &SmapsStats::shared_clean},
+        {"Shared_Dirty:", &SmapsStats::shared_dirty},
+        {"Private_Clean:", &SmapsStats::private_clean},
+        {"Private_Dirty:", &SmapsStats::private_dirty},
+        {"Anonymous:", &SmapsStats::anonymous},
+        {"Swap:", &SmapsStats::swap},
+        {"SwapPss:", &SmapsStats::swap_pss},
+        {"AnonHugePages:", &SmapsStats::anon_huge},
+        {"ShmemPmdMapped:", &SmapsStats::shmem_huge},
+        {"FilePmdMapped:", &SmapsStats::file_huge},
+    };
+
+    stats = {};
+    std::string line;
+    bool found = false;
+    while (std::getline(file, line)) {
+        for (const auto& f : fields) {
+            size_t len = strlen(f.key);
+            if (line.compare(0, len, f.key) == 0) {
+                stats.*f.field = atol(line.c_str() + len);
+                found = true;
+                break;
+            }
+        }
+    }
+    file.close();
+
+    // Sem nenhum campo: processo sem memória de usuário (nunca terá
+    // campos) ou que terminou durante a leitura
+    if (!found) {
+        return process_alive(pid) ? ERR_UNKNOWN : ERR_PROCESS_NOT_FOUND;
+    }
+    stats.uss = stats.private_clean + stats.private_dirty;
+    return 0;
+}
+
+int run_read_schedule(ReadSchedule& schedule, bool changed, const std::function<int()>& read) {
+    if (schedule.error != 0) {
+        return schedule.error;
+    }
+    schedule.ticks_since_read++;
+
+    bool due = !schedule.valid;
+    if (!due) {
+        // Limite de taxa pelo custo medido da última leitura
+        int min_interval = std::max(1, static_cast<int>(std::ceil(schedule.last_cost_ms / schedule.cost_budget_ms)));
+        due = schedule.ticks_since_read >= std::max(schedule.max_interval, min_interval) ||
+              (changed && schedule.ticks_since_read >= min_interval);
+    }
+    if (!due) {
+        schedule.skipped++;
+        return 0;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    int result = read();
+    if (result < 0) {
+        // Processo que terminou não é erro permanente da agenda
+        if (result != ERR_PROCESS_NOT_FOUND) schedule.error = result;
+        return result;
+    }
+    schedule.last_cost_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    schedule.valid = true;
+    schedule.ticks_since_read = 0;
+    schedule.reads++;
+    return 1;
+}
+
+int sample_smaps_adaptive(int pid, long rss_kb, SmapsSchedule& schedule) {
+    long threshold = std::max(schedule.rss_change_min_kb,
+                              static_cast<long>(schedule.rss_at_read * schedule.rss_change_ratio));
+    bool rss_changed = std::labs(rss_kb - schedule.rss_at_read) >= threshold;
+
+    SmapsStats fresh;
+    int result = run_read_schedule(schedule, rss_changed, [&] { return get_smaps_rollup(pid, fresh); });
+    if (result == 1) {
+        schedule.last = fresh;
+        schedule.rss_at_read = rss_kb;
+    }
+    return result;
+}
@@ -0,0 +1,701 @@
+// ============================================================
+// ARQUIVO: src/metrics_server.cpp
+// DESCRIÇÃO: Implementação da exposição Prometheus/OpenMetrics
+// Renderização do snapshot, exportador de métricas e servidor
+// HTTP sobre epoll (uma thread, sockets não bloqueantes)
+// ============================================================
+
+#include "../include/metrics_server.hpp"
+#include "../include/namespace.hpp"
+#include "../include/procfs.hpp"
+#include "../include/process_meta.hpp"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <ctime>
+#include <cerrno>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+// Limite do cabeçalho de uma requisição (scrapes reais têm < 1KB)
+static const size_t MAX_REQUEST_SIZE = 8192;
+
+// ================================
+// FAMÍLIAS E RENDERIZAÇÃO
+// ================================
+
+MetricFamily::MetricFamily(const std::string& metric_name, const std::string& metric_help, MetricType metric_type)
+    : name(metric_name), help(metric_help), type(metric_type) {}
+
+void MetricFamily::add(const std::string& labels, double value) {
+    samples.emplace_back(labels, value);
+}
+
+std::string metrics_escape_label(const std::string& value) {
+    std::string escaped;
+    escaped.reserve(value.size());
+    for (char c : value) {
+        if (c == '\\') escaped += "\\\\";
+        else if (c == '"') escaped += "\\\"";
+        else if (c == '\n') escaped += "\\n";
+        else escaped += c;
+    }
+    return escaped;
+}
+
+// Acrescenta "nome{labels} valor\n" sem passar por iostream
+static void append_sample(std::string& out, const std::string& name, const char* suffix,
+                          const std::string& labels, double value) {
+    out += name;
+    out += suffix;
+    if (!labels.empty()) {
+        out += '{';
+        out += labels;
+        out += '}';
+    }
+    char number[32];
+    int len = snprintf(number, sizeof(number), " %.15g\n", value);
+    out.append(number, len);
+}
+
+// Renderiza nos dois formatos; a única diferença é o nome da família de
+// contadores no # TYPE (OpenMetrics usa o nome sem _total) e o "# EOF" final
+static void render_families(const std::vector<MetricFamily>& families, MetricsBody& body) {
+    body.text.clear();
+    body.openmetrics.clear();
+
+    for (const auto& family : families) {
+        if (family.samples.empty()) continue;
+        bool counter = (family.type == MetricType::COUNTER);
+        const char* suffix = counter ? "_total" : "";
+        const char* type_name = counter ? "counter" : "gauge";
+
+        body.text += "# HELP " + family.name + suffix + " " + family.help + "\n";
+        body.text += "# TYPE " + family.name + suffix + " " + type_name + "\n";
+        body.openmetrics += "# HELP " + family.name + " " + family.help + "\n";
+        body.openmetrics += "# TYPE " + family.name + " " + type_name + "\n";
+
+        for (const auto& sample : family.samples) {
+            append_sample(body.text, family.name, suffix, sample.first, sample.second);
+            append_sample(body.openmetrics, family.name, suffix, sample.first, sample.second);
+        }
+    }
+    body.openmetrics += "# EOF\n";
+}
+
+// ================================
+// SNAPSHOT EM BUFFER DUPLO
+// ================================
+
+MetricsSnapshot::MetricsSnapshot() {}
+
+void MetricsSnapshot::publish(const std::vector<MetricFamily>& families) {
+    // Reaproveita o buffer reserva se nenhum scrape ainda o estiver enviando
+    std::shared_ptr<MetricsBody> target;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (spare && spare.use_count() == 1) {
+            target = std::move(spare);
+        }
+    }
+    if (!target) {
+        target = std::make_shared<MetricsBody>();
+    }
+
+    // Renderização fora do lock: scrapes continuam servindo o buffer atual
+    render_families(families, *target);
+
+    std::lock_guard<std::mutex> lock(mtx);
+    std::shared_ptr<const MetricsBody> previous = std::move(front);
+    front = std::move(target);
+    spare = std::const_pointer_cast<MetricsBody>(previous);
+}
+
+std::shared_ptr<const MetricsBody> MetricsSnapshot::current() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return front;
+}
+
+// ================================
+// EXPORTADOR
+// ================================
+
+MetricsExporter::MetricsExporter(MetricsSnapshot& snap, const std::vector<std::string>& cgroup_paths,
+                                 std::chrono::seconds namespace_refresh)
+    : snapshot(snap), cgroups(cgroup_paths), ns_refresh(namespace_refresh), ns_scanned(false) {}
+
+void MetricsExporter::set_cgroups(const std::vector<std::string>& cgroup_paths) {
+    cgroups = cgroup_paths;
+}
+
+void MetricsExporter::refresh_namespace_groups() {
+    auto now = std::chrono::steady_clock::now();
+    if (ns_scanned && now - last_ns_scan < ns_refresh) {
+        return;
+    }
+    last_ns_scan = now;
+    ns_scanned = true;
+
+    MetricFamily processes("ra3_namespace_processes", "Processos em cada namespace", MetricType::GAUGE);
+    std::map<std::string, int> groups_per_type;
+    for (const auto& group : scan_namespace_groups()) {
+        std::string type = namespace_type_to_string(group.type);
+        processes.add("type=\"" + type + "\",inode=\"" + std::to_string(group.inode) + "\"",
+                      group.process_count);
+        groups_per_type[type]++;
+    }
+
+    MetricFamily groups("ra3_namespace_groups", "Namespaces distintos por tipo", MetricType::GAUGE);
+    for (const auto& entry : groups_per_type) {
+        groups.add("type=\"" + entry.first + "\"", entry.second);
+    }
+
+    ns_families.clear();
+    ns_families.push_back(std::move(processes));
+    ns_families.push_back(std::move(groups));
+}
+
+void MetricsExporter::publish_tick(const std::vector<ProcessSample>& samples, const HostMemory& host) {
+    static const double ticks_per_sec = static_cast<double>(sysconf(_SC_CLK_TCK));
+
+    std::vector<MetricFamily> families;
+    families.reserve(41);
+
+    // ---------- Por processo ----------
+    MetricFamily cpu_pct("ra3_process_cpu_percent", "Uso de CPU normalizado pelos núcleos (%)", MetricType::GAUGE);
+    MetricFamily cpu_sec("ra3_process_cpu_seconds", "Tempo de CPU (usuário + sistema) em segundos", MetricType::COUNTER);
+    MetricFamily rss("ra3_process_resident_memory_bytes", "Memória residente (RSS)", MetricType::GAUGE);
+    MetricFamily vsz("ra3_process_virtual_memory_bytes", "Memória virtual (VSZ)", MetricType::GAUGE);
+    MetricFamily swap("ra3_process_swap_bytes", "Memória em swap", MetricType::GAUGE);
+    MetricFamily pss("ra3_process_proportional_memory_bytes", "Memória proporcional (PSS, smaps_rollup)", MetricType::GAUGE);
+    MetricFamily uss("ra3_process_unique_memory_bytes", "Memória exclusiva do processo (USS, smaps_rollup)", MetricType::GAUGE);
+    MetricFamily io_read("ra3_process_io_read_bytes", "Bytes lidos do armazenamento", MetricType::COUNTER);
+    MetricFamily io_write("ra3_process_io_write_bytes", "Bytes escritos no armazenamento", MetricType::COUNTER);
+    MetricFamily threads("ra3_process_threads", "Threads do processo", MetricType::GAUGE);
+    MetricFamily faults("ra3_process_page_faults", "Page faults por tipo", MetricType::COUNTER);
+    MetricFamily ctxt("ra3_process_context_switches", "Trocas de contexto por tipo", MetricType::COUNTER);
+    MetricFamily resolution("ra3_process_sample_interval_seconds", "Tempo real coberto pela última amostra (resolução)", MetricType::GAUGE);
+    MetricFamily numa_rss("ra3_process_numa_resident_bytes", "Memória residente por nó NUMA (numa_maps)", MetricType::GAUGE);
+    MetricFamily numa_local("ra3_process_numa_local_ratio", "Fração da memória no nó em que a maioria das threads roda", MetricType::GAUGE);
+    MetricFamily numa_misplaced("ra3_process_numa_misplaced", "1 se a memória está majoritariamente fora do nó das threads", MetricType::GAUGE);
+
+    // Agregados em janela: ra3_process_<métrica>_window{window,stat}
+    std::vector<MetricFamily> window_families;
+    for (size_t m = 0; m < STAT_METRIC_COUNT; m++) {
+        window_families.emplace_back(std::string("ra3_process_") + stat_metric_name(static_cast<StatMetric>(m)) + "_window",
+                                     "Resumo em janela deslizante (min, max, mean, stddev, p50, p95, p99)",
+                                     MetricType::GAUGE);
+    }
+    static const StatWindow windows[] = {StatWindow::MIN_1, StatWindow::MIN_5, StatWindow::MIN_15, StatWindow::RUN};
+    auto now = std::chrono::steady_clock::now();
+
+    for (const auto& sample : samples) {
+        const ProcStats& s = sample.stats;
+        // Nome pelo cache compartilhado (PID reutilizado tem outro início)
+        auto meta = process_meta_cache().get(sample.pid, s.start_time);
+        const std::string comm = meta ? meta->comm : "";
+        std::string labels = "pid=\"" + std::to_string(sample.pid) + "\",comm=\"" + metrics_escape_label(comm) + "\"";
+
+        cpu_pct.add(labels, sample.cpu_percent);
+        cpu_sec.add(labels, (s.utime + s.stime) / ticks_per_sec);
+        rss.add(labels, s.memory_rss * 1024.0);
+        vsz.add(labels, s.memory_vsz * 1024.0);
+        swap.add(labels, s.memory_swap * 1024.0);
+        if (s.memory_pss >= 0) pss.add(labels, s.memory_pss * 1024.0);
+        if (s.memory_uss >= 0) uss.add(labels, s.memory_uss * 1024.0);
+        io_read.add(labels, s.io_read_bytes);
+        io_write.add(labels, s.io_write_bytes);
+        threads.add(labels, s.threads);
+        faults.add(labels + ",type=\"minor\"", s.minor_faults);
+        faults.add(labels + ",type=\"major\"", s.major_faults);
+        ctxt.add(labels + ",type=\"voluntary\"", s.voluntary_ctxt);
+        ctxt.add(labels + ",type=\"nonvoluntary\"", s.nonvoluntary_ctxt);
+        resolution.add(labels, sample.elapsed_sec);
+        if (sample.numa) {
+            for (size_t node = 0; node < sample.numa->resident_kb.size(); node++) {
+                numa_rss.add(labels + ",node=\"" + std::to_string(node) + "\"", sample.numa->resident_kb[node] * 1024.0);
+            }
+            numa_local.add(labels, sample.numa->local_ratio);
+            numa_misplaced.add(labels, sample.numa->misplaced ? 1.0 : 0.0);
+        }
+
+        if (!sample.summary) continue;
+        for (size_t m = 0; m < STAT_METRIC_COUNT; m++) {
+            for (StatWindow window : windows) {
+                MetricSummary summary = sample.summary->summary(static_cast<StatMetric>(m), window, now);
+                if (summary.stats.count == 0) continue;
+                std::string window_labels = labels + ",window=\"" + stat_window_name(window) + "\",stat=";
+                MetricFamily& family = window_families[m];
+                family.add(window_labels + "\"min\"", summary.stats.min);
+                family.add(window_labels + "\"max\"", summary.stats.max);
+                family.add(window_labels + "\"mean\"", summary.stats.mean);
+                family.add(window_labels + "\"stddev\"", summary.stats.stddev());
+                family.add(window_labels + "\"p50\"", summary.sketch.quantile(0.50));
+                family.add(window_labels + "\"p95\"", summary.sketch.quantile(0.95));
+                family.add(window_labels + "\"p99\"", summary.sketch.quantile(0.99));
+            }
+        }
+    }
+    bool with_numa = !numa_local.samples.empty();
+    for (MetricFamily* f : {&cpu_pct, &cpu_sec, &rss, &vsz, &swap, &pss, &uss, &io_read, &io_write, &threads, &faults, &ctxt,
+                            &resolution, &numa_rss, &numa_local, &numa_misplaced}) {
+        families.push_back(std::move(*f));
+    }
+    for (auto& family : window_families) {
+        families.push_back(std::move(family));
+    }
+
+    // ---------- Por cgroup ----------
+    MetricFamily cg_cpu("ra3_cgroup_cpu_usage_seconds", "Tempo de CPU consumido pelo cgroup", MetricType::COUNTER);
+    MetricFamily cg_thr("ra3_cgroup_cpu_throttled_seconds", "Tempo em throttling de CPU", MetricType::COUNTER);
+    MetricFamily cg_thr_n("ra3_cgroup_cpu_throttled_periods", "Períodos com throttling de CPU", MetricType::COUNTER);
+    MetricFamily cg_mem("ra3_cgroup_memory_current_bytes", "Memória em uso pelo cgroup", MetricType::GAUGE);
+    MetricFamily cg_io_r("ra3_cgroup_io_read_bytes", "Bytes lidos pelo cgroup", MetricType::COUNTER);
+    MetricFamily cg_io_w("ra3_cgroup_io_write_bytes", "Bytes escritos pelo cgroup", MetricType::COUNTER);
+    MetricFamily cg_pids("ra3_cgroup_pids", "Processos no cgroup", MetricType::GAUGE);
+    MetricFamily cg_psi("ra3_cgroup_pressure_avg10", "Pressure stall (média de 10s, %)", MetricType::GAUGE);
+
+    for (const std::string& path : cgroups) {
+        CGroupStats st = mgr.read_cgroup_stats(path);
+        if (!st.valid) continue;
+        std::string labels = "cgroup=\"" + metrics_escape_label(path) + "\"";
+        cg_cpu.add(labels, st.cpu_usage_usec / 1e6);
+        cg_thr.add(labels, st.cpu_throttled_usec / 1e6);
+        cg_thr_n.add(labels, st.cpu_nr_throttled);
+        cg_mem.add(labels, st.memory_current);
+        cg_io_r.add(labels, st.io_rbytes);
+        cg_io_w.add(labels, st.io_wbytes);
+        if (st.pids_current >= 0) {
+            cg_pids.add(labels, st.pids_current);
+        }
+        cg_psi.add(labels + ",resource=\"cpu\"", st.cpu_pressure.avg10);
+        cg_psi.add(labels + ",resource=\"memory\"", st.memory_pressure.avg10);
+        cg_psi.add(labels + ",resource=\"io\"", st.io_pressure.avg10);
+    }
+
+    for (MetricFamily* f : {&cg_cpu, &cg_thr, &cg_thr_n, &cg_mem, &cg_io_r, &cg_io_w, &cg_pids, &cg_psi}) {
+        families.push_back(std::move(*f));
+    }
+
+    // ---------- Memória do host (snapshot do ciclo) ----------
+    if (host.total_kb > 0) {
+        MetricFamily mem("ra3_host_memory_bytes", "Memória do host por tipo (/proc/meminfo)", MetricType::GAUGE);
+        MetricFamily reclaim("ra3_host_memory_reclaim_pages", "Páginas examinadas (scan) e recuperadas (steal) pelo reclaim", MetricType::COUNTER);
+        MetricFamily stalls("ra3_host_memory_direct_reclaim_stalls", "Alocações que entraram em direct reclaim", MetricType::COUNTER);
+        MetricFamily refaults("ra3_host_memory_refault_pages", "Páginas despejadas e lidas de volta (workingset)", MetricType::COUNTER);
+        MetricFamily swapped("ra3_host_swap_pages", "Páginas trazidas do swap e enviadas para ele", MetricType::COUNTER);
+        mem.add("type=\"total\"", host.total_kb * 1024.0);
+        mem.add("type=\"available\"", host.available_kb * 1024.0);
+        mem.add("type=\"free\"", host.free_kb * 1024.0);
+        mem.add("type=\"page_cache\"", host.page_cache_kb() * 1024.0);
+        mem.add("type=\"slab_reclaimable\"", host.slab_reclaimable_kb * 1024.0);
+        mem.add("type=\"slab_unreclaimable\"", host.slab_unreclaimable_kb * 1024.0);
+        mem.add("type=\"dirty\"", host.dirty_kb * 1024.0);
+        mem.add("type=\"swap_used\"", host.swap_used_kb() * 1024.0);
+        reclaim.add("type=\"scan\"", host.pgscan);
+        reclaim.add("type=\"steal\"", host.pgsteal);
+        stalls.add("", host.allocstall);
+        refaults.add("", host.refaults);
+        swapped.add("direction=\"in\"", host.pswpin);
+        swapped.add("direction=\"out\"", host.pswpout);
+        for (MetricFamily* f : {&mem, &reclaim, &stalls, &refaults, &swapped}) {
+            families.push_back(std::move(*f));
+        }
+    }
+
+    // ---------- Por nó NUMA (só com o posicionamento por PID ligado) ----------
+    if (with_numa) {
+        MetricFamily node_mem("ra3_numa_node_memory_bytes", "Memória do nó NUMA por tipo", MetricType::GAUGE);
+        MetricFamily node_alloc("ra3_numa_node_allocations", "Páginas alocadas no nó por resultado (numastat)", MetricType::COUNTER);
+        for (const NumaNode& node : read_numa_nodes()) {
+            std::string labels = "node=\"" + std::to_string(node.node) + "\"";
+            node_mem.add(labels + ",type=\"total\"", node.mem_total_kb * 1024.0);
+            node_mem.add(labels + ",type=\"free\"", node.mem_free_kb * 1024.0);
+            node_alloc.add(labels + ",type=\"hit\"", node.numa_hit);
+            node_alloc.add(labels + ",type=\"miss\"", node.numa_miss);
+            node_alloc.add(labels + ",type=\"foreign\"", node.numa_foreign);
+            node_alloc.add(labels + ",type=\"local\"", node.local_node);
+            node_alloc.add(labels + ",type=\"other\"", node.other_node);
+        }
+        families.push_back(std::move(node_mem));
+        families.push_back(std::move(node_alloc));
+    }
+
+    // ---------- Por grupo de namespace ----------
+    refresh_namespace_groups();
+    families.insert(families.end(), ns_families.begin(), ns_families.end());
+
+    // ---------- Do próprio exportador ----------
+    MetricFamily last_tick("ra3_exporter_last_sample_timestamp_seconds", "Horário da última amostra (Unix)", MetricType::GAUGE);
+    last_tick.add("", static_cast<double>(time(nullptr)));
+    families.push_back(std::move(last_tick));
+
+    snapshot.publish(families);
+}
+
+// ================================
+// SERVIDOR HTTP
+// ================================
+
+MetricsServer::MetricsServer(MetricsSnapshot& snap) : snapshot(snap), epoll_fd(-1) {
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd < 0) {
+        std::cerr << "ERRO: epoll_create1 falhou - " << strerror(errno) << std::endl;
+    }
+}
+
+MetricsServer::~MetricsServer() {
+    for (auto& entry : connections) {
+        close(entry.first);
+    }
+    for (int fd : listen_fds) {
+        close(fd);
+    }
+    if (!unix_path.empty()) {
+        unlink(unix_path.c_str());
+    }
+    if (epoll_fd >= 0) {
+        close(epoll_fd);
+    }
+}
+
+bool MetricsServer::add_listener(int fd) {
+    if (::listen(fd, 64) < 0) {
+        std::cerr << "ERRO: listen falhou - " << strerror(errno) << std::endl;
+        close(fd);
+        return false;
+    }
+    epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+        std::cerr << "ERRO: epoll_ctl falhou - " << strerror(errno) << std::endl;
+        close(fd);
+        return false;
+    }
+    listen_fds.push_back(fd);
+    return true;
+}
+
+bool MetricsServer::listen(const std::string& address) {
+    if (epoll_fd < 0) {
+        return false;
+    }
+
+    // Socket unix: "unix:/caminho"
+    if (address.rfind("unix:", 0) == 0) {
+        std::string path = address.substr(5);
+        sockaddr_un addr = {};
+        if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+            std::cerr << "ERRO: caminho de socket unix inválido: " << path << std::endl;
+            return false;
+        }
+        int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            std::cerr << "ERRO: socket falhou - " << strerror(errno) << std::endl;
+            return false;
+        }
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+        unlink(path.c_str());  // Remove socket antigo de execução anterior
+        if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            std::cerr << "ERRO: bind em " << path << " falhou - " << strerror(errno) << std::endl;
+            close(fd);
+            return false;
+        }
+        unix_path = path;
+        return add_listener(fd);
+    }
+
+    // TCP: "host:porta" ou "[v6]:porta"
+    size_t colon = address.rfind(':');
+    if (colon == std::string::npos) {
+        std::cerr << "ERRO: endereço inválido (use host:porta ou unix:/caminho): " << address << std::endl;
+        return false;
+    }
+    std::string host = address.substr(0, colon);
+    int port = atoi(address.substr(colon + 1).c_str());
+    if (port <= 0 || port > 65535) {
+        std::cerr << "ERRO: porta inválida: " << address.substr(colon + 1) << std::endl;
+        return false;
+    }
+    if (host.empty() || host == "localhost") {
+        host = "127.0.0.1";
+    }
+
+    sockaddr_storage storage = {};
+    socklen_t addr_len = 0;
+    int family = AF_INET;
+    if (host.front() == '[' && host.back() == ']') {
+        host = host.substr(1, host.size() - 2);
+        sockaddr_in6* addr6 = reinterpret_cast<sockaddr_in6*>(&storage);
+        addr6->sin6_family = AF_INET6;
+        addr6->sin6_port = htons(port);
+        if (inet_pton(AF_INET6, host.c_str(), &addr6->sin6_addr) != 1) {
+            std::cerr << "ERRO: endereço IPv6 inválido: " << host << std::endl;
+            return false;
+        }
+        family = AF_INET6;
+        addr_len = sizeof(sockaddr_in6);
+        if (!IN6_IS_ADDR_LOOPBACK(&addr6->sin6_addr)) {
+            std::cerr << "AVISO: métricas expostas fora do loopback em " << address << std::endl;
+        }
+    } else {
+        sockaddr_in* addr4 = reinterpret_cast<sockaddr_in*>(&storage);
+        addr4->sin_family = AF_INET;
+        addr4->sin_port = htons(port);
+        if (inet_pton(AF_INET, host.c_str(), &addr4->sin_addr) != 1) {
+            std::cerr << "ERRO: endereço IPv4 inválido: " << host << std::endl;
+            return false;
+        }
+        addr_len = sizeof(sockaddr_in);
+        if ((ntohl(addr4->sin_addr.s_addr) >> 24) != 127) {
+            std::cerr << "AVISO: métricas expostas fora do loopback em " << address << std::endl;
+        }
+    }
+
+    int fd = socket(family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        std::cerr << "ERRO: socket falhou - " << strerror(errno) << std::endl;
+        return false;
+    }
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    if (bind(fd, reinterpret_cast<sockaddr*>(&storage), addr_len) < 0) {
+        std::cerr << "ERRO: bind em " << address << " falhou - " << strerror(errno) << std::endl;
+        close(fd);
+        return false;
+    }
+    return add_listener(fd);
+}
+
+void MetricsServer::accept_connections(int listen_fd) {
+    while (true) {
+        int fd = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            return;  // EAGAIN: fila vazia (ou erro transitório)
+        }
+        epoll_event ev = {};
+        ev.events = EPOLLIN | EPOLLRDHUP;
+        ev.data.fd = fd;
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+            close(fd);
+            continue;
+        }
+        Connection conn;
+        conn.payload = nullptr;
+        conn.sent = 0;
+        conn.close_after = false;
+        connections[fd] = std::move(conn);
+    }
+}
+
+void MetricsServer::close_connection(int fd) {
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+    close(fd);
+    connections.erase(fd);
+}
+
+// Monta cabeçalho e escolhe o corpo conforme o caminho e o Accept
+void MetricsServer::prepare_response(Connection& conn, const std::string& request_head) {
+    std::string lower = request_head;
+    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+
+    size_t first_space = request_head.find(' ');
+    size_t second_space = request_head.find(' ', first_space + 1);
+    std::string method = request_head.substr(0, first_space);
+    std::string path = first_space == std::string::npos ? ""
+        : request_head.substr(first_space + 1, second_space - first_space - 1);
+    size_t query = path.find('?');
+    if (query != std::string::npos) path.erase(query);
+
+    bool http10 = lower.find("http/1.0\r\n") != std::string::npos;
+    conn.close_after = lower.find("\r\nconnection: close") != std::string::npos ||
+                       (http10 && lower.find("\r\nconnection: keep-alive") == std::string::npos);
+    conn.body.reset();
+    conn.payload = nullptr;
+    conn.sent = 0;
+
+    static const std::string not_found = "nao encontrado: use /metrics\n";
+    static const std::string not_allowed = "metodo nao suportado\n";
+    static const std::string not_ready = "nenhuma amostra coletada ainda\n";
+
+    std::string status = "200 OK";
+    std::string content_type = "text/plain; version=0.0.4; charset=utf-8";
+    if (method != "GET") {
+        status = "405 Method Not Allowed";
+        conn.payload = &not_allowed;
+    } else if (path != "/metrics" && path != "/") {
+        status = "404 Not Found";
+        conn.payload = &not_found;
+    } else {
+        conn.body = snapshot.current();
+        if (!conn.body) {
+            status = "503 Service Unavailable";
+            conn.payload = &not_ready;
+        } else if (lower.find("application/openmetrics-text") != std::string::npos) {
+            content_type = "application/openmetrics-text; version=1.0.0; charset=utf-8";
+            conn.payload = &conn.body->openmetrics;
+        } else {
+            conn.payload = &conn.body->text;
+        }
+    }
+    if (status[0] != '2') {
+        content_type = "text/plain; charset=utf-8";
+    }
+
+    conn.header = "HTTP/1.1 " + status + "\r\n"
+                  "Content-Type: " + content_type + "\r\n"
+                  "Content-Length: " + std::to_string(conn.payload->size()) + "\r\n" +
+                  (conn.close_after ? "Connection: close\r\n" : "") + "\r\n";
+}
+
+void MetricsServer::handle_readable(int fd) {
+    Connection& conn = connections[fd];
+    char buf[4096];
+    while (true) {
+        ssize_t n = read(fd, buf, sizeof(buf));
+        if (n > 0) {
+            conn.request.append(buf, n);
+            if (conn.request.size() > MAX_REQUEST_SIZE) {
+                close_connection(fd);
+                return;
+            }
+            continue;
+        }
+        if (n == 0) {
+            close_connection(fd);  // Cliente fechou
+            return;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        }
+        close_connection(fd);
+        return;
+    }
+
+    // Ainda enviando a resposta anterior (pipelining): processa depois
+    if (conn.payload) {
+        return;
+    }
+    size_t end = conn.request.find("\r\n\r\n");
+    if (end == std::string::npos) {
+        return;  // Cabeçalho incompleto
+    }
+    std::string head = conn.request.substr(0, end + 2);
+    conn.request.erase(0, end + 4);
+    prepare_response(conn, head);
+    handle_writable(fd);
+}
+
+void MetricsServer::handle_writable(int fd) {
+    auto it = connections.find(fd);
+    if (it == connections.end() || !it->second.payload) {
+        return;
+    }
+    Connection& conn = it->second;
+    size_t total = conn.header.size() + conn.payload->size();
+
+    while (conn.sent < total) {
+        // Cabeçalho e corpo em uma única chamada
+        iovec iov[2];
+        int iov_count = 0;
+        if (conn.sent < conn.header.size()) {
+            iov[iov_count].iov_base = const_cast<char*>(conn.header.data() + conn.sent);
+            iov[iov_count].iov_len = conn.header.size() - conn.sent;
+            iov_count++;
+            iov[iov_count].iov_base = const_cast<char*>(conn.payload->data());
+            iov[iov_count].iov_len = conn.payload->size();
+            iov_count++;
+        } else {
+            size_t offset = conn.sent - conn.header.size();
+            iov[iov_count].iov_base = const_cast<char*>(conn.payload->data() + offset);
+            iov[iov_count].iov_len = conn.payload->size() - offset;
+            iov_count++;
+        }
+        msghdr msg = {};
+        msg.msg_iov = iov;
+        msg.msg_iovlen = iov_count;
+
+        ssize_t n = sendmsg(fd, &msg, MSG_NOSIGNAL);
+        if (n > 0) {
+            conn.sent += n;
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            // Buffer do socket cheio: aguarda EPOLLOUT
+            epoll_event ev = {};
+            ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP;
+            ev.data.fd = fd;
+            epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &ev);
+            return;
+        }
+        close_connection(fd);
+        return;
+    }
+
+    // Resposta completa
+    if (conn.close_after) {
+        close_connection(fd);
+        return;
+    }
+    conn.body.reset();  // Libera o buffer para o próximo publish
+    conn.payload = nullptr;
+    conn.header.clear();
+    epoll_event ev = {};
+    ev.events = EPOLLIN | EPOLLRDHUP;
+    ev.data.fd = fd;
+    epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &ev);
+
+    // Requisição seguinte já recebida (pipelining)
+    size_t end = conn.request.find("\r\n\r\n");
+    if (end != std::string::npos) {
+        std::string head = conn.request.substr(0, end + 2);
+        conn.request.erase(0, end + 4);
+        prepare_response(conn, head);
+        handle_writable(fd);
+    }
+}
+
+void MetricsServer::run(const std::atomic<bool>& active) {
+    if (epoll_fd < 0 || listen_fds.empty()) {
+        return;
+    }
+    epoll_event events[64];
+    while (active) {
+        int n = epoll_wait(epoll_fd, events, 64, 200);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "ERRO: epoll_wait falhou - " << strerror(errno) << std::endl;
+            return;
+        }
+        for (int i = 0; i < n; i++) {
+            int fd = events[i].data.fd;
+            if (std::find(listen_fds.begin(), listen_fds.end(), fd) != listen_fds.end()) {
+                accept_connections(fd);
+                continue;
+            }
+            if (!connections.count(fd)) {
+                continue;
+            }
+            if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                close_connection(fd);
+                continue;
+            }
+            if (events[i].events & EPOLLOUT) {
+                handle_writable(fd);
+            }
+            if (connections.count(fd) && (events[i].events & (EPOLLIN | EPOLLRDHUP))) {
+                handle_readable(fd);
+            }
+        }
+    }
+}
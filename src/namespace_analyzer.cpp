@@ -6,15 +6,19 @@
 // ============================================================
 
 #include "../include/namespace.hpp"
+#include "../include/procfs.hpp"
+#include "../include/process_meta.hpp"
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <filesystem>
 #include <array>
+#include <map>
 #include <unistd.h>
 #include <dirent.h>
 #include <cstring>
 #include <cstdio>
+#include <climits>
 
 namespace fs = std::filesystem;
 
@@ -74,46 +78,29 @@ std::optional<NamespaceType> string_to_namespace_type(const std::string& str) {
     return std::nullopt;
 }
 
-// ================================
-// FUNÇÃO AUXILIAR: get_process_name
-// Propósito: Lê o nome do executável de um processo
-// Lê de /proc/[pid]/comm que contém o nome do programa
-// Exemplo: /proc/1234/comm contém "bash\n"
-// Parâmetros:
-//   pid: ID do processo
-// Retorno: nome do executável, ou string vazia se erro
-// ================================
-static std::string get_process_name(pid_t pid) {
-    // Constrói o caminho: /proc/[pid]/comm
-    char path[256];
-    snprintf(path, sizeof(path), "/proc/%d/comm", pid);
-
-    std::ifstream file(path);
-    if (!file.is_open()) {
-        return "";  // Não conseguiu ler, retorna vazio
-    }
-
-    // Lê a primeira linha (nome do programa)
-    std::string name;
-    std::getline(file, name);
-    return name;
-}
-
 // ================================
 // FUNÇÃO PRINCIPAL 1: list_process_namespaces
 // Propósito: Lista todos os 7 namespaces de um processo
 // Lê os links simbólicos em /proc/[pid]/ns/
 // Exemplo de link: cgroup -> cgroup:[4026531835]
+// Os links são lidos uma vez por processo (process_meta_cache)
 // Parâmetros:
 //   pid: ID do processo a analisar
 // Retorno: std::optional com ProcessNamespaces (dados ou std::nullopt se erro)
 // ================================
 std::optional<ProcessNamespaces> list_process_namespaces(pid_t pid) {
+    // Nome e inodes vêm do cache de metadados: só a primeira consulta de
+    // cada processo lê comm e os links de /proc/[pid]/ns/
+    auto meta = process_meta_cache().get(pid);
+    if (!meta) {
+        return std::nullopt;  // Processo não existe
+    }
+
     // Inicializa a estrutura para armazenar resultados
     ProcessNamespaces proc_ns;
     proc_ns.pid = pid;
     proc_ns.ns_count = 0;
-    proc_ns.process_name = get_process_name(pid);  // Nome do processo
+    proc_ns.process_name = meta->comm;  // Nome do processo
 
     // ================================
     // ITERAR SOBRE OS 7 TIPOS DE NAMESPACE
@@ -123,46 +110,14 @@ std::optional<ProcessNamespaces> list_process_namespaces(pid_t pid) {
         NamespaceInfo ns_info;
         ns_info.type = static_cast<NamespaceType>(i);  // Tipo (ex: PID)
         ns_info.name = ns_names[i];                    // Nome (ex: "pid")
+        ns_info.inode = meta->ns_inode[i];
 
-        // ================================
-        // LER LINK SIMBÓLICO
-        // ================================
-        // Constrói o caminho: /proc/[pid]/ns/[tipo]
-        char ns_path[256];
-        snprintf(ns_path, sizeof(ns_path), "/proc/%d/ns/%s", pid, ns_names[i]);
-
-        // Lê o link simbólico
-        // Exemplo: /proc/1234/ns/pid -> "pid:[4026531836]"
-        char link_buf[256];
-        ssize_t len = readlink(ns_path, link_buf, sizeof(link_buf) - 1);
-
-        if (len != -1) {
-            // Sucesso ao ler o link
-            link_buf[len] = '\0';  // Termina string com null
-            ns_info.link = link_buf;  // Armazena conteúdo completo
-
-            // ================================
-            // EXTRAIR INODE DO LINK
-            // ================================
-            // Formato: "tipo:[numero]"
-            // Exemplo: "pid:[4026531836]"
-            // Queremos extrair só o número (4026531836)
-            // O inode é o identificador único do namespace
-            
-            unsigned long inode = 0;
-            // sscanf %*[^[] = pula até primeiro '['
-            // %lu = lê unsigned long
-            // %*] = ignora ']'
-            if (sscanf(link_buf, "%*[^[][%lu]", &inode) == 1) {
-                ns_info.inode = inode;  // Armazena inode
-            }
-
-            ns_info.exists = true;
+        // Inode 0: link ilegível (permissão negada ou namespace inexistente)
+        ns_info.exists = ns_info.inode != 0;
+        if (ns_info.exists) {
+            // Mesmo formato do link simbólico: "pid:[4026531836]"
+            ns_info.link = std::string(ns_names[i]) + ":[" + std::to_string(ns_info.inode) + "]";
             proc_ns.ns_count++;  // Incrementa contador
-        } else {
-            // Falha ao ler o link
-            // Pode ser: permissão negada ou namespace não existe
-            ns_info.exists = false;
         }
 
         // Adiciona à lista de namespaces
@@ -224,7 +179,7 @@ std::vector<pid_t> find_processes_in_namespace(NamespaceType ns_type, ino_t ns_i
     // ABRIR /proc
     // ================================
     // Lista todos os PIDs (cada entrada é um diretório numerado)
-    DIR* proc_dir = opendir("/proc");
+    DIR* proc_dir = opendir(proc_root().c_str());
     if (!proc_dir) {
         return pids;  // Retorna vazio se erro
     }
@@ -250,8 +205,8 @@ std::vector<pid_t> find_processes_in_namespace(NamespaceType ns_type, ino_t ns_i
         // LER NAMESPACE DO PROCESSO
         // ================================
         // Constrói caminho: /proc/[pid]/ns/[tipo]
-        char ns_path[256];
-        snprintf(ns_path, sizeof(ns_path), "/proc/%s/ns/%s", dir_name.c_str(), ns_names[type_idx]);
+        char ns_path[PATH_MAX];
+        snprintf(ns_path, sizeof(ns_path), "%s/%s/ns/%s", proc_root().c_str(), dir_name.c_str(), ns_names[type_idx]);
 
         // Lê o link simbólico
         char link_buf[256];
@@ -331,52 +286,27 @@ std::optional<NamespaceComparison> compare_namespaces(pid_t pid1, pid_t pid2) {
 }
 
 // ================================
-// FUNÇÃO PRINCIPAL 4: generate_namespace_report
-// Propósito: Gera um relatório completo do sistema
-// Scanneia todos os processos e agrupa por namespace+inode
-// Parâmetros:
-//   output_file: caminho do arquivo de saída
-//   format: "csv" ou "json"
-// Retorno: true se sucesso, false se erro
+// FUNÇÃO: scan_namespace_groups
+// Propósito: Agrupar todos os processos do sistema por namespace
+// Lê /proc/[pid]/ns/* de cada processo e agrupa por (tipo, inode),
+// mantendo a ordem em que cada namespace foi encontrado
+// Retorno: um NamespaceGroup por namespace distinto
 // ================================
-bool generate_namespace_report(const std::string& output_file, const std::string& format) {
-    std::ofstream fp(output_file);
-    if (!fp.is_open()) {
-        return false;  // Não conseguiu abrir arquivo
-    }
+std::vector<NamespaceGroup> scan_namespace_groups() {
+    std::vector<NamespaceGroup> groups;
 
-    bool is_json = (format == "json");
+    // Índice (tipo, inode) -> posição em groups, evita busca linear por processo
+    std::map<std::pair<int, ino_t>, size_t> index;
 
-    // ================================
-    // ESCREVER CABEÇALHO BASEADO EM FORMATO
-    // ================================
-    if (is_json) {
-        fp << "{\n  \"namespaces\": [\n";
-    } else {
-        // CSV
-        fp << "Type,Inode,ProcessCount,PIDs\n";
-    }
-
-    // ================================
-    // ESTRUTURA PARA ARMAZENAR NAMESPACES ÚNICOS
-    // ================================
-    struct UniqueNS {
-        NamespaceType type;
-        ino_t inode;
-        int count = 0;  // Quantos processos usam este namespace
-    };
-
-    std::vector<UniqueNS> unique_list;
-
-    // ================================
-    // ESCANEAR TODOS OS PROCESSOS
-    // ================================
-    DIR* proc_dir = opendir("/proc");
+    DIR* proc_dir = opendir(proc_root().c_str());
     if (!proc_dir) {
-        fp.close();
-        return false;
+        return groups;
     }
 
+    // PIDs vistos nesta varredura: entradas de processos que terminaram
+    // saem do cache de metadados ao final
+    std::vector<int> live_pids;
+
     struct dirent* entry;
     while ((entry = readdir(proc_dir)) != nullptr) {
         std::string dir_name = entry->d_name;
@@ -387,46 +317,65 @@ bool generate_namespace_report(const std::string& output_file, const std::string
         }
 
         pid_t pid = std::stoi(dir_name);
-        
-        // Obtém todos os namespaces deste processo
+        live_pids.push_back(pid);
         auto proc_ns = list_process_namespaces(pid);
-
         if (!proc_ns) {
             continue;  // Processo não mais existe
         }
 
-        // ================================
-        // PROCESSAR CADA NAMESPACE DO PROCESSO
-        // ================================
         for (const auto& ns : proc_ns->namespaces) {
             if (!ns.exists) {
-                continue;  // Namespace não existe, pula
+                continue;
             }
 
-            // ================================
-            // VERIFICAR SE NAMESPACE JÁ ESTÁ LISTADO
-            // ================================
-            bool found = false;
-            for (auto& unique : unique_list) {
-                if (unique.type == ns.type && unique.inode == ns.inode) {
-                    unique.count++;  // Incrementa contador
-                    found = true;
-                    break;
-                }
-            }
-
-            // Se não encontrou, adiciona novo
-            if (!found) {
-                UniqueNS new_ns;
-                new_ns.type = ns.type;
-                new_ns.inode = ns.inode;
-                new_ns.count = 1;
-                unique_list.push_back(new_ns);
+            auto key = std::make_pair(static_cast<int>(ns.type), ns.inode);
+            auto it = index.find(key);
+            if (it == index.end()) {
+                NamespaceGroup group;
+                group.type = ns.type;
+                group.inode = ns.inode;
+                group.process_count = 0;
+                it = index.emplace(key, groups.size()).first;
+                groups.push_back(group);
             }
+            groups[it->second].process_count++;
+            groups[it->second].pids.push_back(pid);
         }
     }
 
     closedir(proc_dir);
+    process_meta_cache().retain(live_pids);
+    return groups;
+}
+
+// ================================
+// FUNÇÃO PRINCIPAL 4: generate_namespace_report
+// Propósito: Gera um relatório completo do sistema
+// Scanneia todos os processos e agrupa por namespace+inode
+// Parâmetros:
+//   output_file: caminho do arquivo de saída
+//   format: "csv" ou "json"
+// Retorno: true se sucesso, false se erro
+// ================================
+bool generate_namespace_report(const std::string& output_file, const std::string& format) {
+    std::ofstream fp(output_file);
+    if (!fp.is_open()) {
+        return false;  // Não conseguiu abrir arquivo
+    }
+
+    bool is_json = (format == "json");
+
+    // ================================
+    // ESCREVER CABEÇALHO BASEADO EM FORMATO
+    // ================================
+    if (is_json) {
+        fp << "{\n  \"namespaces\": [\n";
+    } else {
+        // CSV
+        fp << "Type,Inode,ProcessCount,PIDs\n";
+    }
+
+    std::vector<NamespaceGroup> unique_list = scan_namespace_groups();
 
     // ================================
     // ESCREVER RESULTADOS
@@ -437,13 +386,13 @@ bool generate_namespace_report(const std::string& output_file, const std::string
             fp << "    {\n";
             fp << "      \"type\": \"" << namespace_type_to_string(unique_list[i].type) << "\",\n";
             fp << "      \"inode\": " << unique_list[i].inode << ",\n";
-            fp << "      \"process_count\": " << unique_list[i].count << "\n";
+            fp << "      \"process_count\": " << unique_list[i].process_count << "\n";
             fp << "    }" << (i < unique_list.size() - 1 ? "," : "") << "\n";
         } else {
             // Formato CSV
             fp << namespace_type_to_string(unique_list[i].type) << ","
                << unique_list[i].inode << "," 
-               << unique_list[i].count << ",\n";
+               << unique_list[i].process_count << ",\n";
         }
     }
 
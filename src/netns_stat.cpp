@@ -0,0 +1,173 @@
+// ============================================================
+// ARQUIVO: src/netns_stat.cpp
+// DESCRIÇÃO: Implementação do tráfego de rede por namespace de rede
+// ============================================================
+
+#include "../include/netns_stat.hpp"
+#include "../include/namespace.hpp"
+#include "../include/process_meta.hpp"
+#include "../include/procfs.hpp"
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <unistd.h>
+#include <fcntl.h>
+
+// Inode pelo alvo do link "net:[N]" (stat() falha nos links pendurados de um snapshot)
+NetnsStat::NetnsStat()
+    : buffer(16384), self_inode(read_ns_inode(proc_path("self/ns/net"))), generation(0), last_elapsed(0.0) {
+    // Snapshots não têm /proc/self: o namespace do init é o do host
+    if (self_inode == 0) {
+        self_inode = read_ns_inode(proc_pid_path(1, "ns/net"));
+    }
+}
+
+NetnsStat::~NetnsStat() {
+    for (auto& entry : entries) {
+        if (entry.second.fd >= 0) close(entry.second.fd);
+    }
+}
+
+// Agrupa os processos por namespace NET e abre o net/dev dos namespaces
+// novos; os que ficaram sem processos são fechados (o fd aberto mantém o
+// namespace vivo no kernel)
+void NetnsStat::rescan() {
+    for (auto& entry : entries) {
+        entry.second.seen = false;
+    }
+
+    for (const NamespaceGroup& group : scan_namespace_groups()) {
+        if (group.type != NamespaceType::NET || group.pids.empty()) continue;
+        Entry& entry = entries[group.inode];
+        entry.seen = true;
+        entry.traffic.inode = group.inode;
+        entry.traffic.process_count = group.process_count;
+        entry.traffic.host = group.inode == self_inode;
+        if (entry.fd >= 0) continue;
+
+        // Representante: o menor PID do namespace (em geral o init do contêiner)
+        std::vector<pid_t> pids = group.pids;
+        std::sort(pids.begin(), pids.end());
+        for (pid_t pid : pids) {
+            int fd = open(proc_pid_path(pid, "net/dev").c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) continue;
+            // PID reutilizado entre a varredura e a abertura: outro namespace
+            if (read_ns_inode(proc_pid_path(pid, "ns/net")) != group.inode) {
+                close(fd);
+                continue;
+            }
+            entry.fd = fd;
+            entry.traffic.pid = pid;
+            auto meta = process_meta_cache().get(pid);
+            entry.traffic.comm = meta ? meta->comm : "?";
+            entry.traffic.cgroup = meta ? meta->cgroup : "";
+            break;
+        }
+    }
+
+    for (auto it = entries.begin(); it != entries.end();) {
+        Entry& entry = it->second;
+        if (entry.seen && entry.fd >= 0) {
+            ++it;
+            continue;
+        }
+        if (entry.fd >= 0) close(entry.fd);
+        it = entries.erase(it);
+    }
+}
+
+// Relê o net/dev do namespace e calcula as taxas de cada interface
+// Formato: duas linhas de cabeçalho, depois "nome: 8 campos rx 8 campos tx"
+bool NetnsStat::read_entry(Entry& entry, double elapsed) {
+    ssize_t n;
+    while ((n = pread(entry.fd, buffer.data(), buffer.size() - 1, 0)) == static_cast<ssize_t>(buffer.size() - 1)) {
+        buffer.resize(buffer.size() * 2);  // Muitas interfaces: lê de novo com buffer maior
+    }
+    if (n <= 0) {
+        return false;
+    }
+    buffer[n] = '\0';
+
+    NetnsTraffic& traffic = entry.traffic;
+    std::vector<NetInterfaceStats> previous;
+    previous.swap(traffic.interfaces);
+    traffic.rx_rate = traffic.tx_rate = 0;
+    bool rates = entry.has_prev && elapsed > 0;
+
+    const char* line = strchr(buffer.data(), '\n');
+    line = line ? strchr(line + 1, '\n') : nullptr;  // Pula os dois cabeçalhos
+    while (line && *++line) {
+        const char* colon = strchr(line, ':');
+        const char* end = strchr(line, '\n');
+        if (!colon || (end && colon > end)) break;
+
+        NetInterfaceStats iface;
+        const char* name = line;
+        while (*name == ' ') name++;
+        iface.name.assign(name, colon);
+
+        uint64_t fields[16] = {};
+        char* p = const_cast<char*>(colon + 1);
+        for (int i = 0; i < 16; i++) {
+            fields[i] = strtoull(p, &p, 10);
+        }
+        iface.rx_bytes = fields[0];
+        iface.rx_packets = fields[1];
+        iface.rx_errors = fields[2];
+        iface.rx_drops = fields[3];
+        iface.tx_bytes = fields[8];
+        iface.tx_packets = fields[9];
+        iface.tx_errors = fields[10];
+        iface.tx_drops = fields[11];
+
+        if (rates) {
+            // Mesma interface no ciclo anterior (contador menor = interface recriada)
+            for (const NetInterfaceStats& prev : previous) {
+                if (prev.name != iface.name) continue;
+                if (iface.rx_bytes >= prev.rx_bytes && iface.tx_bytes >= prev.tx_bytes) {
+                    iface.rx_rate = (iface.rx_bytes - prev.rx_bytes) / elapsed;
+                    iface.tx_rate = (iface.tx_bytes - prev.tx_bytes) / elapsed;
+                }
+                if (iface.rx_packets >= prev.rx_packets && iface.tx_packets >= prev.tx_packets) {
+                    iface.rx_packet_rate = (iface.rx_packets - prev.rx_packets) / elapsed;
+                    iface.tx_packet_rate = (iface.tx_packets - prev.tx_packets) / elapsed;
+                }
+                break;
+            }
+        }
+        if (iface.name != "lo") {
+            traffic.rx_rate += iface.rx_rate;
+            traffic.tx_rate += iface.tx_rate;
+        }
+        traffic.interfaces.push_back(std::move(iface));
+        line = end;
+    }
+    entry.has_prev = true;
+    return true;
+}
+
+size_t NetnsStat::sample() {
+    auto now = std::chrono::steady_clock::now();
+    last_elapsed = generation > 0 ? std::chrono::duration<double>(now - prev_time).count() : 0.0;
+    prev_time = now;
+    if (generation % RESCAN_TICKS == 0) {
+        rescan();
+    }
+    generation++;
+
+    order.clear();
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (!read_entry(it->second, last_elapsed)) {
+            close(it->second.fd);
+            it = entries.erase(it);
+            continue;
+        }
+        order.push_back(&it->second.traffic);
+        ++it;
+    }
+    std::sort(order.begin(), order.end(), [](const NetnsTraffic* a, const NetnsTraffic* b) {
+        double va = a->rx_rate + a->tx_rate, vb = b->rx_rate + b->tx_rate;
+        return va != vb ? va > vb : a->inode < b->inode;
+    });
+    return order.size();
+}
@@ -0,0 +1,265 @@
+// ============================================================
+// ARQUIVO: src/numa.cpp
+// DESCRIÇÃO: Implementação do posicionamento NUMA
+// ============================================================
+
+#include "../include/numa.hpp"
+#include "../include/procfs.hpp"
+#include "../include/cpu_stat.hpp"
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+#include <cerrno>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+long long ProcessNuma::total_kb() const {
+    long long total = 0;
+    for (long long kb : resident_kb) total += kb;
+    return total;
+}
+
+std::vector<NumaNode> read_numa_nodes() {
+    std::vector<NumaNode> nodes;
+    std::string base = sys_path("devices/system/node");
+    DIR* dir = opendir(base.c_str());
+    if (!dir) {
+        return nodes;
+    }
+    while (dirent* entry = readdir(dir)) {
+        if (strncmp(entry->d_name, "node", 4) != 0 || !isdigit(static_cast<unsigned char>(entry->d_name[4]))) {
+            continue;
+        }
+        NumaNode node;
+        node.node = atoi(entry->d_name + 4);
+        std::string path = base + "/" + entry->d_name;
+        std::string line;
+
+        std::ifstream cpulist(path + "/cpulist");
+        if (std::getline(cpulist, line)) {
+            node.cpus = parse_cpu_list(line);
+        }
+
+        // "Node 0 MemTotal:       6147400 kB"
+        std::ifstream meminfo(path + "/meminfo");
+        while (std::getline(meminfo, line)) {
+            char key[64];
+            long long value;
+            if (sscanf(line.c_str(), "Node %*d %63[^:]: %lld", key, &value) != 2) continue;
+            if (strcmp(key, "MemTotal") == 0) node.mem_total_kb = value;
+            else if (strcmp(key, "MemFree") == 0) node.mem_free_kb = value;
+        }
+
+        static const struct {
+            const char* key;
+            unsigned long long NumaNode::*field;
+        } counters[] = {
+            {"numa_hit", &NumaNode::numa_hit},
+            {"numa_miss", &NumaNode::numa_miss},
+            {"numa_foreign", &NumaNode::numa_foreign},
+            {"local_node", &NumaNode::local_node},
+            {"other_node", &NumaNode::other_node},
+        };
+        std::ifstream numastat(path + "/numastat");
+        while (std::getline(numastat, line)) {
+            size_t space = line.find(' ');
+            if (space == std::string::npos) continue;
+            for (const auto& counter : counters) {
+                if (line.compare(0, space, counter.key) == 0) {
+                    node.*(counter.field) = strtoull(line.c_str() + space + 1, nullptr, 10);
+                    break;
+                }
+            }
+        }
+        nodes.push_back(std::move(node));
+    }
+    closedir(dir);
+    std::sort(nodes.begin(), nodes.end(), [](const NumaNode& a, const NumaNode& b) { return a.node < b.node; });
+    return nodes;
+}
+
+std::vector<int> numa_cpu_nodes(const std::vector<NumaNode>& nodes) {
+    std::vector<int> cpu_nodes;
+    for (const NumaNode& node : nodes) {
+        for (int cpu : node.cpus) {
+            if (cpu < 0) continue;
+            if (static_cast<size_t>(cpu) >= cpu_nodes.size()) cpu_nodes.resize(cpu + 1, -1);
+            cpu_nodes[cpu] = node.node;
+        }
+    }
+    return cpu_nodes;
+}
+
+// Uma linha de numa_maps: "<endereço> <política> [file=...] ... N0=12 N1=3 kernelpagesize_kB=4"
+// As páginas de cada nó valem kernelpagesize_kB (2048 em VMAs de páginas enormes)
+static void add_numa_line(const char* line, const char* end, std::vector<long long>& resident_kb) {
+    // Até 64 nós por linha antes de saber o tamanho da página (vem no fim)
+    int nodes[64];
+    long long pages[64];
+    int count = 0;
+    long long page_kb = 4;
+    const char* p = line;
+    while (p < end) {
+        while (p < end && *p == ' ') p++;
+        const char* token = p;
+        while (p < end && *p != ' ') p++;
+        if (token == p) break;
+        if (token[0] == 'N' && token + 1 < p && isdigit(static_cast<unsigned char>(token[1]))) {
+            char* eq;
+            long node = strtol(token + 1, &eq, 10);
+            if (*eq == '=' && count < 64) {
+                nodes[count] = static_cast<int>(node);
+                pages[count] = strtoll(eq + 1, nullptr, 10);
+                count++;
+            }
+        } else if (p - token > 18 && strncmp(token, "kernelpagesize_kB=", 18) == 0) {
+            page_kb = strtoll(token + 18, nullptr, 10);
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        if (nodes[i] < 0) continue;
+        if (static_cast<size_t>(nodes[i]) >= resident_kb.size()) resident_kb.resize(nodes[i] + 1, 0);
+        resident_kb[nodes[i]] += pages[i] * page_kb;
+    }
+}
+
+int get_numa_maps(int pid, std::vector<long long>& resident_kb) {
+    std::string path = proc_pid_path(pid, "numa_maps");
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        if (errno == ENOENT) {
+            std::cerr << "ERRO: Processo com PID " << pid << " não existe (ou kernel sem NUMA)" << std::endl;
+            return ERR_PROCESS_NOT_FOUND;
+        } else if (errno == EACCES) {
+            std::cerr << "ERRO: Permissão negada para acessar processo " << pid << std::endl;
+            return ERR_PERMISSION_DENIED;
+        } else {
+            std::cerr << "ERRO: Não foi possível abrir " << path << " - " << strerror(errno) << std::endl;
+            return ERR_UNKNOWN;
+        }
+    }
+
+    // Leitura em blocos, linha a linha: o arquivo tem uma linha por VMA
+    // e pode passar de megabytes; só o resto de linha incompleta é guardado
+    resident_kb.assign(resident_kb.size(), 0);
+    std::vector<char> buffer(65536);
+    size_t pending = 0;
+    while (true) {
+        if (pending == buffer.size()) {
+            buffer.resize(buffer.size() * 2);   // Linha maior que o bloco
+        }
+        ssize_t n = read(fd, buffer.data() + pending, buffer.size() - pending);
+        if (n < 0) {
+            int err = errno;
+            close(fd);
+            // Leitura falha com EACCES sem permissão de ptrace
+            return err == EACCES ? ERR_PERMISSION_DENIED : err == ESRCH ? ERR_PROCESS_NOT_FOUND : ERR_UNKNOWN;
+        }
+        size_t filled = pending + static_cast<size_t>(n);
+        const char* start = buffer.data();
+        const char* stop = buffer.data() + filled;
+        const char* newline;
+        while ((newline = static_cast<const char*>(memchr(start, '\n', stop - start)))) {
+            add_numa_line(start, newline, resident_kb);
+            start = newline + 1;
+        }
+        if (n == 0) {
+            if (start < stop) add_numa_line(start, stop, resident_kb);
+            break;
+        }
+        pending = static_cast<size_t>(stop - start);
+        memmove(buffer.data(), start, pending);
+    }
+    close(fd);
+    return 0;
+}
+
+int get_thread_nodes(int pid, const std::vector<int>& cpu_nodes, std::vector<int>& threads) {
+    std::string task_dir = proc_pid_path(pid, "task");
+    DIR* dir = opendir(task_dir.c_str());
+    if (!dir) {
+        return errno == EACCES ? ERR_PERMISSION_DENIED : errno == ENOENT ? ERR_PROCESS_NOT_FOUND : ERR_UNKNOWN;
+    }
+    threads.assign(threads.size(), 0);
+    int counted = 0;
+    char buf[1024];
+    while (dirent* entry = readdir(dir)) {
+        if (!isdigit(static_cast<unsigned char>(entry->d_name[0]))) continue;
+        FILE* file = fopen((task_dir + "/" + entry->d_name + "/stat").c_str(), "r");
+        if (!file) continue;    // Thread terminou durante a listagem
+        size_t n = fread(buf, 1, sizeof(buf) - 1, file);
+        fclose(file);
+        buf[n] = '\0';
+
+        // processor: campo 39, o 37º depois do ')' que fecha o comm
+        const char* p = strrchr(buf, ')');
+        for (int field = 2; p && field < 39; field++) {
+            p = strchr(p + 1, ' ');
+        }
+        if (!p) continue;
+        int cpu = atoi(p + 1);
+        int node = cpu >= 0 && static_cast<size_t>(cpu) < cpu_nodes.size() ? cpu_nodes[cpu] : -1;
+        if (node < 0) continue;
+        if (static_cast<size_t>(node) >= threads.size()) threads.resize(node + 1, 0);
+        threads[node]++;
+        counted++;
+    }
+    closedir(dir);
+    return counted;
+}
+
+void classify_numa(ProcessNuma& numa, double misplaced_ratio) {
+    numa.memory_node = -1;
+    numa.thread_node = -1;
+    for (size_t i = 0; i < numa.resident_kb.size(); i++) {
+        if (numa.resident_kb[i] > 0 &&
+            (numa.memory_node < 0 || numa.resident_kb[i] > numa.resident_kb[numa.memory_node])) {
+            numa.memory_node = static_cast<int>(i);
+        }
+    }
+    for (size_t i = 0; i < numa.threads.size(); i++) {
+        if (numa.threads[i] > 0 && (numa.thread_node < 0 || numa.threads[i] > numa.threads[numa.thread_node])) {
+            numa.thread_node = static_cast<int>(i);
+        }
+    }
+
+    long long total = numa.total_kb();
+    numa.local_ratio = 1.0;
+    if (total > 0 && numa.thread_node >= 0) {
+        long long local = static_cast<size_t>(numa.thread_node) < numa.resident_kb.size()
+            ? numa.resident_kb[numa.thread_node] : 0;
+        numa.local_ratio = static_cast<double>(local) / total;
+    }
+    numa.misplaced = numa.memory_node >= 0 && numa.thread_node >= 0 &&
+                     numa.memory_node != numa.thread_node && numa.local_ratio < misplaced_ratio;
+}
+
+int get_process_numa(int pid, const std::vector<int>& cpu_nodes, ProcessNuma& numa, double misplaced_ratio) {
+    int result = get_numa_maps(pid, numa.resident_kb);
+    if (result < 0) {
+        return result;
+    }
+    result = get_thread_nodes(pid, cpu_nodes, numa.threads);
+    if (result < 0) {
+        return result;
+    }
+    classify_numa(numa, misplaced_ratio);
+    return 0;
+}
+
+int sample_numa_adaptive(int pid, const std::vector<int>& cpu_nodes, NumaSchedule& schedule) {
+    ProcessNuma fresh;
+    int result = run_read_schedule(schedule, false, [&] {
+        return get_process_numa(pid, cpu_nodes, fresh, schedule.misplaced_ratio);
+    });
+    if (result == 1) {
+        schedule.last = std::move(fresh);
+    }
+    return result;
+}
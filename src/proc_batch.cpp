@@ -0,0 +1,411 @@
+// ============================================================
+// ARQUIVO: src/proc_batch.cpp
+// DESCRIÇÃO: Implementação da leitura em lote do /proc (io_uring)
+// O anel é usado direto pelas syscalls (io_uring_setup/enter/register
+// e os mmaps documentados em linux/io_uring.h), sem liburing
+// ============================================================
+
+#include "../include/proc_batch.hpp"
+#include "../include/procfs.hpp"
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <cstdint>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <linux/io_uring.h>
+
+// ================================
+// BatchReader
+// ================================
+
+BatchReader::BatchReader(bool use_uring)
+    : arena_used(0), ring_fd(-1), sq_ring(nullptr), cq_ring(nullptr), sqes(nullptr),
+      sq_ring_size(0), cq_ring_size(0), sqes_size(0), sq_entries(0),
+      sq_head(nullptr), sq_tail(nullptr), sq_mask(nullptr), sq_array(nullptr),
+      cq_head(nullptr), cq_tail(nullptr), cq_mask(nullptr), cqes(nullptr),
+      registered(nullptr), registered_size(0), register_failed(false), enter_calls(0) {
+    if (use_uring) {
+        setup_ring();
+    }
+}
+
+BatchReader::~BatchReader() {
+    teardown_ring();
+}
+
+bool BatchReader::setup_ring() {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    int fd = static_cast<int>(syscall(__NR_io_uring_setup, RING_ENTRIES, &params));
+    if (fd < 0) {
+        return false;  // ENOSYS, EPERM (io_uring_disabled, seccomp)
+    }
+    // IORING_OP_READ chegou junto com IORING_FEAT_RW_CUR_POS (5.6)
+    if (!(params.features & IORING_FEAT_RW_CUR_POS)) {
+        close(fd);
+        return false;
+    }
+
+    sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+    cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap) {
+        sq_ring_size = cq_ring_size = std::max(sq_ring_size, cq_ring_size);
+    }
+    sq_ring = mmap(nullptr, sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (sq_ring == MAP_FAILED) {
+        sq_ring = nullptr;
+        close(fd);
+        return false;
+    }
+    cq_ring = single_mmap ? sq_ring
+        : mmap(nullptr, cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+    sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    sqes = mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    ring_fd = fd;
+    if (cq_ring == MAP_FAILED || sqes == MAP_FAILED) {
+        if (cq_ring == MAP_FAILED) cq_ring = nullptr;
+        if (sqes == MAP_FAILED) sqes = nullptr;
+        teardown_ring();
+        return false;
+    }
+
+    char* sq = static_cast<char*>(sq_ring);
+    char* cq = static_cast<char*>(cq_ring);
+    sq_entries = params.sq_entries;
+    sq_head = reinterpret_cast<unsigned int*>(sq + params.sq_off.head);
+    sq_tail = reinterpret_cast<unsigned int*>(sq + params.sq_off.tail);
+    sq_mask = reinterpret_cast<unsigned int*>(sq + params.sq_off.ring_mask);
+    sq_array = reinterpret_cast<unsigned int*>(sq + params.sq_off.array);
+    cq_head = reinterpret_cast<unsigned int*>(cq + params.cq_off.head);
+    cq_tail = reinterpret_cast<unsigned int*>(cq + params.cq_off.tail);
+    cq_mask = reinterpret_cast<unsigned int*>(cq + params.cq_off.ring_mask);
+    cqes = cq + params.cq_off.cqes;
+    return true;
+}
+
+void BatchReader::teardown_ring() {
+    if (sqes) munmap(sqes, sqes_size);
+    if (cq_ring && cq_ring != sq_ring) munmap(cq_ring, cq_ring_size);
+    if (sq_ring) munmap(sq_ring, sq_ring_size);
+    sqes = sq_ring = cq_ring = nullptr;
+    if (ring_fd >= 0) {
+        close(ring_fd);  // Também desfaz o registro da arena
+        ring_fd = -1;
+    }
+    registered = nullptr;
+    registered_size = 0;
+}
+
+// Registra a arena inteira como um buffer fixo: o kernel mapeia as páginas
+// uma vez em vez de a cada leitura. Refeito quando a arena cresce
+void BatchReader::register_arena() {
+    if (registered) {
+        syscall(__NR_io_uring_register, ring_fd, IORING_UNREGISTER_BUFFERS, nullptr, 0);
+        registered = nullptr;
+        registered_size = 0;
+    }
+    struct iovec iov = {arena.data(), arena.size()};
+    if (syscall(__NR_io_uring_register, ring_fd, IORING_REGISTER_BUFFERS, &iov, 1) == 0) {
+        registered = arena.data();
+        registered_size = arena.size();
+    } else {
+        register_failed = true;  // Segue com IORING_OP_READ comum
+    }
+}
+
+size_t BatchReader::add(int fd, size_t capacity) {
+    // +1: '\0' depois dos dados
+    size_t needed = arena_used + capacity + 1;
+    if (needed > arena.size()) {
+        arena.resize(std::max(needed, arena.size() * 2));
+    }
+    requests.push_back({fd, arena_used, capacity});
+    arena_used = needed;
+    return requests.size() - 1;
+}
+
+void BatchReader::clear() {
+    requests.clear();
+    arena_used = 0;
+}
+
+void BatchReader::run(const std::function<void(size_t, const char*, ssize_t)>& on_complete) {
+    if (requests.empty()) {
+        return;
+    }
+    if (ring_fd >= 0) {
+        run_uring(on_complete);
+    } else {
+        run_sync(on_complete);
+    }
+}
+
+void BatchReader::run_sync(const std::function<void(size_t, const char*, ssize_t)>& on_complete) {
+    for (size_t i = 0; i < requests.size(); i++) {
+        const Request& r = requests[i];
+        char* data = arena.data() + r.offset;
+        ssize_t n = pread(r.fd, data, r.capacity, 0);
+        enter_calls++;
+        if (n < 0) n = -errno;
+        data[n > 0 ? n : 0] = '\0';
+        on_complete(i, data, n);
+    }
+}
+
+void BatchReader::run_uring(const std::function<void(size_t, const char*, ssize_t)>& on_complete) {
+    if (!register_failed && (registered != arena.data() || registered_size < arena.size())) {
+        register_arena();
+    }
+
+    struct io_uring_sqe* sqe_array = static_cast<struct io_uring_sqe*>(sqes);
+    struct io_uring_cqe* cqe_array = static_cast<struct io_uring_cqe*>(cqes);
+    size_t total = requests.size();
+    size_t next = 0;
+    unsigned int inflight = 0;
+    unsigned int pending = 0;       // SQEs no anel ainda não aceitas pelo kernel
+    std::vector<char> done(total, 0);
+
+    while (next < total || inflight > 0 || pending > 0) {
+        // Preenche o anel com o próximo lote (só esta thread produz)
+        unsigned int tail = *sq_tail;
+        while (next < total && inflight + pending < sq_entries) {
+            unsigned int idx = tail & *sq_mask;
+            struct io_uring_sqe* sqe = &sqe_array[idx];
+            const Request& r = requests[next];
+            memset(sqe, 0, sizeof(*sqe));
+            sqe->opcode = registered ? IORING_OP_READ_FIXED : IORING_OP_READ;
+            sqe->fd = r.fd;
+            sqe->off = 0;
+            sqe->addr = reinterpret_cast<uint64_t>(arena.data() + r.offset);
+            sqe->len = static_cast<uint32_t>(r.capacity);
+            sqe->buf_index = 0;
+            sqe->user_data = next;
+            sq_array[idx] = idx;
+            tail++;
+            pending++;
+            next++;
+        }
+        __atomic_store_n(sq_tail, tail, __ATOMIC_RELEASE);
+
+        // Envia o lote e espera todas as leituras em voo. O retorno é o
+        // número de SQEs aceitas: numa submissão parcial o kernel não
+        // espera, e o restante segue pendente para a próxima chamada
+        long ret = syscall(__NR_io_uring_enter, ring_fd, pending, inflight + pending,
+                           IORING_ENTER_GETEVENTS, nullptr, 0);
+        enter_calls++;
+        unsigned int submitted = ret > 0 ? static_cast<unsigned int>(ret) : 0;
+        // Nada aceito e nada em voo (sem ser por sinal): o anel não avança
+        bool stuck = ret == 0 && pending > 0 && inflight == 0;
+        if ((ret < 0 && errno != EINTR) || stuck) {
+            // Anel inutilizável: o restante (e os próximos ciclos) via pread
+            teardown_ring();
+            for (size_t i = 0; i < total; i++) {
+                if (done[i]) continue;
+                const Request& r = requests[i];
+                char* data = arena.data() + r.offset;
+                ssize_t n = pread(r.fd, data, r.capacity, 0);
+                enter_calls++;
+                if (n < 0) n = -errno;
+                data[n > 0 ? n : 0] = '\0';
+                on_complete(i, data, n);
+            }
+            return;
+        }
+        inflight += submitted;
+        pending -= submitted;
+
+        // Trata as conclusões na ordem em que chegaram
+        unsigned int head = *cq_head;
+        unsigned int cq_end = __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+        while (head != cq_end) {
+            const struct io_uring_cqe& cqe = cqe_array[head & *cq_mask];
+            size_t i = static_cast<size_t>(cqe.user_data);
+            ssize_t n = cqe.res;
+            head++;
+            inflight--;
+            done[i] = 1;
+            char* data = arena.data() + requests[i].offset;
+            data[n > 0 ? n : 0] = '\0';
+            on_complete(i, data, n);
+        }
+        __atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+    }
+}
+
+// ================================
+// ProcBatch
+// ================================
+
+// Valor numérico depois de uma chave ("\nVmRSS:") em status ou io; 0 se ausente
+static long field_after(const char* buf, const char* key) {
+    const char* p = strstr(buf, key);
+    return p ? strtol(p + strlen(key), nullptr, 10) : 0;
+}
+
+// /proc/[pid]/stat: campos contados a partir do último ')' (o comm pode
+// conter espaços e parênteses)
+static bool parse_stat(const char* buf, ProcStats& stats) {
+    const char* p = strrchr(buf, ')');
+    if (!p) return false;
+    p += 2;  // Campo 3 (state)
+    for (int field = 3; field <= 22 && *p; field++) {
+        char* end;
+        long long value = strtoll(p, &end, 10);
+        switch (field) {
+            case 10: stats.minor_faults = static_cast<long>(value); break;
+            case 12: stats.major_faults = static_cast<long>(value); break;
+            case 14: stats.utime = static_cast<long>(value); break;
+            case 15: stats.stime = static_cast<long>(value); break;
+            case 16: stats.cutime = static_cast<long>(value); break;
+            case 17: stats.cstime = static_cast<long>(value); break;
+            case 22: stats.start_time = value; break;
+        }
+        p = strchr(p, ' ');
+        if (!p) break;
+        p++;
+    }
+    return true;
+}
+
+static void parse_status(const char* buf, ProcStats& stats) {
+    stats.memory_vsz = field_after(buf, "\nVmSize:");
+    stats.memory_rss = field_after(buf, "\nVmRSS:");
+    stats.memory_swap = field_after(buf, "\nVmSwap:");
+    stats.threads = static_cast<int>(field_after(buf, "\nThreads:"));
+    stats.voluntary_ctxt = field_after(buf, "\nvoluntary_ctxt_switches:");
+    stats.nonvoluntary_ctxt = field_after(buf, "\nnonvoluntary_ctxt_switches:");
+}
+
+static void parse_io(const char* buf, ProcStats& stats) {
+    stats.io_read_bytes = field_after(buf, "\nread_bytes:");
+    stats.io_write_bytes = field_after(buf, "\nwrite_bytes:");
+}
+
+// Erro de leitura/abertura no código dos coletores
+static int error_code(int err) {
+    if (err == ENOENT || err == ESRCH) return ERR_PROCESS_NOT_FOUND;
+    if (err == EACCES || err == EPERM) return ERR_PERMISSION_DENIED;
+    return ERR_UNKNOWN;
+}
+
+ProcBatch::ProcBatch(bool use_uring, bool io) : reader(use_uring), with_io(io) {
+    // Até 3 fds por alvo: eleva o limite flexível até o rígido
+    raise_nofile_limit();
+}
+
+ProcBatch::~ProcBatch() {
+    for (auto& entry : files) {
+        close_files(entry.second);
+    }
+}
+
+// Retorno: 0 ou ERR_*
+int ProcBatch::open_files(int pid, Files& f) {
+    f.stat_fd = open(proc_pid_path(pid, "stat").c_str(), O_RDONLY | O_CLOEXEC);
+    if (f.stat_fd < 0) return error_code(errno);
+    f.status_fd = open(proc_pid_path(pid, "status").c_str(), O_RDONLY | O_CLOEXEC);
+    if (f.status_fd < 0) return error_code(errno);
+    if (with_io) {
+        f.io_fd = open(proc_pid_path(pid, "io").c_str(), O_RDONLY | O_CLOEXEC);
+        if (f.io_fd < 0) return error_code(errno);
+    }
+    return 0;
+}
+
+void ProcBatch::close_files(Files& f) {
+    if (f.stat_fd >= 0) close(f.stat_fd);
+    if (f.status_fd >= 0) close(f.status_fd);
+    if (f.io_fd >= 0) close(f.io_fd);
+    f.stat_fd = f.status_fd = f.io_fd = -1;
+}
+
+void ProcBatch::forget(int pid) {
+    auto it = files.find(pid);
+    if (it != files.end()) {
+        close_files(it->second);
+        files.erase(it);
+    }
+}
+
+void ProcBatch::sample(const std::vector<int>& pids, long mem_total_kb,
+                       std::vector<ProcStats>& stats, std::vector<int>& results) {
+    stats.assign(pids.size(), ProcStats{});
+    results.assign(pids.size(), 0);
+
+    // Dono de cada leitura: (índice do alvo, arquivo: 0 stat, 1 status, 2 io)
+    std::vector<std::pair<size_t, int>> owners;
+    owners.reserve(pids.size() * 3);
+    reader.clear();
+    for (size_t i = 0; i < pids.size(); i++) {
+        auto found = files.find(pids[i]);
+        if (found == files.end()) {
+            Files f;
+            int error = open_files(pids[i], f);
+            if (error != 0) {
+                close_files(f);
+                results[i] = error;
+                continue;
+            }
+            found = files.emplace(pids[i], f).first;
+        }
+        const Files& f = found->second;
+        reader.add(f.stat_fd, STAT_CAPACITY);
+        owners.emplace_back(i, 0);
+        reader.add(f.status_fd, STATUS_CAPACITY);
+        owners.emplace_back(i, 1);
+        if (f.io_fd >= 0) {
+            reader.add(f.io_fd, IO_CAPACITY);
+            owners.emplace_back(i, 2);
+        }
+    }
+
+    reader.run([&](size_t index, const char* data, ssize_t n) {
+        size_t i = owners[index].first;
+        int kind = owners[index].second;
+        if (results[i] != 0) {
+            return;  // Outro arquivo do mesmo alvo já falhou
+        }
+        if (n <= 0) {
+            // fd preso ao processo original: ESRCH = terminou (ou PID reutilizado)
+            results[i] = n == 0 ? ERR_PROCESS_NOT_FOUND : error_code(static_cast<int>(-n));
+            return;
+        }
+        if (kind == 0) {
+            if (!parse_stat(data, stats[i])) results[i] = ERR_UNKNOWN;
+        } else if (kind == 1) {
+            if (static_cast<size_t>(n) < STATUS_CAPACITY) {
+                parse_status(data, stats[i]);
+                return;
+            }
+            // status maior que o buffer (muitos grupos, listas de CPUs longas):
+            // releitura síncrona só deste alvo
+            std::vector<char> large(64 * 1024);
+            ssize_t len = pread(files[pids[i]].status_fd, large.data(), large.size() - 1, 0);
+            if (len <= 0) {
+                results[i] = ERR_PROCESS_NOT_FOUND;
+                return;
+            }
+            large[len] = '\0';
+            parse_status(large.data(), stats[i]);
+        } else {
+            parse_io(data, stats[i]);
+        }
+    });
+
+    for (size_t i = 0; i < pids.size(); i++) {
+        if (results[i] != 0) {
+            forget(pids[i]);
+            continue;
+        }
+        ProcStats& s = stats[i];
+        s.memory_pss = -1;  // Preenchidos por sample_smaps_adaptive
+        s.memory_uss = -1;
+        s.memory_percent = mem_total_kb > 0 ? (s.memory_rss * 100.0) / mem_total_kb : 0.0;
+    }
+}
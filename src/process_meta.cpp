@@ -0,0 +1,170 @@
+// ============================================================
+// ARQUIVO: src/process_meta.cpp
+// DESCRIÇÃO: Implementação do cache de metadados de processos
+// ============================================================
+
+#include "../include/process_meta.hpp"
+#include "../include/procfs.hpp"
+#include "../include/cgroup_manager.hpp"
+#include <unordered_set>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+static const char* const META_NS_NAMES[PROCESS_META_NS_COUNT] = {
+    "cgroup", "ipc", "mnt", "net", "pid", "user", "uts"
+};
+
+// Campos de /proc/[pid]/stat usados pelo cache
+struct StatFields {
+    std::string comm;
+    int ppid = -1;
+    long long start_time = -1;
+};
+
+// comm fica entre o primeiro '(' e o último ')' (o nome pode conter ")")
+static bool read_stat_fields(int pid, StatFields& out) {
+    FILE* file = fopen(proc_pid_path(pid, "stat").c_str(), "r");
+    if (!file) {
+        return false;
+    }
+    char buf[1024];
+    size_t n = fread(buf, 1, sizeof(buf) - 1, file);
+    fclose(file);
+    buf[n] = '\0';
+
+    const char* open = strchr(buf, '(');
+    const char* close = strrchr(buf, ')');
+    if (!open || !close || close < open) {
+        return false;
+    }
+    out.comm.assign(open + 1, close);
+
+    // Depois do ')': estado (3), ppid (4), ..., starttime (22)
+    const char* p = close;
+    for (int field = 2; p && field < 22; field++) {
+        p = strchr(p + 1, ' ');
+        if (p && field == 3) out.ppid = atoi(p + 1);
+    }
+    if (!p) {
+        return false;
+    }
+    out.start_time = strtoll(p + 1, nullptr, 10);
+    return true;
+}
+
+// Leitura completa dos metadados (uma vez por processo)
+static std::shared_ptr<ProcessMeta> load_meta(int pid, const StatFields& fields) {
+    auto meta = std::make_shared<ProcessMeta>();
+    meta->pid = pid;
+    meta->start_time = fields.start_time;
+    meta->comm = fields.comm;
+    meta->ppid = fields.ppid;
+
+    // cmdline: argumentos separados por '\0'
+    FILE* cmdline = fopen(proc_pid_path(pid, "cmdline").c_str(), "r");
+    if (cmdline) {
+        char buf[4096];
+        size_t n = fread(buf, 1, sizeof(buf), cmdline);
+        fclose(cmdline);
+        while (n > 0 && buf[n - 1] == '\0') n--;
+        for (size_t i = 0; i < n; i++) {
+            if (buf[i] == '\0') buf[i] = ' ';
+        }
+        meta->cmdline.assign(buf, n);
+    }
+
+    char link[4096];
+    ssize_t len = readlink(proc_pid_path(pid, "exe").c_str(), link, sizeof(link) - 1);
+    if (len > 0) {
+        meta->exe.assign(link, static_cast<size_t>(len));
+    }
+
+    FILE* status = fopen(proc_pid_path(pid, "status").c_str(), "r");
+    if (status) {
+        char line[256];
+        while (fgets(line, sizeof(line), status)) {
+            if (sscanf(line, "Uid: %d", &meta->uid) == 1) break;
+        }
+        fclose(status);
+    }
+
+    meta->cgroup = CGroupManager::get_current_cgroup(pid);
+
+    for (size_t i = 0; i < PROCESS_META_NS_COUNT; i++) {
+        meta->ns_inode[i] = read_ns_inode(proc_pid_path(pid, std::string("ns/") + META_NS_NAMES[i]));
+    }
+    return meta;
+}
+
+std::shared_ptr<const ProcessMeta> ProcessMetaCache::get(int pid, long long start_time) {
+    if (start_time >= 0) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(pid);
+        if (it != entries.end() && it->second->start_time == start_time) {
+            hit_count++;
+            return it->second;
+        }
+    }
+
+    // Uma leitura de stat confirma o processo (início e comm)
+    StatFields fields;
+    if (!read_stat_fields(pid, fields) || (start_time >= 0 && fields.start_time != start_time)) {
+        return nullptr;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(pid);
+        if (it != entries.end() && it->second->start_time == fields.start_time && it->second->comm == fields.comm) {
+            hit_count++;
+            return it->second;
+        }
+    }
+
+    // Leitura fora do lock: outras threads continuam consultando o cache
+    std::shared_ptr<const ProcessMeta> meta = load_meta(pid, fields);
+    std::lock_guard<std::mutex> lock(mutex);
+    entries[pid] = meta;
+    load_count++;
+    return meta;
+}
+
+std::shared_ptr<const ProcessMeta> ProcessMetaCache::find(int pid) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(pid);
+    return it != entries.end() ? it->second : nullptr;
+}
+
+void ProcessMetaCache::forget(int pid) {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.erase(pid);
+}
+
+void ProcessMetaCache::retain(const std::vector<int>& live_pids) {
+    std::unordered_set<int> live(live_pids.begin(), live_pids.end());
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto it = entries.begin(); it != entries.end();) {
+        it = live.count(it->first) ? std::next(it) : entries.erase(it);
+    }
+}
+
+size_t ProcessMetaCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
+
+unsigned long ProcessMetaCache::hits() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return hit_count;
+}
+
+unsigned long ProcessMetaCache::loads() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return load_count;
+}
+
+ProcessMetaCache& process_meta_cache() {
+    static ProcessMetaCache cache;
+    return cache;
+}
@@ -0,0 +1,332 @@
+// ============================================================
+// ARQUIVO: src/process_table.cpp
+// DESCRIÇÃO: Implementação da amostragem em lote de processos
+// ============================================================
+
+#include "../include/process_table.hpp"
+#include "../include/monitor.hpp"
+#include "../include/procfs.hpp"
+#include <algorithm>
+#include <numeric>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+
+// Extrai de /proc/[pid]/stat: comm, utime+stime, threads e rss (páginas)
+// O comm pode conter espaços e parênteses, então os campos são contados
+// a partir do último ')'
+static bool parse_stat(const char* buf, std::string* comm, unsigned long long& cpu_ticks,
+                       int& threads, long& rss_pages) {
+    const char* open_paren = strchr(buf, '(');
+    const char* close_paren = strrchr(buf, ')');
+    if (!open_paren || !close_paren || close_paren < open_paren) return false;
+    if (comm) comm->assign(open_paren + 1, close_paren - open_paren - 1);
+
+    // Campo 3 (state) começa em close_paren + 2
+    const char* p = close_paren + 2;
+    unsigned long long utime = 0, stime = 0;
+    for (int field = 3; field <= 24 && *p; field++) {
+        char* end;
+        unsigned long long value = strtoull(p, &end, 10);
+        switch (field) {
+            case 14: utime = value; break;
+            case 15: stime = value; break;
+            case 20: threads = static_cast<int>(value); break;
+            case 24: rss_pages = static_cast<long>(value); break;
+        }
+        p = strchr(p, ' ');
+        if (!p) break;
+        p++;
+    }
+    cpu_ticks = utime + stime;
+    return true;
+}
+
+ProcessTable::ProcessTable(bool io)
+    : with_io(io), generation(0), last_created_pid(-1), last_elapsed(0.0) {
+    ns_per_tick = 1e9 / static_cast<double>(sysconf(_SC_CLK_TCK));
+    page_kb = sysconf(_SC_PAGESIZE) / 1024;
+    num_cores = get_num_cores();
+    start_time = std::chrono::steady_clock::now();
+    loadavg_fd = -1;
+
+    // Até 3 fds por processo: eleva o limite flexível até o rígido
+    raise_nofile_limit();
+}
+
+ProcessTable::~ProcessTable() {
+    for (auto& entry : tracked) {
+        close_process(entry.second);
+    }
+    if (loadavg_fd >= 0) {
+        close(loadavg_fd);
+    }
+}
+
+bool ProcessTable::open_process(int pid, Tracked& t) {
+    t.stat_fd = open(proc_pid_path(pid, "stat").c_str(), O_RDONLY | O_CLOEXEC);
+    if (t.stat_fd < 0 && errno != EMFILE && errno != ENFILE) {
+        return false;  // Processo já terminou
+    }
+    // Sem fds disponíveis: stat_fd = -1 e o arquivo é reaberto a cada leitura
+
+    // Sem schedstat (kernel sem CONFIG_SCHED_INFO ou sem fds): CPU pelo stat
+    t.sched_fd = open(proc_pid_path(pid, "schedstat").c_str(), O_RDONLY | O_CLOEXEC);
+
+    t.io_fd = -1;
+    t.io_available = false;
+    if (with_io) {
+        t.io_fd = open(proc_pid_path(pid, "io").c_str(), O_RDONLY | O_CLOEXEC);
+        // EACCES: io de processos de outros usuários exige privilégio
+        t.io_available = (t.io_fd >= 0 || errno == EMFILE || errno == ENFILE);
+    }
+    t.cpu_from_stat = true;
+    t.has_prev = false;
+    t.cpu_ns = 0;
+    t.cpu_time = 0.0;
+    t.idle_ticks = 0;
+    t.pinned = false;
+    t.io_bytes = 0;
+    t.io_time = -1.0;
+    t.rss_kb = 0;
+    t.threads = 0;
+    t.comm.clear();
+    return true;
+}
+
+void ProcessTable::close_process(Tracked& t) {
+    if (t.stat_fd >= 0) close(t.stat_fd);
+    if (t.sched_fd >= 0) close(t.sched_fd);
+    if (t.io_fd >= 0) close(t.io_fd);
+    t.stat_fd = t.sched_fd = t.io_fd = -1;
+}
+
+bool ProcessTable::read_stat(int pid, Tracked& t, unsigned long long& cpu_ns) {
+    char buf[1024];
+    if (read_proc_file(t.stat_fd, pid, "stat", buf, sizeof(buf)) < 0) {
+        return false;
+    }
+    unsigned long long ticks = 0;
+    long rss_pages = 0;
+    // comm relido junto: muda no exec (ex: filho de fork que vira outro programa)
+    if (!parse_stat(buf, &t.comm, ticks, t.threads, rss_pages)) {
+        return false;
+    }
+    cpu_ns = static_cast<unsigned long long>(ticks * ns_per_tick);
+    t.rss_kb = rss_pages * page_kb;
+    return true;
+}
+
+void ProcessTable::track_process(int pid) {
+    if (tracked.count(pid)) return;
+    Tracked t;
+    if (open_process(pid, t)) {
+        tracked.emplace(pid, std::move(t));
+    }
+}
+
+void ProcessTable::discover_processes() {
+    DIR* dir = opendir(proc_root().c_str());
+    if (!dir) {
+        return;
+    }
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        const char* name = entry->d_name;
+        if (name[0] < '1' || name[0] > '9') continue;
+        char* end;
+        long pid = strtol(name, &end, 10);
+        if (*end != '\0') continue;
+        track_process(static_cast<int>(pid));
+    }
+    closedir(dir);
+}
+
+// Só a faixa entre o último PID criado no ciclo anterior e o atual
+// pode conter processos novos
+void ProcessTable::discover_new_processes() {
+    long newest = read_last_created_pid(loadavg_fd);
+    long previous = last_created_pid;
+    last_created_pid = newest;
+    bool full_scan = generation % REFRESH_TICKS == 1 || newest <= 0 || previous <= 0 ||
+                     newest < previous || newest - previous > MAX_PROBE_RANGE;
+    if (full_scan) {
+        discover_processes();
+        return;
+    }
+
+    char status[512];
+    for (long id = previous + 1; id <= newest; id++) {
+        int pid = static_cast<int>(id);
+        if (tracked.count(pid)) continue;
+        // /proc/[tid] também existe para threads: só líderes (Tgid == PID) são processos
+        if (read_proc_file(-1, pid, "status", status, sizeof(status)) < 0) continue;
+        const char* tgid = strstr(status, "\nTgid:");
+        if (tgid && atol(tgid + 6) == id) {
+            track_process(pid);
+        }
+    }
+}
+
+// Atualiza um processo; retorno false = processo terminou
+bool ProcessTable::sample_process(int pid, Tracked& t, double now_s, double& cpu_pct, double& io_rate) {
+    // Ocioso há vários ciclos: pula a checagem (não rodou, por hipótese)
+    if (!t.pinned && t.idle_ticks >= IDLE_BACKOFF_TICKS) {
+        unsigned int stride = t.idle_ticks >= 4 * IDLE_BACKOFF_TICKS ? 4 : 2;
+        if ((pid + generation) % stride != 0) {
+            cpu_pct = 0.0;
+            io_rate = t.io_available ? 0.0 : -1.0;
+            return true;
+        }
+    }
+    t.pinned = false;
+
+    char buf[256];
+    unsigned long long cpu_ns = 0;
+    bool from_stat = false;
+    bool stat_fresh = false;
+
+    // Até duas tentativas: a primeira falha quando o fd ainda aponta para
+    // um processo que terminou e cujo PID já foi reutilizado
+    for (int attempt = 0; ; attempt++) {
+        from_stat = (t.sched_fd < 0 || t.threads != 1);
+        bool ok;
+        if (from_stat) {
+            ok = stat_fresh = read_stat(pid, t, cpu_ns);
+        } else {
+            ok = pread(t.sched_fd, buf, sizeof(buf) - 1, 0) > 0;
+            if (ok) cpu_ns = strtoull(buf, nullptr, 10);
+        }
+        if (ok) break;
+        close_process(t);
+        if (attempt > 0 || !open_process(pid, t)) {
+            return false;
+        }
+    }
+
+    // schedstat parado logo após uso: a thread principal pode ter criado
+    // threads e estar bloqueada (ex: join) enquanto elas rodam. Confirma
+    // o número de threads pelo stat antes de dar o processo como ocioso
+    if (!from_stat && t.has_prev && !t.cpu_from_stat && cpu_ns == t.cpu_ns && t.idle_ticks == 0) {
+        unsigned long long stat_ns;
+        if (read_stat(pid, t, stat_ns)) {
+            stat_fresh = true;
+            if (t.threads != 1) {
+                from_stat = true;
+                cpu_ns = stat_ns;
+            }
+        }
+    }
+
+    // Taxas só entre leituras da mesma fonte (schedstat e stat diferem)
+    bool comparable = t.has_prev && from_stat == t.cpu_from_stat;
+    bool ran = !comparable || cpu_ns != t.cpu_ns;
+    cpu_pct = 0.0;
+    if (comparable && now_s > t.cpu_time && cpu_ns > t.cpu_ns) {
+        // Tempo real desde a última leitura (pode abranger ciclos pulados)
+        cpu_pct = (cpu_ns - t.cpu_ns) / 1e9 / (now_s - t.cpu_time) * 100.0 / num_cores;
+    }
+    t.idle_ticks = ran ? 0 : t.idle_ticks + 1;
+    t.cpu_ns = cpu_ns;
+    t.cpu_time = now_s;
+    t.cpu_from_stat = from_stat;
+    t.has_prev = true;
+
+    // RSS, threads e io: só se o processo rodou ou está na sua vez do rodízio
+    bool refresh = ran || (pid % REFRESH_TICKS == generation % REFRESH_TICKS);
+    if (refresh && !stat_fresh) {
+        unsigned long long ignored;
+        read_stat(pid, t, ignored);
+    }
+
+    io_rate = t.io_available ? 0.0 : -1.0;
+    if (t.io_available && refresh) {
+        char io_buf[512];
+        if (read_proc_file(t.io_fd, pid, "io", io_buf, sizeof(io_buf)) > 0) {
+            unsigned long long io_bytes = parse_io_bytes(io_buf);
+            if (t.io_time >= 0 && now_s > t.io_time && io_bytes >= t.io_bytes) {
+                io_rate = (io_bytes - t.io_bytes) / (now_s - t.io_time);
+            }
+            t.io_bytes = io_bytes;
+            t.io_time = now_s;
+        } else {
+            t.io_available = false;  // Ex: exec de binário setuid
+            io_rate = -1.0;
+        }
+    }
+    return true;
+}
+
+size_t ProcessTable::sample() {
+    auto now = std::chrono::steady_clock::now();
+    last_elapsed = generation > 0 ? std::chrono::duration<double>(now - prev_time).count() : 0.0;
+    prev_time = now;
+    generation++;
+    double now_s = std::chrono::duration<double>(now - start_time).count();
+
+    discover_new_processes();
+
+    cols.pid.clear();
+    cols.cpu_percent.clear();
+    cols.rss_kb.clear();
+    cols.io_rate.clear();
+    cols.threads.clear();
+    cols.comm.clear();
+
+    for (auto it = tracked.begin(); it != tracked.end();) {
+        int pid = it->first;
+        Tracked& t = it->second;
+        double cpu_pct, io_rate;
+        if (!sample_process(pid, t, now_s, cpu_pct, io_rate)) {
+            close_process(t);
+            it = tracked.erase(it);
+            continue;
+        }
+        cols.pid.push_back(pid);
+        cols.cpu_percent.push_back(cpu_pct);
+        cols.rss_kb.push_back(t.rss_kb);
+        cols.io_rate.push_back(io_rate);
+        cols.threads.push_back(t.threads);
+        cols.comm.push_back(&t.comm);
+        ++it;
+    }
+
+    return cols.size();
+}
+
+void ProcessTable::pin(const std::vector<size_t>& rows) {
+    for (size_t row : rows) {
+        if (row >= cols.size()) continue;
+        auto it = tracked.find(cols.pid[row]);
+        if (it != tracked.end()) it->second.pinned = true;
+    }
+}
+
+std::vector<size_t> ProcessTable::top_k(TopMetric metric, size_t k) const {
+    size_t n = cols.size();
+    k = std::min(k, n);
+    order.resize(n);
+    std::iota(order.begin(), order.end(), 0);
+
+    auto value = [this, metric](size_t i) -> double {
+        switch (metric) {
+            case TopMetric::RSS: return static_cast<double>(cols.rss_kb[i]);
+            case TopMetric::IO:  return cols.io_rate[i];
+            default:             return cols.cpu_percent[i];
+        }
+    };
+    // Empate: PID menor primeiro (ordem estável entre quadros)
+    auto greater = [&](size_t a, size_t b) {
+        double va = value(a), vb = value(b);
+        return va != vb ? va > vb : cols.pid[a] < cols.pid[b];
+    };
+
+    if (k < n) {
+        std::nth_element(order.begin(), order.begin() + k, order.end(), greater);
+    }
+    std::sort(order.begin(), order.begin() + k, greater);
+    return std::vector<size_t>(order.begin(), order.begin() + k);
+}
@@ -0,0 +1,337 @@
+// ============================================================
+// ARQUIVO: src/process_tree.cpp
+// DESCRIÇÃO: Implementação da árvore de processos
+// ============================================================
+
+#include "../include/process_tree.hpp"
+#include "../include/monitor.hpp"
+#include "../include/procfs.hpp"
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <ctime>
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+
+// Campos de /proc/[pid]/stat usados pela árvore
+struct TreeStat {
+    int ppid = 0;
+    unsigned long long cpu_ticks = 0;       // utime + stime
+    unsigned long long child_ticks = 0;     // cutime + cstime
+    long long start_time = -1;
+    long rss_pages = 0;
+};
+
+// Os campos são contados a partir do último ')' (o comm pode conter espaços)
+static bool parse_tree_stat(const char* buf, std::string& comm, TreeStat& out) {
+    const char* open_paren = strchr(buf, '(');
+    const char* close_paren = strrchr(buf, ')');
+    if (!open_paren || !close_paren || close_paren < open_paren) return false;
+    comm.assign(open_paren + 1, close_paren - open_paren - 1);
+
+    // Campo 3 (state) começa em close_paren + 2
+    const char* p = close_paren + 2;
+    int field = 3;
+    for (; field <= 24 && *p; field++) {
+        char* end;
+        unsigned long long value = strtoull(p, &end, 10);
+        switch (field) {
+            case 4: out.ppid = static_cast<int>(value); break;
+            case 14:
+            case 15: out.cpu_ticks += value; break;
+            case 16:
+            case 17: out.child_ticks += value; break;
+            case 22: out.start_time = static_cast<long long>(value); break;
+            case 24: out.rss_pages = static_cast<long>(value); break;
+        }
+        p = strchr(p, ' ');
+        if (!p) break;
+        p++;
+    }
+    return field >= 24;
+}
+
+// Ticks desde o boot agora (mesma base do starttime de /proc/[pid]/stat)
+static double boot_ticks(long ticks_per_sec) {
+    struct timespec ts;
+    clock_gettime(CLOCK_BOOTTIME, &ts);
+    return (ts.tv_sec + ts.tv_nsec / 1e9) * ticks_per_sec;
+}
+
+ProcessTree::ProcessTree(bool io) : with_io(io), generation(0), last_elapsed(0.0) {
+    ticks_per_sec = sysconf(_SC_CLK_TCK);
+    page_kb = sysconf(_SC_PAGESIZE) / 1024;
+    num_cores = get_num_cores();
+
+    // Até 2 fds por processo: eleva o limite flexível até o rígido
+    raise_nofile_limit();
+}
+
+ProcessTree::~ProcessTree() {
+    for (auto& entry : nodes) {
+        if (entry.second.stat_fd >= 0) close(entry.second.stat_fd);
+        if (entry.second.io_fd >= 0) close(entry.second.io_fd);
+    }
+}
+
+void ProcessTree::unlink(int pid, int ppid) {
+    auto parent = nodes.find(ppid);
+    if (parent != nodes.end()) {
+        auto& children = parent->second.children;
+        auto it = std::find(children.begin(), children.end(), pid);
+        if (it != children.end()) {
+            *it = children.back();
+            children.pop_back();
+        }
+    }
+}
+
+// Lê stat (e io) de um nó e calcula os deltas do ciclo
+// fresh: nó criado agora (fds abertos, sem leitura anterior)
+// Retorno: false se o processo terminou (ou o PID foi reutilizado)
+bool ProcessTree::read_node(int pid, Node& node, bool fresh) {
+    char buf[1024];
+    if (read_proc_file(node.stat_fd, pid, "stat", buf, sizeof(buf)) < 0) {
+        return false;
+    }
+    TreeStat st;
+    if (!parse_tree_stat(buf, node.comm, st)) {
+        return false;
+    }
+    // Sem fd persistente o arquivo é reaberto: outro processo no mesmo PID
+    if (!fresh && st.start_time != node.start_time) {
+        return false;
+    }
+
+    if (node.has_prev) {
+        node.self_ticks = st.cpu_ticks > node.cpu_ticks ? static_cast<double>(st.cpu_ticks - node.cpu_ticks) : 0.0;
+        node.reaped_ticks = st.child_ticks > node.child_ticks
+            ? static_cast<double>(st.child_ticks - node.child_ticks) : 0.0;
+    }
+    node.cpu_ticks = st.cpu_ticks;
+    node.child_ticks = st.child_ticks;
+    node.start_time = st.start_time;
+    node.rss_kb = st.rss_pages * page_kb;
+    node.ppid = st.ppid;
+
+    node.io_rate = -1;
+    if (node.io_available) {
+        if (read_proc_file(node.io_fd, pid, "io", buf, sizeof(buf)) >= 0) {
+            unsigned long long bytes = parse_io_bytes(buf);
+            node.io_rate = node.has_prev && last_elapsed > 0 && bytes >= node.io_bytes
+                ? (bytes - node.io_bytes) / last_elapsed : 0.0;
+            node.io_bytes = bytes;
+        } else {
+            node.io_available = false;
+        }
+    }
+    return true;
+}
+
+size_t ProcessTree::sample() {
+    auto now = std::chrono::steady_clock::now();
+    double prev_boot = -1;      // Instante do ciclo anterior na base do starttime
+    last_elapsed = 0.0;
+    if (generation > 0) {
+        last_elapsed = std::chrono::duration<double>(now - prev_time).count();
+        prev_boot = boot_ticks(ticks_per_sec) - last_elapsed * ticks_per_sec;
+    }
+    prev_time = now;
+    generation++;
+
+    DIR* dir = opendir(proc_root().c_str());
+    if (!dir) {
+        return 0;
+    }
+
+    // Uma passada: contadores, ppid e processos novos
+    while (dirent* entry = readdir(dir)) {
+        char* end;
+        long value = strtol(entry->d_name, &end, 10);
+        if (*end != '\0' || value <= 0) continue;
+        int pid = static_cast<int>(value);
+
+        auto it = nodes.find(pid);
+        bool fresh = it == nodes.end();
+        if (fresh) {
+            Node node;
+            node.stat_fd = open(proc_pid_path(pid, "stat").c_str(), O_RDONLY | O_CLOEXEC);
+            if (node.stat_fd < 0 && errno != EMFILE && errno != ENFILE) {
+                continue;  // Processo já terminou
+            }
+            // Sem fds disponíveis: stat_fd = -1 e o arquivo é reaberto a cada leitura
+            if (with_io) {
+                node.io_fd = open(proc_pid_path(pid, "io").c_str(), O_RDONLY | O_CLOEXEC);
+                // EACCES: io de processos de outros usuários exige privilégio
+                node.io_available = (node.io_fd >= 0 || errno == EMFILE || errno == ENFILE);
+            }
+            it = nodes.emplace(pid, std::move(node)).first;
+        }
+
+        Node& node = it->second;
+        int old_ppid = node.ppid;
+        node.self_ticks = node.reaped_ticks = node.gone_ticks = 0;
+        if (!read_node(pid, node, fresh)) {
+            continue;  // Fica com a geração antiga e sai no fim do ciclo
+        }
+        node.generation = generation;
+
+        if (fresh) {
+            // Nascido depois do ciclo anterior: todo o tempo dele é deste ciclo
+            if (prev_boot >= 0 && node.start_time >= prev_boot) {
+                node.self_ticks = static_cast<double>(node.cpu_ticks);
+                node.reaped_ticks = static_cast<double>(node.child_ticks);
+            }
+        } else if (node.ppid != old_ppid && node.linked) {
+            // Reparentado (pai terminou): religado ao fim do ciclo
+            unlink(pid, old_ppid);
+            node.linked = false;
+        }
+        node.has_prev = true;
+    }
+    closedir(dir);
+
+    // Processos encerrados: o total já contado sai do cutime do pai
+    // (só o trecho após a última leitura entra como "reaped")
+    gone.clear();
+    for (auto it = nodes.begin(); it != nodes.end();) {
+        Node& node = it->second;
+        if (node.generation == generation) {
+            ++it;
+            continue;
+        }
+        auto parent = nodes.find(node.ppid);
+        if (parent != nodes.end()) {
+            parent->second.gone_ticks += static_cast<double>(node.cpu_ticks + node.child_ticks);
+        }
+        gone[it->first] = node.cpu_ticks;
+        if (node.linked) unlink(it->first, node.ppid);
+        // Filhos ainda não reparentados nesta leitura viram raízes por ora
+        for (int child : node.children) {
+            auto found = nodes.find(child);
+            if (found != nodes.end()) found->second.linked = false;
+        }
+        if (node.stat_fd >= 0) close(node.stat_fd);
+        if (node.io_fd >= 0) close(node.io_fd);
+        it = nodes.erase(it);
+    }
+
+    // Ligações adiadas: o pai pode ter aparecido depois do filho na listagem
+    for (auto& entry : nodes) {
+        Node& node = entry.second;
+        if (!node.linked && node.ppid != entry.first && nodes.count(node.ppid)) {
+            nodes[node.ppid].children.push_back(entry.first);
+            node.linked = true;
+        }
+    }
+
+    aggregate();
+    return nodes.size();
+}
+
+double ProcessTree::to_percent(double ticks) const {
+    if (last_elapsed <= 0) return 0.0;
+    return ticks / ticks_per_sec / last_elapsed * 100.0 / num_cores;
+}
+
+double ProcessTree::cpu_live() const {
+    double ticks = 0;
+    for (const auto& entry : nodes) ticks += entry.second.self_ticks;
+    return to_percent(ticks);
+}
+
+// Agregados em pós-ordem a partir das raízes (nós sem pai na árvore)
+// Iterativo: cadeias longas de processos não estouram a pilha
+void ProcessTree::aggregate() {
+    std::vector<std::pair<Node*, size_t>> stack;
+    for (auto& entry : nodes) {
+        if (entry.second.linked) continue;
+        stack.emplace_back(&entry.second, 0);
+        while (!stack.empty()) {
+            Node* node = stack.back().first;
+            size_t& next = stack.back().second;
+            if (next == 0) {
+                // Filhos vistos que sumiram já foram contados: fora do cutime
+                node->reaped_ticks = std::max(0.0, node->reaped_ticks - node->gone_ticks);
+                node->total_ticks = node->self_ticks + node->reaped_ticks;
+                node->rss_total_kb = node->rss_kb;
+                node->io_total = std::max(0.0, node->io_rate);
+                node->descendants = 0;
+            }
+            if (next < node->children.size()) {
+                Node* child = &nodes.find(node->children[next++])->second;
+                stack.emplace_back(child, 0);
+                continue;
+            }
+            stack.pop_back();
+            if (!stack.empty()) {
+                Node* parent = stack.back().first;
+                parent->total_ticks += node->total_ticks;
+                parent->rss_total_kb += node->rss_total_kb;
+                parent->io_total += node->io_total;
+                parent->descendants += node->descendants + 1;
+            }
+        }
+    }
+}
+
+std::vector<TreeRow> ProcessTree::rows(int root, int max_depth, TreeMetric order) const {
+    std::vector<TreeRow> out;
+    auto key = [&](int pid) {
+        const Node& node = nodes.at(pid);
+        switch (order) {
+            case TreeMetric::RSS: return static_cast<double>(node.rss_total_kb);
+            case TreeMetric::IO: return node.io_total;
+            default: return node.total_ticks;
+        }
+    };
+    auto sorted = [&](std::vector<int> pids) {
+        std::sort(pids.begin(), pids.end(), [&](int a, int b) {
+            double ka = key(a), kb = key(b);
+            return ka != kb ? ka > kb : a < b;
+        });
+        return pids;
+    };
+
+    std::vector<int> roots;
+    if (root >= 0) {
+        if (!nodes.count(root)) return out;
+        roots.push_back(root);
+    } else {
+        for (const auto& entry : nodes) {
+            if (!entry.second.linked) roots.push_back(entry.first);
+        }
+        roots = sorted(std::move(roots));
+    }
+
+    // Pré-ordem: pilha com os irmãos em ordem inversa
+    std::vector<std::pair<int, int>> stack;     // (pid, profundidade)
+    for (auto it = roots.rbegin(); it != roots.rend(); ++it) stack.emplace_back(*it, 0);
+    while (!stack.empty()) {
+        auto [pid, depth] = stack.back();
+        stack.pop_back();
+        const Node& node = nodes.at(pid);
+
+        TreeRow row;
+        row.pid = pid;
+        row.ppid = node.ppid;
+        row.depth = depth;
+        row.comm = &node.comm;
+        row.cpu_self = to_percent(node.self_ticks);
+        row.cpu_reaped = to_percent(node.reaped_ticks);
+        row.cpu_total = to_percent(node.total_ticks);
+        row.rss_self_kb = node.rss_kb;
+        row.rss_total_kb = node.rss_total_kb;
+        row.io_self = node.io_rate;
+        row.io_total = node.io_total;
+        row.descendants = node.descendants;
+        out.push_back(row);
+
+        if (max_depth >= 0 && depth >= max_depth) continue;
+        std::vector<int> children = sorted(node.children);
+        for (auto it = children.rbegin(); it != children.rend(); ++it) stack.emplace_back(*it, depth + 1);
+    }
+    return out;
+}
@@ -0,0 +1,143 @@
+// ============================================================
+// ARQUIVO: src/process_watch.cpp
+// DESCRIÇÃO: Implementação da vigilância de processos via pidfd
+// ============================================================
+
+#include "../include/process_watch.hpp"
+#include "../include/procfs.hpp"
+#include <iostream>
+#include <thread>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/syscall.h>
+
+#ifndef SYS_pidfd_open
+#define SYS_pidfd_open 434      // Igual em todas as arquiteturas (Linux >= 5.3)
+#endif
+
+long long read_process_start_time(int pid) {
+    FILE* file = fopen(proc_pid_path(pid, "stat").c_str(), "r");
+    if (!file) {
+        return -1;
+    }
+    char buf[1024];
+    size_t n = fread(buf, 1, sizeof(buf) - 1, file);
+    fclose(file);
+    buf[n] = '\0';
+
+    // starttime: campo 22, o 20º depois do ')' que fecha o comm
+    const char* p = strrchr(buf, ')');
+    for (int field = 2; p && field < 22; field++) {
+        p = strchr(p + 1, ' ');
+    }
+    return p ? strtoll(p + 1, nullptr, 10) : -1;
+}
+
+ProcessWatcher::ProcessWatcher() : epoll_fd(-1), pidfd_supported(false) {
+    // pidfd só faz sentido no /proc real (não em snapshot capturado)
+    if (proc_root() != "/proc") {
+        return;
+    }
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd < 0) {
+        std::cerr << "Aviso: epoll_create1 falhou - " << strerror(errno) << "; término detectado por polling" << std::endl;
+        return;
+    }
+    pidfd_supported = true;
+}
+
+ProcessWatcher::~ProcessWatcher() {
+    for (auto& entry : targets) {
+        if (entry.second.fd >= 0) close(entry.second.fd);
+    }
+    if (epoll_fd >= 0) {
+        close(epoll_fd);
+    }
+}
+
+bool ProcessWatcher::watch(int pid) {
+    if (targets.count(pid)) {
+        return true;
+    }
+    long long start = read_process_start_time(pid);
+    if (start < 0) {
+        return false;
+    }
+
+    Target target = {-1, start};
+    if (pidfd_supported) {
+        int fd = static_cast<int>(syscall(SYS_pidfd_open, pid, 0));
+        if (fd < 0 && (errno == ENOSYS || errno == EPERM)) {
+            // Kernel sem pidfd (ou seccomp bloqueando): modo polling para todos
+            pidfd_supported = false;
+        } else if (fd < 0) {
+            return false;   // ESRCH: terminou entre as duas leituras
+        } else {
+            // O PID pode ter sido reutilizado entre a leitura do início e o
+            // pidfd_open: o pidfd só vale se o início ainda for o mesmo
+            if (read_process_start_time(pid) != start) {
+                close(fd);
+                return false;
+            }
+            epoll_event ev = {};
+            ev.events = EPOLLIN;
+            ev.data.u32 = static_cast<uint32_t>(pid);
+            if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+                close(fd);
+                return false;
+            }
+            target.fd = fd;
+        }
+    }
+    targets.emplace(pid, target);
+    return true;
+}
+
+void ProcessWatcher::unwatch(int pid) {
+    auto it = targets.find(pid);
+    if (it == targets.end()) {
+        return;
+    }
+    if (it->second.fd >= 0) {
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, it->second.fd, nullptr);
+        close(it->second.fd);
+    }
+    targets.erase(it);
+}
+
+long long ProcessWatcher::start_time(int pid) const {
+    auto it = targets.find(pid);
+    return it == targets.end() ? -1 : it->second.start_time;
+}
+
+std::vector<int> ProcessWatcher::wait(std::chrono::milliseconds timeout) {
+    std::vector<int> exited;
+    if (timeout.count() < 0) {
+        timeout = std::chrono::milliseconds(0);
+    }
+
+    if (pidfd_supported) {
+        // O pidfd fica legível quando o processo termina (e assim continua)
+        epoll_event events[64];
+        int n = epoll_wait(epoll_fd, events, 64, static_cast<int>(timeout.count()));
+        for (int i = 0; i < n; i++) {
+            int pid = static_cast<int>(events[i].data.u32);
+            if (targets.count(pid)) exited.push_back(pid);
+        }
+        // Alvos sem pidfd (vigiados antes de o modo polling ser descartado) não existem aqui
+        return exited;
+    }
+
+    // Sem pidfd: dorme e confere cada alvo pelo instante de início
+    std::this_thread::sleep_for(timeout);
+    for (const auto& entry : targets) {
+        if (read_process_start_time(entry.first) != entry.second.start_time) {
+            exited.push_back(entry.first);
+        }
+    }
+    return exited;
+}
@@ -0,0 +1,138 @@
+// ============================================================
+// ARQUIVO: src/procfs.cpp
+// DESCRIÇÃO: Implementação da raiz configurável de /proc e /sys
+// ============================================================
+
+#include "../include/procfs.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+
+// Remove barras finais ("/snap/proc/" -> "/snap/proc")
+static std::string trim_root(std::string root) {
+    while (root.size() > 1 && root.back() == '/') {
+        root.pop_back();
+    }
+    return root;
+}
+
+// Lê a raiz da variável de ambiente, ou usa o padrão
+static std::string root_from_env(const char* var, const char* fallback) {
+    const char* value = std::getenv(var);
+    return trim_root((value && *value) ? value : fallback);
+}
+
+// Armazenamento das raízes (inicializado no primeiro uso)
+static std::string& proc_root_storage() {
+    static std::string root = root_from_env("RA3_PROC_ROOT", "/proc");
+    return root;
+}
+
+static std::string& sys_root_storage() {
+    static std::string root = root_from_env("RA3_SYS_ROOT", "/sys");
+    return root;
+}
+
+const std::string& proc_root() {
+    return proc_root_storage();
+}
+
+const std::string& sys_root() {
+    return sys_root_storage();
+}
+
+void set_proc_root(const std::string& root) {
+    proc_root_storage() = trim_root(root);
+}
+
+void set_sys_root(const std::string& root) {
+    sys_root_storage() = trim_root(root);
+}
+
+void set_fs_root(const std::string& snapshot_dir) {
+    set_proc_root(snapshot_dir + "/proc");
+    set_sys_root(snapshot_dir + "/sys");
+}
+
+std::string proc_path(const std::string& relative) {
+    return proc_root() + "/" + relative;
+}
+
+std::string proc_pid_path(int pid, const std::string& relative) {
+    return proc_root() + "/" + std::to_string(pid) + "/" + relative;
+}
+
+std::string sys_path(const std::string& relative) {
+    return sys_root() + "/" + relative;
+}
+
+std::string cgroup_root() {
+    return sys_root() + "/fs/cgroup";
+}
+
+long read_last_created_pid(int& loadavg_fd) {
+    if (loadavg_fd < 0) {
+        loadavg_fd = open(proc_path("loadavg").c_str(), O_RDONLY | O_CLOEXEC);
+        if (loadavg_fd < 0) return -1;
+    }
+    char buf[128];
+    ssize_t n = pread(loadavg_fd, buf, sizeof(buf) - 1, 0);
+    if (n <= 0) return -1;
+    buf[n] = '\0';
+    const char* last = strrchr(buf, ' ');
+    return last ? atol(last + 1) : -1;
+}
+
+unsigned long read_ns_inode(const std::string& ns_path) {
+    char link[256];
+    ssize_t len = readlink(ns_path.c_str(), link, sizeof(link) - 1);
+    if (len > 0) {
+        link[len] = '\0';
+        unsigned long inode = 0;
+        // Formato "tipo:[numero]": pula até o '[' e lê o número
+        if (sscanf(link, "%*[^[][%lu]", &inode) == 1) {
+            return inode;
+        }
+    }
+    struct stat info;
+    if (stat(ns_path.c_str(), &info) == 0) {
+        return info.st_ino;
+    }
+    return 0;
+}
+
+ssize_t read_proc_file(int fd, int pid, const char* name, char* buf, size_t size) {
+    ssize_t n;
+    if (fd >= 0) {
+        n = pread(fd, buf, size - 1, 0);
+    } else {
+        int tmp = open(proc_pid_path(pid, name).c_str(), O_RDONLY | O_CLOEXEC);
+        if (tmp < 0) return -1;
+        n = read(tmp, buf, size - 1);
+        close(tmp);
+    }
+    if (n <= 0) return -1;
+    buf[n] = '\0';
+    return n;
+}
+
+unsigned long long parse_io_bytes(const char* buf) {
+    unsigned long long total = 0;
+    const char* r = strstr(buf, "\nread_bytes:");
+    const char* w = strstr(buf, "\nwrite_bytes:");
+    if (r) total += strtoull(r + 12, nullptr, 10);
+    if (w) total += strtoull(w + 13, nullptr, 10);
+    return total;
+}
+
+void raise_nofile_limit() {
+    struct rlimit rl;
+    if (getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur < rl.rlim_max) {
+        rl.rlim_cur = rl.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &rl);
+    }
+}
@@ -0,0 +1,1264 @@
+// ============================================================
+// ARQUIVO: src/profiler.cpp
+// DESCRIÇÃO: Implementação do Resource Profiler (Componente 1)
+// Laços de monitoramento por processo, por cgroup e o modo não
+// interativo usado pela linha de comando e pelo daemon
+// ============================================================
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+#include <thread>
+#include <chrono>
+#include <ctime>
+#include <cstdlib>
+#include <algorithm>
+#include <cmath>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "profiler.hpp"
+#include "procfs.hpp"
+#include "process_watch.hpp"
+#include "cpu_stat.hpp"
+#include "process_meta.hpp"
+#include "proc_batch.hpp"
+
+using namespace std;
+
+// Variável atômica para controle global do monitoramento (permite parada graciosa)
+atomic<bool> monitoring_active{true};
+
+// Verifica se um processo com o PID especificado existe no sistema
+bool ResourceProfiler::pidExists(int pid) {
+    string pid_dir = proc_pid_path(pid, "");
+    struct stat info;
+    return (stat(pid_dir.c_str(), &info) == 0);
+}
+
+// Verifica se temos permissão para acessar as informações do processo
+bool ResourceProfiler::canAccessProcess(int pid) {
+    string stat_path = proc_pid_path(pid, "stat");
+    ifstream file(stat_path);
+    if (!file.is_open()) {
+        return false;
+    }
+    file.close();
+    return true;
+}
+
+// Horário local formatado para CSV e console
+static string formatTimestamp(time_t t) {
+    struct tm tm_buf;
+    localtime_r(&t, &tm_buf);  // Thread-safe
+    stringstream timestamp;
+    timestamp << put_time(&tm_buf, "%Y-%m-%d %H:%M:%S");
+    return timestamp.str();
+}
+
+// Timestamp atual formatado para CSV e console
+string ResourceProfiler::currentTimestamp() {
+    return formatTimestamp(chrono::system_clock::to_time_t(chrono::system_clock::now()));
+}
+
+// Cabeçalho do CSV por processo (compartilhado por monitorProcess e monitorCgroup)
+void ResourceProfiler::writeProcessCsvHeader(ostream& csv) {
+    csv << "timestamp,pid,cpu_percent,memory_rss_bytes,memory_vsz_bytes,"
+        << "memory_swap_bytes,io_read_bytes,io_write_bytes,io_read_rate_bps,"
+        << "io_write_rate_bps,threads,minor_faults,major_faults,tcp_connections,"
+        << "memory_pss_kb,memory_uss_kb,sample_interval_ms\n";
+}
+
+// Grava uma linha de métricas de processo no CSV
+void ResourceProfiler::writeProcessCsvRow(ostream& csv, const string& timestamp, int pid,
+                                          double cpu_pct, const ProcStats& stats, double interval_ms) {
+    csv << timestamp << ","
+        << pid << ","
+        << fixed << setprecision(2) << cpu_pct << ","
+        << stats.memory_rss << ","
+        << stats.memory_vsz << ","
+        << stats.memory_swap << ","
+        << stats.io_read_bytes << ","
+        << stats.io_write_bytes << ","
+        << fixed << setprecision(0) << stats.io_read_rate << ","
+        << fixed << setprecision(0) << stats.io_write_rate << ","
+        << stats.threads << ","
+        << stats.minor_faults << ","
+        << stats.major_faults << ","
+        << stats.tcp_connections << ","
+        << stats.memory_pss << ","
+        << stats.memory_uss << ","
+        << fixed << setprecision(0) << interval_ms << "\n";
+}
+
+// CSV de memória do host: tamanhos em KB, taxas em páginas/s
+void ResourceProfiler::writeHostCsvHeader(ostream& csv) {
+    csv << "timestamp,mem_total_kb,mem_available_kb,mem_free_kb,page_cache_kb,"
+        << "slab_kb,slab_reclaimable_kb,slab_unreclaimable_kb,dirty_kb,swap_used_kb,"
+        << "scan_rate,steal_rate,direct_reclaim_rate,refault_rate,swapin_rate,"
+        << "swapout_rate,major_fault_rate\n";
+}
+
+void ResourceProfiler::writeHostCsvRow(ostream& csv, const string& timestamp, const HostMemory& host) {
+    csv << timestamp << ","
+        << host.total_kb << ","
+        << host.available_kb << ","
+        << host.free_kb << ","
+        << host.page_cache_kb() << ","
+        << host.slab_kb << ","
+        << host.slab_reclaimable_kb << ","
+        << host.slab_unreclaimable_kb << ","
+        << host.dirty_kb << ","
+        << host.swap_used_kb() << ","
+        << fixed << setprecision(1) << host.scan_rate << ","
+        << host.steal_rate << ","
+        << host.direct_reclaim_rate << ","
+        << host.refault_rate << ","
+        << host.swapin_rate << ","
+        << host.swapout_rate << ","
+        << host.major_fault_rate << "\n";
+}
+
+// Page faults (minor + major) por segundo entre duas amostras
+static double faultRate(const ProcStats& prev, const ProcStats& curr, double elapsed) {
+    long delta = (curr.minor_faults + curr.major_faults) - (prev.minor_faults + prev.major_faults);
+    return (elapsed > 0 && delta >= 0) ? delta / elapsed : 0.0;
+}
+
+// Última amostra de um processo que acabou de terminar: até o pai recolhê-lo
+// (zumbi), /proc/[pid] mantém os tempos de CPU, faults e I/O finais. A memória
+// já foi liberada, então fica a última medida; o instante de início garante
+// que a leitura não é de outro processo com o mesmo PID
+static bool readFinalSample(int pid, long long start_time, const ProcStats& last, ProcStats& stats) {
+    if (read_process_start_time(pid) != start_time) {
+        return false;   // Já recolhido
+    }
+    stats = last;
+    if (get_cpu_usage(pid, stats) < 0 || stats.start_time != start_time) {
+        return false;
+    }
+    ProcStats exited = stats;
+    if (get_memory_usage(pid, exited) == 0) {
+        stats.minor_faults = exited.minor_faults;
+        stats.major_faults = exited.major_faults;
+    }
+    get_io_usage(pid, stats);
+    stats.tcp_connections = 0;
+    return true;
+}
+
+// Completa com espaços até 'width' colunas (setw conta bytes, não caracteres UTF-8)
+static string padText(const string& text, size_t width, bool align_left) {
+    size_t columns = 0;
+    for (unsigned char c : text) {
+        if ((c & 0xC0) != 0x80) columns++;
+    }
+    if (columns >= width) return text;
+    string fill(width - columns, ' ');
+    return align_left ? text + fill : fill + text;
+}
+
+// Relatório final dos agregados de um alvo: uma linha por métrica e janela
+// Memória em MB e I/O em KB/s, como no resumo do console
+void ResourceProfiler::printStatsReport(ostream& out, const string& target, const TargetStats& summary,
+                                        chrono::steady_clock::time_point now) {
+    if (summary.count() == 0) {
+        return;
+    }
+    struct MetricRow {
+        StatMetric metric;
+        const char* label;
+        double scale;
+    };
+    static const MetricRow rows[] = {
+        {StatMetric::CPU_PERCENT, "CPU (%)", 1.0},
+        {StatMetric::MEMORY_BYTES, "Memória (MB)", 1.0 / (1024.0 * 1024.0)},
+        {StatMetric::IO_RATE, "I/O (KB/s)", 1.0 / 1024.0},
+        {StatMetric::FAULT_RATE, "Page faults/s", 1.0},
+    };
+    static const StatWindow windows[] = {StatWindow::RUN, StatWindow::MIN_1, StatWindow::MIN_5, StatWindow::MIN_15};
+
+    out << "\nEstatísticas de " << target << " (" << summary.count() << " amostras):" << endl;
+    out << padText("Métrica", 15, true) << padText("Janela", 6, true);
+    for (const char* column : {"Mín", "Média", "Máx", "Desvio", "p50", "p95", "p99"}) {
+        out << padText(column, 10, false);
+    }
+    out << endl;
+    for (const auto& row : rows) {
+        for (StatWindow window : windows) {
+            MetricSummary m = summary.summary(row.metric, window, now);
+            if (m.stats.count == 0) continue;
+            out << padText(row.label, 15, true) << padText(stat_window_name(window), 6, true)
+                << fixed << setprecision(2)
+                << setw(10) << m.stats.min * row.scale
+                << setw(10) << m.stats.mean * row.scale
+                << setw(10) << m.stats.max * row.scale
+                << setw(10) << m.stats.stddev() * row.scale
+                << setw(10) << m.sketch.quantile(0.50) * row.scale
+                << setw(10) << m.sketch.quantile(0.95) * row.scale
+                << setw(10) << m.sketch.quantile(0.99) * row.scale << endl;
+        }
+    }
+}
+
+// Converte códigos de erro semânticos em mensagens descritivas
+string ResourceProfiler::getErrorDescription(int error_code) {
+    switch (error_code) {
+        case ERR_PROCESS_NOT_FOUND:
+            return "Processo não encontrado";
+        case ERR_PERMISSION_DENIED:
+            return "Permissão negada";
+        case ERR_UNKNOWN:
+            return "Erro desconhecido";
+        default:
+            return "Erro código: " + to_string(error_code);
+    }
+}
+
+// Valida completamente o acesso a um processo antes de iniciar monitoramento
+bool ResourceProfiler::validateProcessAccess(int pid) {
+    if (pid <= 0) {
+        throw invalid_argument("PID inválido: " + to_string(pid));
+    }
+    
+    if (!pidExists(pid)) {
+        throw runtime_error("Processo com PID " + to_string(pid) + " não existe");
+    }
+    
+    if (!canAccessProcess(pid)) {
+        throw runtime_error("Sem permissão para acessar o processo " + to_string(pid) + 
+                          " (execute como root ou com permissões adequadas)");
+    }
+    
+    return true;
+}
+
+// Função principal de monitoramento de processo
+bool ResourceProfiler::monitorProcess(int pid, int duration_sec, int interval_sec, const string& csv_file,
+                                      bool record_session) {
+    try {
+        cout << "\nValidando acesso ao processo " << pid << "..." << endl;
+        validateProcessAccess(pid);
+        
+        // O processo é vigiado por um pidfd: o término chega como evento
+        // durante a espera entre amostras (sem stat() a cada ciclo)
+        ProcessWatcher watcher;
+        if (!watcher.watch(pid)) {
+            throw runtime_error("Processo com PID " + to_string(pid) + " não existe");
+        }
+        cout << "Acesso validado com sucesso\n" << endl;
+        
+        // Abre arquivo CSV para gravação dos dados
+        ofstream csv(csv_file);
+        if (!csv.is_open()) {
+            throw runtime_error("Não foi possível criar arquivo: " + csv_file);
+        }
+        
+        // Escreve cabeçalho do CSV com todas as métricas
+        writeProcessCsvHeader(csv);
+        csv.flush();
+        
+        // Coleta estatísticas iniciais para baseline
+        ProcStats initial_stats;
+        int cpu_result = get_cpu_usage(pid, initial_stats);
+        if (cpu_result < 0) {
+            throw runtime_error("Falha ao coletar CPU: " + getErrorDescription(cpu_result));
+        }
+        
+        int memory_result = get_memory_usage(pid, initial_stats);
+        if (memory_result < 0) {
+            throw runtime_error("Falha ao coletar memória: " + getErrorDescription(memory_result));
+        }
+        
+        int io_result = get_io_usage(pid, initial_stats);
+        if (io_result < 0) {
+            throw runtime_error("Falha ao coletar I/O: " + getErrorDescription(io_result));
+        }
+        if (!watcher.same_process(pid, initial_stats.start_time)) {
+            throw runtime_error("Processo com PID " + to_string(pid) + " não existe");
+        }
+        
+        prev_stats = initial_stats;
+        auto prev_sample_time = chrono::steady_clock::now();
+        TargetStats run_stats;
+        
+        // Alertas de anomalia em um JSON lines ao lado do CSV
+        string events_file = csv_file;
+        size_t dot = events_file.rfind(".csv");
+        events_file.replace(dot == string::npos ? events_file.size() : dot, string::npos, "_events.jsonl");
+        AnomalyEvents events;
+        AnomalyDetector detector;
+        events.open_on_first_event(events_file);
+        SmapsSchedule smaps_schedule;
+        
+        // Contadores brutos gravados ao lado do CSV para replay (só se pedido)
+        string session_file = csv_file;
+        session_file.replace(dot == string::npos ? session_file.size() : dot, string::npos, "_session.ra3");
+        SessionRecorder recorder;
+        if (record_session) {
+            unlink(session_file.c_str());  // Pedido explícito: como o CSV, recomeça a cada execução
+            if (recorder.open(session_file)) {
+                recorder.record(pid, initial_stats, prev_sample_time);
+                recorder.flush();
+            } else {
+                cerr << "Aviso: gravação da sessão desligada" << endl;
+            }
+        }
+        
+        // Informações iniciais para o usuário
+        cout << "Monitorando processo PID: " << pid << endl;
+        cout << "Duração: " << duration_sec << " segundos" << endl;
+        cout << "Intervalo: " << interval_sec << " segundos" << endl;
+        cout << "Arquivo: " << csv_file << endl;
+        cout << "Pressione Ctrl+C para parar..." << endl;
+        cout << "----------------------------------------" << endl;
+        
+        auto start = chrono::steady_clock::now();
+        int iteration = 0;
+        int error_count = 0;
+        const int MAX_ERRORS = 3;  // Máximo de erros consecutivos antes de parar
+        bool target_exited = false;
+        
+        // Grava uma amostra: taxas sobre o tempo realmente decorrido desde a
+        // anterior (a coleta e a espera somam mais que interval_sec)
+        auto record_sample = [&](ProcStats& curr_stats, chrono::steady_clock::time_point sample_time) {
+            double sample_elapsed = chrono::duration<double>(sample_time - prev_sample_time).count();
+            double cpu_pct = calculate_cpu_percent(prev_stats, curr_stats, sample_elapsed);
+            calculate_io_rate(prev_stats, curr_stats, sample_elapsed);
+            recorder.record(pid, curr_stats, sample_time);
+            recorder.flush();
+            run_stats.add(cpu_pct, curr_stats.memory_rss * 1024.0,
+                          curr_stats.io_read_rate + curr_stats.io_write_rate,
+                          faultRate(prev_stats, curr_stats, sample_elapsed), sample_time);
+            int alerts = events.is_open()
+                ? detector.update(pid, chrono::duration<double>(sample_time.time_since_epoch()).count(),
+                                  cpu_pct, curr_stats.memory_rss * 1024.0,
+                                  curr_stats.io_read_rate + curr_stats.io_write_rate, events)
+                : 0;
+            
+            // Obtém timestamp atual formatado
+            string timestamp = currentTimestamp();
+            
+            // Grava linha completa no CSV
+            writeProcessCsvRow(csv, timestamp, pid, cpu_pct, curr_stats, sample_elapsed * 1000.0);
+            csv.flush();
+            
+            // Exibe resumo no console
+            cout << "[" << timestamp << "] "
+                 << "CPU: " << setw(6) << fixed << setprecision(2) << cpu_pct << "% | "
+                 << "RSS: " << setw(6) << (curr_stats.memory_rss / 1024) << "MB | "
+                 << "IO_R: " << setw(7) << fixed << setprecision(1) << (curr_stats.io_read_rate / (1024.0*1024.0)) << "MB/s | "
+                 << "TCP: " << setw(2) << curr_stats.tcp_connections
+                 << endl;
+            if (alerts > 0) {
+                cout << "  ALERTA: " << alerts << " anomalia(s) detectada(s) (ver " << events_file << ")" << endl;
+            }
+            
+            prev_stats = curr_stats;
+            prev_sample_time = sample_time;
+            iteration++;
+        };
+        
+        // Loop principal de monitoramento
+        while (monitoring_active && error_count < MAX_ERRORS) {
+            auto now = chrono::steady_clock::now();
+            auto elapsed = chrono::duration_cast<chrono::seconds>(now - start).count();
+            
+            // Verifica se atingiu o tempo máximo de monitoramento
+            if (elapsed >= duration_sec) {
+                break;
+            }
+            
+            try {
+                ProcStats curr_stats;
+                
+                // Coleta todas as métricas do processo
+                cpu_result = get_cpu_usage(pid, curr_stats);
+                if (cpu_result < 0) {
+                    throw runtime_error("Erro CPU: " + getErrorDescription(cpu_result));
+                }
+                
+                memory_result = get_memory_usage(pid, curr_stats);
+                if (memory_result < 0) {
+                    throw runtime_error("Erro memória: " + getErrorDescription(memory_result));
+                }
+                
+                io_result = get_io_usage(pid, curr_stats);
+                if (io_result < 0) {
+                    throw runtime_error("Erro I/O: " + getErrorDescription(io_result));
+                }
+                
+                // Leitura de outro processo que recebeu o mesmo PID: o original
+                // terminou e já foi recolhido entre duas esperas
+                if (!watcher.same_process(pid, curr_stats.start_time)) {
+                    cout << "Processo " << pid << " terminou (PID reutilizado por outro processo)" << endl;
+                    target_exited = true;
+                    break;
+                }
+                
+                // PSS/USS pela agenda adaptativa; sem permissão fica -1
+                if (sample_smaps_adaptive(pid, curr_stats.memory_rss, smaps_schedule) >= 0 && smaps_schedule.valid) {
+                    curr_stats.memory_pss = smaps_schedule.last.pss;
+                    curr_stats.memory_uss = smaps_schedule.last.uss;
+                }
+                
+                // Rede é opcional (pode falhar sem parar monitoramento)
+                int network_result = get_network_usage(pid, curr_stats);
+                if (network_result < 0) {
+                    curr_stats.tcp_connections = 0;
+                }
+                
+                record_sample(curr_stats, chrono::steady_clock::now());
+                error_count = 0;  // Reset contador de erros em caso de sucesso
+                
+            } catch (const exception& e) {
+                // Falha porque o processo terminou durante a coleta: o pidfd já sinalizou
+                if (!watcher.wait(chrono::milliseconds(0)).empty()) {
+                    target_exited = true;
+                    break;
+                }
+                
+                error_count++;
+                cerr << "Erro iteração " << iteration + 1 << " (" << error_count << "/" << MAX_ERRORS << "): " << e.what() << endl;
+                
+                // Para após muitos erros consecutivos
+                if (error_count >= MAX_ERRORS) {
+                    cerr << "Muitos erros consecutivos. Parando monitoramento." << endl;
+                    break;
+                }
+                
+                // Pequena pausa antes de tentar novamente
+                this_thread::sleep_for(chrono::seconds(2));
+            }
+            
+            // Aguarda o intervalo configurado; o término do processo encerra a
+            // espera na hora e a última amostra é coletada do zumbi
+            if (!watcher.wait(chrono::seconds(interval_sec)).empty()) {
+                ProcStats final_stats;
+                if (readFinalSample(pid, watcher.start_time(pid), prev_stats, final_stats)) {
+                    record_sample(final_stats, chrono::steady_clock::now());
+                }
+                target_exited = true;
+                break;
+            }
+        }
+        
+        csv.close();
+        
+        // Relatório final
+        cout << "----------------------------------------" << endl;
+        if (error_count >= MAX_ERRORS) {
+            cout << "Monitoramento interrompido devido a múltiplos erros" << endl;
+        } else if (target_exited) {
+            cout << "Monitoramento concluído (processo " << pid << " terminou)" << endl;
+        } else {
+            cout << "Monitoramento concluído" << endl;
+        }
+        cout << "Iterações: " << iteration << endl;
+        cout << "Arquivo: " << csv_file << endl;
+        if (events.count() > 0) {
+            cout << "Anomalias: " << events.count() << " (" << events_file << ")" << endl;
+        }
+        if (recorder.is_open()) {
+            recorder.close();
+            cout << "Sessão: " << session_file << " (replay: resource-monitor replay " << session_file << ")" << endl;
+        }
+        printStatsReport(cout, "PID " + to_string(pid), run_stats);
+        
+        return (error_count < MAX_ERRORS);
+        
+    } catch (const exception& e) {
+        cerr << "\nErro: " << e.what() << endl;
+        return false;
+    }
+}
+
+// Dorme até 'deadline' em fatias curtas: Ctrl+C não espera o intervalo inteiro
+// Retorno: false se o monitoramento foi interrompido
+static bool sleepUntil(chrono::steady_clock::time_point deadline) {
+    const auto slice = chrono::milliseconds(100);
+    while (monitoring_active) {
+        auto now = chrono::steady_clock::now();
+        if (now >= deadline) {
+            return true;
+        }
+        this_thread::sleep_for(min<chrono::steady_clock::duration>(deadline - now, slice));
+    }
+    return false;
+}
+
+// Monitora um cgroup inteiro como uma unidade, usando os contadores nativos
+// (cpu.stat, memory.current, io.stat, pids.current, PSI) em vez de somar
+// /proc/[pid]/* de cada membro. Opcionalmente grava a quebra por PID
+// membro (cgroup.procs) em um segundo CSV com o layout de monitorProcess
+bool ResourceProfiler::monitorCgroup(const string& cgroup_path, int duration_sec, int interval_sec,
+                                     const string& csv_file, bool per_pid_breakdown) {
+    try {
+        CGroupManager mgr;
+        
+        cout << "\nValidando cgroup " << cgroup_path << "..." << endl;
+        if (!mgr.exists_cgroup(cgroup_path)) {
+            throw runtime_error("CGroup " + mgr.get_base_path() + cgroup_path + " não existe");
+        }
+        
+        CGroupStats prev_cg = mgr.read_cgroup_stats(cgroup_path);
+        if (!prev_cg.valid) {
+            throw runtime_error("Não foi possível ler os contadores de CPU do cgroup " + cgroup_path);
+        }
+        cout << "Acesso validado com sucesso\n" << endl;
+        
+        ofstream csv(csv_file);
+        if (!csv.is_open()) {
+            throw runtime_error("Não foi possível criar arquivo: " + csv_file);
+        }
+        csv << "timestamp,cgroup,cpu_percent,cpu_usage_usec,cpu_nr_throttled,"
+            << "cpu_throttled_usec,memory_current_bytes,io_read_bytes,io_write_bytes,"
+            << "io_read_rate_bps,io_write_rate_bps,pids_current,"
+            << "cpu_pressure_avg10,memory_pressure_avg10,io_pressure_avg10\n";
+        csv.flush();
+        
+        // CSV secundário com a quebra por processo membro
+        string pids_csv_file = csv_file;
+        size_t dot = pids_csv_file.rfind(".csv");
+        pids_csv_file.insert(dot == string::npos ? pids_csv_file.size() : dot, "_pids");
+        ofstream pids_csv;
+        map<int, ProcStats> prev_members;
+        unique_ptr<ProcBatch> member_reader;
+        if (per_pid_breakdown) {
+            member_reader = make_unique<ProcBatch>();
+            pids_csv.open(pids_csv_file);
+            if (!pids_csv.is_open()) {
+                throw runtime_error("Não foi possível criar arquivo: " + pids_csv_file);
+            }
+            writeProcessCsvHeader(pids_csv);
+            pids_csv.flush();
+        }
+        
+        cout << "Monitorando cgroup: " << cgroup_path << endl;
+        cout << "Duração: " << duration_sec << " segundos" << endl;
+        cout << "Intervalo: " << interval_sec << " segundos" << endl;
+        cout << "Arquivo: " << csv_file << endl;
+        if (per_pid_breakdown) {
+            cout << "Quebra por PID: " << pids_csv_file << endl;
+        }
+        cout << "Pressione Ctrl+C para parar..." << endl;
+        cout << "----------------------------------------" << endl;
+        
+        unsigned int num_cores = get_num_cores();
+        auto start = chrono::steady_clock::now();
+        auto prev_time = start;
+        int iteration = 0;
+        TargetStats run_stats;
+        
+        auto next = start;
+        while (monitoring_active) {
+            // Verifica se atingiu o tempo máximo de monitoramento
+            if (chrono::steady_clock::now() - start >= chrono::seconds(duration_sec)) {
+                break;
+            }
+            
+            // Prazos fixos a partir do início: o tempo de coleta não desloca a fase
+            next += chrono::seconds(interval_sec);
+            if (!sleepUntil(next)) {
+                break;
+            }
+            auto now = chrono::steady_clock::now();
+            
+            CGroupStats curr_cg = mgr.read_cgroup_stats(cgroup_path);
+            if (!curr_cg.valid) {
+                cerr << "CGroup " << cgroup_path << " não pode mais ser lido. Parando monitoramento." << endl;
+                break;
+            }
+            
+            // Taxas sobre o tempo realmente decorrido entre as leituras
+            double elapsed = chrono::duration<double>(now - prev_time).count();
+            if (elapsed <= 0) elapsed = interval_sec;
+            
+            double cpu_pct = 0.0;
+            if (curr_cg.cpu_usage_usec >= prev_cg.cpu_usage_usec) {
+                double delta_sec = (curr_cg.cpu_usage_usec - prev_cg.cpu_usage_usec) / 1e6;
+                cpu_pct = (delta_sec / elapsed) * 100.0 / num_cores;
+            }
+            double io_read_rate = curr_cg.io_rbytes >= prev_cg.io_rbytes
+                ? (curr_cg.io_rbytes - prev_cg.io_rbytes) / elapsed : 0.0;
+            double io_write_rate = curr_cg.io_wbytes >= prev_cg.io_wbytes
+                ? (curr_cg.io_wbytes - prev_cg.io_wbytes) / elapsed : 0.0;
+            run_stats.add(cpu_pct, curr_cg.memory_current, io_read_rate + io_write_rate, -1.0, now);
+            
+            string timestamp = currentTimestamp();
+            csv << timestamp << ","
+                << cgroup_path << ","
+                << fixed << setprecision(2) << cpu_pct << ","
+                << curr_cg.cpu_usage_usec << ","
+                << curr_cg.cpu_nr_throttled << ","
+                << curr_cg.cpu_throttled_usec << ","
+                << curr_cg.memory_current << ","
+                << curr_cg.io_rbytes << ","
+                << curr_cg.io_wbytes << ","
+                << fixed << setprecision(0) << io_read_rate << ","
+                << fixed << setprecision(0) << io_write_rate << ","
+                << curr_cg.pids_current << ","
+                << fixed << setprecision(2) << curr_cg.cpu_pressure.avg10 << ","
+                << curr_cg.memory_pressure.avg10 << ","
+                << curr_cg.io_pressure.avg10 << "\n";
+            csv.flush();
+            
+            cout << "[" << timestamp << "] "
+                 << "CPU: " << setw(6) << fixed << setprecision(2) << cpu_pct << "% | "
+                 << "MEM: " << setw(6) << (curr_cg.memory_current / (1024 * 1024)) << "MB | "
+                 << "IO_R: " << setw(7) << fixed << setprecision(1) << (io_read_rate / (1024.0*1024.0)) << "MB/s | "
+                 << "PIDs: " << setw(3) << curr_cg.pids_current
+                 << endl;
+            
+            if (per_pid_breakdown) {
+                sampleCgroupMembers(mgr, *member_reader, cgroup_path, timestamp, elapsed, prev_members, pids_csv);
+            }
+            
+            prev_cg = curr_cg;
+            prev_time = now;
+            iteration++;
+        }
+        
+        csv.close();
+        if (pids_csv.is_open()) {
+            pids_csv.close();
+        }
+        
+        cout << "----------------------------------------" << endl;
+        cout << "Monitoramento concluído" << endl;
+        cout << "Iterações: " << iteration << endl;
+        cout << "Arquivo: " << csv_file << endl;
+        printStatsReport(cout, "cgroup " + cgroup_path, run_stats);
+        
+        return true;
+        
+    } catch (const exception& e) {
+        cerr << "\nErro: " << e.what() << endl;
+        return false;
+    }
+}
+
+// Coleta métricas de cada PID membro do cgroup e grava no CSV de quebra
+// Membros novos (ou PIDs reutilizados) entram com baseline nesta iteração; membros que saíram são descartados
+// Membros terminam ou são de outro usuário a qualquer momento: o leitor em
+// lote só devolve o código de erro, e o PID fica fora desta iteração
+void ResourceProfiler::sampleCgroupMembers(CGroupManager& mgr, ProcBatch& reader, const string& cgroup_path,
+                                           const string& timestamp, double elapsed,
+                                           map<int, ProcStats>& prev_members, ofstream& pids_csv) {
+    vector<int> pids;
+    for (const string& pid_str : mgr.list_processes_in_cgroup(cgroup_path)) {
+        int member_pid = atoi(pid_str.c_str());
+        if (member_pid > 0) pids.push_back(member_pid);
+    }
+    vector<ProcStats> member_stats;
+    vector<int> results;
+    reader.sample(pids, 0, member_stats, results);
+
+    map<int, ProcStats> curr_members;
+    for (size_t i = 0; i < pids.size(); i++) {
+        if (results[i] != 0) {
+            continue;  // Processo saiu entre a listagem e a leitura, ou sem permissão
+        }
+        int member_pid = pids[i];
+        ProcStats& stats = member_stats[i];
+        
+        // PID reutilizado por outro processo (outro instante de início):
+        // deltas contra o antigo não fazem sentido, vira baseline
+        auto prev = prev_members.find(member_pid);
+        if (prev != prev_members.end() && prev->second.start_time == stats.start_time) {
+            double cpu_pct = calculate_cpu_percent(prev->second, stats, elapsed);
+            calculate_io_rate(prev->second, stats, elapsed);
+            writeProcessCsvRow(pids_csv, timestamp, member_pid, cpu_pct, stats, elapsed * 1000.0);
+        }
+        curr_members[member_pid] = stats;
+    }
+    
+    // Fecha os fds de quem deixou o cgroup
+    for (const auto& entry : prev_members) {
+        if (!curr_members.count(entry.first)) reader.forget(entry.first);
+    }
+    pids_csv.flush();
+    prev_members.swap(curr_members);
+}
+
+// Aguarda até 'deadline' em fatias curtas para reagir rápido a sinais; o
+// término de um processo vigiado interrompe a espera na hora
+// Retorno: false se a coleta deve parar (monitoring_active ou stop_request);
+// 'exited' recebe os PIDs que terminaram (vazio se o prazo chegou)
+static bool waitUntil(chrono::steady_clock::time_point deadline, const atomic<bool>* stop_request,
+                      ProcessWatcher& watcher, vector<int>& exited) {
+    const auto slice = chrono::milliseconds(100);
+    exited.clear();
+    while (monitoring_active && !(stop_request && *stop_request)) {
+        auto now = chrono::steady_clock::now();
+        if (now >= deadline) {
+            return true;
+        }
+        exited = watcher.wait(chrono::ceil<chrono::milliseconds>(min<chrono::steady_clock::duration>(deadline - now, slice)));
+        if (!exited.empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Próximo prazo absoluto: se a coleta atrasou além dele, pula para o
+// próximo ciclo futuro mantendo a fase
+static chrono::steady_clock::time_point advanceDeadline(chrono::steady_clock::time_point deadline,
+                                                        chrono::milliseconds interval,
+                                                        chrono::steady_clock::time_point now) {
+    if (deadline < now) {
+        deadline = now + interval - (now - deadline) % interval;
+    }
+    return deadline;
+}
+
+// Amostras entre duas leituras dos núcleos permitidos de um PID (--cpu-allowed)
+static const int CPU_CAPACITY_REFRESH = 30;
+
+// Modo adaptativo: CPU%, RSS ou taxa de I/O mudaram além dos limiares
+// entre duas amostras consecutivas do PID
+static bool significantChange(const ProfileOptions& opts, const ProcessSample& prev, const ProcessSample& curr) {
+    if (fabs(curr.cpu_percent - prev.cpu_percent) >= opts.adapt_cpu) {
+        return true;
+    }
+    long prev_rss = prev.stats.memory_rss;
+    if (prev_rss > 0 && labs(curr.stats.memory_rss - prev_rss) >= prev_rss * opts.adapt_rss / 100.0) {
+        return true;
+    }
+    double prev_io = prev.stats.io_read_rate + prev.stats.io_write_rate;
+    double curr_io = curr.stats.io_read_rate + curr.stats.io_write_rate;
+    return fabs(curr_io - prev_io) >= opts.adapt_io * 1024.0;
+}
+
+// Monitoramento não interativo de um conjunto de PIDs
+// Cada PID tem seu próprio prazo absoluto (sem deriva acumulada) e as
+// taxas usam o tempo realmente decorrido desde a leitura anterior do PID.
+// No modo adaptativo o intervalo de cada PID encolhe quando as métricas
+// mudam e cresce quando ficam estáveis; processos que terminam saem do
+// conjunto sem parar a coleta. Cada PID é vigiado por um pidfd: o término
+// interrompe a espera e a última amostra é gravada na hora
+bool ResourceProfiler::profileProcesses(const ProfileOptions& opts, const atomic<bool>* stop_request) {
+    CGroupManager mgr;
+    if (!opts.cgroup.empty() && !mgr.exists_cgroup(opts.cgroup)) {
+        cerr << "Erro: CGroup " << mgr.get_base_path() << opts.cgroup << " não existe" << endl;
+        return false;
+    }
+    if (opts.pids.empty() && opts.cgroup.empty()) {
+        cerr << "Erro: nenhum PID ou cgroup para monitorar" << endl;
+        return false;
+    }
+
+    // Saída: stdout ou arquivo em append (o daemon reabre a cada recarga)
+    bool to_stdout = (opts.output == "-");
+    ofstream file;
+    if (!to_stdout) {
+        struct stat info;
+        bool has_content = stat(opts.output.c_str(), &info) == 0 && info.st_size > 0;
+        file.open(opts.output, ios::app);
+        if (!file.is_open()) {
+            cerr << "Erro: Não foi possível abrir arquivo: " << opts.output << endl;
+            return false;
+        }
+        if (!has_content) {
+            writeProcessCsvHeader(file);
+        }
+    } else {
+        writeProcessCsvHeader(cout);
+    }
+    ostream& csv = to_stdout ? cout : file;
+    // Resumo no console só quando o CSV não está indo para o stdout
+    bool console = !to_stdout && !opts.quiet;
+    // Relatório de agregados ao final (stderr se o CSV ocupa o stdout)
+    ostream& report = to_stdout ? cerr : cout;
+
+    AnomalyEvents events;
+    if (!opts.events.empty() && !events.open(opts.events)) {
+        cerr << "Erro: Não foi possível abrir arquivo de eventos: " << opts.events << endl;
+        return false;
+    }
+
+    SessionRecorder recorder;
+    if (!opts.record.empty() && !recorder.open(opts.record)) {
+        return false;
+    }
+
+    ofstream host_csv;
+    if (!opts.host_output.empty()) {
+        struct stat info;
+        bool has_content = stat(opts.host_output.c_str(), &info) == 0 && info.st_size > 0;
+        host_csv.open(opts.host_output, ios::app);
+        if (!host_csv.is_open()) {
+            cerr << "Erro: Não foi possível abrir arquivo: " << opts.host_output << endl;
+            return false;
+        }
+        if (!has_content) {
+            writeHostCsvHeader(host_csv);
+        }
+    }
+
+    vector<int> static_pids = opts.pids;
+    map<int, PidSchedule> schedules;
+    ProcessWatcher watcher;
+    // Memória do host: uma leitura por ciclo, MemTotal compartilhado pelos PIDs
+    SystemMemoryStat host_memory;
+    // NUMA: mapa CPU -> nó lido uma vez (topologia fixa durante a coleta)
+    vector<int> cpu_nodes;
+    if (opts.numa_interval > 0) {
+        cpu_nodes = numa_cpu_nodes(read_numa_nodes());
+        if (cpu_nodes.empty()) {
+            cerr << "Aviso: " << sys_path("devices/system/node") << " sem nós NUMA; posicionamento não coletado" << endl;
+        }
+    }
+    const long ticks_per_sec = sysconf(_SC_CLK_TCK);
+    // Leitura em lote (--batch-reads): fds de stat/status/io de cada PID
+    // ficam abertos entre ciclos
+    unique_ptr<ProcBatch> batch;
+    bool members_only = false;
+    if (opts.batch_reads) {
+        batch = make_unique<ProcBatch>();
+        if (!batch->uring() && !opts.quiet) {
+            cerr << "Aviso: io_uring indisponível; leituras em lote via pread" << endl;
+        }
+    } else if (!opts.cgroup.empty()) {
+        // Membros do cgroup terminam ou são de outro usuário a qualquer
+        // ciclo: lidos pelo lote (pread), que só devolve o código de erro,
+        // em vez das get_*_usage, que imprimem cada falha
+        batch = make_unique<ProcBatch>(false);
+        members_only = true;
+    }
+    auto batched = [&](int pid) {
+        return batch && (!members_only ||
+                         find(static_pids.begin(), static_pids.end(), pid) == static_pids.end());
+    };
+    vector<ProcStats> batch_stats;
+    vector<int> batch_results;
+
+    // Taxas da amostra sobre o tempo real desde a leitura anterior do PID,
+    // agregados, alertas, linha do CSV e resumo no console
+    auto emit_sample = [&](PidSchedule& sched, ProcessSample& sample, chrono::steady_clock::time_point now,
+                           const string& timestamp) {
+        int pid = sample.pid;
+        sample.elapsed_sec = chrono::duration<double>(now - sched.time).count();
+        sample.cpu_percent = sched.cpu_capacity > 0
+            ? calculate_cpu_percent(sched.last.stats, sample.stats, sample.elapsed_sec, ticks_per_sec, sched.cpu_capacity)
+            : calculate_cpu_percent(sched.last.stats, sample.stats, sample.elapsed_sec);
+        calculate_io_rate(sched.last.stats, sample.stats, sample.elapsed_sec);
+        sched.summary->add(sample.cpu_percent, sample.stats.memory_rss * 1024.0,
+                           sample.stats.io_read_rate + sample.stats.io_write_rate,
+                           faultRate(sched.last.stats, sample.stats, sample.elapsed_sec), now);
+        sample.summary = sched.summary.get();
+
+        // Detecção de anomalias sobre as taxas recém-calculadas
+        if (events.is_open()) {
+            if (!sched.detector) sched.detector = make_unique<AnomalyDetector>(opts.anomaly);
+            sched.detector->update(pid, chrono::duration<double>(now.time_since_epoch()).count(),
+                                   sample.cpu_percent, sample.stats.memory_rss * 1024.0,
+                                   sample.stats.io_read_rate + sample.stats.io_write_rate, events);
+        }
+        writeProcessCsvRow(csv, timestamp, pid, sample.cpu_percent, sample.stats, sample.elapsed_sec * 1000.0);
+        if (console) {
+            // Nome pelo cache compartilhado: lido uma vez por processo
+            auto meta = process_meta_cache().get(pid, sample.stats.start_time);
+            cout << "[" << timestamp << "] PID " << setw(7) << pid << " "
+                 << left << setw(16) << (meta ? meta->comm : "?") << right << "| "
+                 << "CPU: " << setw(6) << fixed << setprecision(2) << sample.cpu_percent << "% | "
+                 << "RSS: " << setw(6) << (sample.stats.memory_rss / 1024) << "MB";
+            if (opts.adaptive) {
+                cout << " | Δt: " << setw(5) << llround(sample.elapsed_sec * 1000.0) << "ms";
+            }
+            cout << endl;
+        }
+    };
+
+    // Processo terminou: deixa de ser amostrado (e vigiado)
+    auto retire = [&](int pid, const PidSchedule* sched) {
+        watcher.unwatch(pid);
+        if (batch) batch->forget(pid);
+        process_meta_cache().forget(pid);
+        auto it = find(static_pids.begin(), static_pids.end(), pid);
+        if (it != static_pids.end()) {
+            cerr << "Processo " << pid << " encerrado; removido do monitoramento" << endl;
+            static_pids.erase(it);
+            if (sched && !opts.quiet) {
+                printStatsReport(report, "PID " + to_string(pid), *sched->summary);
+            }
+        }
+    };
+
+    // Término sinalizado pelo pidfd durante a espera: última amostra na
+    // hora (o zumbi ainda tem os contadores finais), sem esperar o prazo do PID
+    auto finish = [&](int pid) {
+        auto found = schedules.find(pid);
+        if (found == schedules.end()) {
+            retire(pid, nullptr);
+            return;
+        }
+        PidSchedule& sched = found->second;
+        ProcStats stats;
+        auto now = chrono::steady_clock::now();
+        if (readFinalSample(pid, watcher.start_time(pid), sched.last.stats, stats)) {
+            recorder.record(pid, stats, now);
+            ProcessSample sample = {pid, 0.0, stats, 0.0, true, nullptr};
+            emit_sample(sched, sample, now, currentTimestamp());
+            csv.flush();
+            recorder.flush();
+        }
+        retire(pid, &sched);
+        schedules.erase(found);
+    };
+
+    // Modo fixo: mínimo = máximo = interval_ms (todos os PIDs no mesmo prazo)
+    auto base_interval = chrono::milliseconds(max(1, opts.interval_ms));
+    auto min_interval = base_interval;
+    auto max_interval = base_interval;
+    if (opts.adaptive) {
+        min_interval = chrono::milliseconds(max(1, opts.min_interval_ms));
+        max_interval = max(min_interval, chrono::milliseconds(opts.max_interval_ms));
+        base_interval = clamp(base_interval, min_interval, max_interval);
+    }
+    // PIDs com prazo até 'slack' à frente entram no ciclo atual (evita
+    // acordar de novo microssegundos depois)
+    auto slack = min_interval / 10;
+    auto start = chrono::steady_clock::now();
+    auto wake = start;
+
+    while (monitoring_active && !(stop_request && *stop_request)) {
+        auto now = chrono::steady_clock::now();
+        if (opts.duration_sec > 0 && now - start >= chrono::seconds(opts.duration_sec)) {
+            break;
+        }
+
+        // Conjunto desta amostra: PIDs fixos + membros atuais do cgroup
+        vector<int> pids = static_pids;
+        if (!opts.cgroup.empty()) {
+            for (const string& pid_str : mgr.list_processes_in_cgroup(opts.cgroup)) {
+                int member_pid = atoi(pid_str.c_str());
+                if (member_pid > 0) pids.push_back(member_pid);
+            }
+            sort(pids.begin(), pids.end());
+            pids.erase(unique(pids.begin(), pids.end()), pids.end());
+        }
+
+        string timestamp = currentTimestamp();
+        bool host_valid = host_memory.sample();
+        const HostMemory& host = host_memory.current();
+        if (host_valid && host_csv.is_open()) {
+            writeHostCsvRow(host_csv, timestamp, host);
+            host_csv.flush();
+        }
+
+        map<int, PidSchedule> curr_schedules;
+        vector<ProcessSample> tick_samples;
+
+        // Lote: os PIDs no prazo (mesmo critério do laço abaixo) de uma vez
+        size_t batch_pos = 0;
+        if (batch) {
+            vector<int> due;
+            for (int pid : pids) {
+                auto found = schedules.find(pid);
+                if (batched(pid) && (found == schedules.end() || found->second.due <= now + slack)) {
+                    due.push_back(pid);
+                }
+            }
+            batch->sample(due, host_valid ? static_cast<long>(host.total_kb) : 0, batch_stats, batch_results);
+        }
+
+        for (int pid : pids) {
+            auto found = schedules.find(pid);
+            bool known = found != schedules.end();
+
+            // Fora da vez: repassa a última amostra (o exportador precisa do conjunto completo)
+            if (known && found->second.due > now + slack) {
+                if (found->second.has_rates) {
+                    tick_samples.push_back(found->second.last);
+                    tick_samples.back().fresh = false;
+                }
+                curr_schedules.emplace(pid, std::move(found->second));
+                continue;
+            }
+
+            // Leitura de outro processo com o mesmo PID (o vigiado já foi
+            // recolhido) conta como término: nunca mistura os dois
+            ProcStats stats = {};
+            bool read_ok = known || watcher.watch(pid);
+            if (batched(pid)) {
+                size_t slot = batch_pos++;
+                read_ok = read_ok && batch_results[slot] == 0;
+                if (read_ok) stats = batch_stats[slot];
+            } else {
+                read_ok = read_ok &&
+                    get_cpu_usage(pid, stats) >= 0 &&
+                    (host_valid ? get_memory_usage(pid, stats, host.total_kb) : get_memory_usage(pid, stats)) >= 0 &&
+                    get_io_usage(pid, stats) >= 0;
+            }
+            if (!read_ok || !watcher.same_process(pid, stats.start_time)) {
+                retire(pid, known ? &found->second : nullptr);
+                continue;
+            }
+            if (opts.include_network && get_network_usage(pid, stats) < 0) {
+                stats.tcp_connections = 0;
+            }
+
+            PidSchedule sched;
+            if (known) {
+                sched = std::move(found->second);
+            } else {
+                sched.interval = base_interval;
+                sched.due = wake;
+                sched.smaps.max_interval = opts.pss_interval;
+            }
+            // Núcleos permitidos: relidos periodicamente (cpuset e cota podem
+            // mudar com o processo rodando, ex: redimensionamento de contêiner)
+            if (opts.cpu_allowed && sched.capacity_age-- <= 0) {
+                sched.cpu_capacity = process_cpu_capacity(pid);
+                sched.capacity_age = CPU_CAPACITY_REFRESH;
+            }
+            if (opts.pss_interval > 0 &&
+                sample_smaps_adaptive(pid, stats.memory_rss, sched.smaps) >= 0 && sched.smaps.valid) {
+                stats.memory_pss = sched.smaps.last.pss;
+                stats.memory_uss = sched.smaps.last.uss;
+            }
+            // Posicionamento NUMA: avisa quando a memória passa a ficar
+            // (ou deixa de ficar) majoritariamente fora do nó das threads
+            if (!cpu_nodes.empty()) {
+                if (!sched.numa) {
+                    sched.numa = make_unique<NumaSchedule>();
+                    sched.numa->max_interval = opts.numa_interval;
+                }
+                bool was_misplaced = sched.numa->valid && sched.numa->last.misplaced;
+                if (sample_numa_adaptive(pid, cpu_nodes, *sched.numa) == 1 &&
+                    sched.numa->last.misplaced != was_misplaced && !opts.quiet) {
+                    const ProcessNuma& numa = sched.numa->last;
+                    if (numa.misplaced) {
+                        cerr << "Aviso: PID " << pid << " com "
+                             << llround((1.0 - numa.local_ratio) * 100.0) << "% da memória fora do nó das threads (memória no nó "
+                             << numa.memory_node << ", threads no nó " << numa.thread_node << ")" << endl;
+                    } else {
+                        cerr << "PID " << pid << ": memória de volta ao nó das threads (nó " << numa.thread_node << ")" << endl;
+                    }
+                }
+            }
+            recorder.record(pid, stats, now);
+
+            // Primeira amostra de um PID serve só de baseline para as taxas,
+            // calculadas sobre o tempo real desde a leitura anterior do PID
+            ProcessSample sample = {pid, 0.0, stats, 0.0, true, nullptr};
+            if (sched.numa && sched.numa->valid) {
+                sample.numa = &sched.numa->last;
+            }
+            if (known) {
+                emit_sample(sched, sample, now, timestamp);
+                tick_samples.push_back(sample);
+                if (opts.adaptive && sched.has_rates) {
+                    sched.interval = significantChange(opts, sched.last, sample)
+                        ? min_interval
+                        : min(max_interval, sched.interval * 2);
+                }
+            }
+            sched.has_rates = known;
+            sched.last = sample;
+            sched.time = now;
+            sched.due += sched.interval;
+            curr_schedules.emplace(pid, std::move(sched));
+        }
+        csv.flush();
+        recorder.flush();
+        schedules.swap(curr_schedules);
+        // Membros que saíram do cgroup deixam de ser vigiados
+        for (const auto& entry : curr_schedules) {
+            if (!schedules.count(entry.first)) {
+                watcher.unwatch(entry.first);
+                if (batch) batch->forget(entry.first);
+            }
+        }
+        if (opts.on_tick) {
+            opts.on_tick(tick_samples, host);
+        }
+
+        if (static_pids.empty() && opts.cgroup.empty()) {
+            cerr << "Todos os processos monitorados terminaram" << endl;
+            break;
+        }
+
+        // Próximo prazo absoluto de cada PID; se a coleta atrasou, pula
+        // para o próximo ciclo futuro. Acorda no prazo mais próximo (e no
+        // intervalo base para relistar o cgroup)
+        now = chrono::steady_clock::now();
+        auto next_wake = advanceDeadline(wake + base_interval, base_interval, now);
+        if (opts.cgroup.empty() && !schedules.empty()) {
+            next_wake = chrono::steady_clock::time_point::max();
+        }
+        for (auto& entry : schedules) {
+            PidSchedule& sched = entry.second;
+            sched.due = advanceDeadline(sched.due, sched.interval, now);
+            next_wake = min(next_wake, sched.due);
+        }
+        wake = next_wake;
+        vector<int> exited;
+        bool keep_running = waitUntil(wake, stop_request, watcher, exited);
+        while (keep_running && !exited.empty()) {
+            for (int pid : exited) {
+                finish(pid);
+            }
+            if (static_pids.empty() && opts.cgroup.empty()) {
+                break;  // O próximo ciclo encerra com a mensagem de sempre
+            }
+            keep_running = waitUntil(wake, stop_request, watcher, exited);
+        }
+        if (!keep_running) {
+            break;
+        }
+    }
+
+    if (!opts.quiet) {
+        for (const auto& entry : schedules) {
+            printStatsReport(report, "PID " + to_string(entry.first), *entry.second.summary);
+        }
+    }
+    return true;
+}
+
+// Replay de uma sessão gravada: os contadores brutos passam pelos mesmos
+// cálculos do monitoramento ao vivo (CPU%, taxas, TargetStats e
+// detectores), com o tempo dado pelos instantes gravados e sem esperas
+bool ResourceProfiler::replaySession(const ReplayOptions& opts) {
+    SessionReader reader;
+    if (!reader.open(opts.input)) {
+        return false;
+    }
+
+    // CSV recalculado: stdout, arquivo novo ou nenhum
+    bool to_stdout = (opts.output == "-");
+    ofstream file;
+    if (!opts.output.empty() && !to_stdout) {
+        file.open(opts.output);
+        if (!file.is_open()) {
+            cerr << "Erro: Não foi possível abrir arquivo: " << opts.output << endl;
+            return false;
+        }
+    }
+    ostream* csv = to_stdout ? &cout : (file.is_open() ? &file : nullptr);
+    if (csv) {
+        writeProcessCsvHeader(*csv);
+    }
+    ostream& report = to_stdout ? cerr : cout;
+
+    AnomalyEvents events;
+    if (!opts.events.empty() && !events.open(opts.events)) {
+        cerr << "Erro: Não foi possível abrir arquivo de eventos: " << opts.events << endl;
+        return false;
+    }
+
+    struct ReplayTarget {
+        ProcStats last = {};
+        int64_t last_ns = 0;
+        bool has_last = false;
+        string comm;
+        TargetStats summary;
+        unique_ptr<AnomalyDetector> detector;
+    };
+    map<int, ReplayTarget> targets;
+    auto selected = [&opts](int pid) {
+        return opts.pids.empty() || find(opts.pids.begin(), opts.pids.end(), pid) != opts.pids.end();
+    };
+
+    // Sem âncora (não deveria ocorrer), vale a máquina atual
+    SessionAnchor anchor = {};
+    anchor.ticks_per_sec = sysconf(_SC_CLK_TCK);
+    anchor.num_cores = get_num_cores();
+    bool has_anchor = false;
+    int64_t segment_start = 0, segment_end = 0;
+    double session_sec = 0.0;
+    uint64_t samples = 0, segments = 0;
+
+    auto start = chrono::steady_clock::now();
+    SessionRecord record;
+    while (reader.next(record)) {
+        if (record.type == SESSION_ANCHOR) {
+            SessionAnchor next_anchor;
+            if (!session_read_anchor(record, next_anchor)) continue;
+            // Novo trecho (gravador reaberto): os contadores anteriores
+            // não servem de baseline para as taxas
+            if (has_anchor) session_sec += (segment_end - segment_start) / 1e9;
+            anchor = next_anchor;
+            has_anchor = true;
+            segment_start = segment_end = anchor.mono_ns;
+            segments++;
+            for (auto& entry : targets) entry.second.has_last = false;
+        } else if (record.type == SESSION_PROCESS) {
+            SessionProcess process;
+            string comm, cgroup;
+            if (session_read_process(record, process, comm, cgroup) && selected(process.pid)) {
+                // Um novo registro para o mesmo PID é outro processo (PID reutilizado)
+                targets[process.pid].comm = comm;
+                targets[process.pid].has_last = false;
+            }
+        } else if (record.type == SESSION_SAMPLE) {
+            SessionSample sample;
+            if (!session_read_sample(record, sample) || !selected(sample.pid)) continue;
+            segment_end = max(segment_end, sample.mono_ns);
+
+            ReplayTarget& target = targets[sample.pid];
+            ProcStats stats = session_sample_to_stats(sample);
+            if (target.has_last && sample.mono_ns > target.last_ns) {
+                double elapsed = (sample.mono_ns - target.last_ns) / 1e9;
+                double cpu_pct = calculate_cpu_percent(target.last, stats, elapsed, anchor.ticks_per_sec,
+                                                       anchor.num_cores);
+                calculate_io_rate(target.last, stats, elapsed);
+                double io_rate = stats.io_read_rate + stats.io_write_rate;
+                auto time = chrono::steady_clock::time_point(
+                    chrono::duration_cast<chrono::steady_clock::duration>(chrono::nanoseconds(sample.mono_ns)));
+                target.summary.add(cpu_pct, stats.memory_rss * 1024.0, io_rate,
+                                   faultRate(target.last, stats, elapsed), time);
+
+                double wall = (anchor.wall_ns + (sample.mono_ns - anchor.mono_ns)) / 1e9;
+                if (events.is_open()) {
+                    if (!target.detector) target.detector = make_unique<AnomalyDetector>(opts.anomaly);
+                    AnomalyOrigin origin = {target.comm, wall};
+                    target.detector->update(sample.pid, sample.mono_ns / 1e9, cpu_pct, stats.memory_rss * 1024.0,
+                                            io_rate, events, &origin);
+                }
+                if (csv) {
+                    writeProcessCsvRow(*csv, formatTimestamp(static_cast<time_t>(wall)), sample.pid, cpu_pct,
+                                       stats, elapsed * 1000.0);
+                }
+                samples++;
+            }
+            target.last = stats;
+            target.last_ns = sample.mono_ns;
+            target.has_last = true;
+        }
+    }
+    if (has_anchor) session_sec += (segment_end - segment_start) / 1e9;
+    if (csv) csv->flush();
+    double replay_sec = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    if (reader.truncated()) {
+        cerr << "Aviso: " << opts.input << " termina com registro incompleto em " << reader.offset()
+             << " de " << reader.file_size() << " bytes (ignorado)" << endl;
+    }
+    if (!opts.quiet) {
+        for (const auto& entry : targets) {
+            const ReplayTarget& target = entry.second;
+            auto last = chrono::steady_clock::time_point(
+                chrono::duration_cast<chrono::steady_clock::duration>(chrono::nanoseconds(target.last_ns)));
+            string name = "PID " + to_string(entry.first) + (target.comm.empty() ? "" : " (" + target.comm + ")");
+            printStatsReport(report, name, target.summary, last);
+        }
+    }
+    report << "\nReplay: " << samples << " amostras de " << targets.size() << " processo(s), "
+           << segments << " trecho(s), " << fixed << setprecision(1) << session_sec << "s de sessão em "
+           << setprecision(1) << replay_sec * 1000.0 << "ms";
+    if (replay_sec > 0 && session_sec > 0) {
+        report << " (" << setprecision(0) << session_sec / replay_sec << "x o tempo real)";
+    }
+    report << endl;
+    if (events.count() > 0) {
+        report << "Anomalias: " << events.count() << endl;
+    }
+    return true;
+}
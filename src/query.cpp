@@ -0,0 +1,484 @@
+// ============================================================
+// ARQUIVO: src/query.cpp
+// DESCRIÇÃO: Implementação das consultas sobre sessões gravadas
+// ============================================================
+
+#include "../include/query.hpp"
+#include "../include/session.hpp"
+#include "../include/stream_stats.hpp"
+#include <iostream>
+#include <sstream>
+#include <map>
+#include <unordered_map>
+#include <memory>
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <unistd.h>
+
+// ================================
+// NOMES
+// ================================
+
+static const struct {
+    const char* name;
+    const char* column;
+    QueryMetric metric;
+} METRIC_NAMES[] = {
+    {"cpu", "cpu_percent", QueryMetric::CPU_PERCENT},
+    {"rss", "memory_rss_bytes", QueryMetric::MEMORY_RSS},
+    {"vsz", "memory_vsz_bytes", QueryMetric::MEMORY_VSZ},
+    {"swap", "memory_swap_bytes", QueryMetric::MEMORY_SWAP},
+    {"pss", "memory_pss_bytes", QueryMetric::MEMORY_PSS},
+    {"uss", "memory_uss_bytes", QueryMetric::MEMORY_USS},
+    {"io", "io_bytes_per_second", QueryMetric::IO_RATE},
+    {"io-read", "io_read_bytes_per_second", QueryMetric::IO_READ_RATE},
+    {"io-write", "io_write_bytes_per_second", QueryMetric::IO_WRITE_RATE},
+    {"faults", "page_faults_per_second", QueryMetric::FAULT_RATE},
+    {"ctxt", "context_switches_per_second", QueryMetric::CTXT_RATE},
+    {"threads", "threads", QueryMetric::THREADS},
+};
+
+bool query_metric_from_name(const std::string& name, QueryMetric& metric) {
+    for (const auto& entry : METRIC_NAMES) {
+        if (name == entry.name || name == entry.column) {
+            metric = entry.metric;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* query_metric_name(QueryMetric metric) {
+    for (const auto& entry : METRIC_NAMES) {
+        if (entry.metric == metric) return entry.column;
+    }
+    return "?";
+}
+
+// "pid", "comm", "cgroup", "ns" (conjunto) ou "netns", "pidns", ... (um tipo)
+bool query_group_from_name(const std::string& name, QueryGroup& group, int& ns_index) {
+    ns_index = -1;
+    if (name == "none") group = QueryGroup::NONE;
+    else if (name == "pid") group = QueryGroup::PID;
+    else if (name == "comm") group = QueryGroup::COMM;
+    else if (name == "cgroup") group = QueryGroup::CGROUP;
+    else if (name == "ns") group = QueryGroup::NAMESPACES;
+    else {
+        for (size_t i = 0; i < SESSION_NS_COUNT; i++) {
+            if (name == std::string(SESSION_NS_NAMES[i]) + "ns") {
+                group = QueryGroup::NAMESPACES;
+                ns_index = static_cast<int>(i);
+                return true;
+            }
+        }
+        return false;
+    }
+    return true;
+}
+
+// "avg,max,p99" -> lista de agregações
+bool query_aggregates_from_list(const std::string& list, std::vector<QueryAggSpec>& aggregates) {
+    std::vector<QueryAggSpec> parsed;
+    std::stringstream ss(list);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (item.empty()) continue;
+        QueryAggSpec spec;
+        if (item == "count") spec.type = QueryAggregate::COUNT;
+        else if (item == "avg") spec.type = QueryAggregate::AVG;
+        else if (item == "min") spec.type = QueryAggregate::MIN;
+        else if (item == "max") spec.type = QueryAggregate::MAX;
+        else if (item == "sum") spec.type = QueryAggregate::SUM;
+        else if (item == "last") spec.type = QueryAggregate::LAST;
+        else if (item.size() > 1 && item[0] == 'p') {
+            char* end = nullptr;
+            double q = strtod(item.c_str() + 1, &end);
+            if (*end != '\0' || !(q >= 0 && q <= 100)) return false;
+            spec.type = QueryAggregate::QUANTILE;
+            spec.quantile = q / 100.0;
+        } else {
+            return false;
+        }
+        parsed.push_back(spec);
+    }
+    if (parsed.empty()) return false;
+    aggregates = parsed;
+    return true;
+}
+
+std::string query_aggregate_name(const QueryAggSpec& spec) {
+    switch (spec.type) {
+        case QueryAggregate::COUNT: return "count";
+        case QueryAggregate::AVG:   return "avg";
+        case QueryAggregate::MIN:   return "min";
+        case QueryAggregate::MAX:   return "max";
+        case QueryAggregate::SUM:   return "sum";
+        case QueryAggregate::LAST:  return "last";
+        case QueryAggregate::QUANTILE: {
+            std::ostringstream name;
+            name << "p" << spec.quantile * 100.0;
+            return name.str();
+        }
+    }
+    return "?";
+}
+
+// ================================
+// AGREGAÇÃO EM BLOCOS DE COLUNAS
+// ================================
+
+namespace {
+
+// Linhas por bloco: colunas cabem na L2 e o laço de agregação roda sobre
+// vetores contíguos
+const size_t BLOCK_ROWS = 4096;
+
+struct ColumnBlock {
+    std::vector<long long> time;        // ns desde a época
+    std::vector<uint32_t> group;        // Id do grupo (dicionário)
+    std::vector<double> value;
+    std::vector<long long> bucket;      // Preenchida pelo kernel
+
+    ColumnBlock() {
+        time.reserve(BLOCK_ROWS);
+        group.reserve(BLOCK_ROWS);
+        value.reserve(BLOCK_ROWS);
+        bucket.resize(BLOCK_ROWS);
+    }
+
+    size_t size() const { return time.size(); }
+
+    void clear() {
+        time.clear();
+        group.clear();
+        value.clear();
+    }
+};
+
+// Acumulador de um (bucket, grupo)
+struct Cell {
+    uint32_t group = 0;
+    long long bucket = 0;
+    long long first_ns = LLONG_MAX;
+    long long last_ns = LLONG_MIN;
+    uint64_t count = 0;
+    double sum = 0.0;
+    double min = 0.0;
+    double max = 0.0;
+    double last = 0.0;
+    std::unique_ptr<QuantileSketch> sketch;     // Só com agregação pNN
+};
+
+class Aggregator {
+private:
+    long long bucket_ns;
+    bool quantiles;
+    std::vector<Cell> cells;
+    std::map<std::pair<uint32_t, long long>, uint32_t> index;   // (grupo, bucket) -> célula
+    std::vector<std::pair<long long, uint32_t>> cache;         // Por grupo: último bucket e sua célula
+
+    uint32_t cell_of(uint32_t group, long long bucket) {
+        if (group >= cache.size()) cache.resize(group + 1, {LLONG_MIN, 0});
+        auto& cached = cache[group];
+        if (cached.first == bucket) return cached.second;
+
+        auto key = std::make_pair(group, bucket);
+        auto it = index.find(key);
+        uint32_t id;
+        if (it == index.end()) {
+            id = static_cast<uint32_t>(cells.size());
+            cells.emplace_back();
+            cells.back().group = group;
+            cells.back().bucket = bucket;
+            if (quantiles) cells.back().sketch = std::make_unique<QuantileSketch>();
+            index.emplace(key, id);
+        } else {
+            id = it->second;
+        }
+        cached = {bucket, id};
+        return id;
+    }
+
+public:
+    Aggregator(long long bucket, bool with_quantiles) : bucket_ns(bucket), quantiles(with_quantiles) {}
+
+    // Kernel de um bloco: primeiro a coluna de buckets (laço sem
+    // dependências, vetorizável), depois a acumulação por célula; amostras
+    // consecutivas do mesmo grupo e bucket reusam a célula do cache
+    void consume(ColumnBlock& block) {
+        size_t n = block.size();
+        const long long* time = block.time.data();
+        long long* bucket = block.bucket.data();
+        if (bucket_ns > 0) {
+            for (size_t i = 0; i < n; i++) {
+                long long t = time[i];
+                bucket[i] = (t >= 0 ? t : t - bucket_ns + 1) / bucket_ns;
+            }
+        } else {
+            std::fill(bucket, bucket + n, 0LL);
+        }
+
+        const uint32_t* group = block.group.data();
+        const double* value = block.value.data();
+        for (size_t i = 0; i < n; i++) {
+            Cell& c = cells[cell_of(group[i], bucket[i])];
+            double v = value[i];
+            if (c.count == 0) {
+                c.min = c.max = v;
+            } else {
+                c.min = std::min(c.min, v);
+                c.max = std::max(c.max, v);
+            }
+            c.count++;
+            c.sum += v;
+            if (time[i] >= c.last_ns) {
+                c.last_ns = time[i];
+                c.last = v;
+            }
+            c.first_ns = std::min(c.first_ns, time[i]);
+            if (c.sketch) c.sketch->add(v);
+        }
+        block.clear();
+    }
+
+    const std::vector<Cell>& result() const { return cells; }
+};
+
+// Estado de um PID durante a varredura de uma sessão
+struct PidState {
+    SessionSample last = {};            // Baseline das taxas (contadores brutos)
+    bool has_last = false;
+    uint32_t group = UINT32_MAX;        // UINT32_MAX = ainda não resolvido
+    std::string label;                  // Rótulo do grupo (metadados do processo)
+};
+
+// Estados indexados por PID sem hash: slot[pid] aponta para states
+// (PIDs vão até pid_max, no máximo 2^22)
+class PidStates {
+private:
+    std::vector<int32_t> slot;
+    std::vector<PidState> states;
+
+public:
+    PidState& operator[](int pid) {
+        size_t index = static_cast<size_t>(pid);
+        if (index >= slot.size()) slot.resize(std::max(index + 1, slot.size() * 2), -1);
+        if (slot[index] < 0) {
+            slot[index] = static_cast<int32_t>(states.size());
+            states.emplace_back();
+        }
+        return states[slot[index]];
+    }
+
+    void reset_rates() {
+        for (auto& state : states) state.has_last = false;
+    }
+};
+
+// Rótulo de grupo de um processo a partir dos seus metadados
+std::string group_label(const QueryOptions& opts, const SessionProcess& process, const std::string& comm,
+                        const std::string& cgroup) {
+    switch (opts.group) {
+        case QueryGroup::COMM:
+            return comm.empty() ? "?" : comm;
+        case QueryGroup::CGROUP:
+            return cgroup.empty() ? "?" : cgroup;
+        case QueryGroup::NAMESPACES: {
+            std::string label;
+            for (size_t i = 0; i < SESSION_NS_COUNT; i++) {
+                if (opts.ns_index >= 0 && static_cast<size_t>(opts.ns_index) != i) continue;
+                if (!label.empty()) label += ' ';
+                label += std::string(SESSION_NS_NAMES[i]) + ":" + std::to_string(process.ns_inode[i]);
+            }
+            return label;
+        }
+        default:
+            return "*";
+    }
+}
+
+// Valor da métrica para uma amostra; false se não há valor (taxa sem
+// amostra anterior ou PSS/USS não coletado). Mesmas fórmulas de
+// calculate_cpu_percent e calculate_io_rate, sem montar ProcStats por amostra
+bool metric_value(QueryMetric metric, const SessionAnchor& anchor, const PidState& state,
+                  const SessionSample& sample, double& value) {
+    switch (metric) {
+        case QueryMetric::MEMORY_RSS:  value = sample.memory_rss * 1024.0; return true;
+        case QueryMetric::MEMORY_VSZ:  value = sample.memory_vsz * 1024.0; return true;
+        case QueryMetric::MEMORY_SWAP: value = sample.memory_swap * 1024.0; return true;
+        case QueryMetric::MEMORY_PSS:  value = sample.memory_pss * 1024.0; return sample.memory_pss >= 0;
+        case QueryMetric::MEMORY_USS:  value = sample.memory_uss * 1024.0; return sample.memory_uss >= 0;
+        case QueryMetric::THREADS:     value = sample.threads; return true;
+        default: break;
+    }
+
+    const SessionSample& prev = state.last;
+    if (!state.has_last || sample.mono_ns <= prev.mono_ns) {
+        return false;
+    }
+    double elapsed = (sample.mono_ns - prev.mono_ns) / 1e9;
+    switch (metric) {
+        case QueryMetric::CPU_PERCENT: {
+            double ticks = static_cast<double>((sample.utime + sample.stime) - (prev.utime + prev.stime));
+            value = ticks / anchor.ticks_per_sec / elapsed * 100.0 / std::max(anchor.num_cores, 1u);
+            if (value < 0) value = 0;
+            return true;
+        }
+        case QueryMetric::IO_RATE:
+        case QueryMetric::IO_READ_RATE:
+        case QueryMetric::IO_WRITE_RATE: {
+            double read = std::max(0.0, (sample.io_read_bytes - prev.io_read_bytes) / elapsed);
+            double written = std::max(0.0, (sample.io_write_bytes - prev.io_write_bytes) / elapsed);
+            value = metric == QueryMetric::IO_READ_RATE ? read
+                  : metric == QueryMetric::IO_WRITE_RATE ? written
+                  : read + written;
+            return true;
+        }
+        case QueryMetric::FAULT_RATE: {
+            int64_t delta = (sample.minor_faults + sample.major_faults) - (prev.minor_faults + prev.major_faults);
+            value = delta >= 0 ? delta / elapsed : 0.0;
+            return true;
+        }
+        case QueryMetric::CTXT_RATE: {
+            int64_t delta = (sample.voluntary_ctxt + sample.nonvoluntary_ctxt) -
+                            (prev.voluntary_ctxt + prev.nonvoluntary_ctxt);
+            value = delta >= 0 ? delta / elapsed : 0.0;
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+}  // namespace
+
+// ================================
+// CONSULTA
+// ================================
+
+bool run_query(const QueryOptions& opts, QueryResult& result) {
+    auto start = std::chrono::steady_clock::now();
+    result = QueryResult();
+
+    bool with_quantiles = false;
+    for (const auto& spec : opts.aggregates) {
+        if (spec.type == QueryAggregate::QUANTILE) with_quantiles = true;
+    }
+    Aggregator aggregator(opts.bucket_ns, with_quantiles);
+    ColumnBlock block;
+
+    // Dicionário de grupos (rótulo <-> id), compartilhado entre as sessões
+    std::unordered_map<std::string, uint32_t> group_ids;
+    std::vector<std::string> group_names;
+    auto group_id = [&](const std::string& label) {
+        auto it = group_ids.find(label);
+        if (it != group_ids.end()) return it->second;
+        uint32_t id = static_cast<uint32_t>(group_names.size());
+        group_names.push_back(label);
+        group_ids.emplace(label, id);
+        return id;
+    };
+
+    std::vector<int> pids = opts.pids;
+    std::sort(pids.begin(), pids.end());
+
+    for (const std::string& input : opts.inputs) {
+        SessionReader reader;
+        if (!reader.open(input)) {
+            return false;
+        }
+
+        SessionAnchor anchor = {};
+        anchor.ticks_per_sec = sysconf(_SC_CLK_TCK);
+        anchor.num_cores = get_num_cores();
+        PidStates states;
+
+        SessionRecord record;
+        while (reader.next(record)) {
+            result.records++;
+            if (record.type == SESSION_SAMPLE) {
+                SessionSample sample;
+                if (!session_read_sample(record, sample) || sample.pid < 0) continue;
+                if (!pids.empty() && !std::binary_search(pids.begin(), pids.end(), sample.pid)) continue;
+
+                PidState& state = states[sample.pid];
+                long long wall = anchor.wall_ns + (sample.mono_ns - anchor.mono_ns);
+                double value;
+                if (wall >= opts.from_ns && wall < opts.to_ns &&
+                    metric_value(opts.metric, anchor, state, sample, value)) {
+                    if (state.group == UINT32_MAX) {
+                        if (opts.group == QueryGroup::PID) {
+                            state.group = group_id(std::to_string(sample.pid));
+                        } else if (opts.group == QueryGroup::NONE) {
+                            state.group = group_id("*");
+                        } else {
+                            state.group = group_id(state.label.empty() ? "?" : state.label);
+                        }
+                    }
+                    block.time.push_back(wall);
+                    block.group.push_back(state.group);
+                    block.value.push_back(value);
+                    if (block.size() == BLOCK_ROWS) {
+                        result.matched += block.size();
+                        aggregator.consume(block);
+                    }
+                }
+                state.last = sample;
+                state.has_last = true;
+            } else if (record.type == SESSION_ANCHOR) {
+                // Novo trecho: contadores anteriores não servem para taxas
+                if (!session_read_anchor(record, anchor)) continue;
+                states.reset_rates();
+            } else if (record.type == SESSION_PROCESS) {
+                SessionProcess process;
+                std::string comm, cgroup;
+                if (!session_read_process(record, process, comm, cgroup) || process.pid < 0) continue;
+                // Novo registro de processo para o PID = outro processo (PID reutilizado):
+                // as taxas recomeçam da primeira amostra dele
+                PidState& state = states[process.pid];
+                state.has_last = false;
+                if (opts.group != QueryGroup::NONE && opts.group != QueryGroup::PID) {
+                    state.label = group_label(opts, process, comm, cgroup);
+                    state.group = UINT32_MAX;   // Resolvido na próxima amostra (PID pode ter sido reusado)
+                }
+            }
+        }
+        result.bytes += reader.offset();
+        if (reader.truncated()) {
+            result.truncated = true;
+            std::cerr << "Aviso: " << input << " termina com registro incompleto (ignorado)" << std::endl;
+        }
+    }
+    result.matched += block.size();
+    aggregator.consume(block);
+
+    // Linhas na ordem (bucket, grupo)
+    for (const Cell& c : aggregator.result()) {
+        QueryRow row;
+        row.bucket_ns = opts.bucket_ns > 0 ? c.bucket * opts.bucket_ns : c.first_ns;
+        row.group = group_names[c.group];
+        row.count = c.count;
+        for (const auto& spec : opts.aggregates) {
+            double v = 0.0;
+            switch (spec.type) {
+                case QueryAggregate::COUNT:    v = static_cast<double>(c.count); break;
+                case QueryAggregate::AVG:      v = c.count ? c.sum / c.count : 0.0; break;
+                case QueryAggregate::MIN:      v = c.min; break;
+                case QueryAggregate::MAX:      v = c.max; break;
+                case QueryAggregate::SUM:      v = c.sum; break;
+                case QueryAggregate::LAST:     v = c.last; break;
+                case QueryAggregate::QUANTILE: v = c.sketch ? c.sketch->quantile(spec.quantile) : 0.0; break;
+            }
+            row.values.push_back(v);
+        }
+        result.rows.push_back(std::move(row));
+    }
+    std::sort(result.rows.begin(), result.rows.end(), [](const QueryRow& a, const QueryRow& b) {
+        return a.bucket_ns != b.bucket_ns ? a.bucket_ns < b.bucket_ns : a.group < b.group;
+    });
+
+    result.elapsed_sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return true;
+}
@@ -0,0 +1,431 @@
+// ============================================================
+// ARQUIVO: src/session.cpp
+// DESCRIÇÃO: Implementação da gravação e leitura de sessões
+// ============================================================
+
+#include "../include/session.hpp"
+#include "../include/procfs.hpp"
+#include "../include/process_meta.hpp"
+#include "../include/process_watch.hpp"
+#include <iostream>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <cerrno>
+#include <algorithm>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+// Arredonda para o próximo múltiplo de 8 (alinhamento dos registros)
+static size_t align8(size_t n) {
+    return (n + 7) & ~static_cast<size_t>(7);
+}
+
+// Checksum dos registros: FNV-1a sobre palavras de 64 bits em 4 faixas
+// independentes (a cadeia xor-multiplicação de cada faixa não espera a
+// das outras), cerca de 8x mais rápido que o FNV-1a byte a byte na
+// varredura de uma sessão grande. Detecta registros cortados ou
+// sobrescritos; não é criptográfico
+static const uint64_t FNV_OFFSET = 14695981039346656037ull;
+static const uint64_t FNV_PRIME = 1099511628211ull;
+
+struct FrameHasher {
+    uint64_t lane[4] = {FNV_OFFSET, FNV_OFFSET ^ 1, FNV_OFFSET ^ 2, FNV_OFFSET ^ 3};
+    unsigned char pending[32];
+    size_t pending_length = 0;
+
+    void block(const unsigned char* p) {
+        for (int k = 0; k < 4; k++) {
+            uint64_t word;
+            memcpy(&word, p + 8 * k, sizeof(word));
+            lane[k] = (lane[k] ^ word) * FNV_PRIME;
+        }
+    }
+
+    void update(const void* data, size_t length) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        if (pending_length > 0) {
+            size_t take = std::min(length, sizeof(pending) - pending_length);
+            memcpy(pending + pending_length, p, take);
+            pending_length += take;
+            p += take;
+            length -= take;
+            if (pending_length < sizeof(pending)) return;
+            block(pending);
+            pending_length = 0;
+        }
+        for (; length >= 32; p += 32, length -= 32) {
+            block(p);
+        }
+        memcpy(pending, p, length);
+        pending_length = length;
+    }
+
+    uint32_t finish() {
+        // Resto (< 32 bytes) completado com zeros; o tamanho já entrou no cabeçalho
+        if (pending_length > 0) {
+            memset(pending + pending_length, 0, sizeof(pending) - pending_length);
+            block(pending);
+        }
+        uint64_t hash = FNV_OFFSET;
+        for (uint64_t l : lane) {
+            hash = (hash ^ l) * FNV_PRIME;
+        }
+        return static_cast<uint32_t>(hash ^ (hash >> 32));
+    }
+};
+
+static uint32_t frame_checksum(uint32_t type, uint32_t length, const void* payload, const void* extra,
+                               size_t extra_length) {
+    FrameHasher hasher;
+    uint64_t head = (static_cast<uint64_t>(type) << 32) | length;
+    hasher.lane[0] = (hasher.lane[0] ^ head) * FNV_PRIME;
+    if (extra_length == 0) {
+        // Payload contíguo (caso da leitura): blocos direto do mmap
+        const unsigned char* p = static_cast<const unsigned char*>(payload);
+        size_t full = length & ~static_cast<size_t>(31);
+        for (size_t off = 0; off < full; off += 32) {
+            hasher.block(p + off);
+        }
+        hasher.update(p + full, length - full);
+    } else {
+        hasher.update(payload, length - extra_length);
+        hasher.update(extra, extra_length);
+    }
+    return hasher.finish();
+}
+
+// ================================
+// CONVERSÕES
+// ================================
+
+int64_t session_mono_ns(std::chrono::steady_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+SessionSample session_sample_from_stats(int pid, const ProcStats& stats, int64_t mono_ns) {
+    SessionSample s = {};
+    s.mono_ns = mono_ns;
+    s.pid = pid;
+    s.threads = stats.threads;
+    s.utime = stats.utime;
+    s.stime = stats.stime;
+    s.memory_rss = stats.memory_rss;
+    s.memory_vsz = stats.memory_vsz;
+    s.memory_swap = stats.memory_swap;
+    s.memory_pss = stats.memory_pss;
+    s.memory_uss = stats.memory_uss;
+    s.io_read_bytes = stats.io_read_bytes;
+    s.io_write_bytes = stats.io_write_bytes;
+    s.minor_faults = stats.minor_faults;
+    s.major_faults = stats.major_faults;
+    s.voluntary_ctxt = stats.voluntary_ctxt;
+    s.nonvoluntary_ctxt = stats.nonvoluntary_ctxt;
+    s.tcp_connections = stats.tcp_connections;
+    return s;
+}
+
+ProcStats session_sample_to_stats(const SessionSample& s) {
+    ProcStats stats = {};
+    stats.threads = s.threads;
+    stats.utime = s.utime;
+    stats.stime = s.stime;
+    stats.memory_rss = s.memory_rss;
+    stats.memory_vsz = s.memory_vsz;
+    stats.memory_swap = s.memory_swap;
+    stats.memory_pss = s.memory_pss;
+    stats.memory_uss = s.memory_uss;
+    stats.io_read_bytes = s.io_read_bytes;
+    stats.io_write_bytes = s.io_write_bytes;
+    stats.minor_faults = s.minor_faults;
+    stats.major_faults = s.major_faults;
+    stats.voluntary_ctxt = s.voluntary_ctxt;
+    stats.nonvoluntary_ctxt = s.nonvoluntary_ctxt;
+    stats.tcp_connections = s.tcp_connections;
+    return stats;
+}
+
+// ================================
+// GRAVADOR
+// ================================
+
+SessionRecorder::SessionRecorder() : fd(-1), samples(0), failed(false) {}
+
+SessionRecorder::~SessionRecorder() {
+    close();
+}
+
+bool SessionRecorder::open(const std::string& file) {
+    close();
+    int new_fd = ::open(file.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (new_fd < 0) {
+        std::cerr << "ERRO: Não foi possível abrir sessão " << file << " - " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(new_fd, &info) != 0) {
+        ::close(new_fd);
+        return false;
+    }
+    if (info.st_size == 0) {
+        SessionFileHeader header = {};
+        memcpy(header.magic, SESSION_MAGIC, sizeof(header.magic));
+        header.version = SESSION_VERSION;
+        if (write(new_fd, &header, sizeof(header)) != static_cast<ssize_t>(sizeof(header))) {
+            std::cerr << "ERRO: Falha ao gravar cabeçalho da sessão " << file << " - " << strerror(errno) << std::endl;
+            ::close(new_fd);
+            return false;
+        }
+    } else {
+        // Sessão existente: continua após o último registro íntegro
+        SessionReader reader;
+        if (!reader.open(file)) {
+            ::close(new_fd);
+            return false;
+        }
+        SessionRecord record;
+        while (reader.next(record)) {}
+        if (reader.offset() < reader.file_size()) {
+            std::cerr << "Aviso: sessão " << file << " tinha " << (reader.file_size() - reader.offset())
+                      << " bytes incompletos no final (descartados)" << std::endl;
+            if (ftruncate(new_fd, static_cast<off_t>(reader.offset())) != 0) {
+                std::cerr << "ERRO: Falha ao truncar sessão " << file << " - " << strerror(errno) << std::endl;
+                ::close(new_fd);
+                return false;
+            }
+        }
+    }
+    if (lseek(new_fd, 0, SEEK_END) < 0) {
+        ::close(new_fd);
+        return false;
+    }
+
+    fd = new_fd;
+    path = file;
+    failed = false;
+    known.clear();
+    last_sync = std::chrono::steady_clock::now();
+
+    // Âncora: relógios no mesmo instante e parâmetros da máquina
+    SessionAnchor anchor = {};
+    anchor.mono_ns = session_mono_ns(std::chrono::steady_clock::now());
+    anchor.wall_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    anchor.ticks_per_sec = sysconf(_SC_CLK_TCK);
+    anchor.page_size = sysconf(_SC_PAGESIZE);
+    anchor.num_cores = get_num_cores();
+    FILE* boot = fopen(proc_path("sys/kernel/random/boot_id").c_str(), "r");
+    if (boot) {
+        if (fgets(anchor.boot_id, sizeof(anchor.boot_id), boot)) {
+            anchor.boot_id[strcspn(anchor.boot_id, "\n")] = '\0';
+        }
+        fclose(boot);
+    }
+    append(SESSION_ANCHOR, &anchor, sizeof(anchor));
+    return flush();
+}
+
+void SessionRecorder::append(uint32_t type, const void* payload, size_t length, const void* extra,
+                             size_t extra_length) {
+    SessionFrame frame = {};
+    frame.type = type;
+    frame.length = static_cast<uint32_t>(length + extra_length);
+    frame.checksum = frame_checksum(type, frame.length, payload, extra, extra_length);
+
+    size_t start = buffer.size();
+    buffer.resize(start + sizeof(frame) + align8(frame.length), 0);
+    memcpy(&buffer[start], &frame, sizeof(frame));
+    memcpy(&buffer[start + sizeof(frame)], payload, length);
+    if (extra_length > 0) {
+        memcpy(&buffer[start + sizeof(frame) + length], extra, extra_length);
+    }
+}
+
+// Metadados lidos uma vez por PID: comm, cgroup, instante de início e namespaces
+void SessionRecorder::record_process(int pid, long long start_time) {
+    SessionProcess process = {};
+    process.pid = pid;
+
+    process.start_time = start_time;
+
+    // Metadados do cache compartilhado (já lidos pelo profiler ou pela
+    // varredura de namespaces); processo que terminou grava só o PID
+    std::string comm;
+    std::string cgroup;
+    if (auto meta = process_meta_cache().get(pid, start_time)) {
+        comm = meta->comm;
+        cgroup = meta->cgroup;
+        static_assert(SESSION_NS_COUNT == PROCESS_META_NS_COUNT, "mesma ordem de namespaces");
+        for (size_t i = 0; i < SESSION_NS_COUNT; i++) {
+            process.ns_inode[i] = meta->ns_inode[i];
+        }
+    }
+
+    if (comm.size() > UINT16_MAX) comm.resize(UINT16_MAX);
+    if (cgroup.size() > UINT16_MAX) cgroup.resize(UINT16_MAX);
+    process.comm_length = static_cast<uint16_t>(comm.size());
+    process.cgroup_length = static_cast<uint16_t>(cgroup.size());
+    std::string names = comm + cgroup;
+    append(SESSION_PROCESS, &process, sizeof(process), names.data(), names.size());
+}
+
+void SessionRecorder::record(int pid, const ProcStats& stats, std::chrono::steady_clock::time_point time) {
+    if (fd < 0) return;
+    // PID reutilizado (outro instante de início): novo registro de processo
+    long long start_time = stats.start_time >= 0 ? stats.start_time : read_process_start_time(pid);
+    auto it = known.find(pid);
+    if (it == known.end() || it->second != start_time) {
+        known[pid] = start_time;
+        record_process(pid, start_time);
+    }
+    SessionSample sample = session_sample_from_stats(pid, stats, session_mono_ns(time));
+    append(SESSION_SAMPLE, &sample, sizeof(sample));
+    samples++;
+}
+
+bool SessionRecorder::flush() {
+    if (fd < 0 || buffer.empty()) {
+        return fd >= 0;
+    }
+
+    // Um write() por ciclo; escrita parcial é completada (disco cheio
+    // deixa um registro cortado, descartado na próxima abertura)
+    size_t done = 0;
+    while (done < buffer.size()) {
+        ssize_t n = write(fd, buffer.data() + done, buffer.size() - done);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            std::cerr << "ERRO: Falha ao gravar sessão " << path << " - " << strerror(errno)
+                      << "; gravação desligada" << std::endl;
+            failed = true;
+            buffer.clear();
+            ::close(fd);
+            fd = -1;
+            return false;
+        }
+        done += static_cast<size_t>(n);
+    }
+    buffer.clear();
+
+    auto now = std::chrono::steady_clock::now();
+    if (sync_interval_sec >= 0 && now - last_sync >= std::chrono::seconds(sync_interval_sec)) {
+        fdatasync(fd);
+        last_sync = now;
+    }
+    return true;
+}
+
+void SessionRecorder::close() {
+    if (fd < 0) return;
+    flush();
+    if (fd >= 0) {
+        fdatasync(fd);
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+// ================================
+// LEITOR
+// ================================
+
+SessionReader::SessionReader() : fd(-1), base(nullptr), size(0), pos(0), torn(false) {}
+
+SessionReader::~SessionReader() {
+    if (base) munmap(const_cast<unsigned char*>(base), size);
+    if (fd >= 0) close(fd);
+}
+
+bool SessionReader::open(const std::string& file) {
+    fd = ::open(file.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        std::cerr << "ERRO: Não foi possível abrir sessão " << file << " - " << strerror(errno) << std::endl;
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(SessionFileHeader)) {
+        std::cerr << "ERRO: " << file << " não é uma sessão gravada (arquivo curto)" << std::endl;
+        return false;
+    }
+    size = static_cast<size_t>(info.st_size);
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+    if (mapped == MAP_FAILED) {
+        std::cerr << "ERRO: mmap de " << file << " falhou - " << strerror(errno) << std::endl;
+        size = 0;
+        return false;
+    }
+    base = static_cast<const unsigned char*>(mapped);
+    madvise(mapped, size, MADV_SEQUENTIAL);
+
+    SessionFileHeader header;
+    memcpy(&header, base, sizeof(header));
+    if (memcmp(header.magic, SESSION_MAGIC, sizeof(header.magic)) != 0) {
+        std::cerr << "ERRO: " << file << " não é uma sessão gravada (assinatura inválida)" << std::endl;
+        return false;
+    }
+    if (header.version != SESSION_VERSION) {
+        std::cerr << "ERRO: versão de sessão não suportada em " << file << ": " << header.version << std::endl;
+        return false;
+    }
+    pos = sizeof(SessionFileHeader);
+    return true;
+}
+
+bool SessionReader::next(SessionRecord& record) {
+    if (!base || pos >= size) {
+        return false;
+    }
+    SessionFrame frame;
+    if (size - pos < sizeof(frame)) {
+        torn = true;
+        return false;
+    }
+    memcpy(&frame, base + pos, sizeof(frame));
+    size_t total = sizeof(frame) + align8(frame.length);
+    if (frame.length > size - pos - sizeof(frame) || total > size - pos) {
+        torn = true;
+        return false;
+    }
+    const unsigned char* data = base + pos + sizeof(frame);
+    if (frame_checksum(frame.type, frame.length, data, nullptr, 0) != frame.checksum) {
+        torn = true;
+        return false;
+    }
+    record.type = frame.type;
+    record.data = data;
+    record.length = frame.length;
+    pos += total;
+    return true;
+}
+
+void SessionReader::rewind() {
+    pos = sizeof(SessionFileHeader);
+    torn = false;
+}
+
+bool session_read_anchor(const SessionRecord& record, SessionAnchor& anchor) {
+    if (record.type != SESSION_ANCHOR || record.length < sizeof(anchor)) return false;
+    memcpy(&anchor, record.data, sizeof(anchor));
+    anchor.boot_id[sizeof(anchor.boot_id) - 1] = '\0';
+    return true;
+}
+
+bool session_read_sample(const SessionRecord& record, SessionSample& sample) {
+    if (record.type != SESSION_SAMPLE || record.length < sizeof(sample)) return false;
+    memcpy(&sample, record.data, sizeof(sample));
+    return true;
+}
+
+bool session_read_process(const SessionRecord& record, SessionProcess& process, std::string& comm,
+                          std::string& cgroup) {
+    if (record.type != SESSION_PROCESS || record.length < sizeof(process)) return false;
+    memcpy(&process, record.data, sizeof(process));
+    if (record.length < sizeof(process) + process.comm_length + process.cgroup_length) return false;
+    const char* names = reinterpret_cast<const char*>(record.data + sizeof(process));
+    comm.assign(names, process.comm_length);
+    cgroup.assign(names + process.comm_length, process.cgroup_length);
+    return true;
+}
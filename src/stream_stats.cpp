@@ -0,0 +1,246 @@
+// ============================================================
+// ARQUIVO: src/stream_stats.cpp
+// DESCRIÇÃO: Implementação das estatísticas em fluxo (Welford,
+// DDSketch e janelas deslizantes)
+// ============================================================
+
+#include "../include/stream_stats.hpp"
+#include <cmath>
+#include <algorithm>
+
+// ================================
+// RUNNINGSTATS
+// ================================
+
+void RunningStats::add(double value) {
+    count++;
+    if (count == 1) {
+        min = max = value;
+    } else {
+        min = std::min(min, value);
+        max = std::max(max, value);
+    }
+    double delta = value - mean;
+    mean += delta / count;
+    m2 += delta * (value - mean);
+}
+
+void RunningStats::merge(const RunningStats& other) {
+    if (other.count == 0) return;
+    if (count == 0) {
+        *this = other;
+        return;
+    }
+    uint64_t n = count + other.count;
+    double delta = other.mean - mean;
+    mean += delta * other.count / n;
+    m2 += other.m2 + delta * delta * (static_cast<double>(count) * other.count / n);
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+    count = n;
+}
+
+double RunningStats::variance() const {
+    return count > 1 ? m2 / (count - 1) : 0.0;
+}
+
+double RunningStats::stddev() const {
+    return std::sqrt(variance());
+}
+
+// ================================
+// QUANTILESKETCH (DDSketch)
+// ================================
+
+QuantileSketch::QuantileSketch(double accuracy, size_t bin_limit)
+    : relative_accuracy(accuracy), max_bins(std::max<size_t>(bin_limit, 16)),
+      offset(0), zero_count(0), total(0) {
+    gamma = (1.0 + relative_accuracy) / (1.0 - relative_accuracy);
+    log_gamma = std::log(gamma);
+}
+
+int QuantileSketch::index_of(double value) const {
+    return static_cast<int>(std::ceil(std::log(value) / log_gamma));
+}
+
+void QuantileSketch::add_count(int index, uint64_t n) {
+    if (bins.empty()) {
+        offset = index;
+        bins.assign(1, 0);
+    } else if (index < offset) {
+        bins.insert(bins.begin(), offset - index, 0);
+        offset = index;
+    } else if (index >= offset + static_cast<int>(bins.size())) {
+        bins.resize(index - offset + 1, 0);
+    }
+    bins[index - offset] += n;
+
+    // Colapsa os buckets mais baixos no primeiro bucket mantido
+    if (bins.size() > max_bins) {
+        size_t excess = bins.size() - max_bins;
+        uint64_t collapsed = 0;
+        for (size_t k = 0; k < excess; k++) collapsed += bins[k];
+        bins.erase(bins.begin(), bins.begin() + excess);
+        bins[0] += collapsed;
+        offset += static_cast<int>(excess);
+    }
+}
+
+void QuantileSketch::add(double value) {
+    total++;
+    if (!(value > 0.0)) {
+        zero_count++;
+        return;
+    }
+    add_count(index_of(value), 1);
+}
+
+void QuantileSketch::merge(const QuantileSketch& other) {
+    if (other.total == 0) return;
+    total += other.total;
+    zero_count += other.zero_count;
+    if (other.bins.empty()) return;
+
+    // Reserva a faixa inteira de uma vez (evita inserções repetidas no início)
+    add_count(other.offset, 0);
+    add_count(other.offset + static_cast<int>(other.bins.size()) - 1, 0);
+    for (size_t k = 0; k < other.bins.size(); k++) {
+        if (other.bins[k]) add_count(other.offset + static_cast<int>(k), other.bins[k]);
+    }
+}
+
+double QuantileSketch::quantile(double q) const {
+    if (total == 0) return 0.0;
+    q = std::clamp(q, 0.0, 1.0);
+    double rank = q * (total - 1);
+    if (rank < zero_count) return 0.0;
+
+    uint64_t seen = zero_count;
+    for (size_t k = 0; k < bins.size(); k++) {
+        seen += bins[k];
+        if (seen > rank) {
+            // Ponto do bucket com erro relativo <= relative_accuracy
+            return 2.0 * std::pow(gamma, offset + static_cast<int>(k)) / (gamma + 1.0);
+        }
+    }
+    return 2.0 * std::pow(gamma, offset + static_cast<int>(bins.size()) - 1) / (gamma + 1.0);
+}
+
+void QuantileSketch::clear() {
+    bins.clear();
+    offset = 0;
+    zero_count = 0;
+    total = 0;
+}
+
+// ================================
+// METRICSUMMARY
+// ================================
+
+void MetricSummary::add(double value) {
+    stats.add(value);
+    sketch.add(value);
+}
+
+void MetricSummary::merge(const MetricSummary& other) {
+    stats.merge(other.stats);
+    sketch.merge(other.sketch);
+}
+
+void MetricSummary::clear() {
+    stats = RunningStats();
+    sketch.clear();
+}
+
+// ================================
+// WINDOWEDSUMMARY
+// ================================
+
+WindowedSummary::WindowedSummary(std::chrono::seconds window, size_t slot_count)
+    : slot_length(std::chrono::duration_cast<std::chrono::steady_clock::duration>(window) / std::max<size_t>(slot_count, 1)),
+      slots(std::max<size_t>(slot_count, 1)),
+      slot_epoch(std::max<size_t>(slot_count, 1), -1) {}
+
+long long WindowedSummary::epoch_of(std::chrono::steady_clock::time_point now) const {
+    return now.time_since_epoch() / slot_length;
+}
+
+void WindowedSummary::add(double value, std::chrono::steady_clock::time_point now) {
+    long long epoch = epoch_of(now);
+    size_t pos = static_cast<size_t>(epoch % static_cast<long long>(slots.size()));
+    if (slot_epoch[pos] != epoch) {
+        slots[pos].clear();
+        slot_epoch[pos] = epoch;
+    }
+    slots[pos].add(value);
+}
+
+MetricSummary WindowedSummary::summary(std::chrono::steady_clock::time_point now) const {
+    long long epoch = epoch_of(now);
+    long long oldest = epoch - static_cast<long long>(slots.size()) + 1;
+    MetricSummary merged;
+    for (size_t pos = 0; pos < slots.size(); pos++) {
+        if (slot_epoch[pos] >= oldest && slot_epoch[pos] <= epoch) {
+            merged.merge(slots[pos]);
+        }
+    }
+    return merged;
+}
+
+// ================================
+// TARGETSTATS
+// ================================
+
+const char* stat_metric_name(StatMetric metric) {
+    switch (metric) {
+        case StatMetric::CPU_PERCENT:  return "cpu_percent";
+        case StatMetric::MEMORY_BYTES: return "memory_bytes";
+        case StatMetric::IO_RATE:      return "io_bytes_per_second";
+        case StatMetric::FAULT_RATE:   return "page_faults_per_second";
+    }
+    return "?";
+}
+
+const char* stat_window_name(StatWindow window) {
+    switch (window) {
+        case StatWindow::RUN:    return "run";
+        case StatWindow::MIN_1:  return "1m";
+        case StatWindow::MIN_5:  return "5m";
+        case StatWindow::MIN_15: return "15m";
+    }
+    return "?";
+}
+
+// Sub-janelas: 5s na de 1m, 30s na de 5m, 1min na de 15m
+TargetStats::Series::Series()
+    : last_1m(std::chrono::seconds(60), 12),
+      last_5m(std::chrono::seconds(300), 10),
+      last_15m(std::chrono::seconds(900), 15) {}
+
+void TargetStats::Series::add(double value, std::chrono::steady_clock::time_point now) {
+    run.add(value);
+    last_1m.add(value, now);
+    last_5m.add(value, now);
+    last_15m.add(value, now);
+}
+
+void TargetStats::add(double cpu_percent, double memory_bytes, double io_rate, double fault_rate,
+                      std::chrono::steady_clock::time_point now) {
+    series[static_cast<size_t>(StatMetric::CPU_PERCENT)].add(cpu_percent, now);
+    series[static_cast<size_t>(StatMetric::MEMORY_BYTES)].add(memory_bytes, now);
+    series[static_cast<size_t>(StatMetric::IO_RATE)].add(io_rate, now);
+    if (fault_rate >= 0) {
+        series[static_cast<size_t>(StatMetric::FAULT_RATE)].add(fault_rate, now);
+    }
+}
+
+MetricSummary TargetStats::summary(StatMetric metric, StatWindow window,
+                                   std::chrono::steady_clock::time_point now) const {
+    const Series& s = series[static_cast<size_t>(metric)];
+    switch (window) {
+        case StatWindow::MIN_1:  return s.last_1m.summary(now);
+        case StatWindow::MIN_5:  return s.last_5m.summary(now);
+        case StatWindow::MIN_15: return s.last_15m.summary(now);
+        default:                 return s.run;
+    }
+}
@@ -0,0 +1,176 @@
+// ============================================================
+// ARQUIVO: src/system_memory.cpp
+// DESCRIÇÃO: Implementação da memória do host
+// ============================================================
+
+#include "../include/system_memory.hpp"
+#include "../include/procfs.hpp"
+#include <cstring>
+#include <cstdlib>
+#include <unistd.h>
+#include <fcntl.h>
+
+// Campos usados de /proc/meminfo ("Nome:   valor kB")
+struct MeminfoKey {
+    const char* name;
+    long long HostMemory::*field;
+};
+
+static const MeminfoKey MEMINFO_KEYS[] = {
+    {"MemTotal", &HostMemory::total_kb},
+    {"MemFree", &HostMemory::free_kb},
+    {"MemAvailable", &HostMemory::available_kb},
+    {"Buffers", &HostMemory::buffers_kb},
+    {"Cached", &HostMemory::cached_kb},
+    {"Slab", &HostMemory::slab_kb},
+    {"SReclaimable", &HostMemory::slab_reclaimable_kb},
+    {"SUnreclaim", &HostMemory::slab_unreclaimable_kb},
+    {"Dirty", &HostMemory::dirty_kb},
+    {"SwapTotal", &HostMemory::swap_total_kb},
+    {"SwapFree", &HostMemory::swap_free_kb},
+};
+
+// Campos usados de /proc/vmstat ("nome valor"); vários nomes somam no
+// mesmo contador. Só os nomes por origem: pgscan_anon/pgscan_file
+// (Linux >= 5.8) repetem os mesmos totais e ficam de fora
+struct VmstatKey {
+    const char* name;
+    unsigned long long HostMemory::*field;
+};
+
+static const VmstatKey VMSTAT_KEYS[] = {
+    {"pgscan_kswapd", &HostMemory::pgscan},
+    {"pgscan_direct", &HostMemory::pgscan},
+    {"pgscan_khugepaged", &HostMemory::pgscan},
+    {"pgsteal_kswapd", &HostMemory::pgsteal},
+    {"pgsteal_direct", &HostMemory::pgsteal},
+    {"pgsteal_khugepaged", &HostMemory::pgsteal},
+    {"allocstall", &HostMemory::allocstall},            // Kernels < 4.8
+    {"allocstall_dma", &HostMemory::allocstall},
+    {"allocstall_dma32", &HostMemory::allocstall},
+    {"allocstall_normal", &HostMemory::allocstall},
+    {"allocstall_movable", &HostMemory::allocstall},
+    {"allocstall_device", &HostMemory::allocstall},
+    {"workingset_refault", &HostMemory::refaults},      // Kernels < 5.9
+    {"workingset_refault_anon", &HostMemory::refaults},
+    {"workingset_refault_file", &HostMemory::refaults},
+    {"pswpin", &HostMemory::pswpin},
+    {"pswpout", &HostMemory::pswpout},
+    {"pgmajfault", &HostMemory::pgmajfault},
+};
+
+// Percorre as linhas "nome<sep>valor" do buffer e entrega a store() o
+// índice da chave e o valor de cada linha reconhecida
+// Retorno: linhas reconhecidas
+template <typename Key, size_t N, typename Store>
+static size_t parse_keys(const char* p, char sep, const Key (&keys)[N], Store store) {
+    size_t found = 0;
+    while (*p) {
+        const char* end = strchr(p, sep);
+        const char* newline = strchr(p, '\n');
+        if (end && (!newline || end < newline)) {
+            size_t len = static_cast<size_t>(end - p);
+            for (size_t k = 0; k < N; k++) {
+                if (strncmp(keys[k].name, p, len) == 0 && keys[k].name[len] == '\0') {
+                    store(k, strtoull(end + 1, nullptr, 10));
+                    found++;
+                    break;
+                }
+            }
+        }
+        if (!newline) break;
+        p = newline + 1;
+    }
+    return found;
+}
+
+SystemMemoryStat::SystemMemoryStat() : meminfo_fd(-1), vmstat_fd(-1), has_prev(false) {
+    // /proc/vmstat tem ~4-8 KB; cresce se não couber
+    buffer.resize(16384);
+}
+
+SystemMemoryStat::~SystemMemoryStat() {
+    if (meminfo_fd >= 0) {
+        close(meminfo_fd);
+    }
+    if (vmstat_fd >= 0) {
+        close(vmstat_fd);
+    }
+}
+
+// Lê o arquivo inteiro para 'buffer' (terminado em '\0')
+bool SystemMemoryStat::read_file(int& fd, const char* name) {
+    if (fd < 0) {
+        fd = open(proc_path(name).c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return false;
+        }
+    }
+    while (true) {
+        ssize_t n = pread(fd, buffer.data(), buffer.size() - 1, 0);
+        if (n < 0) {
+            return false;
+        }
+        if (static_cast<size_t>(n) < buffer.size() - 1) {
+            buffer[n] = '\0';
+            return true;
+        }
+        buffer.resize(buffer.size() * 2);   // Não coube: relê com o dobro
+    }
+}
+
+bool SystemMemoryStat::parse_meminfo(HostMemory& out) {
+    if (!read_file(meminfo_fd, "meminfo")) {
+        return false;
+    }
+    parse_keys(buffer.data(), ':', MEMINFO_KEYS, [&](size_t k, unsigned long long value) {
+        out.*(MEMINFO_KEYS[k].field) = static_cast<long long>(value);
+    });
+    // Kernels < 3.14 não têm MemAvailable: aproximação pelo livre + cache
+    if (out.available_kb == 0) {
+        out.available_kb = out.free_kb + out.cached_kb + out.buffers_kb + out.slab_reclaimable_kb;
+    }
+    return out.total_kb > 0;
+}
+
+bool SystemMemoryStat::parse_vmstat(HostMemory& out) {
+    if (!read_file(vmstat_fd, "vmstat")) {
+        return false;
+    }
+    return parse_keys(buffer.data(), ' ', VMSTAT_KEYS, [&](size_t k, unsigned long long value) {
+        out.*(VMSTAT_KEYS[k].field) += value;
+    }) > 0;
+}
+
+bool SystemMemoryStat::sample() {
+    HostMemory next;
+    if (!parse_meminfo(next)) {
+        return false;
+    }
+    auto now = std::chrono::steady_clock::now();
+    if (!parse_vmstat(next)) {
+        has_prev = false;
+        snapshot = next;
+        return true;
+    }
+
+    double elapsed = std::chrono::duration<double>(now - time).count();
+    if (has_prev && elapsed > 0) {
+        // Contadores só crescem; um recuo (não deveria ocorrer) vira taxa zero
+        auto rate = [elapsed](unsigned long long curr, unsigned long long prev) {
+            return curr > prev ? static_cast<double>(curr - prev) / elapsed : 0.0;
+        };
+        next.scan_rate = rate(next.pgscan, snapshot.pgscan);
+        next.steal_rate = rate(next.pgsteal, snapshot.pgsteal);
+        next.direct_reclaim_rate = rate(next.allocstall, snapshot.allocstall);
+        next.refault_rate = rate(next.refaults, snapshot.refaults);
+        next.swapin_rate = rate(next.pswpin, snapshot.pswpin);
+        next.swapout_rate = rate(next.pswpout, snapshot.pswpout);
+        next.major_fault_rate = rate(next.pgmajfault, snapshot.pgmajfault);
+        next.has_rates = true;
+    }
+    has_prev = true;
+    time = now;
+    snapshot = next;
+    return true;
+}
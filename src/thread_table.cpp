@@ -0,0 +1,252 @@
+// ============================================================
+// ARQUIVO: src/thread_table.cpp
+// DESCRIÇÃO: Implementação da amostragem por thread (TID)
+// ============================================================
+
+#include "../include/thread_table.hpp"
+#include "../include/procfs.hpp"
+#include <algorithm>
+#include <numeric>
+#include <cstring>
+#include <cstdlib>
+#include <cerrno>
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+
+// Caminho de /proc/[pid]/task/[tid]/<arquivo>
+static std::string task_path(int pid, int tid, const char* name) {
+    return proc_pid_path(pid, "task/" + std::to_string(tid) + "/" + name);
+}
+
+// Relê um arquivo aberto; retorno false se a thread terminou
+static bool pread_text(int fd, char* buf, size_t size) {
+    if (fd < 0) return false;
+    ssize_t n = pread(fd, buf, size - 1, 0);
+    if (n <= 0) return false;
+    buf[n] = '\0';
+    return true;
+}
+
+// Extrai de task/[tid]/stat: nome, estado e utime+stime (ticks)
+static bool parse_task_stat(const char* buf, std::string& name, char& state, unsigned long long& cpu_ticks) {
+    const char* open_paren = strchr(buf, '(');
+    const char* close_paren = strrchr(buf, ')');
+    if (!open_paren || !close_paren || close_paren < open_paren || !close_paren[1]) return false;
+    name.assign(open_paren + 1, close_paren - open_paren - 1);
+    state = close_paren[2];
+
+    // utime e stime são os campos 14 e 15; o campo 3 (state) começa em close_paren + 2
+    const char* p = close_paren + 2;
+    for (int field = 3; field < 14 && p; field++) {
+        p = strchr(p, ' ');
+        if (p) p++;
+    }
+    if (!p) return false;
+    char* end;
+    unsigned long long utime = strtoull(p, &end, 10);
+    unsigned long long stime = strtoull(end, nullptr, 10);
+    cpu_ticks = utime + stime;
+    return true;
+}
+
+// Extrai um campo numérico de task/[tid]/status (ex: "voluntary_ctxt_switches:")
+static long status_field(const char* buf, const char* key) {
+    const char* p = strstr(buf, key);
+    return p ? atol(p + strlen(key)) : 0;
+}
+
+ThreadTable::ThreadTable(int target_pid)
+    : pid(target_pid), generation(0), loadavg_fd(-1), last_created_tid(-1), alive(true), last_elapsed(0.0),
+      status_buffer(4096) {
+    ns_per_tick = 1e9 / static_cast<double>(sysconf(_SC_CLK_TCK));
+
+    // 3 fds por thread: eleva o limite flexível até o rígido
+    raise_nofile_limit();
+}
+
+ThreadTable::~ThreadTable() {
+    for (auto& entry : tracked) {
+        close_thread(entry.second);
+    }
+    if (loadavg_fd >= 0) {
+        close(loadavg_fd);
+    }
+}
+
+bool ThreadTable::open_thread(int tid, Tracked& t) {
+    t.stat_fd = open(task_path(pid, tid, "stat").c_str(), O_RDONLY | O_CLOEXEC);
+    if (t.stat_fd < 0) {
+        return false;  // Thread já terminou (ou limite de fds esgotado)
+    }
+    t.sched_fd = open(task_path(pid, tid, "schedstat").c_str(), O_RDONLY | O_CLOEXEC);
+    t.status_fd = open(task_path(pid, tid, "status").c_str(), O_RDONLY | O_CLOEXEC);
+    t.has_prev = false;
+    t.run_ns = t.wait_ns = t.slices = 0;
+    t.voluntary = t.nonvoluntary = 0;
+    t.state = '?';
+    return true;
+}
+
+void ThreadTable::close_thread(Tracked& t) {
+    if (t.stat_fd >= 0) close(t.stat_fd);
+    if (t.sched_fd >= 0) close(t.sched_fd);
+    if (t.status_fd >= 0) close(t.status_fd);
+    t.stat_fd = t.sched_fd = t.status_fd = -1;
+}
+
+void ThreadTable::discover_threads() {
+    DIR* dir = opendir(proc_pid_path(pid, "task").c_str());
+    if (!dir) {
+        alive = false;
+        return;
+    }
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        const char* name = entry->d_name;
+        if (name[0] < '1' || name[0] > '9') continue;
+        int tid = atoi(name);
+        if (tracked.count(tid)) continue;
+        Tracked t;
+        if (open_thread(tid, t)) {
+            tracked.emplace(tid, std::move(t));
+        }
+    }
+    closedir(dir);
+}
+
+// Lê task/[tid]/status inteiro: as trocas de contexto são as últimas
+// linhas, depois de Cpus_allowed/Mems_allowed (longas com muitas CPUs)
+bool ThreadTable::read_status(int fd) {
+    if (fd < 0) return false;
+    ssize_t n;
+    while ((n = pread(fd, status_buffer.data(), status_buffer.size() - 1, 0)) ==
+           static_cast<ssize_t>(status_buffer.size() - 1)) {
+        status_buffer.resize(status_buffer.size() * 2);  // Buffer cheio: lê de novo com o dobro
+    }
+    if (n <= 0) return false;
+    status_buffer[n] = '\0';
+    return true;
+}
+
+size_t ThreadTable::sample() {
+    auto now = std::chrono::steady_clock::now();
+    last_elapsed = generation > 0 ? std::chrono::duration<double>(now - prev_time).count() : 0.0;
+    prev_time = now;
+    generation++;
+
+    cols.tid.clear();
+    cols.state.clear();
+    cols.cpu_percent.clear();
+    cols.wait_percent.clear();
+    cols.avg_wait_us.clear();
+    cols.slices_rate.clear();
+    cols.voluntary_rate.clear();
+    cols.nonvoluntary_rate.clear();
+    cols.name.clear();
+    if (!alive) {
+        return 0;
+    }
+
+    // Threads novas só existem se algum TID foi criado desde o último ciclo
+    long newest = read_last_created_pid(loadavg_fd);
+    if (newest < 0 || newest != last_created_tid) {
+        last_created_tid = newest;
+        discover_threads();
+    }
+
+    char buf[1536];             // stat e schedstat
+    double elapsed_ns = last_elapsed * 1e9;
+    for (auto it = tracked.begin(); it != tracked.end();) {
+        int tid = it->first;
+        Tracked& t = it->second;
+
+        // stat: estado e nome a cada ciclo (a thread pode estar em D sem rodar)
+        unsigned long long cpu_ticks = 0;
+        char state = '?';
+        if (!pread_text(t.stat_fd, buf, sizeof(buf)) || !parse_task_stat(buf, t.name, state, cpu_ticks)) {
+            close_thread(t);
+            it = tracked.erase(it);
+            continue;
+        }
+
+        // schedstat: "<ns em CPU> <ns na runqueue> <fatias>"
+        unsigned long long run_ns = static_cast<unsigned long long>(cpu_ticks * ns_per_tick);
+        unsigned long long wait_ns = 0, slices = 0;
+        bool has_sched = pread_text(t.sched_fd, buf, sizeof(buf));
+        if (has_sched) {
+            char* end;
+            run_ns = strtoull(buf, &end, 10);
+            wait_ns = strtoull(end, &end, 10);
+            slices = strtoull(end, nullptr, 10);
+        }
+
+        // status só para quem rodou: sem rodar não há troca de contexto
+        bool ran = !t.has_prev || run_ns != t.run_ns || slices != t.slices;
+        long voluntary = t.voluntary, nonvoluntary = t.nonvoluntary;
+        if (ran && read_status(t.status_fd)) {
+            voluntary = status_field(status_buffer.data(), "\nvoluntary_ctxt_switches:");
+            nonvoluntary = status_field(status_buffer.data(), "\nnonvoluntary_ctxt_switches:");
+        }
+
+        double cpu_pct = 0, wait_pct = 0, avg_wait = 0, slices_rate = 0, vol_rate = 0, invol_rate = 0;
+        if (t.has_prev && elapsed_ns > 0) {
+            if (run_ns > t.run_ns) cpu_pct = (run_ns - t.run_ns) / elapsed_ns * 100.0;
+            if (wait_ns > t.wait_ns) wait_pct = (wait_ns - t.wait_ns) / elapsed_ns * 100.0;
+            if (slices > t.slices) {
+                slices_rate = (slices - t.slices) / last_elapsed;
+                avg_wait = wait_ns > t.wait_ns ? (wait_ns - t.wait_ns) / 1e3 / (slices - t.slices) : 0.0;
+            }
+            if (voluntary > t.voluntary) vol_rate = (voluntary - t.voluntary) / last_elapsed;
+            if (nonvoluntary > t.nonvoluntary) invol_rate = (nonvoluntary - t.nonvoluntary) / last_elapsed;
+        }
+        t.run_ns = run_ns;
+        t.wait_ns = wait_ns;
+        t.slices = slices;
+        t.voluntary = voluntary;
+        t.nonvoluntary = nonvoluntary;
+        t.state = state;
+        t.has_prev = true;
+
+        cols.tid.push_back(tid);
+        cols.state.push_back(state);
+        cols.cpu_percent.push_back(cpu_pct);
+        cols.wait_percent.push_back(has_sched ? wait_pct : -1.0);
+        cols.avg_wait_us.push_back(has_sched ? avg_wait : -1.0);
+        cols.slices_rate.push_back(slices_rate);
+        cols.voluntary_rate.push_back(vol_rate);
+        cols.nonvoluntary_rate.push_back(invol_rate);
+        cols.name.push_back(&t.name);
+        ++it;
+    }
+
+    if (tracked.empty()) {
+        alive = false;
+    }
+    return cols.size();
+}
+
+std::vector<size_t> ThreadTable::top_k(ThreadMetric metric, size_t k) const {
+    size_t n = cols.size();
+    k = std::min(k, n);
+    order.resize(n);
+    std::iota(order.begin(), order.end(), 0);
+
+    auto value = [this, metric](size_t i) -> double {
+        switch (metric) {
+            case ThreadMetric::WAIT:     return cols.wait_percent[i];
+            case ThreadMetric::SWITCHES: return cols.voluntary_rate[i] + cols.nonvoluntary_rate[i];
+            default:                     return cols.cpu_percent[i];
+        }
+    };
+    auto greater = [&](size_t a, size_t b) {
+        double va = value(a), vb = value(b);
+        return va != vb ? va > vb : cols.tid[a] < cols.tid[b];
+    };
+
+    if (k < n) {
+        std::nth_element(order.begin(), order.begin() + k, order.end(), greater);
+    }
+    std::sort(order.begin(), order.begin() + k, greater);
+    return std::vector<size_t>(order.begin(), order.begin() + k);
+}
@@ -0,0 +1,697 @@
+// ============================================================
+// ARQUIVO: tests/bench_collectors.cpp
+// DESCRIÇÃO: Microbenchmarks de cada função coletora
+// Mede o custo isolado por chamada de get_cpu_usage, get_memory_usage,
+// get_io_usage, get_network_usage, list_process_namespaces, dos
+// métodos CGroupManager::read_* e das amostragens do sistema inteiro
+// (ProcessTable, SystemCpuStat)
+//
+// ALVOS:
+// - PID real (padrão: o próprio benchmark, ou --pid N)
+// - Fixture sintético: processo com muitos sockets TCP abertos e filhos
+//   em namespaces próprios, que infla /proc/net/tcp, /proc/[pid]/fd e o
+//   número de namespaces distintos do sistema
+// - Snapshot capturado (--root DIR, ver scripts/capture_procfs.py): os
+//   coletores leem DIR/proc e DIR/sys em vez do sistema vivo, permitindo
+//   medir os parsers na escala de um host de produção
+//
+// MÉTRICAS:
+// - ns/chamada (harness: repetições até o IC 95% convergir)
+// - alocações/chamada (operator new global contador)
+// - syscalls/chamada (tracepoint raw_syscalls:sys_enter, se acessível)
+// - throughput com 1..N threads chamando o coletor em paralelo
+// - ciclo do profile por número de alvos (--targets): get_*_usage por
+//   PID contra ProcBatch (io_uring e pread), em ms/ciclo e syscalls/ciclo
+//
+// USO:
+//   make bench
+//   ./bin/bench_collectors [--pid N] [--sockets N] [--ns-procs N]
+//                          [--threads N] [--no-fixture] [--root DIR] [--json ARQ]
+//                          [--targets 100,1000,5000]
+// ============================================================
+
+#include "../include/monitor.hpp"
+#include "../include/namespace.hpp"
+#include "../include/cgroup_manager.hpp"
+#include "../include/procfs.hpp"
+#include "../include/process_table.hpp"
+#include "../include/thread_table.hpp"
+#include "../include/cpu_stat.hpp"
+#include "../include/system_memory.hpp"
+#include "../include/numa.hpp"
+#include "../include/process_meta.hpp"
+#include "../include/process_tree.hpp"
+#include "../include/proc_batch.hpp"
+#include "../include/netns_stat.hpp"
+#include "../include/disk_stat.hpp"
+#include "bench_harness.hpp"
+#include "perf_counters.hpp"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cmath>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <new>
+#include <cstdlib>
+#include <cstring>
+#include <csignal>
+#include <unistd.h>
+#include <sched.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+using namespace std;
+using namespace chrono;
+
+// ================================
+// ALOCADOR CONTADOR
+// Substitui o operator new global; o contador é por thread para não
+// introduzir contenção nas medições com várias threads
+// ================================
+static thread_local uint64_t tl_allocations = 0;
+
+void* operator new(size_t size) {
+    tl_allocations++;
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw bad_alloc();
+}
+
+void* operator new[](size_t size) {
+    tl_allocations++;
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw bad_alloc();
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+// ================================
+// FIXTURE SINTÉTICO
+// ================================
+
+// Processo com muitos sockets e filhos em namespaces próprios
+struct SyntheticFixture {
+    pid_t pid = -1;
+    int sockets = 0;
+    int ns_procs = 0;
+};
+
+// Cria o fixture; o filho avisa pelo pipe quando terminou de montar o cenário
+SyntheticFixture start_fixture(int sockets, int ns_procs) {
+    SyntheticFixture fx;
+    int ready[2];
+    if (pipe(ready) == -1) {
+        return fx;
+    }
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(ready[0]);
+        setpgid(0, 0);  // Grupo próprio: o pai mata tudo de uma vez
+
+        // Garante descritores suficientes para os sockets
+        raise_nofile_limit();
+
+        int opened = 0;
+        for (int i = 0; i < sockets; i++) {
+            int s = socket(AF_INET, SOCK_STREAM, 0);
+            if (s < 0) break;
+            sockaddr_in addr = {};
+            addr.sin_family = AF_INET;
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            addr.sin_port = 0;
+            if (bind(s, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0 && listen(s, 1) == 0) {
+                opened++;
+            }
+        }
+
+        // Filhos em namespaces UTS/IPC próprios (via user namespace sem root)
+        int created = 0;
+        for (int i = 0; i < ns_procs; i++) {
+            pid_t child = fork();
+            if (child == 0) {
+                if (unshare(CLONE_NEWUTS | CLONE_NEWIPC) != 0) {
+                    unshare(CLONE_NEWUSER | CLONE_NEWUTS | CLONE_NEWIPC);
+                }
+                pause();
+                _exit(0);
+            }
+            if (child > 0) created++;
+        }
+
+        int counts[2] = {opened, created};
+        ssize_t n = write(ready[1], counts, sizeof(counts));
+        (void)n;
+        close(ready[1]);
+        pause();
+        _exit(0);
+    }
+
+    close(ready[1]);
+    if (pid > 0) {
+        int counts[2] = {0, 0};
+        if (read(ready[0], counts, sizeof(counts)) == sizeof(counts)) {
+            fx.pid = pid;
+            fx.sockets = counts[0];
+            fx.ns_procs = counts[1];
+        }
+    }
+    close(ready[0]);
+    return fx;
+}
+
+void stop_fixture(const SyntheticFixture& fx) {
+    if (fx.pid > 0) {
+        kill(-fx.pid, SIGKILL);
+        waitpid(fx.pid, nullptr, 0);
+    }
+}
+
+// Processos dormindo como alvos do ciclo do profile: um processo de grupo
+// próprio com n filhos; os PIDs dos filhos chegam pelo pipe
+pid_t start_sleepers(int n, vector<int>& pids) {
+    int ready[2];
+    if (pipe(ready) == -1) {
+        return -1;
+    }
+    pid_t holder = fork();
+    if (holder == 0) {
+        close(ready[0]);
+        setpgid(0, 0);
+        for (int i = 0; i < n; i++) {
+            pid_t child = fork();
+            if (child == 0) {
+                close(ready[1]);  // Senão o pai nunca vê o fim do pipe
+                pause();
+                _exit(0);
+            }
+            if (child < 0) break;
+            int id = child;
+            ssize_t w = write(ready[1], &id, sizeof(id));
+            (void)w;
+        }
+        close(ready[1]);
+        pause();
+        _exit(0);
+    }
+    close(ready[1]);
+    int id;
+    while (holder > 0 && read(ready[0], &id, sizeof(id)) == sizeof(id)) {
+        pids.push_back(id);
+    }
+    close(ready[0]);
+    return holder;
+}
+
+// ================================
+// MEDIÇÕES
+// ================================
+
+// Silencia std::cerr durante as medições (coletores reportam erros por chamada)
+class CerrSilencer {
+private:
+    ofstream null_stream;
+    streambuf* saved;
+public:
+    CerrSilencer() : null_stream("/dev/null"), saved(cerr.rdbuf(null_stream.rdbuf())) {}
+    ~CerrSilencer() { cerr.rdbuf(saved); }
+};
+
+struct CollectorCase {
+    string name;
+    function<void()> call;
+};
+
+struct CollectorReport {
+    string name;
+    string target;
+    double ns_per_call;
+    double ci95;
+    double p99;
+    double allocs_per_call;
+    double syscalls_per_call;  // -1 se indisponível
+    vector<double> calls_per_sec;  // Uma entrada por contagem de threads
+};
+
+// Calibra quantas chamadas cabem em ~10ms (lote de medição)
+int calibrate_batch(const function<void()>& call) {
+    auto start = steady_clock::now();
+    call();
+    double one_ns = duration<double, nano>(steady_clock::now() - start).count();
+    if (one_ns <= 0) one_ns = 1;
+    long batch = static_cast<long>(10e6 / one_ns);
+    if (batch < 1) batch = 1;
+    if (batch > 10000) batch = 10000;
+    return static_cast<int>(batch);
+}
+
+// Chamadas/s somadas de 'threads' threads chamando o coletor por 'seconds'
+double measure_throughput(const function<void()>& call, int threads, double seconds) {
+    atomic<bool> go{false};
+    atomic<bool> stop{false};
+    vector<uint64_t> counts(threads, 0);
+    vector<thread> workers;
+
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            while (!go) this_thread::yield();
+            uint64_t n = 0;
+            while (!stop) {
+                call();
+                n++;
+            }
+            counts[t] = n;
+        });
+    }
+
+    auto start = steady_clock::now();
+    go = true;
+    this_thread::sleep_for(duration<double>(seconds));
+    stop = true;
+    for (auto& w : workers) w.join();
+    double elapsed = duration<double>(steady_clock::now() - start).count();
+
+    uint64_t total = 0;
+    for (uint64_t c : counts) total += c;
+    return total / elapsed;
+}
+
+CollectorReport bench_collector(BenchHarness& harness, PerfCounterSet& counters, const CollectorCase& c,
+                                const string& target, const vector<int>& thread_counts, double scaling_seconds) {
+    CollectorReport rep;
+    rep.name = c.name;
+    rep.target = target;
+
+    CerrSilencer silence;
+    int batch = calibrate_batch(c.call);
+
+    // ns/chamada: cada repetição do harness executa um lote inteiro
+    BenchResult stats = harness.run(c.name + "@" + target, [&]() {
+        auto start = steady_clock::now();
+        for (int i = 0; i < batch; i++) c.call();
+        return duration<double, nano>(steady_clock::now() - start).count() / batch;
+    }, "ns");
+    rep.ns_per_call = stats.median;
+    rep.ci95 = stats.ci95;
+    rep.p99 = stats.p99;
+
+    // Alocações e syscalls: um lote à parte, fora da medição de tempo
+    uint64_t allocs_before = tl_allocations;
+    uint64_t sys_before = counters.read_syscalls();
+    for (int i = 0; i < batch; i++) c.call();
+    uint64_t sys_after = counters.read_syscalls();
+    rep.allocs_per_call = static_cast<double>(tl_allocations - allocs_before) / batch;
+    rep.syscalls_per_call = counters.has_syscalls()
+        ? static_cast<double>(sys_after - sys_before - 1) / batch : -1;
+
+    for (int threads : thread_counts) {
+        rep.calls_per_sec.push_back(measure_throughput(c.call, threads, scaling_seconds));
+    }
+    return rep;
+}
+
+// Coletores aplicados a um PID
+vector<CollectorCase> pid_collectors(int pid) {
+    return {
+        {"get_cpu_usage", [pid]() { ProcStats s; get_cpu_usage(pid, s); }},
+        {"get_memory_usage", [pid]() { ProcStats s; get_memory_usage(pid, s); }},
+        // Como no profile: MemTotal vem do snapshot do host, lido uma vez por ciclo
+        {"get_memory_usage(MemTotal do ciclo)", [pid]() {
+            static const long mem_total_kb = [] {
+                SystemMemoryStat host;
+                return host.sample() ? static_cast<long>(host.current().total_kb) : 0L;
+            }();
+            ProcStats s;
+            get_memory_usage(pid, s, mem_total_kb);
+        }},
+        {"get_io_usage", [pid]() { ProcStats s; get_io_usage(pid, s); }},
+        {"get_smaps_rollup", [pid]() { SmapsStats s; get_smaps_rollup(pid, s); }},
+        {"get_process_numa", [pid]() {
+            static const vector<int> cpu_nodes = numa_cpu_nodes(read_numa_nodes());
+            ProcessNuma numa;
+            get_process_numa(pid, cpu_nodes, numa);
+        }},
+        {"get_network_usage(sistema)", []() { ProcStats s; get_network_usage(s); }},
+        {"get_network_usage(pid)", [pid]() { ProcStats s = {}; get_network_usage(pid, s); }},
+        {"list_process_namespaces", [pid]() { auto ns = list_process_namespaces(pid); (void)ns; }},
+        {"ProcessMetaCache::get(frio)", [pid]() {
+            // Cache por thread esvaziado a cada chamada: custo sem acerto
+            thread_local ProcessMetaCache cache;
+            cache.forget(pid);
+            cache.get(pid);
+        }},
+        {"ThreadTable::sample", [pid]() {
+            // Uma tabela por thread e por PID: os fds ficam abertos entre chamadas
+            thread_local map<int, unique_ptr<ThreadTable>> tables;
+            auto& table = tables[pid];
+            if (!table) table = make_unique<ThreadTable>(pid);
+            table->sample();
+        }},
+    };
+}
+
+// Métodos read_* do CGroupManager sobre um cgroup
+vector<CollectorCase> cgroup_collectors(CGroupManager& mgr, const string& cg) {
+    return {
+        {"CGroupManager::read_cpu_usage", [&mgr, cg]() { mgr.read_cpu_usage(cg); }},
+        {"CGroupManager::read_memory_usage", [&mgr, cg]() { mgr.read_memory_usage(cg); }},
+        {"CGroupManager::read_pids_current", [&mgr, cg]() { mgr.read_pids_current(cg); }},
+        {"CGroupManager::read_pids_max", [&mgr, cg]() { mgr.read_pids_max(cg); }},
+        {"CGroupManager::read_cpu_pressure", [&mgr, cg]() { mgr.read_cpu_pressure(cg); }},
+        {"CGroupManager::read_memory_pressure", [&mgr, cg]() { mgr.read_memory_pressure(cg); }},
+        {"CGroupManager::read_io_pressure", [&mgr, cg]() { mgr.read_io_pressure(cg); }},
+        {"CGroupManager::read_cgroup_stats", [&mgr, cg]() { mgr.read_cgroup_stats(cg); }},
+    };
+}
+
+// Ciclo do profile (stat + status + io de cada alvo) por número de alvos
+struct TargetsReport {
+    int targets;
+    double sync_ms, pread_ms, uring_ms;
+    double sync_sys, pread_sys, uring_sys;  // syscalls/ciclo (-1 se indisponível)
+    bool uring;
+};
+
+TargetsReport bench_targets(BenchHarness& harness, PerfCounterSet& counters, const vector<int>& pids) {
+    TargetsReport rep = {};
+    rep.targets = static_cast<int>(pids.size());
+    SystemMemoryStat host;
+    long mem_total_kb = host.sample() ? static_cast<long>(host.current().total_kb) : 0L;
+    string suffix = "@" + to_string(pids.size()) + "alvos";
+    CerrSilencer silence;
+
+    // Mede um ciclo e as syscalls de um ciclo à parte
+    auto measure = [&](const string& name, const function<void()>& tick, double& ms, double& sys) {
+        tick();  // Abre os fds persistentes fora da medição
+        ms = harness.run(name + suffix, [&]() {
+            auto start = steady_clock::now();
+            tick();
+            return duration<double, milli>(steady_clock::now() - start).count();
+        }, "ms").median;
+        uint64_t before = counters.read_syscalls();
+        tick();
+        sys = counters.has_syscalls() ? static_cast<double>(counters.read_syscalls() - before - 1) : -1;
+    };
+
+    measure("ciclo get_*_usage", [&]() {
+        for (int pid : pids) {
+            ProcStats s;
+            get_cpu_usage(pid, s);
+            get_memory_usage(pid, s, mem_total_kb);
+            get_io_usage(pid, s);
+        }
+    }, rep.sync_ms, rep.sync_sys);
+
+    vector<ProcStats> stats;
+    vector<int> results;
+    ProcBatch by_pread(false);
+    measure("ciclo ProcBatch(pread)", [&]() { by_pread.sample(pids, mem_total_kb, stats, results); },
+            rep.pread_ms, rep.pread_sys);
+
+    ProcBatch by_uring(true);
+    rep.uring = by_uring.uring();
+    if (rep.uring) {
+        measure("ciclo ProcBatch(io_uring)", [&]() { by_uring.sample(pids, mem_total_kb, stats, results); },
+                rep.uring_ms, rep.uring_sys);
+    }
+    return rep;
+}
+
+void print_targets(const vector<TargetsReport>& reports) {
+    auto sys = [](double v) { return v >= 0 ? to_string(llround(v)) : string("N/A"); };
+    cout << "\nCiclo do profile por número de alvos (stat + status + io; ms/ciclo, syscalls/ciclo):" << endl;
+    cout << right << setw(8) << "Alvos"
+         << setw(14) << "get_*_usage" << setw(10) << "sys"
+         << setw(14) << "pread" << setw(10) << "sys"
+         << setw(14) << "io_uring" << setw(10) << "sys" << endl;
+    cout << string(80, '-') << endl;
+    for (const auto& r : reports) {
+        cout << setw(8) << r.targets << fixed << setprecision(2)
+             << setw(14) << r.sync_ms << setw(10) << sys(r.sync_sys)
+             << setw(14) << r.pread_ms << setw(10) << sys(r.pread_sys);
+        if (r.uring) {
+            cout << setw(14) << r.uring_ms << setw(10) << sys(r.uring_sys) << endl;
+        } else {
+            cout << setw(14) << "N/A" << setw(10) << "N/A" << endl;
+        }
+    }
+}
+
+void print_reports(const vector<CollectorReport>& reports, const vector<int>& thread_counts) {
+    cout << "\n" << left << setw(38) << "Coletor"
+         << setw(10) << "Alvo"
+         << right << setw(14) << "ns/chamada"
+         << setw(12) << "+- IC95"
+         << setw(14) << "p99 (ns)"
+         << setw(12) << "allocs/ch"
+         << setw(12) << "syscalls/ch" << endl;
+    cout << string(112, '-') << endl;
+    for (const auto& r : reports) {
+        cout << left << setw(38) << r.name
+             << setw(10) << r.target
+             << right << setw(14) << fixed << setprecision(0) << r.ns_per_call
+             << setw(12) << r.ci95
+             << setw(14) << r.p99
+             << setw(12) << setprecision(1) << r.allocs_per_call;
+        if (r.syscalls_per_call >= 0) {
+            cout << setw(12) << setprecision(1) << r.syscalls_per_call << endl;
+        } else {
+            cout << setw(12) << "N/A" << endl;
+        }
+    }
+    cout << string(112, '-') << endl;
+
+    cout << "\nEscalabilidade (chamadas/s somadas entre threads):" << endl;
+    cout << left << setw(38) << "Coletor" << setw(10) << "Alvo" << right;
+    for (int t : thread_counts) {
+        cout << setw(14) << (to_string(t) + " thr");
+    }
+    cout << endl;
+    cout << string(48 + 14 * thread_counts.size(), '-') << endl;
+    for (const auto& r : reports) {
+        cout << left << setw(38) << r.name << setw(10) << r.target << right;
+        for (double cps : r.calls_per_sec) {
+            cout << setw(14) << fixed << setprecision(0) << cps;
+        }
+        cout << endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int pid = -1;
+    string snapshot_root;
+    int sockets = 256;
+    int ns_procs = 32;
+    int max_threads = static_cast<int>(thread::hardware_concurrency());
+    bool use_fixture = true;
+    double scaling_seconds = 0.3;
+    vector<int> target_counts = {100, 1000, 5000};
+
+    for (int i = 1; i < argc; i++) {
+        string opt = argv[i];
+        if (opt == "--pid" && i + 1 < argc) pid = atoi(argv[++i]);
+        else if (opt == "--sockets" && i + 1 < argc) sockets = atoi(argv[++i]);
+        else if (opt == "--ns-procs" && i + 1 < argc) ns_procs = atoi(argv[++i]);
+        else if (opt == "--threads" && i + 1 < argc) max_threads = atoi(argv[++i]);
+        else if (opt == "--no-fixture") use_fixture = false;
+        else if (opt == "--root" && i + 1 < argc) snapshot_root = argv[++i];
+        else if (opt == "--targets" && i + 1 < argc) {
+            target_counts.clear();
+            stringstream list(argv[++i]);
+            string item;
+            while (getline(list, item, ',')) {
+                if (atoi(item.c_str()) > 0) target_counts.push_back(atoi(item.c_str()));
+            }
+        }
+    }
+
+    // Snapshot: o fixture é um processo vivo, não existe dentro dele
+    string target = "real";
+    if (!snapshot_root.empty()) {
+        set_fs_root(snapshot_root);
+        use_fixture = false;
+        target = "snapshot";
+        if (pid < 0) pid = 1;
+    }
+    if (pid < 0) pid = getpid();
+    if (max_threads < 1) max_threads = 1;
+
+    // Contagens de threads: 1, 2, 4, ... até N (inclui N)
+    vector<int> thread_counts;
+    for (int t = 1; t < max_threads; t *= 2) thread_counts.push_back(t);
+    thread_counts.push_back(max_threads);
+
+    BenchConfig defaults;
+    defaults.warmup_runs = 2;
+    defaults.min_runs = 5;
+    defaults.max_runs = 30;
+    defaults.target_ci_percent = 3.0;
+    defaults.json_output = "bench_collectors.json";
+    BenchHarness harness("bench_collectors", bench_parse_args(argc, argv, defaults));
+
+    PerfCounterSet counters;
+    counters.open(0, true);
+
+    cout << "======================================================" << endl;
+    cout << "  MICROBENCHMARKS DOS COLETORES" << endl;
+    cout << "======================================================" << endl;
+    if (!snapshot_root.empty()) {
+        cout << "Snapshot: " << proc_root() << " e " << sys_root() << endl;
+    }
+    cout << "PID alvo: " << pid << endl;
+    cout << "Threads (escalabilidade): ";
+    for (int t : thread_counts) cout << t << " ";
+    cout << endl;
+    if (!counters.has_syscalls()) {
+        cout << "Syscalls/chamada indisponível (requer root ou perf_event_paranoid=-1)" << endl;
+    }
+
+    vector<CollectorReport> reports;
+
+    for (const auto& c : pid_collectors(pid)) {
+        cout << "  " << c.name << " (pid " << pid << ")..." << flush;
+        reports.push_back(bench_collector(harness, counters, c, target, thread_counts, scaling_seconds));
+        cout << " OK" << endl;
+    }
+
+    // CGroup do próprio processo (leituras do Componente 3)
+    CGroupManager mgr;
+    string cg = CGroupManager::get_current_cgroup(pid);
+    if (!cg.empty() && mgr.exists_cgroup(cg)) {
+        for (const auto& c : cgroup_collectors(mgr, cg)) {
+            cout << "  " << c.name << " (" << cg << ")..." << flush;
+            reports.push_back(bench_collector(harness, counters, c, target, thread_counts, scaling_seconds));
+            cout << " OK" << endl;
+        }
+    } else {
+        cout << "  CGroup do processo não acessível em " << mgr.get_base_path() << cg
+             << " - métodos read_* ignorados" << endl;
+    }
+
+    // Ciclo do top sobre todos os PIDs (uma tabela por thread: fds persistentes)
+    CollectorCase table_case = {"ProcessTable::sample", []() {
+        thread_local ProcessTable table;
+        table.sample();
+    }};
+    cout << "  " << table_case.name << " (todos os PIDs)..." << flush;
+    reports.push_back(bench_collector(harness, counters, table_case, "system", thread_counts, scaling_seconds));
+    cout << " OK" << endl;
+
+    // Utilização por núcleo do sistema (um fd persistente por thread)
+    CollectorCase cpu_case = {"SystemCpuStat::sample", []() {
+        thread_local SystemCpuStat stat;
+        stat.sample();
+    }};
+    cout << "  " << cpu_case.name << " (todos os núcleos)..." << flush;
+    reports.push_back(bench_collector(harness, counters, cpu_case, "system", thread_counts, scaling_seconds));
+    cout << " OK" << endl;
+
+    // Memória do host (meminfo + vmstat, fds persistentes por thread)
+    CollectorCase mem_case = {"SystemMemoryStat::sample", []() {
+        thread_local SystemMemoryStat stat;
+        stat.sample();
+    }};
+    cout << "  " << mem_case.name << "..." << flush;
+    reports.push_back(bench_collector(harness, counters, mem_case, "system", thread_counts, scaling_seconds));
+    cout << " OK" << endl;
+
+    // Árvore de processos: uma listagem do /proc por ciclo (fds persistentes por thread)
+    CollectorCase tree_case = {"ProcessTree::sample", []() {
+        thread_local ProcessTree tree;
+        tree.sample();
+    }};
+    cout << "  " << tree_case.name << "..." << flush;
+    reports.push_back(bench_collector(harness, counters, tree_case, "system", thread_counts, scaling_seconds));
+    cout << " OK" << endl;
+
+    // Rede por namespace: um pread por namespace (varredura a cada 10 ciclos)
+    CollectorCase netns_case = {"NetnsStat::sample", []() {
+        thread_local NetnsStat netns;
+        netns.sample();
+    }};
+    cout << "  " << netns_case.name << "..." << flush;
+    reports.push_back(bench_collector(harness, counters, netns_case, "system", thread_counts, scaling_seconds));
+    cout << " OK" << endl;
+
+    // Dispositivos de bloco: um pread do /proc/diskstats por ciclo
+    CollectorCase disk_case = {"DiskStat::sample", []() {
+        thread_local DiskStat disks;
+        disks.sample();
+    }};
+    cout << "  " << disk_case.name << "..." << flush;
+    reports.push_back(bench_collector(harness, counters, disk_case, "system", thread_counts, scaling_seconds));
+    cout << " OK" << endl;
+
+    if (use_fixture) {
+        SyntheticFixture fx = start_fixture(sockets, ns_procs);
+        if (fx.pid > 0) {
+            cout << "\nFixture sintético: PID " << fx.pid << ", " << fx.sockets << " sockets TCP, "
+                 << fx.ns_procs << " processos em namespaces próprios" << endl;
+            for (const auto& c : pid_collectors(fx.pid)) {
+                cout << "  " << c.name << " (fixture)..." << flush;
+                reports.push_back(bench_collector(harness, counters, c, "fixture", thread_counts, scaling_seconds));
+                cout << " OK" << endl;
+            }
+
+            // Varredura do sistema: cresce com o número de processos/namespaces
+            auto self_ns = list_process_namespaces(getpid());
+            ino_t uts_inode = 0;
+            if (self_ns) {
+                for (const auto& ns : self_ns->namespaces) {
+                    if (ns.type == NamespaceType::UTS && ns.exists) uts_inode = ns.inode;
+                }
+            }
+            if (uts_inode != 0) {
+                CollectorCase scan = {"find_processes_in_namespace", [uts_inode]() {
+                    auto pids = find_processes_in_namespace(NamespaceType::UTS, uts_inode);
+                    (void)pids;
+                }};
+                cout << "  " << scan.name << " (fixture)..." << flush;
+                reports.push_back(bench_collector(harness, counters, scan, "fixture", thread_counts, scaling_seconds));
+                cout << " OK" << endl;
+            }
+            stop_fixture(fx);
+        } else {
+            cerr << "Não foi possível criar o fixture sintético" << endl;
+        }
+    }
+
+    // Ciclo do profile com N alvos (só no sistema vivo)
+    vector<TargetsReport> target_reports;
+    if (snapshot_root.empty()) {
+        for (int n : target_counts) {
+            vector<int> pids;
+            pid_t holder = start_sleepers(n, pids);
+            cout << "  ciclo do profile (" << pids.size() << " alvos)..." << flush;
+            if (holder > 0 && !pids.empty()) {
+                target_reports.push_back(bench_targets(harness, counters, pids));
+                cout << " OK" << endl;
+            } else {
+                cout << " sem processos" << endl;
+            }
+            if (holder > 0) {
+                kill(-holder, SIGKILL);
+                waitpid(holder, nullptr, 0);
+            }
+        }
+    }
+
+    print_reports(reports, thread_counts);
+    if (!target_reports.empty()) {
+        print_targets(target_reports);
+    }
+    harness.write_json();
+    return 0;
+}
@@ -0,0 +1,96 @@
+// ============================================================
+// ARQUIVO: tests/bench_compare.cpp
+// DESCRIÇÃO: Compara resultados do harness contra um baseline salvo
+//
+// USO:
+//   ./bin/bench_compare baseline.json atual.json [limiar_pct]
+//
+// Um benchmark é marcado como REGRESSAO quando a mediana piora mais que
+// o limiar (padrão 5%) E os intervalos de confiança 95% não se sobrepõem,
+// para não acusar regressão por simples ruído de medição.
+// Código de saída: 0 sem regressões, 1 com regressões, 2 em erro de leitura
+// ============================================================
+
+#include "bench_harness.hpp"
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cmath>
+#include <map>
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        cerr << "Uso: " << argv[0] << " baseline.json atual.json [limiar_pct]" << endl;
+        return 2;
+    }
+
+    double threshold_pct = argc > 3 ? atof(argv[3]) : 5.0;
+
+    string base_suite, curr_suite;
+    vector<BenchResult> baseline, current;
+    if (!bench_load_json(argv[1], base_suite, baseline)) {
+        cerr << "ERRO: Não foi possível ler baseline " << argv[1] << endl;
+        return 2;
+    }
+    if (!bench_load_json(argv[2], curr_suite, current)) {
+        cerr << "ERRO: Não foi possível ler resultados " << argv[2] << endl;
+        return 2;
+    }
+
+    map<string, BenchResult> base_by_name;
+    for (const auto& r : baseline) {
+        base_by_name[r.name] = r;
+    }
+
+    cout << "Comparando " << curr_suite << " contra baseline " << base_suite
+         << " (limiar " << threshold_pct << "%)\n" << endl;
+    cout << left << setw(32) << "Benchmark"
+         << right << setw(14) << "Baseline"
+         << setw(14) << "Atual"
+         << setw(12) << "Delta (%)"
+         << setw(14) << "Status" << endl;
+    cout << string(86, '-') << endl;
+
+    int regressions = 0;
+    for (const auto& curr : current) {
+        auto it = base_by_name.find(curr.name);
+        if (it == base_by_name.end()) {
+            cout << left << setw(32) << curr.name << right << setw(54) << "NOVO" << endl;
+            continue;
+        }
+        const BenchResult& base = it->second;
+
+        double delta_pct = base.median != 0 ? (curr.median - base.median) / base.median * 100.0 : 0.0;
+        // Piora é aumento para tempos e queda para throughput
+        double worse_pct = curr.higher_is_better ? -delta_pct : delta_pct;
+
+        // ICs disjuntos na direção da piora
+        bool ci_disjoint = curr.higher_is_better
+            ? (curr.mean + curr.ci95) < (base.mean - base.ci95)
+            : (curr.mean - curr.ci95) > (base.mean + base.ci95);
+
+        string status = "OK";
+        if (worse_pct > threshold_pct && ci_disjoint) {
+            status = "REGRESSAO";
+            regressions++;
+        } else if (-worse_pct > threshold_pct) {
+            status = "MELHORA";
+        }
+
+        cout << left << setw(32) << curr.name
+             << right << setw(14) << fixed << setprecision(2) << base.median
+             << setw(14) << curr.median
+             << setw(11) << showpos << delta_pct << noshowpos << "%"
+             << setw(14) << status << endl;
+    }
+
+    cout << string(86, '-') << endl;
+    if (regressions > 0) {
+        cout << regressions << " regressao(oes) detectada(s)" << endl;
+        return 1;
+    }
+    cout << "Nenhuma regressao detectada" << endl;
+    return 0;
+}
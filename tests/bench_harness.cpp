@@ -0,0 +1,396 @@
+// ============================================================
+// ARQUIVO: tests/bench_harness.cpp
+// DESCRIÇÃO: Implementação do harness de benchmark dos experimentos
+// ============================================================
+
+#include "bench_harness.hpp"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cmath>
+#include <cstring>
+#include <cstdlib>
+#include <ctime>
+#include <thread>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/utsname.h>
+
+// Resolução do histograma: medidas são gravadas em milésimos da unidade
+static constexpr double HISTOGRAM_SCALE = 1000.0;
+
+// Sub-buckets por potência de 2 (precisão do histograma)
+static constexpr int SUB_BUCKET_BITS = 6;
+static constexpr uint64_t SUB_BUCKET_COUNT = 1ULL << SUB_BUCKET_BITS;       // 64
+static constexpr uint64_t LINEAR_LIMIT = SUB_BUCKET_COUNT * 2;              // 128
+static constexpr size_t BUCKET_TOTAL = LINEAR_LIMIT + (64 - SUB_BUCKET_BITS - 1) * SUB_BUCKET_COUNT;
+
+// ================================
+// LatencyHistogram
+// ================================
+
+LatencyHistogram::LatencyHistogram() : counts(BUCKET_TOTAL, 0), total(0), min_value(UINT64_MAX), max_value(0) {}
+
+size_t LatencyHistogram::bucket_index(uint64_t value) {
+    if (value < LINEAR_LIMIT) {
+        return static_cast<size_t>(value);
+    }
+    // msb >= 7; mantissa fica com os 7 bits mais significativos (64..127)
+    int msb = 63 - __builtin_clzll(value);
+    int shift = msb - SUB_BUCKET_BITS;
+    uint64_t mantissa = value >> shift;
+    return LINEAR_LIMIT + static_cast<size_t>(shift - 1) * SUB_BUCKET_COUNT + (mantissa - SUB_BUCKET_COUNT);
+}
+
+uint64_t LatencyHistogram::bucket_lower_bound(size_t index) {
+    if (index < LINEAR_LIMIT) {
+        return index;
+    }
+    size_t rel = index - LINEAR_LIMIT;
+    int shift = static_cast<int>(rel / SUB_BUCKET_COUNT) + 1;
+    uint64_t mantissa = SUB_BUCKET_COUNT + rel % SUB_BUCKET_COUNT;
+    return mantissa << shift;
+}
+
+void LatencyHistogram::record(uint64_t value) {
+    counts[bucket_index(value)]++;
+    total++;
+    if (value < min_value) min_value = value;
+    if (value > max_value) max_value = value;
+}
+
+uint64_t LatencyHistogram::percentile(double p) const {
+    if (total == 0) return 0;
+    if (p <= 0) return min_value;
+    if (p >= 100) return max_value;
+
+    // Posição (1-based) da amostra no percentil pedido
+    uint64_t rank = static_cast<uint64_t>(std::ceil(p / 100.0 * total));
+    if (rank == 0) rank = 1;
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts.size(); i++) {
+        seen += counts[i];
+        if (seen >= rank) {
+            // Ponto médio do bucket, limitado aos extremos observados
+            uint64_t low = bucket_lower_bound(i);
+            uint64_t high = (i + 1 < counts.size()) ? bucket_lower_bound(i + 1) : low;
+            uint64_t mid = low + (high - low) / 2;
+            if (mid < min_value) mid = min_value;
+            if (mid > max_value) mid = max_value;
+            return mid;
+        }
+    }
+    return max_value;
+}
+
+uint64_t LatencyHistogram::count() const { return total; }
+uint64_t LatencyHistogram::min() const { return total ? min_value : 0; }
+uint64_t LatencyHistogram::max() const { return max_value; }
+
+void LatencyHistogram::reset() {
+    std::fill(counts.begin(), counts.end(), 0);
+    total = 0;
+    min_value = UINT64_MAX;
+    max_value = 0;
+}
+
+// ================================
+// Estatística auxiliar
+// ================================
+
+// Quantil bicaudal 95% da t de Student para df graus de liberdade
+static double student_t95(int df) {
+    static const double table[] = {
+        0, 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+    };
+    if (df <= 0) return 0;
+    if (df <= 30) return table[df];
+    if (df <= 40) return 2.021;
+    if (df <= 60) return 2.000;
+    if (df <= 120) return 1.980;
+    return 1.960;
+}
+
+// ================================
+// BenchHarness
+// ================================
+
+bool bench_pin_to_cpu(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+BenchHarness::BenchHarness(const std::string& suite_name, const BenchConfig& cfg)
+    : suite(suite_name), config(cfg) {
+    if (config.min_runs < 2) config.min_runs = 2;
+    if (config.max_runs < config.min_runs) config.max_runs = config.min_runs;
+
+    if (config.pin_cpu >= 0) {
+        if (bench_pin_to_cpu(config.pin_cpu)) {
+            std::cout << " Harness: fixado na CPU " << config.pin_cpu << std::endl;
+        } else {
+            std::cerr << " Harness: não foi possível fixar na CPU " << config.pin_cpu
+                      << " - " << strerror(errno) << std::endl;
+            config.pin_cpu = -1;
+        }
+    }
+}
+
+BenchResult BenchHarness::run(const std::string& name, const std::function<double()>& measure,
+                              const std::string& unit, bool higher_is_better) {
+    BenchResult r = {};
+    r.name = name;
+    r.unit = unit;
+    r.higher_is_better = higher_is_better;
+
+    // Aquecimento: resultados descartados
+    for (int i = 0; i < config.warmup_runs; i++) {
+        measure();
+    }
+
+    LatencyHistogram histogram;
+    double mean = 0.0, m2 = 0.0;
+    double min_v = 0.0, max_v = 0.0;
+    int n = 0;
+    int attempts = 0;
+
+    while (attempts < config.max_runs) {
+        attempts++;
+        double value = measure();
+        if (value < 0 || std::isnan(value)) {
+            continue;  // Repetição falhou
+        }
+
+        // Welford: média e variância em uma passada
+        n++;
+        double delta = value - mean;
+        mean += delta / n;
+        m2 += delta * (value - mean);
+        if (n == 1 || value < min_v) min_v = value;
+        if (n == 1 || value > max_v) max_v = value;
+        histogram.record(static_cast<uint64_t>(std::llround(value * HISTOGRAM_SCALE)));
+
+        if (n >= config.min_runs) {
+            double stddev = std::sqrt(m2 / (n - 1));
+            double ci = student_t95(n - 1) * stddev / std::sqrt(static_cast<double>(n));
+            if (mean != 0 && std::fabs(ci / mean) * 100.0 <= config.target_ci_percent) {
+                r.converged = true;
+                break;
+            }
+        }
+    }
+
+    r.runs = n;
+    r.mean = mean;
+    r.stddev = n > 1 ? std::sqrt(m2 / (n - 1)) : 0.0;
+    r.ci95 = n > 1 ? student_t95(n - 1) * r.stddev / std::sqrt(static_cast<double>(n)) : 0.0;
+    r.min = min_v;
+    r.max = max_v;
+    r.median = histogram.percentile(50) / HISTOGRAM_SCALE;
+    r.p90 = histogram.percentile(90) / HISTOGRAM_SCALE;
+    r.p99 = histogram.percentile(99) / HISTOGRAM_SCALE;
+
+    results.push_back(r);
+    return results.back();
+}
+
+const std::vector<BenchResult>& BenchHarness::get_results() const {
+    return results;
+}
+
+const BenchConfig& BenchHarness::get_config() const {
+    return config;
+}
+
+void BenchHarness::print_summary() const {
+    std::cout << "\nHarness: " << suite << " (warmup " << config.warmup_runs
+              << ", " << config.min_runs << "-" << config.max_runs << " repeticoes, IC alvo "
+              << config.target_ci_percent << "%)" << std::endl;
+    std::cout << std::left << std::setw(32) << "Benchmark"
+              << std::right << std::setw(6) << "N"
+              << std::setw(22) << "Media +- IC95"
+              << std::setw(12) << "Mediana"
+              << std::setw(12) << "p90"
+              << std::setw(12) << "p99"
+              << std::setw(8) << "Unid" << std::endl;
+    std::cout << std::string(104, '-') << std::endl;
+
+    for (const auto& r : results) {
+        std::ostringstream mean_ci;
+        mean_ci << std::fixed << std::setprecision(2) << r.mean << " +- " << r.ci95;
+        std::cout << std::left << std::setw(32) << r.name
+                  << std::right << std::setw(5) << r.runs << (r.converged ? " " : "*")
+                  << std::setw(22) << mean_ci.str()
+                  << std::setw(12) << std::fixed << std::setprecision(2) << r.median
+                  << std::setw(12) << r.p90
+                  << std::setw(12) << r.p99
+                  << std::setw(8) << r.unit << std::endl;
+    }
+    std::cout << std::string(104, '-') << std::endl;
+    std::cout << "* IC nao convergiu antes do maximo de repeticoes" << std::endl;
+}
+
+// Escapa aspas e barras para strings JSON
+static std::string json_escape(const std::string& s) {
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+bool BenchHarness::write_json(const std::string& filename) const {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << " Erro: Não foi possível criar arquivo JSON: " << filename << std::endl;
+        return false;
+    }
+
+    struct utsname uts;
+    std::string kernel = (uname(&uts) == 0) ? uts.release : "";
+    char host[256] = {0};
+    gethostname(host, sizeof(host) - 1);
+
+    file << "{\n";
+    file << "  \"suite\": \"" << json_escape(suite) << "\",\n";
+    file << "  \"timestamp\": " << static_cast<long long>(std::time(nullptr)) << ",\n";
+    file << "  \"host\": \"" << json_escape(host) << "\",\n";
+    file << "  \"kernel\": \"" << json_escape(kernel) << "\",\n";
+    file << "  \"cpus\": " << std::thread::hardware_concurrency() << ",\n";
+    file << "  \"pin_cpu\": " << config.pin_cpu << ",\n";
+    file << "  \"benchmarks\": [\n";
+
+    file << std::setprecision(6);
+    for (size_t i = 0; i < results.size(); i++) {
+        const auto& r = results[i];
+        file << "    {"
+             << "\"name\": \"" << json_escape(r.name) << "\", "
+             << "\"unit\": \"" << json_escape(r.unit) << "\", "
+             << "\"higher_is_better\": " << (r.higher_is_better ? "true" : "false") << ", "
+             << "\"runs\": " << r.runs << ", "
+             << "\"converged\": " << (r.converged ? "true" : "false") << ", "
+             << "\"mean\": " << r.mean << ", "
+             << "\"stddev\": " << r.stddev << ", "
+             << "\"ci95\": " << r.ci95 << ", "
+             << "\"min\": " << r.min << ", "
+             << "\"median\": " << r.median << ", "
+             << "\"p90\": " << r.p90 << ", "
+             << "\"p99\": " << r.p99 << ", "
+             << "\"max\": " << r.max << "}"
+             << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+
+    file << "  ]\n}\n";
+    file.close();
+    std::cout << " Resultados do harness salvos em: " << filename << std::endl;
+    return true;
+}
+
+bool BenchHarness::write_json() const {
+    if (config.json_output.empty()) {
+        return false;
+    }
+    return write_json(config.json_output);
+}
+
+BenchConfig bench_parse_args(int argc, char* argv[], const BenchConfig& defaults) {
+    BenchConfig cfg = defaults;
+    for (int i = 1; i + 1 < argc; i++) {
+        std::string opt = argv[i];
+        const char* value = argv[i + 1];
+        if (opt == "--json") { cfg.json_output = value; i++; }
+        else if (opt == "--warmup") { cfg.warmup_runs = std::atoi(value); i++; }
+        else if (opt == "--min-runs") { cfg.min_runs = std::atoi(value); i++; }
+        else if (opt == "--max-runs") { cfg.max_runs = std::atoi(value); i++; }
+        else if (opt == "--ci") { cfg.target_ci_percent = std::atof(value); i++; }
+        else if (opt == "--pin-cpu") { cfg.pin_cpu = std::atoi(value); i++; }
+    }
+    return cfg;
+}
+
+// ================================
+// Leitura do JSON (formato gravado por write_json)
+// ================================
+
+// Extrai o valor bruto (string sem aspas, número ou literal) de "key": valor
+static bool json_field(const std::string& obj, const std::string& key, std::string& value) {
+    std::string pattern = "\"" + key + "\":";
+    size_t pos = obj.find(pattern);
+    if (pos == std::string::npos) return false;
+    pos += pattern.size();
+    while (pos < obj.size() && obj[pos] == ' ') pos++;
+    if (pos >= obj.size()) return false;
+
+    if (obj[pos] == '"') {
+        std::string out;
+        for (size_t i = pos + 1; i < obj.size() && obj[i] != '"'; i++) {
+            if (obj[i] == '\\' && i + 1 < obj.size()) i++;
+            out += obj[i];
+        }
+        value = out;
+        return true;
+    }
+
+    size_t end = obj.find_first_of(",}", pos);
+    value = obj.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+    while (!value.empty() && (value.back() == ' ' || value.back() == '\n')) value.pop_back();
+    return true;
+}
+
+static double json_number(const std::string& obj, const std::string& key) {
+    std::string value;
+    return json_field(obj, key, value) ? std::atof(value.c_str()) : 0.0;
+}
+
+bool bench_load_json(const std::string& filename, std::string& suite, std::vector<BenchResult>& results) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    std::string doc = buffer.str();
+
+    size_t bench_pos = doc.find("\"benchmarks\"");
+    if (bench_pos == std::string::npos) {
+        return false;
+    }
+    json_field(doc.substr(0, bench_pos), "suite", suite);
+
+    // Cada benchmark é um objeto plano {...} dentro do array
+    size_t pos = doc.find('[', bench_pos);
+    while (pos != std::string::npos) {
+        size_t open = doc.find('{', pos);
+        if (open == std::string::npos) break;
+        size_t close = doc.find('}', open);
+        if (close == std::string::npos) break;
+        std::string obj = doc.substr(open, close - open + 1);
+
+        BenchResult r = {};
+        std::string flag;
+        json_field(obj, "name", r.name);
+        json_field(obj, "unit", r.unit);
+        r.higher_is_better = json_field(obj, "higher_is_better", flag) && flag == "true";
+        r.converged = json_field(obj, "converged", flag) && flag == "true";
+        r.runs = static_cast<int>(json_number(obj, "runs"));
+        r.mean = json_number(obj, "mean");
+        r.stddev = json_number(obj, "stddev");
+        r.ci95 = json_number(obj, "ci95");
+        r.min = json_number(obj, "min");
+        r.median = json_number(obj, "median");
+        r.p90 = json_number(obj, "p90");
+        r.p99 = json_number(obj, "p99");
+        r.max = json_number(obj, "max");
+        results.push_back(r);
+
+        pos = close + 1;
+    }
+    return true;
+}
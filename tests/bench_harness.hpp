@@ -0,0 +1,149 @@
+// ============================================================
+// ARQUIVO: tests/bench_harness.hpp
+// DESCRIÇÃO: Harness de benchmark compartilhado pelos experimentos 1-5
+// Fornece aquecimento (warmup), repetições até o intervalo de confiança
+// convergir, percentis (mediana/p90/p99) via histograma estilo HDR,
+// fixação de CPU e saída JSON legível por máquina, comparável contra
+// um baseline com bin/bench_compare
+// ============================================================
+
+#ifndef BENCH_HARNESS_HPP
+#define BENCH_HARNESS_HPP
+
+#include <cstdint>      // Para uint64_t
+#include <string>       // Para std::string
+#include <vector>       // Para std::vector
+#include <functional>   // Para std::function
+
+// BenchConfig: parâmetros de execução do harness
+struct BenchConfig {
+    // Execuções descartadas antes da medição (aquece cache, page cache, CPU freq)
+    int warmup_runs = 2;
+
+    // Mínimo de repetições medidas antes de testar convergência
+    int min_runs = 5;
+
+    // Máximo de repetições (para mesmo sem convergir)
+    int max_runs = 30;
+
+    // Convergência: semi-amplitude do IC 95% relativa à média (em %)
+    double target_ci_percent = 2.0;
+
+    // CPU para fixar a thread de medição (-1 = sem fixação)
+    int pin_cpu = -1;
+
+    // Arquivo JSON de saída (vazio = não grava)
+    std::string json_output;
+};
+
+// BenchResult: estatísticas de um benchmark
+struct BenchResult {
+    // Identificação do benchmark (única dentro da suíte)
+    std::string name;
+
+    // Unidade das medidas (ex: "ms", "us", "ops/s")
+    std::string unit;
+
+    // True se maior é melhor (throughput); false para tempos
+    bool higher_is_better;
+
+    // Repetições medidas e se o IC convergiu antes de max_runs
+    int runs;
+    bool converged;
+
+    // Estatísticas de momento (Welford)
+    double mean;
+    double stddev;
+
+    // Semi-amplitude do IC 95% da média (t de Student)
+    double ci95;
+
+    // Extremos e percentis do histograma
+    double min;
+    double median;
+    double p90;
+    double p99;
+    double max;
+};
+
+// LatencyHistogram: histograma log-linear no estilo HDR
+// Valores até 127 têm bucket exato; acima disso, cada potência de 2 é
+// dividida em 64 sub-buckets (erro relativo < 1.6%) com memória constante
+class LatencyHistogram {
+private:
+    std::vector<uint64_t> counts;
+    uint64_t total;
+    uint64_t min_value;
+    uint64_t max_value;
+
+    static size_t bucket_index(uint64_t value);
+    static uint64_t bucket_lower_bound(size_t index);
+
+public:
+    LatencyHistogram();
+
+    // Registra um valor (inteiro, na resolução escolhida pelo chamador)
+    void record(uint64_t value);
+
+    // Valor no percentil p (0-100); 0 se vazio
+    uint64_t percentile(double p) const;
+
+    uint64_t count() const;
+    uint64_t min() const;
+    uint64_t max() const;
+    void reset();
+};
+
+class BenchHarness {
+private:
+    std::string suite;
+    BenchConfig config;
+    std::vector<BenchResult> results;
+
+public:
+    // Cria o harness de uma suíte (ex: "experimento1") e aplica a fixação de CPU
+    BenchHarness(const std::string& suite_name, const BenchConfig& cfg);
+
+    // Executa um benchmark: warmup + repetições até convergir
+    // Parâmetros:
+    //   name: identificador do benchmark
+    //   measure: executa UMA repetição e retorna a medida
+    //            (valores negativos são tratados como falha e descartados)
+    //   unit: unidade da medida
+    //   higher_is_better: true para throughput
+    // Retorno: cópia das estatísticas do benchmark (também guardadas para
+    // o JSON; uma referência ao vetor interno não sobreviveria ao próximo run)
+    BenchResult run(const std::string& name, const std::function<double()>& measure,
+                    const std::string& unit = "ms", bool higher_is_better = false);
+
+    // Resultados acumulados
+    const std::vector<BenchResult>& get_results() const;
+
+    // Configuração efetiva
+    const BenchConfig& get_config() const;
+
+    // Imprime tabela com média ± IC, mediana, p90 e p99
+    void print_summary() const;
+
+    // Grava todos os resultados em JSON
+    // Retorno: true se o arquivo foi escrito
+    bool write_json(const std::string& filename) const;
+
+    // Grava no arquivo de config.json_output, se configurado
+    bool write_json() const;
+};
+
+// Fixa a thread chamadora em uma CPU (sched_setaffinity)
+// Retorno: true se sucesso
+bool bench_pin_to_cpu(int cpu);
+
+// Lê opções comuns da linha de comando dos experimentos:
+//   --json ARQ  --warmup N  --min-runs N  --max-runs N  --ci PCT  --pin-cpu N
+// Opções desconhecidas são ignoradas (ficam para o experimento)
+BenchConfig bench_parse_args(int argc, char* argv[], const BenchConfig& defaults);
+
+// Carrega resultados de um JSON gravado por write_json()
+// Retorno: false se o arquivo não pôde ser lido/interpretado
+bool bench_load_json(const std::string& filename, std::string& suite, std::vector<BenchResult>& results);
+
+#endif
@@ -1,4 +1,6 @@
 #include "../include/monitor.hpp"
+#include "perf_counters.hpp"
+#include "bench_harness.hpp"
 #include <iostream>
 #include <fstream>
 #include <vector>
@@ -22,117 +24,181 @@ using namespace chrono;
 // - Baseline: fork() + workload no filho + waitpid() SEM monitoramento
 // - Com monitoramento: fork() + workload no filho + coleta de métricas no pai + waitpid()
 // - Comparação justa: ambos usam fork/waitpid, diferença é apenas o monitoramento
+// - Contadores de software do perf_event (task-clock, context-switches,
+//   cpu-migrations, page-faults) anexados ao worker e à thread do profiler,
+//   para atribuir o overhead sem depender de PMU de hardware (funciona em VMs)
+// - Syscalls do profiler por amostra via tracepoint raw_syscalls:sys_enter
+// - Cada configuração passa pelo harness (warmup + repetições até o IC 95%
+//   convergir); o tempo reportado é a mediana e os contadores vêm da última repetição
 
 struct BenchmarkResult {
     string test_name;
     double execution_time_ms;
     double cpu_overhead_percent;
-    int sampling_latency_us;
+    double sampling_latency_us;
     int iterations_completed;
+    int samples;
+
+    // Contadores do processo worker (workload)
+    PerfCounterValues worker;
+
+    // Contadores da thread do profiler (somente com monitoramento)
+    PerfCounterValues profiler;
+
+    // Syscalls do profiler por amostra (-1 se tracepoint indisponível)
+    double syscalls_per_sample;
 };
 
 // Workload de referência: cálculo intensivo de CPU
 void cpu_intensive_workload(int iterations) {
     volatile double result = 0.0;
     for (int i = 0; i < iterations; i++) {
-        result += sqrt(i) * sin(i) * cos(i);
+        result = result + sqrt(i) * sin(i) * cos(i);
     }
 }
 
+// Cria o worker bloqueado em um pipe, para que os contadores do perf
+// sejam anexados antes de o workload começar a executar
+pid_t fork_gated_worker(int workload_iterations, int& gate_fd) {
+    int gate[2];
+    if (pipe(gate) == -1) {
+        return -1;
+    }
+
+    pid_t worker_pid = fork();
+    if (worker_pid == 0) {
+        // Processo filho: espera a liberação do pai e executa o workload
+        close(gate[1]);
+        char go;
+        ssize_t n = read(gate[0], &go, 1);
+        (void)n;
+        close(gate[0]);
+        cpu_intensive_workload(workload_iterations);
+        _exit(0);
+    }
+
+    close(gate[0]);
+    gate_fd = gate[1];
+    return worker_pid;
+}
+
+// Libera o worker bloqueado em fork_gated_worker
+void release_worker(int gate_fd) {
+    ssize_t n = write(gate_fd, "g", 1);
+    (void)n;
+    close(gate_fd);
+}
+
 // Executa workload SEM monitoramento (mas com fork para comparação justa)
 BenchmarkResult run_without_monitoring(int workload_iterations) {
-    BenchmarkResult result;
+    BenchmarkResult result = {};
     result.test_name = "SEM_MONITORAMENTO";
-    result.cpu_overhead_percent = 0.0;
-    result.sampling_latency_us = 0;
     result.iterations_completed = workload_iterations;
+    result.syscalls_per_sample = -1;
 
-    auto start = high_resolution_clock::now();  // MEDIR ANTES DO FORK
+    int gate_fd = -1;
+    pid_t worker_pid = fork_gated_worker(workload_iterations, gate_fd);
+    if (worker_pid <= 0) {
+        return result;
+    }
 
-    pid_t worker_pid = fork();
+    PerfCounterSet worker_counters;
+    worker_counters.open(worker_pid, false);
 
-    if (worker_pid == 0) {
-        // Processo filho: executa o workload
-        cpu_intensive_workload(workload_iterations);
-        _exit(0);
-    } else if (worker_pid > 0) {
-        // Processo pai: apenas espera (SEM monitorar)
-        waitpid(worker_pid, nullptr, 0);
+    auto start = high_resolution_clock::now();
+    release_worker(gate_fd);
 
-        auto end = high_resolution_clock::now();
-        result.execution_time_ms = duration<double, milli>(end - start).count();
-    }
+    // Processo pai: apenas espera (SEM monitorar)
+    waitpid(worker_pid, nullptr, 0);
+
+    auto end = high_resolution_clock::now();
+    result.execution_time_ms = duration<double, milli>(end - start).count();
+    result.worker = worker_counters.read();
 
     return result;
 }
 
 // Executa workload COM monitoramento usando o Resource Profiler
 BenchmarkResult run_with_monitoring(int workload_iterations, int sampling_interval_ms) {
-    BenchmarkResult result;
+    BenchmarkResult result = {};
     result.test_name = "COM_MONITORAMENTO_" + to_string(sampling_interval_ms) + "ms";
     result.iterations_completed = workload_iterations;
+    result.syscalls_per_sample = -1;
 
-    pid_t worker_pid = fork();
+    int gate_fd = -1;
+    pid_t worker_pid = fork_gated_worker(workload_iterations, gate_fd);
+    if (worker_pid <= 0) {
+        return result;
+    }
 
-    if (worker_pid == 0) {
-        // Processo filho: executa o workload
-        cpu_intensive_workload(workload_iterations);
-        _exit(0);
-    } else if (worker_pid > 0) {
-        // Processo pai: monitora usando o Resource Profiler
-        auto start = high_resolution_clock::now();
+    // Contadores do worker e da própria thread do profiler (tid 0 = chamadora)
+    PerfCounterSet worker_counters;
+    worker_counters.open(worker_pid, false);
+    PerfCounterSet profiler_counters;
+    profiler_counters.open(0, true);
+    PerfCounterValues profiler_before = profiler_counters.read();
 
-        ProcStats prev_stats, curr_stats;
-        vector<int> sampling_latencies;
-        int sample_count = 0;
+    // Processo pai: monitora usando o Resource Profiler
+    auto start = high_resolution_clock::now();
+    release_worker(gate_fd);
 
-        // Coleta inicial de métricas usando o Componente 1
-        get_cpu_usage(worker_pid, prev_stats);
-        get_memory_usage(worker_pid, prev_stats);
-        get_io_usage(worker_pid, prev_stats);
+    ProcStats prev_stats, curr_stats;
+    double latency_sum_us = 0.0;
+    uint64_t sampling_syscalls = 0;
+    int sample_count = 0;
 
-        while (true) {
-            this_thread::sleep_for(milliseconds(sampling_interval_ms));
+    // Coleta inicial de métricas usando o Componente 1
+    get_cpu_usage(worker_pid, prev_stats);
+    get_memory_usage(worker_pid, prev_stats);
+    get_io_usage(worker_pid, prev_stats);
 
-            auto sample_start = high_resolution_clock::now();
+    while (true) {
+        this_thread::sleep_for(milliseconds(sampling_interval_ms));
 
-            // Coleta métricas de CPU, memória e I/O do processo filho
-            int status = get_cpu_usage(worker_pid, curr_stats);
-            if (status != 0) break; // processo terminou
+        uint64_t syscalls_before = profiler_counters.read_syscalls();
+        auto sample_start = high_resolution_clock::now();
 
-            get_memory_usage(worker_pid, curr_stats);
-            get_io_usage(worker_pid, curr_stats);
+        // Coleta métricas de CPU, memória e I/O do processo filho
+        int status = get_cpu_usage(worker_pid, curr_stats);
+        if (status != 0) break; // processo terminou
 
-            auto sample_end = high_resolution_clock::now();
-            int latency = duration_cast<microseconds>(sample_end - sample_start).count();
-            sampling_latencies.push_back(latency);
+        get_memory_usage(worker_pid, curr_stats);
+        get_io_usage(worker_pid, curr_stats);
 
-            prev_stats = curr_stats;
-            sample_count++;
+        auto sample_end = high_resolution_clock::now();
+        uint64_t syscalls_after = profiler_counters.read_syscalls();
 
-            // Verifica se processo filho terminou
-            int child_status;
-            if (waitpid(worker_pid, &child_status, WNOHANG) > 0) {
-                break;
-            }
+        // A leitura final do contador conta a própria syscall read: descontada
+        if (syscalls_after > syscalls_before) {
+            sampling_syscalls += syscalls_after - syscalls_before - 1;
         }
+        latency_sum_us += duration<double, micro>(sample_end - sample_start).count();
 
-        // Espera filho terminar
-        waitpid(worker_pid, nullptr, 0);
-
-        auto end = high_resolution_clock::now();
-        result.execution_time_ms = duration<double, milli>(end - start).count();
+        prev_stats = curr_stats;
+        sample_count++;
 
-        // Calcula latência média de sampling
-        if (!sampling_latencies.empty()) {
-            int sum = 0;
-            for (int lat : sampling_latencies) sum += lat;
-            result.sampling_latency_us = sum / sampling_latencies.size();
-        } else {
-            result.sampling_latency_us = 0;
+        // Verifica se processo filho terminou
+        int child_status;
+        if (waitpid(worker_pid, &child_status, WNOHANG) > 0) {
+            break;
         }
     }
 
+    // Espera filho terminar
+    waitpid(worker_pid, nullptr, 0);
+
+    auto end = high_resolution_clock::now();
+    result.execution_time_ms = duration<double, milli>(end - start).count();
+    result.worker = worker_counters.read();
+    result.profiler = perf_counters_delta(profiler_before, profiler_counters.read());
+    result.samples = sample_count;
+
+    // Latência média de sampling (em ponto flutuante, sem truncar)
+    result.sampling_latency_us = sample_count > 0 ? latency_sum_us / sample_count : 0.0;
+    if (profiler_counters.has_syscalls() && sample_count > 0) {
+        result.syscalls_per_sample = static_cast<double>(sampling_syscalls) / sample_count;
+    }
+
     return result;
 }
 
@@ -157,13 +223,46 @@ void print_results(const vector<BenchmarkResult>& results) {
         cout << left << setw(30) << r.test_name
              << right << setw(15) << fixed << setprecision(2) << r.execution_time_ms
              << setw(18) << fixed << setprecision(2) << overhead << "%"
-             << setw(20) << r.sampling_latency_us << endl;
+             << setw(20) << fixed << setprecision(2) << r.sampling_latency_us << endl;
     }
 
     cout << string(83, '-') << endl;
+
+    // Atribuição do overhead pelos contadores de software do perf_event
+    cout << "\nContadores perf_event (software):" << endl;
+    cout << left << setw(30) << "Teste"
+         << right << setw(14) << "Worker CPU ms"
+         << setw(10) << "W ctxsw"
+         << setw(10) << "W migr"
+         << setw(10) << "W faults"
+         << setw(14) << "Prof CPU ms"
+         << setw(10) << "P ctxsw"
+         << setw(10) << "P faults"
+         << setw(12) << "Syscalls/am" << endl;
+
+    cout << string(120, '-') << endl;
+
+    for (const auto& r : results) {
+        cout << left << setw(30) << r.test_name
+             << right << setw(14) << fixed << setprecision(2) << r.worker.task_clock_ns / 1e6
+             << setw(10) << r.worker.context_switches
+             << setw(10) << r.worker.cpu_migrations
+             << setw(10) << r.worker.page_faults
+             << setw(14) << fixed << setprecision(2) << r.profiler.task_clock_ns / 1e6
+             << setw(10) << r.profiler.context_switches
+             << setw(10) << r.profiler.page_faults;
+        if (r.syscalls_per_sample >= 0) {
+            cout << setw(12) << fixed << setprecision(1) << r.syscalls_per_sample << endl;
+        } else {
+            cout << setw(12) << "N/A" << endl;
+        }
+    }
+
+    cout << string(120, '-') << endl;
+    cout << "Syscalls/amostra requer o tracepoint raw_syscalls (root ou perf_event_paranoid=-1)" << endl;
 }
 
-int main() {
+int main(int argc, char* argv[]) {
     cout << "======================================================" << endl;
     cout << "  EXPERIMENTO 1: OVERHEAD DE MONITORAMENTO" << endl;
     cout << "  Benchmark do Resource Profiler - Aluno 1/2" << endl;
@@ -173,32 +272,59 @@ int main() {
 
     const int WORKLOAD_ITERATIONS = 5000000; // 5 milhões de iterações
 
+    BenchConfig defaults;
+    defaults.warmup_runs = 1;
+    defaults.min_runs = 5;
+    defaults.max_runs = 15;
+    defaults.target_ci_percent = 3.0;
+    defaults.json_output = "experimento1_harness.json";
+    BenchHarness harness("experimento1_overhead", bench_parse_args(argc, argv, defaults));
+
     vector<BenchmarkResult> results;
 
     cout << "Configuracao:" << endl;
     cout << "  Workload: " << WORKLOAD_ITERATIONS << " iteracoes" << endl;
     cout << "  Metricas coletadas: CPU, Memoria, I/O" << endl;
+    cout << "  Contadores perf: task-clock, context-switches, cpu-migrations, page-faults, syscalls" << endl;
     cout << "  Intervalos testados: Sem, 10ms, 50ms, 100ms, 500ms\n" << endl;
 
     // TESTE 1: Baseline - SEM monitoramento
     cout << "Executando baseline (sem monitoramento)... " << flush;
-    results.push_back(run_without_monitoring(WORKLOAD_ITERATIONS));
-    cout << "OK (" << fixed << setprecision(2) << results.back().execution_time_ms << "ms)" << endl;
+    BenchmarkResult last;
+    BenchResult base = harness.run("SEM_MONITORAMENTO", [&]() {
+        last = run_without_monitoring(WORKLOAD_ITERATIONS);
+        return last.execution_time_ms;
+    });
+    last.execution_time_ms = base.median;
+    results.push_back(last);
+    cout << "OK (" << fixed << setprecision(2) << results.back().execution_time_ms
+         << "ms, " << base.runs << " repeticoes)" << endl;
 
     // TESTE 2-5: COM monitoramento em diferentes intervalos
     vector<int> intervals = {10, 50, 100, 500};
 
     for (int interval : intervals) {
         cout << "Executando com monitoramento (" << interval << "ms)... " << flush;
-        results.push_back(run_with_monitoring(WORKLOAD_ITERATIONS, interval));
-        cout << "OK (" << fixed << setprecision(2) << results.back().execution_time_ms << "ms)" << endl;
+        BenchResult stats = harness.run("COM_MONITORAMENTO_" + to_string(interval) + "ms", [&]() {
+            last = run_with_monitoring(WORKLOAD_ITERATIONS, interval);
+            return last.execution_time_ms;
+        });
+        last.execution_time_ms = stats.median;
+        results.push_back(last);
+        cout << "OK (" << fixed << setprecision(2) << results.back().execution_time_ms
+             << "ms, " << stats.runs << " repeticoes)" << endl;
     }
 
     print_results(results);
+    harness.print_summary();
+    harness.write_json();
 
     // Salva resultados em CSV
     ofstream csv("experimento1_overhead_results.csv");
-    csv << "Teste,Tempo_ms,Overhead_percent,Latencia_amostragem_us,Iteracoes\n";
+    csv << "Teste,Tempo_ms,Overhead_percent,Latencia_amostragem_us,Iteracoes,Amostras,"
+        << "Worker_task_clock_ns,Worker_context_switches,Worker_cpu_migrations,Worker_page_faults,"
+        << "Profiler_task_clock_ns,Profiler_context_switches,Profiler_cpu_migrations,"
+        << "Profiler_page_faults,Profiler_syscalls_por_amostra\n";
 
     double baseline_time = results[0].execution_time_ms;
     for (const auto& r : results) {
@@ -207,7 +333,21 @@ int main() {
             << r.execution_time_ms << ","
             << overhead << ","
             << r.sampling_latency_us << ","
-            << r.iterations_completed << "\n";
+            << r.iterations_completed << ","
+            << r.samples << ","
+            << r.worker.task_clock_ns << ","
+            << r.worker.context_switches << ","
+            << r.worker.cpu_migrations << ","
+            << r.worker.page_faults << ","
+            << r.profiler.task_clock_ns << ","
+            << r.profiler.context_switches << ","
+            << r.profiler.cpu_migrations << ","
+            << r.profiler.page_faults << ",";
+        if (r.syscalls_per_sample >= 0) {
+            csv << r.syscalls_per_sample << "\n";
+        } else {
+            csv << "NA\n";
+        }
     }
     csv.close();
 
@@ -229,7 +369,8 @@ int main() {
 
     cout << "\n======================================================" << endl;
     cout << "  EXPERIMENTO 1 CONCLUIDO" << endl;
-    cout << "  Arquivo gerado: experimento1_overhead_results.csv" << endl;
+    cout << "  Arquivos gerados: experimento1_overhead_results.csv, "
+         << harness.get_config().json_output << endl;
     cout << "======================================================" << endl;
 
     return 0;
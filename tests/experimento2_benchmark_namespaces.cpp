@@ -1,4 +1,5 @@
 #include "../include/namespace.hpp"
+#include "bench_harness.hpp"
 #include <iostream>
 #include <fstream>
 #include <vector>
@@ -23,7 +24,7 @@ using namespace std;
 // METODOLOGIA:
 // - Mede apenas a syscall unshare(), sem incluir fork/waitpid no tempo
 // - Usa pipe para comunicar o tempo medido do processo filho ao pai
-// - 200 iterações para reduzir variância estatística
+// - Harness compartilhado: warmup e repetições (até 200) até o IC 95% convergir
 // - Cada namespace é testado de forma independente
 
 // Estrutura para armazenar resultados do benchmark
@@ -33,6 +34,9 @@ struct BenchmarkResult {
     double avg_us;
     double min_us;
     double max_us;
+    double median_us;
+    double p99_us;
+    int runs;
     bool supported;
     int processes_found; // usando a funcao find_processes_in_namespace
 };
@@ -127,9 +131,9 @@ int count_processes_in_namespace(NamespaceType ns_type) {
 
 // Faz benchmark de um tipo de namespace
 // AGORA INTEGRADO COM A ESTRUTURA DO PROJETO
-BenchmarkResult benchmark_namespace(const string& name, int ns_flag,
-                                   NamespaceType ns_type, int iterations) {
-    BenchmarkResult result;
+BenchmarkResult benchmark_namespace(BenchHarness& harness, const string& name, int ns_flag,
+                                   NamespaceType ns_type) {
+    BenchmarkResult result = {};
     result.ns_name = name;
     result.ns_flag = ns_flag;
     result.supported = true;
@@ -138,32 +142,22 @@ BenchmarkResult benchmark_namespace(const string& name, int ns_flag,
     // verifica se é suportado
     if (ns_flag != 0 && !is_namespace_supported(ns_flag)) {
         result.supported = false;
-        result.avg_us = 0;
-        result.min_us = 0;
-        result.max_us = 0;
         return result;
     }
 
-    vector<double> times;
-
     cout << "  Testando " << name << "... " << flush;
 
-    for (int i = 0; i < iterations; i++) {
-        double time_us = test_namespace_creation(ns_flag);
-        times.push_back(time_us);
-    }
-
-    // calcula estatisticas
-    sort(times.begin(), times.end());
-
-    double sum = 0;
-    for (double t : times) {
-        sum += t;
-    }
+    // Repetições controladas pelo harness (tempo negativo = falha descartada)
+    BenchResult stats = harness.run(name, [ns_flag]() {
+        return test_namespace_creation(ns_flag);
+    }, "us");
 
-    result.avg_us = sum / times.size();
-    result.min_us = times.front();
-    result.max_us = times.back();
+    result.avg_us = stats.mean;
+    result.min_us = stats.min;
+    result.max_us = stats.max;
+    result.median_us = stats.median;
+    result.p99_us = stats.p99;
+    result.runs = stats.runs;
 
     // Usa a API do Namespace Analyzer para contar processos no namespace
     if (ns_flag != 0) {
@@ -184,27 +178,31 @@ void print_results(const vector<BenchmarkResult>& results) {
     // tabela formatada
     cout << left << setw(12) << "Namespace"
          << right << setw(15) << "Media (us)"
+         << setw(15) << "Mediana (us)"
+         << setw(15) << "p99 (us)"
          << setw(15) << "Min (us)"
          << setw(15) << "Max (us)"
          << setw(12) << "Processos" << endl;
 
-    cout << string(69, '-') << endl;
+    cout << string(99, '-') << endl;
 
     for (const auto& result : results) {
         if (!result.supported) {
             cout << left << setw(12) << result.ns_name
-                 << right << setw(57) << "NAO SUPORTADO" << endl;
+                 << right << setw(87) << "NAO SUPORTADO" << endl;
             continue;
         }
 
         cout << left << setw(12) << result.ns_name
              << right << setw(15) << fixed << setprecision(2) << result.avg_us
+             << setw(15) << fixed << setprecision(2) << result.median_us
+             << setw(15) << fixed << setprecision(2) << result.p99_us
              << setw(15) << fixed << setprecision(2) << result.min_us
              << setw(15) << fixed << setprecision(2) << result.max_us
              << setw(12) << result.processes_found << endl;
     }
 
-    cout << string(69, '-') << endl;
+    cout << string(99, '-') << endl;
 
     // Ranking de overhead (do mais rápido ao mais lento)
     cout << "\nRANKING DE OVERHEAD (mais rapido -> mais lento):\n" << endl;
@@ -227,16 +225,22 @@ void print_results(const vector<BenchmarkResult>& results) {
     }
 }
 
-int main() {
+int main(int argc, char* argv[]) {
     cout << "======================================================" << endl;
     cout << "  EXPERIMENTO 2: ISOLAMENTO VIA NAMESPACES" << endl;
     cout << "  Benchmark de Overhead - Aluno C" << endl;
     cout << "======================================================" << endl;
     cout << "\nEste experimento mede o overhead de criacao de namespaces" << endl;
     cout << "usando as funcoes do Namespace Analyzer (Componente 2)" << endl;
-    cout << "Cada teste sera executado 200 vezes para precisao\n" << endl;
+    cout << "Cada teste repete ate o IC 95% convergir (maximo 200 vezes)\n" << endl;
 
-    const int ITERATIONS = 200;
+    BenchConfig defaults;
+    defaults.warmup_runs = 5;
+    defaults.min_runs = 30;
+    defaults.max_runs = 200;
+    defaults.target_ci_percent = 5.0;
+    defaults.json_output = "experimento2_harness.json";
+    BenchHarness harness("experimento2_namespaces", bench_parse_args(argc, argv, defaults));
 
     // verifica se esta rodando como root
     if (geteuid() != 0) {
@@ -258,24 +262,29 @@ int main() {
     cout << "Executando testes de overhead (medindo apenas unshare)...\n" << endl;
 
     // Testa cada tipo de namespace usando a API do Namespace Analyzer
-    results.push_back(benchmark_namespace("CGROUP", CLONE_NEWCGROUP, NamespaceType::CGROUP, ITERATIONS));
-    results.push_back(benchmark_namespace("IPC", CLONE_NEWIPC, NamespaceType::IPC, ITERATIONS));
-    results.push_back(benchmark_namespace("MNT", CLONE_NEWNS, NamespaceType::MNT, ITERATIONS));
-    results.push_back(benchmark_namespace("NET", CLONE_NEWNET, NamespaceType::NET, ITERATIONS));
-    results.push_back(benchmark_namespace("PID", CLONE_NEWPID, NamespaceType::PID, ITERATIONS));
-    results.push_back(benchmark_namespace("USER", CLONE_NEWUSER, NamespaceType::USER, ITERATIONS));
-    results.push_back(benchmark_namespace("UTS", CLONE_NEWUTS, NamespaceType::UTS, ITERATIONS));
+    results.push_back(benchmark_namespace(harness, "CGROUP", CLONE_NEWCGROUP, NamespaceType::CGROUP));
+    results.push_back(benchmark_namespace(harness, "IPC", CLONE_NEWIPC, NamespaceType::IPC));
+    results.push_back(benchmark_namespace(harness, "MNT", CLONE_NEWNS, NamespaceType::MNT));
+    results.push_back(benchmark_namespace(harness, "NET", CLONE_NEWNET, NamespaceType::NET));
+    results.push_back(benchmark_namespace(harness, "PID", CLONE_NEWPID, NamespaceType::PID));
+    results.push_back(benchmark_namespace(harness, "USER", CLONE_NEWUSER, NamespaceType::USER));
+    results.push_back(benchmark_namespace(harness, "UTS", CLONE_NEWUTS, NamespaceType::UTS));
 
     print_results(results);
+    harness.print_summary();
+    harness.write_json();
 
     // salva em arquivo CSV
     ofstream csv("experimento2_benchmark_results.csv");
-    csv << "Namespace,Avg_us,Min_us,Max_us,Processes_Found,Supported\n";
+    csv << "Namespace,Avg_us,Median_us,P99_us,Min_us,Max_us,Runs,Processes_Found,Supported\n";
     for (const auto& r : results) {
         csv << r.ns_name << ","
             << r.avg_us << ","
+            << r.median_us << ","
+            << r.p99_us << ","
             << r.min_us << ","
             << r.max_us << ","
+            << r.runs << ","
             << r.processes_found << ","
             << (r.supported ? "yes" : "no") << "\n";
     }
@@ -294,6 +303,7 @@ int main() {
     cout << "  Arquivos gerados:" << endl;
     cout << "  - experimento2_benchmark_results.csv" << endl;
     cout << "  - experimento2_system_namespaces.csv" << endl;
+    cout << "  - " << harness.get_config().json_output << endl;
     cout << "======================================================" << endl;
 
     return 0;
@@ -18,6 +18,8 @@
 #include <chrono>
 #include <thread>
 #include <random>
+#include <cstdio>
+#include "bench_harness.hpp"
 
 // ================================
 // FUNÇÃO SIMULADA: set_cpu_limit
@@ -58,20 +60,21 @@ struct Result {
 // FUNÇÃO: test_limit
 // Propósito: Testa um limite de CPU específico
 // Parâmetros:
+//   harness: harness compartilhado (warmup, repetições até o IC convergir)
 //   cores: limite em cores (ex: 0.25, 0.5, 1.0)
-//   iterations: quantas medições fazer (padrão 10)
 // Retorno: Estrutura com resultados do teste
 // ================================
-Result test_limit(double cores, int iterations = 10) {
+Result test_limit(BenchHarness& harness, double cores) {
     Result r;
     r.limit_cores = cores;  // Armazena limite testado
 
-    // Vetores para armazenar medições individuais
-    std::vector<double> cpu_percents;  // Cada medição de CPU%
-    std::vector<double> throughputs;   // Cada medição de throughput
+    // Medições de CPU% de cada repetição (o throughput fica no harness)
+    // As chamadas de aquecimento do harness não entram na estatística
+    std::vector<double> cpu_percents;
+    int calls = 0;
 
-    // Executa o teste 'iterations' vezes
-    for (int i = 0; i < iterations; i++) {
+    // Uma repetição do teste: aplica o limite, roda o workload e mede
+    auto one_iteration = [&]() {
         // ================================
         // APLICAR LIMITE
         // ================================
@@ -98,15 +101,22 @@ Result test_limit(double cores, int iterations = 10) {
         // ================================
         // Em produção: double cpu = cgm.read_cpu_usage(cgroup_path);
         double cpu = read_cpu_from_cgroup();
-        cpu_percents.push_back(cpu);  // Armazena leitura
-        
-        // Calcula throughput: quantas operações por segundo
-        // Esperado: mais operações = menos throttling
-        throughputs.push_back(counter / 5.0);
+        if (++calls > harness.get_config().warmup_runs) {
+            cpu_percents.push_back(cpu);  // Armazena leitura
+        }
 
         // Pausa entre iterações para deixar sistema se recuperar
         std::this_thread::sleep_for(std::chrono::seconds(1));
-    }
+
+        // Throughput: quantas operações por segundo
+        // Esperado: mais operações = menos throttling
+        return counter / 5.0;
+    };
+
+    char name[64];
+    snprintf(name, sizeof(name), "limite_%.2f_cores", cores);
+    BenchResult stats = harness.run(name, one_iteration, "ops/s", true);
+    int iterations = static_cast<int>(cpu_percents.size());
 
     // ================================
     // CALCULAR ESTATÍSTICAS
@@ -124,8 +134,8 @@ Result test_limit(double cores, int iterations = 10) {
     }
     r.std_dev = std::sqrt(var / iterations);  // Raiz quadrada da variância
 
-    // Média de throughput
-    r.mean_throughput = std::accumulate(throughputs.begin(), throughputs.end(), 0.0) / iterations;
+    // Média de throughput (calculada pelo harness sobre as repetições medidas)
+    r.mean_throughput = stats.mean;
 
     return r;
 }
@@ -135,21 +145,30 @@ Result test_limit(double cores, int iterations = 10) {
 // Propósito: Executa Experimento 3 completo
 // Testa 4 limites de CPU diferentes
 // ================================
-int main() {
+int main(int argc, char* argv[]) {
     // Vetor para armazenar resultados de todos os testes
     std::vector<Result> results;
     
     // Cabeçalho
     std::cout << "Iniciando Experimento 3 - Throttling de CPU\n";
+
+    // Cada repetição leva ~6s: sem warmup longo, 3 a 10 repetições
+    BenchConfig defaults;
+    defaults.warmup_runs = 1;
+    defaults.min_runs = 3;
+    defaults.max_runs = 10;
+    defaults.target_ci_percent = 2.0;
+    defaults.json_output = "experimento3_harness.json";
+    BenchHarness harness("experimento3_throttling_cpu", bench_parse_args(argc, argv, defaults));
     
     // ================================
     // EXECUTAR TESTES COM DIFERENTES LIMITES
     // ================================
     // Testa: 0.25 cores (25%), 0.5 cores (50%), 1.0 core (100%), 2.0 cores (200%)
-    results.push_back(test_limit(0.25));  // Limite agressivo
-    results.push_back(test_limit(0.5));   // Limite moderado
-    results.push_back(test_limit(1.0));   // Limite de 1 core
-    results.push_back(test_limit(2.0));   // Limite de 2 cores
+    results.push_back(test_limit(harness, 0.25));  // Limite agressivo
+    results.push_back(test_limit(harness, 0.5));   // Limite moderado
+    results.push_back(test_limit(harness, 1.0));   // Limite de 1 core
+    results.push_back(test_limit(harness, 2.0));   // Limite de 2 cores
 
     // ================================
     // GERAR RELATÓRIO CSV
@@ -197,6 +216,9 @@ int main() {
                   << "\t" << precisao << "%\n";         // Precisão %
     }
 
+    harness.print_summary();
+    harness.write_json();
+
     // Mensagem final
     std::cout << "\n Experimento 3 concluído! Resultados salvos em experimento3_results.csv\n";
     return 0;
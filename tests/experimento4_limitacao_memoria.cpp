@@ -17,6 +17,8 @@
 #include <cstdlib>      // Para malloc, free
 #include <cstring>      // Para memset
 #include <fstream>      // Para ofstream
+#include <chrono>       // Para medir tempo de alocação
+#include "bench_harness.hpp"  // Harness compartilhado dos experimentos
 
 using namespace std;
 
@@ -58,21 +60,25 @@ struct MemResult {
     size_t allocated_mb;     // Memória que conseguiu alocar
     int oom_count;           // Quantas vezes OOM Killer atuou
     int failcnt;             // Contador de falhas de alocação
+    double alloc_time_ms;    // Mediana do tempo para alocar até o limite
+    int runs;                // Repetições medidas pelo harness
 };
 
 // ================================
 // FUNÇÃO: test_mem_limit
 // Propósito: Testa um limite de memória específico
 // Parâmetros:
+//   harness: harness compartilhado (warmup, repetições até o IC convergir)
 //   limit_mb: limite em megabytes (ex: 50, 100, 200)
-//   iterations: quantas tentativas fazer
 // Retorno: Estrutura com resultados
 // ================================
-MemResult test_mem_limit(size_t limit_mb, int iterations = 10) {
-    MemResult r = {limit_mb, 0, 0, 0};  // Inicializa resultado
+MemResult test_mem_limit(BenchHarness& harness, size_t limit_mb) {
+    MemResult r = {limit_mb, 0, 0, 0, 0.0, 0};  // Inicializa resultado
+    int calls = 0;       // Chamadas do harness (inclui aquecimento)
+    int measured = 0;    // Repetições que entram nas médias
 
-    // Executa 'iterations' vezes
-    for (int i = 0; i < iterations; i++) {
+    // Uma repetição: cria cgroup, aloca até o limite e mede o tempo
+    auto one_iteration = [&]() {
         // ================================
         // CRIAR CGROUP COM LIMITE
         // ================================
@@ -87,7 +93,9 @@ MemResult test_mem_limit(size_t limit_mb, int iterations = 10) {
         // Aloca blocos de 1MB até atingir limite ou falha
         
         size_t allocated = 0;  // Memória alocada (em MB)
+        int oom = 0;           // Falhas de alocação nesta repetição
         vector<void*> allocations;  // Ponteiros dos blocos
+        auto start = chrono::steady_clock::now();
         
         // Loop: aloca enquanto consegue e até limite + 50MB
         while (allocated < limit_mb + 50) {
@@ -96,7 +104,7 @@ MemResult test_mem_limit(size_t limit_mb, int iterations = 10) {
             
             if (!ptr) {
                 // Falha de alocação (limite atingido)
-                r.oom_count++;
+                oom++;
                 break;
             }
             
@@ -109,11 +117,16 @@ MemResult test_mem_limit(size_t limit_mb, int iterations = 10) {
             allocated++;
         }
 
-        // Acumula quantidade alocada
-        r.allocated_mb += allocated;
-        
-        // Lê contador de falhas do cgroup
-        r.failcnt += read_memory_failcnt();
+        double elapsed_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+        // Acumula apenas repetições medidas (aquecimento é descartado)
+        int failcnt = read_memory_failcnt();
+        if (++calls > harness.get_config().warmup_runs) {
+            r.allocated_mb += allocated;
+            r.oom_count += oom;
+            r.failcnt += failcnt;
+            measured++;
+        }
 
         // ================================
         // LIBERAR MEMÓRIA E LIMPAR
@@ -125,15 +138,23 @@ MemResult test_mem_limit(size_t limit_mb, int iterations = 10) {
         
         // Em produção: cgm.delete_cgroup("/test_mem");
         cleanup_cgroup();
-    }
+
+        return elapsed_ms;
+    };
+
+    BenchResult stats = harness.run("alocacao_" + to_string(limit_mb) + "MB", one_iteration, "ms");
+    r.alloc_time_ms = stats.median;
+    r.runs = stats.runs;
 
     // ================================
     // CALCULAR MÉDIAS
     // ================================
-    // Divide por número de iterações para obter média
-    r.allocated_mb /= iterations;
-    r.failcnt /= iterations;
-    r.oom_count /= iterations;
+    // Divide por número de repetições medidas para obter média
+    if (measured > 0) {
+        r.allocated_mb /= measured;
+        r.failcnt /= measured;
+        r.oom_count /= measured;
+    }
 
     return r;
 }
@@ -143,33 +164,43 @@ MemResult test_mem_limit(size_t limit_mb, int iterations = 10) {
 // Propósito: Executa Experimento 4 completo
 // Testa 4 limites de memória diferentes
 // ================================
-int main() {
+int main(int argc, char* argv[]) {
     // Vetor para armazenar resultados
     vector<MemResult> results;
     
     // Cabeçalho
     cout << "Iniciando Experimento 4 - Limitação de Memória\n";
+
+    BenchConfig defaults;
+    defaults.warmup_runs = 1;
+    defaults.min_runs = 5;
+    defaults.max_runs = 20;
+    defaults.target_ci_percent = 5.0;
+    defaults.json_output = "experimento4_harness.json";
+    BenchHarness harness("experimento4_limitacao_memoria", bench_parse_args(argc, argv, defaults));
     
     // ================================
     // EXECUTAR TESTES COM DIFERENTES LIMITES
     // ================================
     // Testa: 50MB, 100MB, 200MB, 500MB
-    results.push_back(test_mem_limit(50));    // Limite pequeno
-    results.push_back(test_mem_limit(100));   // Limite médio
-    results.push_back(test_mem_limit(200));   // Limite médio-grande
-    results.push_back(test_mem_limit(500));   // Limite grande
+    results.push_back(test_mem_limit(harness, 50));    // Limite pequeno
+    results.push_back(test_mem_limit(harness, 100));   // Limite médio
+    results.push_back(test_mem_limit(harness, 200));   // Limite médio-grande
+    results.push_back(test_mem_limit(harness, 500));   // Limite grande
 
     // ================================
     // GERAR RELATÓRIO CSV
     // ================================
     ofstream csv("experimento4_results.csv");
-    csv << "limite_mb,alocado_mb,oom_count,failcnt\n";  // Cabeçalho
+    csv << "limite_mb,alocado_mb,oom_count,failcnt,tempo_alocacao_ms,repeticoes\n";  // Cabeçalho
     
     for (auto& r : results) {
         csv << r.limit_mb << ","        // Coluna 1: limite em MB
             << r.allocated_mb << ","    // Coluna 2: memória alocada
             << r.oom_count << ","       // Coluna 3: OOM kills
-            << r.failcnt << "\n";       // Coluna 4: falhas
+            << r.failcnt << ","         // Coluna 4: falhas
+            << r.alloc_time_ms << ","   // Coluna 5: mediana do tempo de alocação
+            << r.runs << "\n";          // Coluna 6: repetições medidas
     }
     // Resultado: experimento4_results.csv
 
@@ -177,15 +208,19 @@ int main() {
     // EXIBIR TABELA NO CONSOLE
     // ================================
     cout << "\n=== RESULTADOS EXPERIMENTO 4 ===\n";
-    cout << "Limite\tAlocado\tOOM\tFailcnt\n";
+    cout << "Limite\tAlocado\tOOM\tFailcnt\tTempo (ms)\n";
     
     for (auto& r : results) {
         cout << r.limit_mb << " MB\t"  // Limite
              << r.allocated_mb << " MB\t"  // Alocado
              << r.oom_count << "\t"        // OOM kills
-             << r.failcnt << "\n";         // Falhas
+             << r.failcnt << "\t"         // Falhas
+             << r.alloc_time_ms << "\n";  // Mediana do tempo de alocação
     }
 
+    harness.print_summary();
+    harness.write_json();
+
     // Mensagem final
     cout << "\n Experimento 4 concluído! Resultados salvos em experimento4_results.csv\n";
     return 0;
@@ -12,15 +12,39 @@
 #include <fcntl.h>
 #include <sstream>
 #include <dirent.h>
+#include <algorithm>
 
 // Adicionar includes para major() e minor()
 #include <sys/sysmacros.h>
 
+// Harness compartilhado: repetições, IC 95% e saída JSON
+#include "bench_harness.hpp"
+
+// Latência e utilização do dispositivo durante cada escrita
+#include "../include/disk_stat.hpp"
+
+// Mediana de valores por repetição (0 se nenhuma repetição válida)
+static double median_of(std::vector<double> values) {
+    if (values.empty()) return 0.0;
+    size_t mid = values.size() / 2;
+    std::nth_element(values.begin(), values.begin() + mid, values.end());
+    double upper = values[mid];
+    if (values.size() % 2 != 0) return upper;
+    double lower = *std::max_element(values.begin(), values.begin() + mid);
+    return (lower + upper) / 2.0;
+}
+
 class IOThrottleExperiment {
 private:
     std::string CGROUP_PATH;
     std::string device_major_minor;
 
+    // /proc/diskstats amostrado no início e no fim de cada escrita
+    DiskStat disk_stat{true};
+    double last_write_await = 0;
+    double last_utilization = 0;
+    double last_queue_depth = 0;
+
     // Detectar dispositivo de bloco automaticamente
     bool detect_block_device() {
         // Tentar detectar o dispositivo raiz
@@ -157,6 +181,8 @@ private:
     long run_workload(int size_mb) {
         std::cout << "💾 Executando workload de " << size_mb << "MB..." << std::endl;
         
+        last_write_await = last_utilization = last_queue_depth = 0;
+        disk_stat.sample();
         auto start = std::chrono::high_resolution_clock::now();
 
         std::string filename = "/tmp/io_benchmark_" + std::to_string(getpid()) + ".bin";
@@ -202,11 +228,24 @@ private:
         long duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
         
         std::cout << " Duração: " << duration << " ms" << std::endl;
+
+        // Médias do dispositivo na escrita inteira: await alto com
+        // utilização baixa = espera pelo limite, não pelo disco
+        unsigned int major_num = 0, minor_num = 0;
+        sscanf(device_major_minor.c_str(), "%u:%u", &major_num, &minor_num);
+        const DiskDevice* dev = disk_stat.sample() ? disk_stat.find(major_num, minor_num) : nullptr;
+        if (dev) {
+            last_write_await = dev->write_await;
+            last_utilization = dev->utilization;
+            last_queue_depth = dev->queue_depth;
+            std::cout << " Disco " << dev->name << ": w_await " << last_write_await << " ms, util "
+                      << last_utilization << "%, fila " << last_queue_depth << std::endl;
+        }
         return duration;
     }
 
 public:
-    void run() {
+    void run(BenchHarness& harness) {
         std::cout << " INICIANDO EXPERIMENTO 5 - LIMITAÇÃO DE I/O" << std::endl;
         std::cout << "=============================================" << std::endl;
 
@@ -241,6 +280,7 @@ public:
         };
 
         std::vector<long> results;
+        std::vector<double> awaits, utilizations;
 
         for (const auto& test : test_cases) {
             std::cout << "\n TESTE: " << test.name << std::endl;
@@ -257,8 +297,24 @@ public:
             // Pequena pausa para estabilização
             std::this_thread::sleep_for(std::chrono::seconds(1));
 
-            // Executar workload
-            long duration_ms = run_workload(test.file_size_mb);
+            // Executar workload repetidamente pelo harness (mediana das repetições)
+            // await e utilização de cada repetição válida também entram pela
+            // mediana; o aquecimento passa pelo mesmo lambda e é descartado
+            int warmup_left = harness.get_config().warmup_runs;
+            std::vector<double> run_awaits, run_utilizations;
+            BenchResult stats = harness.run(test.name, [&]() {
+                long duration = run_workload(test.file_size_mb);
+                if (warmup_left > 0) {
+                    warmup_left--;
+                } else if (duration >= 0) {
+                    run_awaits.push_back(last_write_await);
+                    run_utilizations.push_back(last_utilization);
+                }
+                return static_cast<double>(duration);
+            }, "ms");
+            long duration_ms = stats.runs > 0 ? static_cast<long>(stats.median) : -1;
+            awaits.push_back(median_of(run_awaits));
+            utilizations.push_back(median_of(run_utilizations));
             
             if (duration_ms > 0) {
                 double throughput_mbps = (test.file_size_mb * 1024.0 * 1024.0) / (duration_ms / 1000.0);
@@ -276,7 +332,7 @@ public:
 
         // Gerar relatório CSV
         std::ofstream csv("experimento5_results.csv");
-        csv << "limite,arquivo_mb,tempo_ms,throughput_mbps\n";
+        csv << "limite,arquivo_mb,tempo_ms,throughput_mbps,w_await_ms,util_disco\n";
         
         for (size_t i = 0; i < test_cases.size(); i++) {
             if (results[i] > 0 && i < results.size()) {
@@ -286,7 +342,9 @@ public:
                 csv << test_cases[i].name << ","
                     << test_cases[i].file_size_mb << ","
                     << results[i] << ","
-                    << throughput_mbps << "\n";
+                    << throughput_mbps << ","
+                    << awaits[i] << ","
+                    << utilizations[i] << "\n";
             }
         }
         csv.close();
@@ -294,13 +352,16 @@ public:
         // Limpeza
         cleanup_cgroup();
 
+        harness.print_summary();
+        harness.write_json();
+
         std::cout << "\n EXPERIMENTO 5 CONCLUÍDO!" << std::endl;
         std::cout << " Resultados salvos em: experimento5_results.csv" << std::endl;
         std::cout << " Dica: Execute 'cat experimento5_results.csv' para ver os resultados" << std::endl;
     }
 };
 
-int main() {
+int main(int argc, char* argv[]) {
     if (geteuid() != 0) {
         std::cerr << " Este experimento requer privilégios de root!" << std::endl;
         std::cerr << "   Execute com: sudo ./bin/experimento5_limitacao_io" << std::endl;
@@ -316,8 +377,17 @@ int main() {
         return 1;
     }
 
+    // Cada repetição escreve até 50MB sob limite: poucas repetições
+    BenchConfig defaults;
+    defaults.warmup_runs = 0;
+    defaults.min_runs = 3;
+    defaults.max_runs = 5;
+    defaults.target_ci_percent = 5.0;
+    defaults.json_output = "experimento5_harness.json";
+    BenchHarness harness("experimento5_limitacao_io", bench_parse_args(argc, argv, defaults));
+
     IOThrottleExperiment experiment;
-    experiment.run();
+    experiment.run(harness);
 
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,129 @@
+// ============================================================
+// ARQUIVO: tests/perf_counters.cpp
+// DESCRIÇÃO: Implementação dos contadores de software do perf_event
+// Cada evento é aberto de forma independente (sem grupo), para que
+// a falta de um deles (ex: tracepoint sem permissão) não invalide os demais
+// ============================================================
+
+#include "perf_counters.hpp"
+#include <fstream>
+#include <string>
+#include <cstring>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <linux/perf_event.h>
+
+// glibc não exporta wrapper para perf_event_open
+static int perf_event_open(perf_event_attr* attr, pid_t pid, int cpu, int group_fd, unsigned long flags) {
+    return static_cast<int>(syscall(SYS_perf_event_open, attr, pid, cpu, group_fd, flags));
+}
+
+// Abre um contador contando apenas a tarefa indicada (sem herdar para filhos)
+static int open_counter(uint32_t type, uint64_t config, pid_t tid) {
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 0;
+    attr.exclude_hv = 1;
+    return perf_event_open(&attr, tid, -1, -1, PERF_FLAG_FD_CLOEXEC);
+}
+
+// Obtém o ID do tracepoint raw_syscalls:sys_enter (tracefs ou debugfs)
+static long syscall_tracepoint_id() {
+    static const char* paths[] = {
+        "/sys/kernel/tracing/events/raw_syscalls/sys_enter/id",
+        "/sys/kernel/debug/tracing/events/raw_syscalls/sys_enter/id"
+    };
+    for (const char* path : paths) {
+        std::ifstream file(path);
+        long id = -1;
+        if (file.is_open() && (file >> id)) {
+            return id;
+        }
+    }
+    return -1;
+}
+
+// Lê um contador; descritores inválidos valem 0
+static uint64_t read_counter(int fd) {
+    if (fd < 0) return 0;
+    uint64_t value = 0;
+    if (::read(fd, &value, sizeof(value)) != sizeof(value)) {
+        return 0;
+    }
+    return value;
+}
+
+PerfCounterValues perf_counters_delta(const PerfCounterValues& before, const PerfCounterValues& after) {
+    PerfCounterValues d;
+    d.task_clock_ns = after.task_clock_ns - before.task_clock_ns;
+    d.context_switches = after.context_switches - before.context_switches;
+    d.cpu_migrations = after.cpu_migrations - before.cpu_migrations;
+    d.page_faults = after.page_faults - before.page_faults;
+    d.syscalls = after.syscalls - before.syscalls;
+    d.syscalls_available = before.syscalls_available && after.syscalls_available;
+    return d;
+}
+
+PerfCounterSet::PerfCounterSet()
+    : task_clock_fd(-1), context_switches_fd(-1), cpu_migrations_fd(-1),
+      page_faults_fd(-1), syscalls_fd(-1) {}
+
+PerfCounterSet::~PerfCounterSet() {
+    close();
+}
+
+bool PerfCounterSet::open(pid_t tid, bool count_syscalls) {
+    close();
+
+    task_clock_fd = open_counter(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK, tid);
+    context_switches_fd = open_counter(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES, tid);
+    cpu_migrations_fd = open_counter(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_MIGRATIONS, tid);
+    page_faults_fd = open_counter(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS, tid);
+
+    if (count_syscalls) {
+        long id = syscall_tracepoint_id();
+        if (id >= 0) {
+            syscalls_fd = open_counter(PERF_TYPE_TRACEPOINT, static_cast<uint64_t>(id), tid);
+        }
+    }
+
+    return task_clock_fd >= 0;
+}
+
+void PerfCounterSet::close() {
+    int* fds[] = {&task_clock_fd, &context_switches_fd, &cpu_migrations_fd,
+                  &page_faults_fd, &syscalls_fd};
+    for (int* fd : fds) {
+        if (*fd >= 0) {
+            ::close(*fd);
+            *fd = -1;
+        }
+    }
+}
+
+PerfCounterValues PerfCounterSet::read() const {
+    PerfCounterValues v;
+    v.task_clock_ns = read_counter(task_clock_fd);
+    v.context_switches = read_counter(context_switches_fd);
+    v.cpu_migrations = read_counter(cpu_migrations_fd);
+    v.page_faults = read_counter(page_faults_fd);
+    v.syscalls = read_counter(syscalls_fd);
+    v.syscalls_available = syscalls_fd >= 0;
+    return v;
+}
+
+uint64_t PerfCounterSet::read_syscalls() const {
+    return read_counter(syscalls_fd);
+}
+
+bool PerfCounterSet::is_open() const {
+    return task_clock_fd >= 0;
+}
+
+bool PerfCounterSet::has_syscalls() const {
+    return syscalls_fd >= 0;
+}
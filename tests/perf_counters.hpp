@@ -0,0 +1,76 @@
+// ============================================================
+// ARQUIVO: tests/perf_counters.hpp
+// DESCRIÇÃO: Contadores de software do perf_event para os experimentos
+// Usa apenas eventos PERF_TYPE_SOFTWARE (task-clock, context-switches,
+// cpu-migrations, page-faults), que funcionam em VMs sem PMU de hardware,
+// e o tracepoint raw_syscalls:sys_enter para contar syscalls
+// ============================================================
+
+#ifndef PERF_COUNTERS_HPP
+#define PERF_COUNTERS_HPP
+
+#include <sys/types.h>  // Para pid_t
+#include <cstdint>      // Para uint64_t
+
+// PerfCounterValues: leitura de todos os contadores de uma tarefa
+struct PerfCounterValues {
+    // Tempo de CPU efetivamente consumido pela tarefa (ns)
+    uint64_t task_clock_ns;
+
+    // Trocas de contexto (voluntárias + involuntárias)
+    uint64_t context_switches;
+
+    // Migrações da tarefa entre CPUs
+    uint64_t cpu_migrations;
+
+    // Page faults (minor + major)
+    uint64_t page_faults;
+
+    // Syscalls executadas (tracepoint raw_syscalls:sys_enter)
+    // Só é válido quando syscalls_available == true
+    uint64_t syscalls;
+    bool syscalls_available;
+};
+
+// Diferença entre duas leituras (after - before)
+PerfCounterValues perf_counters_delta(const PerfCounterValues& before, const PerfCounterValues& after);
+
+class PerfCounterSet {
+private:
+    // Um descritor por evento; -1 quando o evento não pôde ser aberto
+    int task_clock_fd;
+    int context_switches_fd;
+    int cpu_migrations_fd;
+    int page_faults_fd;
+    int syscalls_fd;
+
+public:
+    PerfCounterSet();
+    ~PerfCounterSet();
+
+    PerfCounterSet(const PerfCounterSet&) = delete;
+    PerfCounterSet& operator=(const PerfCounterSet&) = delete;
+
+    // Abre os contadores para uma tarefa específica
+    // Parâmetros:
+    //   tid: PID/TID alvo, ou 0 para a thread chamadora
+    //   count_syscalls: tenta abrir o tracepoint de syscalls
+    //                   (requer root ou perf_event_paranoid = -1)
+    // Retorno: true se ao menos o task-clock foi aberto
+    bool open(pid_t tid, bool count_syscalls = true);
+
+    // Fecha todos os descritores abertos
+    void close();
+
+    // Lê o valor atual de todos os contadores abertos
+    PerfCounterValues read() const;
+
+    // Lê apenas o contador de syscalls (uma única syscall read)
+    // Retorna 0 se o tracepoint não estiver disponível
+    uint64_t read_syscalls() const;
+
+    bool is_open() const;
+    bool has_syscalls() const;
+};
+
+#endif